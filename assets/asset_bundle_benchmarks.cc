@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_packer.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/file.h"
+
+namespace flutter {
+namespace benchmarking {
+
+namespace {
+
+constexpr char kPackName[] = "assets.pack";
+
+// An assets directory of small assets spread over subdirectories of 100
+// assets, and the pack of that directory.
+class AssetBundleFixture {
+ public:
+  explicit AssetBundleFixture(size_t asset_count) {
+    const std::string contents(512, 'x');
+    for (size_t i = 0; i < asset_count; i++) {
+      if (i % 100 == 0) {
+        directories_.push_back(fml::CreateDirectory(
+            assets_dir_.fd(), {"dir" + std::to_string(i / 100)},
+            fml::FilePermission::kReadWrite));
+      }
+      const std::string name = "asset" + std::to_string(i) + ".png";
+      fml::WriteAtomically(directories_.back(), name.c_str(),
+                           fml::DataMapping(contents));
+      asset_names_.push_back("dir" + std::to_string(i / 100) + "/" + name);
+    }
+
+    AssetPacker packer;
+    packer.AddDirectory(assets_dir_.fd());
+    fml::WriteAtomically(pack_dir_.fd(), kPackName, *packer.Pack());
+  }
+
+  const fml::UniqueFD& assets_dir() { return assets_dir_.fd(); }
+
+  const fml::UniqueFD& pack_dir() { return pack_dir_.fd(); }
+
+  const std::vector<std::string>& asset_names() const { return asset_names_; }
+
+ private:
+  fml::ScopedTemporaryDirectory assets_dir_;
+  fml::ScopedTemporaryDirectory pack_dir_;
+  std::vector<fml::UniqueFD> directories_;
+  std::vector<std::string> asset_names_;
+};
+
+// Creates a bundle and maps every asset, as an application loading all its
+// assets at startup would.
+void LoadAllAssets(benchmark::State& state,
+                   const AssetBundleFixture& fixture,
+                   const std::function<std::unique_ptr<AssetResolver>()>&
+                       create_bundle) {
+  while (state.KeepRunning()) {
+    auto bundle = create_bundle();
+    size_t total_size = 0;
+    for (const auto& name : fixture.asset_names()) {
+      total_size += bundle->GetAsMapping(name)->GetSize();
+    }
+    benchmark::DoNotOptimize(total_size);
+  }
+  state.SetItemsProcessed(state.iterations() * fixture.asset_names().size());
+}
+
+}  // namespace
+
+static void BM_DirectoryAssetBundleLoadAllAssets(
+    benchmark::State& state) {  // NOLINT
+  AssetBundleFixture fixture(state.range(0));
+  LoadAllAssets(state, fixture, [&fixture]() {
+    return std::make_unique<DirectoryAssetBundle>(
+        fml::Duplicate(fixture.assets_dir().get()), false);
+  });
+}
+
+static void BM_PackedAssetBundleLoadAllAssets(
+    benchmark::State& state) {  // NOLINT
+  AssetBundleFixture fixture(state.range(0));
+  LoadAllAssets(state, fixture, [&fixture]() {
+    return std::make_unique<PackedAssetBundle>(
+        fml::OpenFile(fixture.pack_dir(), kPackName, false,
+                      fml::FilePermission::kRead),
+        false);
+  });
+}
+
+static void BM_DirectoryAssetBundleMatchPattern(
+    benchmark::State& state) {  // NOLINT
+  AssetBundleFixture fixture(state.range(0));
+  std::unique_ptr<AssetResolver> bundle =
+      std::make_unique<DirectoryAssetBundle>(
+          fml::Duplicate(fixture.assets_dir().get()), false);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(bundle->GetAsMappings("asset1.*\\.png"));
+  }
+}
+
+static void BM_PackedAssetBundleMatchPattern(
+    benchmark::State& state) {  // NOLINT
+  AssetBundleFixture fixture(state.range(0));
+  std::unique_ptr<AssetResolver> bundle = std::make_unique<PackedAssetBundle>(
+      fml::OpenFile(fixture.pack_dir(), kPackName, false,
+                    fml::FilePermission::kRead),
+      false);
+  while (state.KeepRunning()) {
+    benchmark::DoNotOptimize(bundle->GetAsMappings("asset1.*\\.png"));
+  }
+}
+
+BENCHMARK(BM_DirectoryAssetBundleLoadAllAssets)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PackedAssetBundleLoadAllAssets)
+    ->RangeMultiplier(10)
+    ->Range(10, 1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_DirectoryAssetBundleMatchPattern)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PackedAssetBundleMatchPattern)
+    ->Arg(1000)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace benchmarking
+}  // namespace flutter
@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_packer.h"
+
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "flutter/assets/packed_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+static uint64_t AlignUp(uint64_t offset, uint64_t alignment) {
+  return (offset + alignment - 1) / alignment * alignment;
+}
+
+AssetPacker::AssetPacker() = default;
+
+AssetPacker::~AssetPacker() = default;
+
+void AssetPacker::AddAsset(const std::string& asset_name,
+                           std::unique_ptr<fml::Mapping> contents) {
+  assets_[asset_name] = std::move(contents);
+}
+
+bool AssetPacker::AddDirectory(const fml::UniqueFD& directory) {
+  return AddDirectoryRecursively(directory, "");
+}
+
+bool AssetPacker::AddDirectoryRecursively(const fml::UniqueFD& directory,
+                                          const std::string& prefix) {
+  bool success = true;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& parent,
+                                 const std::string& filename) {
+    if (fml::IsDirectory(parent, filename.c_str())) {
+      success &= AddDirectoryRecursively(
+          fml::OpenDirectoryReadOnly(parent, filename.c_str()),
+          prefix + filename + "/");
+      return true;
+    }
+    auto mapping = fml::FileMapping::CreateReadOnly(parent, filename);
+    if (!mapping) {
+      FML_LOG(ERROR) << "Could not read asset " << prefix << filename;
+      success = false;
+      return true;
+    }
+    AddAsset(prefix + filename, std::move(mapping));
+    return true;
+  });
+  return success;
+}
+
+std::unique_ptr<fml::Mapping> AssetPacker::Pack() const {
+  using Header = PackedAssetBundle::Header;
+  using Entry = PackedAssetBundle::Entry;
+
+  if (assets_.size() > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+
+  // Lay out the index, then the names, then the aligned contents.
+  std::vector<Entry> entries;
+  entries.reserve(assets_.size());
+  uint64_t offset = sizeof(Header) + assets_.size() * sizeof(Entry);
+  for (const auto& asset : assets_) {
+    if (offset + asset.first.size() > std::numeric_limits<uint32_t>::max()) {
+      FML_LOG(ERROR) << "The names of the assets are too large to be indexed.";
+      return nullptr;
+    }
+    Entry entry = {};
+    entry.name_offset = static_cast<uint32_t>(offset);
+    entry.name_size = static_cast<uint32_t>(asset.first.size());
+    entries.push_back(entry);
+    offset += asset.first.size();
+  }
+  size_t index = 0;
+  for (const auto& asset : assets_) {
+    offset = AlignUp(offset, PackedAssetBundle::kDataAlignment);
+    entries[index].data_offset = offset;
+    entries[index].data_size = asset.second->GetSize();
+    offset += asset.second->GetSize();
+    index++;
+  }
+
+  std::vector<uint8_t> pack(offset, 0);
+  Header header = {};
+  memcpy(header.magic, PackedAssetBundle::kMagic, sizeof(header.magic));
+  header.version = PackedAssetBundle::kVersion;
+  header.entry_count = static_cast<uint32_t>(assets_.size());
+  memcpy(pack.data(), &header, sizeof(header));
+  if (!entries.empty()) {
+    memcpy(pack.data() + sizeof(header), entries.data(),
+           entries.size() * sizeof(Entry));
+  }
+
+  index = 0;
+  for (const auto& asset : assets_) {
+    const Entry& entry = entries[index++];
+    memcpy(pack.data() + entry.name_offset, asset.first.data(),
+           entry.name_size);
+    if (entry.data_size > 0) {
+      memcpy(pack.data() + entry.data_offset, asset.second->GetMapping(),
+             entry.data_size);
+    }
+  }
+  return std::make_unique<fml::DataMapping>(std::move(pack));
+}
+
+}  // namespace flutter
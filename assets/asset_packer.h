@@ -0,0 +1,63 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_PACKER_H_
+#define FLUTTER_ASSETS_ASSET_PACKER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      Packs assets into the single file format served by
+///             |PackedAssetBundle|.
+///
+class AssetPacker {
+ public:
+  AssetPacker();
+
+  ~AssetPacker();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds an asset to the pack, replacing any asset previously
+  ///             added with the same name.
+  ///
+  void AddAsset(const std::string& asset_name,
+                std::unique_ptr<fml::Mapping> contents);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds every file under |directory| to the pack. The assets are
+  ///             named by their paths relative to |directory|, with `/`
+  ///             separators, which are the names |DirectoryAssetBundle| serves
+  ///             them under.
+  ///
+  /// @return     Whether all the files could be read.
+  ///
+  bool AddDirectory(const fml::UniqueFD& directory);
+
+  //----------------------------------------------------------------------------
+  /// @return     The pack of the assets added so far, or null if they are too
+  ///             large to be indexed.
+  ///
+  std::unique_ptr<fml::Mapping> Pack() const;
+
+ private:
+  // Sorted by name, as the index of the pack is.
+  std::map<std::string, std::unique_ptr<fml::Mapping>> assets_;
+
+  bool AddDirectoryRecursively(const fml::UniqueFD& directory,
+                               const std::string& prefix);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AssetPacker);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_ASSET_PACKER_H_
@@ -0,0 +1,160 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <cstring>
+#include <regex>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+static_assert(sizeof(PackedAssetBundle::Header) == 16,
+              "The header must not be padded.");
+static_assert(sizeof(PackedAssetBundle::Entry) == 24,
+              "Entries must not be padded.");
+
+PackedAssetBundle::PackedAssetBundle(const fml::UniqueFD& descriptor,
+                                     bool is_valid_after_asset_manager_change)
+    : PackedAssetBundle(std::make_shared<fml::FileMapping>(descriptor),
+                        is_valid_after_asset_manager_change) {}
+
+PackedAssetBundle::PackedAssetBundle(std::shared_ptr<const fml::Mapping> pack,
+                                     bool is_valid_after_asset_manager_change)
+    : pack_(std::move(pack)) {
+  if (!pack_ || !ValidatePack()) {
+    return;
+  }
+  is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
+  is_valid_ = true;
+}
+
+PackedAssetBundle::~PackedAssetBundle() = default;
+
+bool PackedAssetBundle::ValidatePack() {
+  const uint64_t pack_size = pack_->GetSize();
+  Header header;
+  if (pack_size < sizeof(header)) {
+    FML_DLOG(ERROR) << "Asset pack is too small for its header.";
+    return false;
+  }
+  memcpy(&header, pack_->GetMapping(), sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kVersion) {
+    FML_DLOG(ERROR) << "Not an asset pack, or an unsupported version of one.";
+    return false;
+  }
+  if (sizeof(Header) + uint64_t{header.entry_count} * sizeof(Entry) >
+      pack_size) {
+    FML_DLOG(ERROR) << "Asset pack is too small for its index.";
+    return false;
+  }
+  entry_count_ = header.entry_count;
+
+  std::string_view previous_name;
+  for (size_t i = 0; i < entry_count_; i++) {
+    const Entry entry = GetEntry(i);
+    if (uint64_t{entry.name_offset} + entry.name_size > pack_size ||
+        entry.data_size > pack_size ||
+        entry.data_offset > pack_size - entry.data_size) {
+      FML_DLOG(ERROR) << "Asset pack entry " << i << " is out of bounds.";
+      return false;
+    }
+    const std::string_view name = GetName(entry);
+    if (i > 0 && name <= previous_name) {
+      FML_DLOG(ERROR) << "Asset pack index is not sorted at entry " << i
+                      << ".";
+      return false;
+    }
+    previous_name = name;
+  }
+  return true;
+}
+
+PackedAssetBundle::Entry PackedAssetBundle::GetEntry(size_t index) const {
+  Entry entry;
+  memcpy(&entry, pack_->GetMapping() + sizeof(Header) + index * sizeof(Entry),
+         sizeof(entry));
+  return entry;
+}
+
+std::string_view PackedAssetBundle::GetName(const Entry& entry) const {
+  return {reinterpret_cast<const char*>(pack_->GetMapping()) +
+              entry.name_offset,
+          entry.name_size};
+}
+
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetData(
+    const Entry& entry) const {
+  // The mapping holds a reference to the pack to keep it mapped.
+  return std::make_unique<fml::NonOwnedMapping>(
+      pack_->GetMapping() + entry.data_offset, entry.data_size,
+      [pack = pack_](const uint8_t* data, size_t size) {});
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValid() const {
+  return is_valid_;
+}
+
+// |AssetResolver|
+bool PackedAssetBundle::IsValidAfterAssetManagerChange() const {
+  return is_valid_after_asset_manager_change_;
+}
+
+// |AssetResolver|
+AssetResolver::AssetResolverType PackedAssetBundle::GetType() const {
+  return AssetResolver::AssetResolverType::kPackedAssetBundle;
+}
+
+// |AssetResolver|
+std::unique_ptr<fml::Mapping> PackedAssetBundle::GetAsMapping(
+    const std::string& asset_name) const {
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return nullptr;
+  }
+
+  size_t low = 0;
+  size_t high = entry_count_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    const Entry entry = GetEntry(middle);
+    const int comparison = GetName(entry).compare(asset_name);
+    if (comparison == 0) {
+      return GetData(entry);
+    }
+    if (comparison < 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return nullptr;
+}
+
+// |AssetResolver|
+std::vector<std::unique_ptr<fml::Mapping>> PackedAssetBundle::GetAsMappings(
+    const std::string& asset_pattern) const {
+  std::vector<std::unique_ptr<fml::Mapping>> mappings;
+  if (!is_valid_) {
+    FML_DLOG(WARNING) << "Asset bundle was not valid.";
+    return mappings;
+  }
+
+  std::regex asset_regex(asset_pattern);
+  for (size_t i = 0; i < entry_count_; i++) {
+    const Entry entry = GetEntry(i);
+    std::string_view filename = GetName(entry);
+    filename.remove_prefix(filename.rfind('/') + 1);
+    if (std::regex_match(filename.begin(), filename.end(), asset_regex)) {
+      mappings.push_back(GetData(entry));
+    }
+  }
+  return mappings;
+}
+
+}  // namespace flutter
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+#define FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include "flutter/assets/asset_resolver.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      An asset resolver that serves the assets packed into a single
+///             file by the `asset-packer` tool.
+///
+///             The pack is mapped once. Looking up an asset is a binary search
+///             of the index of the pack, and the returned mappings point into
+///             the mapping of the pack, so no system calls are made per asset.
+///             The mappings keep the pack mapped until they are destroyed,
+///             even if the bundle is destroyed first.
+///
+///             The pack is laid out as follows. Integers are stored in the
+///             byte order of the engine targets, which are all little-endian.
+///
+///             - A |Header|.
+///             - `Header::entry_count` |Entry| records, sorted by name in
+///               byte order.
+///             - The names of the assets, which are not null terminated.
+///             - The contents of the assets, each aligned to
+///               |kDataAlignment| bytes.
+///
+class PackedAssetBundle : public AssetResolver {
+ public:
+  static constexpr char kMagic[8] = {'F', 'L', 'T', 'P', 'A', 'C', 'K', '\0'};
+  static constexpr uint32_t kVersion = 1;
+  static constexpr size_t kDataAlignment = 16;
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_count;
+  };
+
+  struct Entry {
+    // The offsets are from the start of the pack.
+    uint32_t name_offset;
+    uint32_t name_size;
+    uint64_t data_offset;
+    uint64_t data_size;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a bundle for the pack file at |descriptor|. The
+  ///             descriptor is only used to map the pack, so it can be closed
+  ///             once the bundle is created.
+  ///
+  PackedAssetBundle(const fml::UniqueFD& descriptor,
+                    bool is_valid_after_asset_manager_change);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a bundle for a pack that has already been mapped.
+  ///
+  PackedAssetBundle(std::shared_ptr<const fml::Mapping> pack,
+                    bool is_valid_after_asset_manager_change);
+
+  ~PackedAssetBundle() override;
+
+ private:
+  const std::shared_ptr<const fml::Mapping> pack_;
+  uint32_t entry_count_ = 0;
+  bool is_valid_ = false;
+  bool is_valid_after_asset_manager_change_ = false;
+
+  // Checks that the header and the index of the pack are well formed, and
+  // that the index is sorted.
+  bool ValidatePack();
+
+  Entry GetEntry(size_t index) const;
+
+  std::string_view GetName(const Entry& entry) const;
+
+  std::unique_ptr<fml::Mapping> GetData(const Entry& entry) const;
+
+  // |AssetResolver|
+  bool IsValid() const override;
+
+  // |AssetResolver|
+  bool IsValidAfterAssetManagerChange() const override;
+
+  // |AssetResolver|
+  AssetResolver::AssetResolverType GetType() const override;
+
+  // |AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) const override;
+
+  // |AssetResolver|
+  //
+  // Like |DirectoryAssetBundle|, the pattern is matched against the last
+  // component of the name of each asset.
+  std::vector<std::unique_ptr<fml::Mapping>> GetAsMappings(
+      const std::string& asset_pattern) const override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PackedAssetBundle);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_PACKED_ASSET_BUNDLE_H_
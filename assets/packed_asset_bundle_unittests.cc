@@ -0,0 +1,196 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/packed_asset_bundle.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_packer.h"
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/fml/file.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::string ToString(const fml::Mapping& mapping) {
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+std::unique_ptr<fml::Mapping> MakeMapping(const std::string& contents) {
+  return std::make_unique<fml::DataMapping>(contents);
+}
+
+std::shared_ptr<fml::Mapping> MakePack(
+    const std::vector<std::pair<std::string, std::string>>& assets) {
+  AssetPacker packer;
+  for (const auto& asset : assets) {
+    packer.AddAsset(asset.first, MakeMapping(asset.second));
+  }
+  return packer.Pack();
+}
+
+std::unique_ptr<AssetResolver> MakeBundle(
+    std::shared_ptr<const fml::Mapping> pack) {
+  return std::make_unique<PackedAssetBundle>(std::move(pack), false);
+}
+
+}  // namespace
+
+TEST(PackedAssetBundleTest, ServesPackedAssets) {
+  std::unique_ptr<AssetResolver> bundle = std::make_unique<PackedAssetBundle>(
+      MakePack({
+          {"AssetManifest.json", "{}"},
+          {"fonts/Roboto.ttf", "roboto"},
+          {"empty", ""},
+          {"packages/foo/image.png", std::string(1000, 'x')},
+      }),
+      true);
+  ASSERT_TRUE(bundle->IsValid());
+  EXPECT_TRUE(bundle->IsValidAfterAssetManagerChange());
+  EXPECT_EQ(bundle->GetType(),
+            AssetResolver::AssetResolverType::kPackedAssetBundle);
+
+  auto mapping = bundle->GetAsMapping("fonts/Roboto.ttf");
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(ToString(*mapping), "roboto");
+
+  mapping = bundle->GetAsMapping("AssetManifest.json");
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(ToString(*mapping), "{}");
+
+  mapping = bundle->GetAsMapping("empty");
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(mapping->GetSize(), 0u);
+
+  mapping = bundle->GetAsMapping("packages/foo/image.png");
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(ToString(*mapping), std::string(1000, 'x'));
+
+  EXPECT_FALSE(bundle->GetAsMapping("fonts"));
+  EXPECT_FALSE(bundle->GetAsMapping("fonts/Roboto.tt"));
+  EXPECT_FALSE(bundle->GetAsMapping("zzz"));
+  EXPECT_FALSE(bundle->GetAsMapping(""));
+}
+
+TEST(PackedAssetBundleTest, ServesEmptyPack) {
+  auto bundle = MakeBundle(MakePack({}));
+  ASSERT_TRUE(bundle->IsValid());
+  EXPECT_FALSE(bundle->GetAsMapping("anything"));
+}
+
+TEST(PackedAssetBundleTest, MatchesPatternsAgainstFileNames) {
+  auto bundle = MakeBundle(MakePack({
+      {"shaders/a.sksl", "a"},
+      {"shaders/b.sksl", "b"},
+      {"c.sksl", "c"},
+      {"shaders/d.json", "d"},
+  }));
+  ASSERT_TRUE(bundle->IsValid());
+
+  auto mappings = bundle->GetAsMappings(".*\\.sksl");
+  ASSERT_EQ(mappings.size(), 3u);
+  EXPECT_EQ(ToString(*mappings[0]), "c");
+  EXPECT_EQ(ToString(*mappings[1]), "a");
+  EXPECT_EQ(ToString(*mappings[2]), "b");
+
+  EXPECT_TRUE(bundle->GetAsMappings("shaders/.*").empty());
+}
+
+TEST(PackedAssetBundleTest, MappingsOutliveTheBundle) {
+  std::unique_ptr<fml::Mapping> mapping;
+  {
+    auto bundle = MakeBundle(MakePack({{"a", "contents"}}));
+    mapping = bundle->GetAsMapping("a");
+  }
+  ASSERT_TRUE(mapping);
+  EXPECT_EQ(ToString(*mapping), "contents");
+}
+
+TEST(PackedAssetBundleTest, RejectsMalformedPacks) {
+  EXPECT_FALSE(MakeBundle(nullptr)->IsValid());
+  EXPECT_FALSE(MakeBundle(MakeMapping(""))->IsValid());
+  EXPECT_FALSE(MakeBundle(MakeMapping("not an asset pack at all"))->IsValid());
+
+  const auto pack = MakePack({{"a", "first"}, {"b", "second"}});
+  const std::vector<uint8_t> bytes(pack->GetMapping(),
+                                   pack->GetMapping() + pack->GetSize());
+  auto make_bundle = [](std::vector<uint8_t> bytes) {
+    return MakeBundle(std::make_shared<fml::DataMapping>(std::move(bytes)));
+  };
+  ASSERT_TRUE(make_bundle(bytes)->IsValid());
+
+  // Truncated index.
+  EXPECT_FALSE(make_bundle({bytes.begin(), bytes.begin() + 30})->IsValid());
+
+  // Truncated contents.
+  EXPECT_FALSE(make_bundle({bytes.begin(), bytes.end() - 1})->IsValid());
+
+  // Unsupported version.
+  auto corrupted = bytes;
+  corrupted[8] = 2;
+  EXPECT_FALSE(make_bundle(corrupted)->IsValid());
+
+  // Unsorted index.
+  corrupted = bytes;
+  PackedAssetBundle::Entry entries[2];
+  memcpy(entries, corrupted.data() + sizeof(PackedAssetBundle::Header),
+         sizeof(entries));
+  std::swap(entries[0], entries[1]);
+  memcpy(corrupted.data() + sizeof(PackedAssetBundle::Header), entries,
+         sizeof(entries));
+  EXPECT_FALSE(make_bundle(corrupted)->IsValid());
+}
+
+TEST(PackedAssetBundleTest, ServesTheAssetsOfAPackedDirectory) {
+  fml::ScopedTemporaryDirectory assets_dir;
+  auto fonts_dir = fml::CreateDirectory(assets_dir.fd(), {"fonts"},
+                                        fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(fml::WriteAtomically(assets_dir.fd(), "AssetManifest.json",
+                                   *MakeMapping("{}")));
+  ASSERT_TRUE(fml::WriteAtomically(fonts_dir, "Roboto.ttf",
+                                   *MakeMapping("roboto")));
+
+  AssetPacker packer;
+  ASSERT_TRUE(packer.AddDirectory(assets_dir.fd()));
+  auto pack = packer.Pack();
+  ASSERT_TRUE(pack);
+
+  fml::ScopedTemporaryDirectory pack_dir;
+  ASSERT_TRUE(fml::WriteAtomically(pack_dir.fd(), "assets.pack", *pack));
+  std::unique_ptr<AssetResolver> packed_bundle =
+      std::make_unique<PackedAssetBundle>(
+          fml::OpenFile(pack_dir.fd(), "assets.pack", false,
+                        fml::FilePermission::kRead),
+          true);
+  ASSERT_TRUE(packed_bundle->IsValid());
+
+  std::unique_ptr<AssetResolver> directory_bundle =
+      std::make_unique<DirectoryAssetBundle>(
+          fml::Duplicate(assets_dir.fd().get()), true);
+  for (const char* asset_name : {"AssetManifest.json", "fonts/Roboto.ttf"}) {
+    auto packed = packed_bundle->GetAsMapping(asset_name);
+    auto unpacked = directory_bundle->GetAsMapping(asset_name);
+    ASSERT_TRUE(packed);
+    ASSERT_TRUE(unpacked);
+    EXPECT_EQ(ToString(*packed), ToString(*unpacked));
+    // The pack is mapped at a page boundary, so the contents are aligned.
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(packed->GetMapping()) %
+                  PackedAssetBundle::kDataAlignment,
+              0u);
+  }
+
+  fml::UnlinkFile(pack_dir.fd(), "assets.pack");
+  fml::UnlinkFile(fonts_dir, "Roboto.ttf");
+  fml::UnlinkDirectory(assets_dir.fd(), "fonts");
+  fml::UnlinkFile(assets_dir.fd(), "AssetManifest.json");
+}
+
+}  // namespace testing
+}  // namespace flutter
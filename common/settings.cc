@@ -62,6 +62,18 @@ std::string Settings::ToString() const {
   stream << "frame_rasterized_callback set: " << !!frame_rasterized_callback
          << std::endl;
   stream << "old_gen_heap_size: " << old_gen_heap_size << std::endl;
+  stream << "raster_cache_max_bytes: " << raster_cache_max_bytes << std::endl;
+  stream << "decoded_image_cache_max_bytes: " << decoded_image_cache_max_bytes
+         << std::endl;
+  stream << "shaping_cache_max_bytes: " << shaping_cache_max_bytes << std::endl;
+  stream << "enable_async_raster_cache: " << enable_async_raster_cache
+         << std::endl;
+  stream << "raster_cache_reuse_scale_tolerance: "
+         << raster_cache_reuse_scale_tolerance << std::endl;
+  stream << "enable_latest_frame_pipeline: " << enable_latest_frame_pipeline
+         << std::endl;
+  stream << "enable_platform_message_batching: "
+         << enable_platform_message_batching << std::endl;
   return stream.str();
 }
 
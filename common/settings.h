@@ -238,6 +238,54 @@ struct Settings {
   /// https://github.com/dart-lang/sdk/blob/ca64509108b3e7219c50d6c52877c85ab6a35ff2/runtime/vm/flag_list.h#L150
   int64_t old_gen_heap_size = -1;
 
+  /// Max size of the images held by the raster cache in bytes, or 0 for
+  /// unlimited, -1 for the default value.
+  ///
+  /// See also: `RasterCache::SetMaxBytes`.
+  int64_t raster_cache_max_bytes = -1;
+
+  /// Max size of the images held by the decoded image cache of the process in
+  /// bytes, or 0 to disable the cache, -1 for the default value.
+  ///
+  /// See also: `DecodedImageCache::SetMaxBytes`.
+  int64_t decoded_image_cache_max_bytes = -1;
+
+  /// Max size of the shaped words held by the shaping cache of the process in
+  /// bytes, or 0 to disable the cache, -1 for the default value.
+  ///
+  /// See also: `txt::FontCollection::SetShapingCacheMaxBytes`.
+  int64_t shaping_cache_max_bytes = -1;
+
+  /// Rasterize the pictures of the raster cache on the concurrent worker
+  /// threads of the VM instead of during the frame workload.
+  ///
+  /// See also: `RasterCache::SetWorkerTaskRunner`.
+  bool enable_async_raster_cache = false;
+
+  /// How much the scale of a raster cache entry may differ from the scale it
+  /// was rasterized at when it is reused for another transform, or 0 to only
+  /// reuse entries for their own transform.
+  ///
+  /// See also: `RasterCache::SetReuseScaleBounds`.
+  double raster_cache_reuse_scale_tolerance = 0;
+
+  /// Hand layer trees to the raster thread through a single slot in which a
+  /// newer layer tree replaces one that has not been rasterized yet, instead
+  /// of a queue. This keeps the latency of frames bounded when the raster
+  /// thread cannot keep up, at the cost of skipping frames.
+  ///
+  /// See also: `PipelineMode::LatestWins`.
+  bool enable_latest_frame_pipeline = false;
+
+  /// Coalesce the platform messages sent between the platform and the engine,
+  /// and the responses to the messages sent by the platform, into a single
+  /// task per burst. A batch is delivered when its task runs, so its messages
+  /// and responses may be handled ahead of other platform events, such as
+  /// pointer data packets, that were sent after the batch's task was posted.
+  ///
+  /// See also: `PlatformMessageBatcher`, `PlatformMessageResponseBatcher`.
+  bool enable_platform_message_batching = false;
+
   /// A timestamp representing when the engine started. The value is based
   /// on the clock used by the Dart timeline APIs. This timestamp is used
   /// to log a timeline event that tracks the latency of engine startup.
@@ -16,6 +16,7 @@ CompositorContext::~CompositorContext() = default;
 
 void CompositorContext::BeginFrame(ScopedFrame& frame,
                                    bool enable_instrumentation) {
+  raster_cache_.CollectWorkerResults(frame.gr_context());
   if (enable_instrumentation) {
     frame_count_.Increment();
     raster_time_.Start();
@@ -60,6 +61,9 @@ CompositorContext::ScopedFrame::ScopedFrame(
       instrumentation_enabled_(instrumentation_enabled),
       surface_supports_readback_(surface_supports_readback),
       raster_thread_merger_(raster_thread_merger) {
+  if (context_.layer_profiling_enabled()) {
+    layer_profiler_ = std::make_unique<LayerProfiler>();
+  }
   context_.BeginFrame(*this, instrumentation_enabled_);
 }
 
@@ -69,9 +73,14 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
 
 RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
-    bool ignore_raster_cache) {
+    bool ignore_raster_cache,
+    FrameDamage* frame_damage) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
   bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
+  std::optional<SkRect> clip_rect;
+  if (frame_damage) {
+    clip_rect = ComputeClipRect(layer_tree, frame_damage);
+  }
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
   if (view_embedder_ && raster_thread_merger_) {
@@ -88,6 +97,14 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
   if (canvas()) {
+    if (clip_rect) {
+      // The damage is in device coordinates.
+      canvas()->save();
+      const SkMatrix matrix = canvas()->getTotalMatrix();
+      canvas()->resetMatrix();
+      canvas()->clipRect(*clip_rect);
+      canvas()->setMatrix(matrix);
+    }
     if (needs_save_layer) {
       FML_LOG(INFO) << "Using SaveLayer to protect non-readback surface";
       SkRect bounds = SkRect::Make(layer_tree.frame_size());
@@ -101,9 +118,64 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (canvas() && needs_save_layer) {
     canvas()->restore();
   }
+  if (canvas() && clip_rect) {
+    canvas()->restore();
+  }
+  if (layer_profiler_) {
+    context_.last_layer_profile_ = std::move(layer_profiler_);
+  }
   return RasterStatus::kSuccess;
 }
 
+std::optional<SkRect> CompositorContext::ScopedFrame::ComputeClipRect(
+    flutter::LayerTree& layer_tree,
+    FrameDamage* frame_damage) {
+  TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::ComputeClipRect");
+  const SkIRect frame_rect =
+      root_surface_transformation_
+          .mapRect(SkRect::Make(layer_tree.frame_size()))
+          .roundOut();
+
+  DiffContext context(layer_tree.frame_size(), root_surface_transformation_);
+  if (layer_tree.root_layer()) {
+    layer_tree.root_layer()->Diff(&context);
+  }
+
+  if (frame_damage->prev_paint_regions) {
+    frame_damage->frame_damage =
+        context.ComputeDamage(*frame_damage->prev_paint_regions);
+  } else {
+    frame_damage->frame_damage = frame_rect;
+  }
+
+  std::optional<SkRect> clip_rect;
+  if (frame_damage->existing_buffer_damage) {
+    SkIRect buffer_damage = *frame_damage->frame_damage;
+    buffer_damage.join(*frame_damage->existing_buffer_damage);
+    buffer_damage = context.ExpandDamageForReadback(buffer_damage);
+    if (buffer_damage.intersect(frame_rect)) {
+      frame_damage->buffer_damage = buffer_damage;
+    } else {
+      frame_damage->buffer_damage = SkIRect::MakeEmpty();
+    }
+    clip_rect = SkRect::Make(*frame_damage->buffer_damage);
+  } else {
+    frame_damage->buffer_damage = std::nullopt;
+  }
+
+  frame_damage->paint_regions = context.TakePaintRegions();
+
+  const SkIRect& damage = *frame_damage->frame_damage;
+  const SkIRect repainted =
+      frame_damage->buffer_damage.value_or(frame_rect);
+  FML_TRACE_COUNTER("flutter", "FrameDamage",
+                    reinterpret_cast<int64_t>(&context_),            //
+                    "DamagedPixels", damage.width() * damage.height(),  //
+                    "RepaintedPixels",
+                    repainted.width() * repainted.height());
+  return clip_rect;
+}
+
 void CompositorContext::OnGrContextCreated() {
   texture_registry_.OnGrContextCreated();
   raster_cache_.Clear();
@@ -6,11 +6,14 @@
 #define FLUTTER_FLOW_COMPOSITOR_CONTEXT_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/raster_thread_merger.h"
@@ -50,6 +53,32 @@ enum class RasterStatus {
   kDiscarded
 };
 
+//------------------------------------------------------------------------------
+/// Inputs and outputs of the damage computation performed when a frame is
+/// rasterized with partial repaint enabled.
+///
+struct FrameDamage {
+  // The paint regions of the previously presented frame. If null, the
+  // previous frame is unknown and the whole frame is damaged.
+  const PaintRegionList* prev_paint_regions = nullptr;
+
+  // The area of the framebuffer that does not contain the previously
+  // presented frame. If unset, the whole framebuffer must be repainted.
+  std::optional<SkIRect> existing_buffer_damage;
+
+  // Set by |ScopedFrame::Raster| to the paint regions of the rasterized frame
+  // so that they can be compared against by the next frame.
+  PaintRegionList paint_regions;
+
+  // Set by |ScopedFrame::Raster| to the area that changed compared to the
+  // previous frame.
+  std::optional<SkIRect> frame_damage;
+
+  // Set by |ScopedFrame::Raster| to the area of the framebuffer that was
+  // repainted. If unset, the whole framebuffer was repainted.
+  std::optional<SkIRect> buffer_damage;
+};
+
 class CompositorContext {
  public:
   class ScopedFrame {
@@ -79,10 +108,23 @@ class CompositorContext {
 
     GrDirectContext* gr_context() const { return gr_context_; }
 
+    // The profiler recording the costs of the layers of this frame, or null
+    // if layer profiling is disabled.
+    LayerProfiler* layer_profiler() const { return layer_profiler_.get(); }
+
+    // If |frame_damage| is not null, the frame is diffed against the paint
+    // regions of the previous frame and only the damaged area of the canvas is
+    // repainted. The results of the diff are written back to |frame_damage|.
     virtual RasterStatus Raster(LayerTree& layer_tree,
-                                bool ignore_raster_cache);
+                                bool ignore_raster_cache,
+                                FrameDamage* frame_damage = nullptr);
 
    private:
+    // Diffs the layer tree against the previous frame and returns the area of
+    // the canvas that must be repainted, or nullopt to repaint everything.
+    std::optional<SkRect> ComputeClipRect(LayerTree& layer_tree,
+                                          FrameDamage* frame_damage);
+
     CompositorContext& context_;
     GrDirectContext* gr_context_;
     SkCanvas* canvas_;
@@ -91,6 +133,7 @@ class CompositorContext {
     const bool instrumentation_enabled_;
     const bool surface_supports_readback_;
     fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger_;
+    std::unique_ptr<LayerProfiler> layer_profiler_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(ScopedFrame);
   };
@@ -122,12 +165,28 @@ class CompositorContext {
 
   Stopwatch& ui_time() { return ui_time_; }
 
+  // Enables or disables the recording of the costs of the layers of the
+  // frames rasterized from now on.
+  void set_layer_profiling_enabled(bool enabled) {
+    layer_profiling_enabled_ = enabled;
+  }
+
+  bool layer_profiling_enabled() const { return layer_profiling_enabled_; }
+
+  // The layer costs of the last frame that was rasterized while layer
+  // profiling was enabled, or null if there was none.
+  std::shared_ptr<const LayerProfiler> last_layer_profile() const {
+    return last_layer_profile_;
+  }
+
  private:
   RasterCache raster_cache_;
   TextureRegistry texture_registry_;
   Counter frame_count_;
   Stopwatch raster_time_;
   Stopwatch ui_time_;
+  bool layer_profiling_enabled_ = false;
+  std::shared_ptr<const LayerProfiler> last_layer_profile_;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
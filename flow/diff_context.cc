@@ -0,0 +1,306 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+
+namespace flutter {
+
+namespace {
+
+// Combines the bounds of a paint region with its hash so that regions can be
+// looked up by both at once.
+uint64_t PaintRegionKey(const PaintRegion& region) {
+  return fml::HashCombine(region.hash, region.bounds.fLeft, region.bounds.fTop,
+                          region.bounds.fRight, region.bounds.fBottom);
+}
+
+sk_sp<SkData> SerializeImageUniqueID(SkImage* image, void* ctx) {
+  const uint32_t id = image->uniqueID();
+  return SkData::MakeWithCopy(&id, sizeof(id));
+}
+
+sk_sp<SkData> SerializePictureUniqueID(SkPicture* picture, void* ctx) {
+  const uint32_t id = picture->uniqueID();
+  return SkData::MakeWithCopy(&id, sizeof(id));
+}
+
+}  // namespace
+
+DiffContext::DiffContext(const SkISize& frame_size,
+                         const SkMatrix& root_surface_transformation)
+    : frame_rect_(
+          root_surface_transformation.mapRect(SkRect::Make(frame_size))),
+      damage_(SkRect::MakeEmpty()) {
+  state_.transform = root_surface_transformation;
+  state_.clip = frame_rect_;
+  state_.hash = HashMatrix(root_surface_transformation);
+}
+
+DiffContext::~DiffContext() = default;
+
+DiffContext::AutoSubtreeRestore::AutoSubtreeRestore(DiffContext* context)
+    : context_(context), state_stack_depth_(context->state_stack_.size()) {
+  context_->state_stack_.push_back(context_->state_);
+}
+
+DiffContext::AutoSubtreeRestore::~AutoSubtreeRestore() {
+  FML_DCHECK(context_->state_stack_.size() == state_stack_depth_ + 1);
+  context_->state_ = context_->state_stack_.back();
+  context_->state_stack_.pop_back();
+}
+
+void DiffContext::PushTransform(const SkMatrix& transform) {
+  state_.transform.preConcat(transform);
+  state_.hash = fml::HashCombine(state_.hash, HashMatrix(transform));
+}
+
+void DiffContext::PushClipRect(const SkRect& clip_rect, bool anti_alias) {
+  PushClipBounds(clip_rect, fml::HashCombine(HashRect(clip_rect), anti_alias));
+}
+
+void DiffContext::PushClipRRect(const SkRRect& clip_rrect, bool anti_alias) {
+  PushClipBounds(clip_rrect.getBounds(),
+                 fml::HashCombine(HashRRect(clip_rrect), anti_alias));
+}
+
+void DiffContext::PushClipPath(const SkPath& clip_path, bool anti_alias) {
+  PushClipBounds(clip_path.getBounds(),
+                 fml::HashCombine(HashPath(clip_path), anti_alias));
+}
+
+void DiffContext::PushClipBounds(const SkRect& local_bounds,
+                                 uint64_t clip_hash) {
+  SkRect device_bounds = state_.transform.mapRect(local_bounds);
+  if (!state_.clip.intersect(device_bounds)) {
+    state_.clip.setEmpty();
+  }
+  // The clip affects the pixels at the edges of the children (anti-aliasing)
+  // even when the device bounds of the children are unchanged, so it is part
+  // of the state hash.
+  state_.hash = fml::HashCombine(state_.hash, clip_hash);
+}
+
+void DiffContext::PushStateHash(uint64_t hash) {
+  state_.hash = fml::HashCombine(state_.hash, hash);
+}
+
+std::optional<SkRect> DiffContext::MapToDevice(
+    const SkRect& local_bounds) const {
+  if (local_bounds.isEmpty()) {
+    return std::nullopt;
+  }
+  SkRect device_bounds = state_.transform.mapRect(local_bounds);
+  if (!device_bounds.intersect(state_.clip)) {
+    return std::nullopt;
+  }
+  return device_bounds;
+}
+
+void DiffContext::AddPaintRegion(const SkRect& local_bounds,
+                                 uint64_t content_hash) {
+  auto device_bounds = MapToDevice(local_bounds);
+  if (!device_bounds) {
+    return;
+  }
+  paint_regions_.push_back(
+      {*device_bounds, fml::HashCombine(state_.hash, content_hash)});
+}
+
+void DiffContext::AddDamage(const SkRect& local_bounds) {
+  auto device_bounds = MapToDevice(local_bounds);
+  if (device_bounds) {
+    damage_.join(*device_bounds);
+  }
+}
+
+DiffContext::Group DiffContext::BeginGroup() const {
+  return {paint_regions_.size(), damage_};
+}
+
+void DiffContext::EndGroup(const Group& group,
+                           const SkRect& local_bounds,
+                           uint64_t group_hash) {
+  FML_DCHECK(group.paint_region_start <= paint_regions_.size());
+  uint64_t hash = group_hash;
+  for (size_t i = group.paint_region_start; i < paint_regions_.size(); i++) {
+    hash = fml::HashCombine(hash, PaintRegionKey(paint_regions_[i]));
+  }
+  paint_regions_.erase(paint_regions_.begin() + group.paint_region_start,
+                       paint_regions_.end());
+  AddPaintRegion(local_bounds, hash);
+  // Damage only grows, so any change means a child added damage, which the
+  // group may spread over its whole bounds.
+  if (damage_ != group.damage) {
+    AddDamage(local_bounds);
+  }
+}
+
+void DiffContext::AddReadbackRegion(const SkRect& local_bounds,
+                                    const SkImageFilter* filter) {
+  auto device_bounds = MapToDevice(local_bounds);
+  if (!device_bounds) {
+    return;
+  }
+  SkIRect bounds = device_bounds->roundOut();
+  SkIRect input_bounds =
+      filter ? filter->filterBounds(bounds, state_.transform,
+                                    SkImageFilter::kReverse_MapDirection)
+             : bounds;
+  input_bounds.join(bounds);
+  readback_regions_.push_back({bounds, input_bounds});
+}
+
+SkIRect DiffContext::ComputeDamage(const PaintRegionList& old_regions) const {
+  SkRect damage = damage_;
+
+  std::unordered_map<uint64_t, std::vector<size_t>> old_indices;
+  for (size_t i = 0; i < old_regions.size(); i++) {
+    old_indices[PaintRegionKey(old_regions[i])].push_back(i);
+  }
+
+  // Regions are matched in paint order. A region of this frame matches a
+  // region of the previous frame if it has the same bounds and hash and it
+  // comes after the last matched region. Anything reordered, added or removed
+  // is damaged, which makes sure overlapping regions painted in a different
+  // order are repainted.
+  std::vector<bool> old_matched(old_regions.size(), false);
+  size_t next_old_index = 0;
+  for (const auto& region : paint_regions_) {
+    bool matched = false;
+    auto found = old_indices.find(PaintRegionKey(region));
+    if (found != old_indices.end()) {
+      const auto& indices = found->second;
+      auto candidate =
+          std::lower_bound(indices.begin(), indices.end(), next_old_index);
+      for (; candidate != indices.end(); ++candidate) {
+        const auto& old_region = old_regions[*candidate];
+        if (old_region.hash == region.hash &&
+            old_region.bounds == region.bounds) {
+          old_matched[*candidate] = true;
+          next_old_index = *candidate + 1;
+          matched = true;
+          break;
+        }
+      }
+    }
+    if (!matched) {
+      damage.join(region.bounds);
+    }
+  }
+
+  for (size_t i = 0; i < old_regions.size(); i++) {
+    if (!old_matched[i]) {
+      damage.join(old_regions[i].bounds);
+    }
+  }
+
+  if (!damage.intersect(frame_rect_)) {
+    return SkIRect::MakeEmpty();
+  }
+
+  // Pictures may be painted at an integral translation and anti-aliased
+  // edges may touch the pixels adjacent to the bounds.
+  SkIRect result = damage.roundOut().makeOutset(1, 1);
+  if (!result.intersect(frame_rect_.roundOut())) {
+    return SkIRect::MakeEmpty();
+  }
+  return ExpandDamageForReadback(result);
+}
+
+SkIRect DiffContext::ExpandDamageForReadback(const SkIRect& damage) const {
+  if (damage.isEmpty()) {
+    return damage;
+  }
+  SkIRect result = damage;
+  std::vector<bool> expanded(readback_regions_.size(), false);
+  // Expanding the damage for one readback region may make it intersect the
+  // input of another one, so repeat until nothing changes.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < readback_regions_.size(); i++) {
+      if (!expanded[i] &&
+          SkIRect::Intersects(result, readback_regions_[i].input_bounds)) {
+        result.join(readback_regions_[i].input_bounds);
+        expanded[i] = true;
+        changed = true;
+      }
+    }
+  }
+  if (!result.intersect(frame_rect_.roundOut())) {
+    return SkIRect::MakeEmpty();
+  }
+  return result;
+}
+
+uint64_t DiffContext::HashMatrix(const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  return fml::HashCombine(values[0], values[1], values[2], values[3],
+                          values[4], values[5], values[6], values[7],
+                          values[8]);
+}
+
+uint64_t DiffContext::HashRect(const SkRect& rect) {
+  return fml::HashCombine(rect.fLeft, rect.fTop, rect.fRight, rect.fBottom);
+}
+
+uint64_t DiffContext::HashRRect(const SkRRect& rrect) {
+  uint64_t hash = HashRect(rrect.rect());
+  for (int i = 0; i < 4; i++) {
+    const SkVector radii = rrect.radii(static_cast<SkRRect::Corner>(i));
+    hash = fml::HashCombine(hash, radii.fX, radii.fY);
+  }
+  return hash;
+}
+
+uint64_t DiffContext::HashPath(const SkPath& path) {
+  std::vector<SkPoint> points(path.countPoints());
+  path.getPoints(points.data(), static_cast<int>(points.size()));
+  std::vector<uint8_t> verbs(path.countVerbs());
+  path.getVerbs(verbs.data(), static_cast<int>(verbs.size()));
+
+  size_t hash = fml::HashCombine(static_cast<int>(path.getFillType()));
+  for (const auto& point : points) {
+    fml::HashCombineSeed(hash, point.fX, point.fY);
+  }
+  fml::HashCombineSeed(
+      hash, std::hash<std::string_view>{}(std::string_view(
+                reinterpret_cast<const char*>(verbs.data()), verbs.size())));
+  // Conic weights are not exposed individually, so fall back to the
+  // generation ID for paths that contain them.
+  if (path.getSegmentMasks() & SkPath::kConic_SegmentMask) {
+    fml::HashCombineSeed(hash, path.getGenerationID());
+  }
+  return hash;
+}
+
+uint64_t DiffContext::HashFlattenable(const SkFlattenable* flattenable) {
+  if (flattenable == nullptr) {
+    return 0;
+  }
+  SkSerialProcs procs = {0};
+  procs.fImageProc = SerializeImageUniqueID;
+  procs.fPictureProc = SerializePictureUniqueID;
+  sk_sp<SkData> data = flattenable->serialize(&procs);
+  if (!data) {
+    // Can't describe the flattenable, so its identity is the best we have.
+    return std::hash<const void*>{}(flattenable);
+  }
+  return std::hash<std::string_view>{}(std::string_view(
+      static_cast<const char*>(data->data()), data->size()));
+}
+
+}  // namespace flutter
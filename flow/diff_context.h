@@ -0,0 +1,194 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DIFF_CONTEXT_H_
+#define FLUTTER_FLOW_DIFF_CONTEXT_H_
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// A region of the frame painted by a single leaf layer (or by a layer whose
+/// subtree can only be repainted as a whole, such as an image filter layer).
+///
+/// The |bounds| are in device coordinates and already clipped by the clips
+/// applied by the ancestors of the layer. The |hash| identifies everything
+/// that affects the pixels produced in the region: the content of the layer,
+/// the transform and clips it was painted with, the opacity and filters of
+/// its ancestors, and so on. Two paint regions with equal bounds and hashes
+/// produce identical pixels.
+///
+struct PaintRegion {
+  SkRect bounds;
+  uint64_t hash;
+};
+
+using PaintRegionList = std::vector<PaintRegion>;
+
+//------------------------------------------------------------------------------
+/// Collects the paint regions of a layer tree so that it can be compared
+/// against the paint regions of the previously rasterized frame.
+///
+/// Layers describe themselves to the context through |Layer::Diff|. Container
+/// layers push the state they apply to their children (transforms, clips,
+/// opacity, color filters) before diffing the children and leaf layers add a
+/// paint region identified by their content. Layers whose content may change
+/// without the layer tree changing (external textures, platform views, the
+/// performance overlay) add damage directly.
+///
+class DiffContext {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a diff context for a frame of the given size.
+  ///
+  /// @param[in]  frame_size                   The size of the frame in
+  ///                                          physical pixels.
+  /// @param[in]  root_surface_transformation  The transformation applied to
+  ///                                          the root layer.
+  ///
+  DiffContext(const SkISize& frame_size,
+              const SkMatrix& root_surface_transformation);
+
+  ~DiffContext();
+
+  //----------------------------------------------------------------------------
+  /// Saves the current transform, clip and state hash and restores them when
+  /// destroyed. Container layers create one of these before pushing the state
+  /// they apply to their children.
+  ///
+  class AutoSubtreeRestore {
+   public:
+    explicit AutoSubtreeRestore(DiffContext* context);
+    ~AutoSubtreeRestore();
+
+   private:
+    DiffContext* context_;
+    size_t state_stack_depth_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(AutoSubtreeRestore);
+  };
+
+  void PushTransform(const SkMatrix& transform);
+
+  void PushClipRect(const SkRect& clip_rect, bool anti_alias);
+
+  void PushClipRRect(const SkRRect& clip_rrect, bool anti_alias);
+
+  void PushClipPath(const SkPath& clip_path, bool anti_alias);
+
+  // Mixes a property of a container layer that affects the pixels of all of
+  // its children (opacity, color filters, ...) into the state hash.
+  void PushStateHash(uint64_t hash);
+
+  // Adds a paint region for a layer whose content is identified by
+  // |content_hash|. |local_bounds| are in the current coordinate system.
+  void AddPaintRegion(const SkRect& local_bounds, uint64_t content_hash);
+
+  // Marks the given bounds as damaged regardless of the previous frame. Used
+  // by layers whose content can change without the layer tree changing.
+  void AddDamage(const SkRect& local_bounds);
+
+  // The state of the context when a group began, as returned by
+  // |BeginGroup|.
+  struct Group {
+    size_t paint_region_start;
+    SkRect damage;
+  };
+
+  // Paint regions added between |BeginGroup| and |EndGroup| are collapsed
+  // into a single paint region that covers |local_bounds|. This is used by
+  // layers that cannot repaint only a part of their subtree, such as layers
+  // applying an image filter that moves pixels around. For the same reason,
+  // if the children add damage directly, the damage is expanded to cover
+  // |local_bounds|.
+  Group BeginGroup() const;
+
+  void EndGroup(const Group& group,
+                const SkRect& local_bounds,
+                uint64_t group_hash);
+
+  // Records an area of the frame that the layer reads back from the surface
+  // (for example, a backdrop filter). If the damage of the frame intersects
+  // the pixels read by |filter|, the whole area is repainted so that the
+  // filter sees a consistent backdrop.
+  void AddReadbackRegion(const SkRect& local_bounds,
+                         const SkImageFilter* filter);
+
+  const SkMatrix& GetTransform() const { return state_.transform; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Computes the damage of this frame compared to the paint
+  ///             regions of the previous frame.
+  ///
+  /// @param[in]  old_regions  The paint regions of the previous frame, as
+  ///                          returned by |TakePaintRegions|.
+  ///
+  /// @return     The damaged area of the frame in device coordinates, rounded
+  ///             out to pixels. May be empty if nothing changed.
+  ///
+  SkIRect ComputeDamage(const PaintRegionList& old_regions) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Expands |damage| by the readback regions it intersects so
+  ///             that every area read by a backdrop filter is either entirely
+  ///             repainted or not repainted at all.
+  ///
+  SkIRect ExpandDamageForReadback(const SkIRect& damage) const;
+
+  PaintRegionList TakePaintRegions() { return std::move(paint_regions_); }
+
+  const PaintRegionList& paint_regions() const { return paint_regions_; }
+
+  // Hashing helpers for layer properties.
+  static uint64_t HashMatrix(const SkMatrix& matrix);
+  static uint64_t HashRect(const SkRect& rect);
+  static uint64_t HashRRect(const SkRRect& rrect);
+  static uint64_t HashPath(const SkPath& path);
+  // Hashes the serialized form of a Skia flattenable (shaders, image filters,
+  // color filters). Images and pictures referenced by the flattenable are
+  // identified by their unique IDs rather than by their pixels.
+  static uint64_t HashFlattenable(const SkFlattenable* flattenable);
+
+ private:
+  struct State {
+    SkMatrix transform;
+    SkRect clip;
+    uint64_t hash;
+  };
+
+  struct ReadbackRegion {
+    SkIRect bounds;
+    SkIRect input_bounds;
+  };
+
+  // The bounds of the frame in device coordinates.
+  const SkRect frame_rect_;
+  State state_;
+  std::vector<State> state_stack_;
+  PaintRegionList paint_regions_;
+  std::vector<ReadbackRegion> readback_regions_;
+  SkRect damage_;
+
+  void PushClipBounds(const SkRect& local_bounds, uint64_t clip_hash);
+
+  // Maps |local_bounds| to device coordinates and clips them.
+  std::optional<SkRect> MapToDevice(const SkRect& local_bounds) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DiffContext);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_DIFF_CONTEXT_H_
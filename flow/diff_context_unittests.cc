@@ -0,0 +1,189 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/diff_context.h"
+
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/image_filter_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "flutter/flow/testing/skia_gpu_object_layer_test.h"
+#include "third_party/skia/include/effects/SkImageFilters.h"
+
+namespace flutter {
+namespace testing {
+
+class DiffContextTest : public SkiaGPUObjectLayerTest {
+ public:
+  std::shared_ptr<PictureLayer> CreatePictureLayer(sk_sp<SkPicture> picture,
+                                                   SkPoint offset = {0, 0}) {
+    return std::make_shared<PictureLayer>(
+        offset, SkiaGPUObject(picture, unref_queue()), false, false);
+  }
+
+  // Prerolls and diffs |root|, returning its paint regions.
+  PaintRegionList Diff(std::shared_ptr<Layer> root,
+                       const PaintRegionList* old_regions = nullptr,
+                       SkIRect* damage = nullptr) {
+    root->Preroll(preroll_context(), SkMatrix());
+    DiffContext context(kFrameSize, SkMatrix());
+    root->Diff(&context);
+    if (damage && old_regions) {
+      *damage = context.ComputeDamage(*old_regions);
+    }
+    return context.TakePaintRegions();
+  }
+
+  static constexpr SkISize kFrameSize = SkISize::Make(800, 600);
+};
+
+TEST_F(DiffContextTest, IdenticalTreesHaveNoDamage) {
+  auto picture =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(10, 10, 50, 50));
+
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(CreatePictureLayer(picture));
+  auto regions1 = Diff(root1);
+  EXPECT_EQ(regions1.size(), 1u);
+
+  // A new layer tree referencing the same picture.
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(CreatePictureLayer(picture));
+  SkIRect damage;
+  Diff(root2, &regions1, &damage);
+  EXPECT_TRUE(damage.isEmpty());
+}
+
+TEST_F(DiffContextTest, ChangedPictureIsDamaged) {
+  auto picture1 =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(10, 10, 50, 50));
+  auto picture2 =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(10, 10, 50, 50));
+  auto unchanged =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(100, 100, 200, 200));
+
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(CreatePictureLayer(picture1));
+  root1->Add(CreatePictureLayer(unchanged));
+  auto regions1 = Diff(root1);
+
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(CreatePictureLayer(picture2));
+  root2->Add(CreatePictureLayer(unchanged));
+  SkIRect damage;
+  Diff(root2, &regions1, &damage);
+  EXPECT_EQ(damage, SkIRect::MakeLTRB(9, 9, 51, 51));
+}
+
+TEST_F(DiffContextTest, MovedLayerDamagesOldAndNewBounds) {
+  auto picture =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(0, 0, 10, 10));
+
+  auto root1 = std::make_shared<TransformLayer>(SkMatrix::Translate(20, 20));
+  root1->Add(CreatePictureLayer(picture));
+  auto regions1 = Diff(root1);
+
+  auto root2 = std::make_shared<TransformLayer>(SkMatrix::Translate(40, 20));
+  root2->Add(CreatePictureLayer(picture));
+  SkIRect damage;
+  Diff(root2, &regions1, &damage);
+  EXPECT_EQ(damage, SkIRect::MakeLTRB(19, 19, 51, 31));
+}
+
+TEST_F(DiffContextTest, OpacityChangeDamagesChildren) {
+  auto picture =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(10, 10, 50, 50));
+
+  auto root1 = std::make_shared<OpacityLayer>(128, SkPoint::Make(0, 0));
+  root1->Add(CreatePictureLayer(picture));
+  auto regions1 = Diff(root1);
+
+  auto root2 = std::make_shared<OpacityLayer>(64, SkPoint::Make(0, 0));
+  root2->Add(CreatePictureLayer(picture));
+  SkIRect damage;
+  Diff(root2, &regions1, &damage);
+  EXPECT_EQ(damage, SkIRect::MakeLTRB(9, 9, 51, 51));
+}
+
+TEST_F(DiffContextTest, ReorderedLayersAreDamaged) {
+  auto picture1 =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(10, 10, 50, 50));
+  auto picture2 =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(30, 30, 70, 70));
+
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(CreatePictureLayer(picture1));
+  root1->Add(CreatePictureLayer(picture2));
+  auto regions1 = Diff(root1);
+
+  auto root2 = std::make_shared<ContainerLayer>();
+  root2->Add(CreatePictureLayer(picture2));
+  root2->Add(CreatePictureLayer(picture1));
+  SkIRect damage;
+  Diff(root2, &regions1, &damage);
+  // The overlapping area must be repainted.
+  EXPECT_TRUE(damage.contains(SkIRect::MakeLTRB(30, 30, 50, 50)));
+}
+
+TEST_F(DiffContextTest, LayersWithoutDiffSupportAreAlwaysDamaged) {
+  auto root1 = std::make_shared<ContainerLayer>();
+  root1->Add(std::make_shared<MockLayer>(
+      SkPath().addRect(SkRect::MakeLTRB(10, 10, 50, 50))));
+  auto regions1 = Diff(root1);
+
+  SkIRect damage;
+  Diff(root1, &regions1, &damage);
+  EXPECT_EQ(damage, SkIRect::MakeLTRB(9, 9, 51, 51));
+}
+
+TEST_F(DiffContextTest, DamageUnderBackdropFilterIsExpanded) {
+  auto background =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(0, 0, 800, 600));
+  auto changing1 =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(100, 100, 110, 110));
+  auto changing2 =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(100, 100, 110, 110));
+  auto foreground =
+      SkPicture::MakePlaceholder(SkRect::MakeLTRB(50, 50, 250, 250));
+  auto filter = SkImageFilters::Blur(5, 5, SkTileMode::kClamp, nullptr);
+
+  auto make_tree = [&](sk_sp<SkPicture> changing) {
+    auto root = std::make_shared<ContainerLayer>();
+    root->Add(CreatePictureLayer(background));
+    root->Add(CreatePictureLayer(changing));
+    auto backdrop = std::make_shared<BackdropFilterLayer>(filter);
+    backdrop->Add(CreatePictureLayer(foreground));
+    root->Add(backdrop);
+    return root;
+  };
+
+  auto regions1 = Diff(make_tree(changing1));
+  SkIRect damage;
+  Diff(make_tree(changing2), &regions1, &damage);
+  // The whole area read by the backdrop filter is repainted.
+  EXPECT_TRUE(damage.contains(SkIRect::MakeLTRB(50, 50, 250, 250)));
+}
+
+TEST_F(DiffContextTest, DamageUnderImageFilterIsExpanded) {
+  auto filter = SkImageFilters::Blur(5, 5, SkTileMode::kClamp, nullptr);
+  auto root = std::make_shared<ImageFilterLayer>(filter);
+  root->Add(std::make_shared<TextureLayer>(SkPoint::Make(100, 100),
+                                           SkSize::Make(10, 10), 0, false,
+                                           kNone_SkFilterQuality));
+  auto regions1 = Diff(root);
+
+  // The texture may have changed, so the damage covers the blurred texture
+  // rather than only the texture itself.
+  SkIRect damage;
+  Diff(root, &regions1, &damage);
+  EXPECT_TRUE(damage.contains(root->paint_bounds().roundOut()));
+  EXPECT_TRUE(damage.contains(SkIRect::MakeLTRB(90, 90, 120, 120)));
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -0,0 +1,86 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_profiler.h"
+
+#include "flutter/flow/layers/layer.h"
+
+namespace flutter {
+
+LayerProfiler::LayerProfiler() = default;
+
+LayerProfiler::~LayerProfiler() = default;
+
+LayerProfiler::ScopedPreroll::ScopedPreroll(LayerProfiler* profiler,
+                                            const Layer* layer)
+    : profiler_(profiler), index_(kNoParent) {
+  if (!profiler_) {
+    return;
+  }
+  const auto& current = profiler_->current_entries_;
+  index_ = profiler_->entries_.size();
+  profiler_->entries_.push_back({
+      layer->unique_id(),                            // layer_id
+      layer->GetTypeName(),                          // type_name
+      current.empty() ? kNoParent : current.back(),  // parent
+  });
+  profiler_->entry_indices_[layer] = index_;
+  profiler_->current_entries_.push_back(index_);
+  start_ = fml::TimePoint::Now();
+}
+
+LayerProfiler::ScopedPreroll::~ScopedPreroll() {
+  if (!profiler_) {
+    return;
+  }
+  auto& entry = profiler_->entries_[index_];
+  entry.preroll_time = entry.preroll_time + (fml::TimePoint::Now() - start_);
+  profiler_->current_entries_.pop_back();
+}
+
+LayerProfiler::ScopedPaint::ScopedPaint(LayerProfiler* profiler,
+                                        const Layer* layer)
+    : profiler_(profiler), index_(kNoParent) {
+  if (!profiler_) {
+    return;
+  }
+  auto found = profiler_->entry_indices_.find(layer);
+  if (found != profiler_->entry_indices_.end()) {
+    index_ = found->second;
+  }
+  profiler_->current_entries_.push_back(index_);
+  start_ = fml::TimePoint::Now();
+}
+
+LayerProfiler::ScopedPaint::~ScopedPaint() {
+  if (!profiler_) {
+    return;
+  }
+  if (index_ != kNoParent) {
+    auto& entry = profiler_->entries_[index_];
+    entry.paint_time = entry.paint_time + (fml::TimePoint::Now() - start_);
+  }
+  profiler_->current_entries_.pop_back();
+}
+
+void LayerProfiler::RecordSaveLayer() {
+  if (Entry* entry = GetCurrentEntry()) {
+    entry->save_layer_count++;
+  }
+}
+
+void LayerProfiler::RecordRasterCacheHit() {
+  if (Entry* entry = GetCurrentEntry()) {
+    entry->raster_cache_hit_count++;
+  }
+}
+
+LayerProfiler::Entry* LayerProfiler::GetCurrentEntry() {
+  if (current_entries_.empty() || current_entries_.back() == kNoParent) {
+    return nullptr;
+  }
+  return &entries_[current_entries_.back()];
+}
+
+}  // namespace flutter
@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYER_PROFILER_H_
+#define FLUTTER_FLOW_LAYER_PROFILER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+class Layer;
+
+//------------------------------------------------------------------------------
+/// Records the raster costs of every layer of a frame: the time spent in its
+/// preroll and its paint, including its children, the saveLayer calls it made
+/// and the raster cache entries it drew.
+///
+/// Entries are recorded in preroll order, so a parent always precedes its
+/// children. Layers are identified by their |Layer::unique_id|, which is
+/// stable across frames for the layers retained by the framework.
+///
+/// A profiler is only created for the frames rasterized while layer profiling
+/// is enabled on the |CompositorContext|, so the layers only pay for a null
+/// check otherwise.
+///
+class LayerProfiler {
+ public:
+  static constexpr size_t kNoParent = std::numeric_limits<size_t>::max();
+
+  struct Entry {
+    uint64_t layer_id;
+    const char* type_name;
+    // The index of the entry of the parent layer, or |kNoParent|.
+    size_t parent;
+    fml::TimeDelta preroll_time;
+    fml::TimeDelta paint_time;
+    size_t save_layer_count = 0;
+    size_t raster_cache_hit_count = 0;
+  };
+
+  // Records the preroll of a layer, as a child of the layer whose preroll is
+  // being recorded. Does nothing if |profiler| is null.
+  class ScopedPreroll {
+   public:
+    ScopedPreroll(LayerProfiler* profiler, const Layer* layer);
+    ~ScopedPreroll();
+
+   private:
+    LayerProfiler* profiler_;
+    size_t index_;
+    fml::TimePoint start_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedPreroll);
+  };
+
+  // Records the paint of a layer that was prerolled in this frame. Does
+  // nothing if |profiler| is null.
+  class ScopedPaint {
+   public:
+    ScopedPaint(LayerProfiler* profiler, const Layer* layer);
+    ~ScopedPaint();
+
+   private:
+    LayerProfiler* profiler_;
+    size_t index_;
+    fml::TimePoint start_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedPaint);
+  };
+
+  LayerProfiler();
+
+  ~LayerProfiler();
+
+  // Attributes a saveLayer to the layer being painted.
+  void RecordSaveLayer();
+
+  // Attributes a raster cache hit to the layer being painted.
+  void RecordRasterCacheHit();
+
+  const std::vector<Entry>& entries() const { return entries_; }
+
+ private:
+  std::vector<Entry> entries_;
+  std::unordered_map<const Layer*, size_t> entry_indices_;
+  // The entries of the layers being prerolled or painted, innermost last.
+  // Layers painted without having been prerolled are |kNoParent|.
+  std::vector<size_t> current_entries_;
+
+  Entry* GetCurrentEntry();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerProfiler);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_FLOW_LAYER_PROFILER_H_
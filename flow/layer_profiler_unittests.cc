@@ -0,0 +1,132 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_profiler.h"
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/testing/layer_test.h"
+#include "flutter/flow/testing/mock_layer.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+using LayerProfilerTest = LayerTest;
+
+TEST_F(LayerProfilerTest, RecordsLayersInPrerollOrder) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto mock_layer1 = std::make_shared<MockLayer>(child_path);
+  auto mock_layer2 = std::make_shared<MockLayer>(child_path);
+  auto opacity_layer =
+      std::make_shared<OpacityLayer>(SK_AlphaOPAQUE / 2, SkPoint::Make(0, 0));
+  opacity_layer->Add(mock_layer1);
+  auto root = std::make_shared<ContainerLayer>();
+  root->Add(opacity_layer);
+  root->Add(mock_layer2);
+
+  LayerProfiler profiler;
+  preroll_context()->layer_profiler = &profiler;
+  paint_context().layer_profiler = &profiler;
+  {
+    LayerProfiler::ScopedPreroll profile(&profiler, root.get());
+    root->Preroll(preroll_context(), SkMatrix());
+  }
+  {
+    LayerProfiler::ScopedPaint profile(&profiler, root.get());
+    root->Paint(paint_context());
+  }
+
+  // The children of an opacity layer are held by an implicit container.
+  const auto& entries = profiler.entries();
+  ASSERT_EQ(entries.size(), 5u);
+  EXPECT_EQ(entries[0].layer_id, root->unique_id());
+  EXPECT_STREQ(entries[0].type_name, "ContainerLayer");
+  EXPECT_EQ(entries[0].parent, LayerProfiler::kNoParent);
+  EXPECT_EQ(entries[1].layer_id, opacity_layer->unique_id());
+  EXPECT_STREQ(entries[1].type_name, "OpacityLayer");
+  EXPECT_EQ(entries[1].parent, 0u);
+  EXPECT_STREQ(entries[2].type_name, "ContainerLayer");
+  EXPECT_EQ(entries[2].parent, 1u);
+  EXPECT_EQ(entries[3].layer_id, mock_layer1->unique_id());
+  EXPECT_EQ(entries[3].parent, 2u);
+  EXPECT_EQ(entries[4].layer_id, mock_layer2->unique_id());
+  EXPECT_EQ(entries[4].parent, 0u);
+
+  // The saveLayer of the opacity layer is not attributed to its ancestors.
+  EXPECT_EQ(entries[0].save_layer_count, 0u);
+  EXPECT_EQ(entries[1].save_layer_count, 1u);
+  EXPECT_EQ(entries[3].save_layer_count, 0u);
+
+  // The times of a parent include the times of its children.
+  for (const auto& entry : entries) {
+    EXPECT_GE(entry.preroll_time, fml::TimeDelta::Zero());
+    if (entry.parent != LayerProfiler::kNoParent) {
+      EXPECT_GE(entries[entry.parent].preroll_time, entry.preroll_time);
+      EXPECT_GE(entries[entry.parent].paint_time, entry.paint_time);
+    }
+  }
+}
+
+TEST_F(LayerProfilerTest, AttributesCountersToTheInnermostLayer) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto parent = std::make_shared<ContainerLayer>();
+  auto child = std::make_shared<MockLayer>(child_path);
+
+  LayerProfiler profiler;
+  {
+    LayerProfiler::ScopedPreroll parent_profile(&profiler, parent.get());
+    LayerProfiler::ScopedPreroll child_profile(&profiler, child.get());
+  }
+  {
+    LayerProfiler::ScopedPaint parent_profile(&profiler, parent.get());
+    profiler.RecordSaveLayer();
+    {
+      LayerProfiler::ScopedPaint child_profile(&profiler, child.get());
+      profiler.RecordRasterCacheHit();
+      profiler.RecordRasterCacheHit();
+    }
+    profiler.RecordSaveLayer();
+  }
+  // Counters recorded outside of any paint are dropped.
+  profiler.RecordSaveLayer();
+
+  const auto& entries = profiler.entries();
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[0].save_layer_count, 2u);
+  EXPECT_EQ(entries[0].raster_cache_hit_count, 0u);
+  EXPECT_EQ(entries[1].save_layer_count, 0u);
+  EXPECT_EQ(entries[1].raster_cache_hit_count, 2u);
+}
+
+TEST_F(LayerProfilerTest, IgnoresLayersPaintedWithoutPreroll) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto prerolled = std::make_shared<MockLayer>(child_path);
+  auto unprerolled = std::make_shared<MockLayer>(child_path);
+
+  LayerProfiler profiler;
+  { LayerProfiler::ScopedPreroll profile(&profiler, prerolled.get()); }
+  {
+    LayerProfiler::ScopedPaint profile(&profiler, prerolled.get());
+    {
+      LayerProfiler::ScopedPaint inner_profile(&profiler, unprerolled.get());
+      profiler.RecordSaveLayer();
+    }
+  }
+
+  const auto& entries = profiler.entries();
+  ASSERT_EQ(entries.size(), 1u);
+  EXPECT_EQ(entries[0].layer_id, prerolled->unique_id());
+  EXPECT_EQ(entries[0].save_layer_count, 0u);
+}
+
+TEST_F(LayerProfilerTest, IgnoresNullProfiler) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeWH(5.0f, 5.0f));
+  auto layer = std::make_shared<MockLayer>(child_path);
+  { LayerProfiler::ScopedPreroll profile(nullptr, layer.get()); }
+  { LayerProfiler::ScopedPaint profile(nullptr, layer.get()); }
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -26,4 +26,14 @@ void BackdropFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void BackdropFilterLayer::Diff(DiffContext* context) const {
+  // The filtered backdrop depends on everything painted below this layer, so
+  // the area it reads from must be repainted as a whole when damaged.
+  context->AddReadbackRegion(paint_bounds(), filter_.get());
+  DiffContext::Group group = context->BeginGroup();
+  DiffChildren(context);
+  context->EndGroup(group, paint_bounds(),
+                    DiffContext::HashFlattenable(filter_.get()));
+}
+
 }  // namespace flutter
@@ -18,6 +18,10 @@ class BackdropFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "BackdropFilterLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
 
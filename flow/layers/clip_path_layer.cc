@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_path_layer.h"
+
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/paint_utils.h"
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
@@ -59,6 +61,9 @@ void ClipPathLayer::Paint(PaintContext& context) const {
 
   if (UsesSaveLayer()) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+    if (context.layer_profiler) {
+      context.layer_profiler->RecordSaveLayer();
+    }
   }
   PaintChildren(context);
   if (UsesSaveLayer()) {
@@ -69,4 +74,10 @@ void ClipPathLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipPathLayer::Diff(DiffContext* context) const {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  context->PushClipPath(clip_path_, clip_behavior_ != Clip::hardEdge);
+  DiffChildren(context);
+}
+
 }  // namespace flutter
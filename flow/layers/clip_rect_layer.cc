@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_rect_layer.h"
+
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/paint_utils.h"
 
 namespace flutter {
@@ -54,6 +56,9 @@ void ClipRectLayer::Paint(PaintContext& context) const {
 
   if (UsesSaveLayer()) {
     context.internal_nodes_canvas->saveLayer(clip_rect_, nullptr);
+    if (context.layer_profiler) {
+      context.layer_profiler->RecordSaveLayer();
+    }
   }
   PaintChildren(context);
   if (UsesSaveLayer()) {
@@ -64,4 +69,10 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRectLayer::Diff(DiffContext* context) const {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  context->PushClipRect(clip_rect_, clip_behavior_ != Clip::hardEdge);
+  DiffChildren(context);
+}
+
 }  // namespace flutter
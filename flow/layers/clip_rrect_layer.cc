@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/layers/clip_rrect_layer.h"
+
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/paint_utils.h"
 
 namespace flutter {
@@ -55,6 +57,9 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
 
   if (UsesSaveLayer()) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+    if (context.layer_profiler) {
+      context.layer_profiler->RecordSaveLayer();
+    }
   }
   PaintChildren(context);
   if (UsesSaveLayer()) {
@@ -65,4 +70,10 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRRectLayer::Diff(DiffContext* context) const {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  context->PushClipRRect(clip_rrect_, clip_behavior_ != Clip::hardEdge);
+  DiffChildren(context);
+}
+
 }  // namespace flutter
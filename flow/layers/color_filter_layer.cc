@@ -28,4 +28,10 @@ void ColorFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ColorFilterLayer::Diff(DiffContext* context) const {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  context->PushStateHash(DiffContext::HashFlattenable(filter_.get()));
+  DiffChildren(context);
+}
+
 }  // namespace flutter
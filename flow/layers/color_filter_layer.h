@@ -18,6 +18,10 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ColorFilterLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
  private:
   sk_sp<SkColorFilter> filter_;
 
@@ -6,6 +6,8 @@
 
 #include <optional>
 
+#include "flutter/flow/layer_profiler.h"
+
 namespace flutter {
 
 ContainerLayer::ContainerLayer() {}
@@ -28,6 +30,10 @@ void ContainerLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ContainerLayer::Diff(DiffContext* context) const {
+  DiffChildren(context);
+}
+
 void ContainerLayer::PrerollChildren(PrerollContext* context,
                                      const SkMatrix& child_matrix,
                                      SkRect* child_paint_bounds) {
@@ -49,7 +55,11 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
     // sibling tree.
     context->has_platform_view = false;
 
-    layer->Preroll(context, child_matrix);
+    {
+      LayerProfiler::ScopedPreroll profile(context->layer_profiler,
+                                           layer.get());
+      layer->Preroll(context, child_matrix);
+    }
 
     if (layer->needs_system_composite()) {
       set_needs_system_composite(true);
@@ -82,11 +92,18 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
     if (layer->needs_painting(context)) {
+      LayerProfiler::ScopedPaint profile(context.layer_profiler, layer.get());
       layer->Paint(context);
     }
   }
 }
 
+void ContainerLayer::DiffChildren(DiffContext* context) const {
+  for (auto& layer : layers_) {
+    layer->Diff(context);
+  }
+}
+
 void ContainerLayer::TryToPrepareRasterCache(PrerollContext* context,
                                              Layer* layer,
                                              const SkMatrix& matrix) {
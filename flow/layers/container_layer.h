@@ -19,6 +19,9 @@ class ContainerLayer : public Layer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
+
+  const char* GetTypeName() const override { return "ContainerLayer"; }
+  void Diff(DiffContext* context) const override;
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void CheckForChildLayerBelow(PrerollContext* context) override;
   void UpdateScene(std::shared_ptr<SceneUpdateContext> context) override;
@@ -31,6 +34,7 @@ class ContainerLayer : public Layer {
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
   void PaintChildren(PaintContext& context) const;
+  void DiffChildren(DiffContext* context) const;
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateSceneChildren(std::shared_ptr<SceneUpdateContext> context);
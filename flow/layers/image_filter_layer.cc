@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/image_filter_layer.h"
 
+#include "flutter/flow/layer_profiler.h"
+
 namespace flutter {
 
 ImageFilterLayer::ImageFilterLayer(sk_sp<SkImageFilter> filter)
@@ -70,6 +72,9 @@ void ImageFilterLayer::Paint(PaintContext& context) const {
 
   if (context.raster_cache) {
     if (context.raster_cache->Draw(this, *context.leaf_nodes_canvas)) {
+      if (context.layer_profiler) {
+        context.layer_profiler->RecordRasterCacheHit();
+      }
       return;
     }
     if (transformed_filter_) {
@@ -78,6 +83,9 @@ void ImageFilterLayer::Paint(PaintContext& context) const {
 
       if (context.raster_cache->Draw(GetCacheableChild(),
                                      *context.leaf_nodes_canvas, &paint)) {
+        if (context.layer_profiler) {
+          context.layer_profiler->RecordRasterCacheHit();
+        }
         return;
       }
     }
@@ -95,4 +103,13 @@ void ImageFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void ImageFilterLayer::Diff(DiffContext* context) const {
+  // The filter may move pixels around (blur, offset, ...), so a change in any
+  // child damages the whole output of the filter.
+  DiffContext::Group group = context->BeginGroup();
+  DiffChildren(context);
+  context->EndGroup(group, paint_bounds(),
+                    DiffContext::HashFlattenable(filter_.get()));
+}
+
 }  // namespace flutter
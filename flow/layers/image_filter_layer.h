@@ -18,6 +18,10 @@ class ImageFilterLayer : public MergedContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ImageFilterLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
  private:
   // The ImageFilterLayer might cache the filtered output of this layer
   // if the layer remains stable (if it is not animating for instance).
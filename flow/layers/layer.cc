@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -27,6 +28,10 @@ uint64_t Layer::NextUniqueID() {
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+void Layer::Diff(DiffContext* context) const {
+  context->AddDamage(paint_bounds());
+}
+
 Layer::AutoPrerollSaveLayerState::AutoPrerollSaveLayerState(
     PrerollContext* preroll_context,
     bool save_layer_is_active,
@@ -85,12 +90,18 @@ Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                                     const SkPaint* paint)
     : paint_context_(paint_context), bounds_(bounds) {
   paint_context_.internal_nodes_canvas->saveLayer(bounds_, paint);
+  if (paint_context_.layer_profiler) {
+    paint_context_.layer_profiler->RecordSaveLayer();
+  }
 }
 
 Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                                     const SkCanvas::SaveLayerRec& layer_rec)
     : paint_context_(paint_context), bounds_(*layer_rec.fBounds) {
   paint_context_.internal_nodes_canvas->saveLayer(layer_rec);
+  if (paint_context_.layer_profiler) {
+    paint_context_.layer_profiler->RecordSaveLayer();
+  }
 }
 
 Layer::AutoSaveLayer Layer::AutoSaveLayer::Create(
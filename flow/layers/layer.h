@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
@@ -35,6 +36,8 @@
 
 namespace flutter {
 
+class LayerProfiler;
+
 static constexpr SkRect kGiantRect = SkRect::MakeLTRB(-1E9F, -1E9F, 1E9F, 1E9F);
 
 // This should be an exact copy of the Clip enum in painting.dart.
@@ -64,6 +67,9 @@ struct PrerollContext {
   // Informs whether a layer needs to be system composited.
   bool child_scene_layer_exists_below = false;
 #endif
+
+  // Records the cost of each layer when layer profiling is enabled.
+  LayerProfiler* layer_profiler = nullptr;
 };
 
 // Represents a single composited layer. Created on the UI thread but then
@@ -122,6 +128,8 @@ class Layer {
     const RasterCache* raster_cache;
     const bool checkerboard_offscreen_layers;
     const float frame_device_pixel_ratio;
+    // Records the cost of each layer when layer profiling is enabled.
+    LayerProfiler* layer_profiler = nullptr;
   };
 
   // Calls SkCanvas::saveLayer and restores the layer upon destruction. Also
@@ -152,6 +160,20 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // The name of the class of the layer, which identifies it in layer
+  // profiles.
+  virtual const char* GetTypeName() const { return "Layer"; }
+
+  // Describes the content painted by this layer to the |DiffContext| so that
+  // the damage of the frame can be computed against the previously rasterized
+  // frame. This must be called after Preroll() as it relies on the paint
+  // bounds of the layer.
+  //
+  // The default implementation marks the paint bounds of the layer as damaged
+  // on every frame, which is always correct but defeats partial repaint.
+  // Layers that can identify their content override this.
+  virtual void Diff(DiffContext* context) const;
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   // Updates the system composited scene.
   virtual void UpdateScene(std::shared_ptr<SceneUpdateContext> context);
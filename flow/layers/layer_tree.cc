@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -56,8 +57,13 @@ bool LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       frame.context().texture_registry(),
       checkerboard_offscreen_layers_,
       device_pixel_ratio_};
+  context.layer_profiler = frame.layer_profiler();
 
-  root_layer_->Preroll(&context, frame.root_surface_transformation());
+  {
+    LayerProfiler::ScopedPreroll profile(context.layer_profiler,
+                                         root_layer_.get());
+    root_layer_->Preroll(&context, frame.root_surface_transformation());
+  }
   return context.surface_needs_readback;
 }
 
@@ -111,9 +117,12 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       frame.context().texture_registry(),
       ignore_raster_cache ? nullptr : &frame.context().raster_cache(),
       checkerboard_offscreen_layers_,
-      device_pixel_ratio_};
+      device_pixel_ratio_,
+      frame.layer_profiler()};
 
   if (root_layer_->needs_painting(context)) {
+    LayerProfiler::ScopedPaint profile(context.layer_profiler,
+                                       root_layer_.get());
     root_layer_->Paint(context);
   }
 }
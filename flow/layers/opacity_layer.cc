@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/opacity_layer.h"
 
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPaint.h"
 
@@ -62,6 +63,9 @@ void OpacityLayer::Paint(PaintContext& context) const {
   if (context.raster_cache &&
       context.raster_cache->Draw(GetCacheableChild(),
                                  *context.leaf_nodes_canvas, &paint)) {
+    if (context.layer_profiler) {
+      context.layer_profiler->RecordRasterCacheHit();
+    }
     return;
   }
 
@@ -83,6 +87,13 @@ void OpacityLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void OpacityLayer::Diff(DiffContext* context) const {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  context->PushTransform(SkMatrix::Translate(offset_.fX, offset_.fY));
+  context->PushStateHash(alpha_);
+  DiffChildren(context);
+}
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
 
 void OpacityLayer::UpdateScene(std::shared_ptr<SceneUpdateContext> context) {
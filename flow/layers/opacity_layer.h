@@ -31,6 +31,10 @@ class OpacityLayer : public MergedContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "OpacityLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateScene(std::shared_ptr<SceneUpdateContext> context) override;
 #endif
@@ -31,6 +31,8 @@ class PerformanceOverlayLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "PerformanceOverlayLayer"; }
+
  private:
   int options_;
   std::string font_path_;
@@ -4,7 +4,9 @@
 
 #include "flutter/flow/layers/physical_shape_layer.h"
 
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/flow/paint_utils.h"
+#include "flutter/fml/hash_combine.h"
 #include "third_party/skia/include/utils/SkShadowUtils.h"
 
 namespace flutter {
@@ -71,6 +73,9 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
     case Clip::antiAliasWithSaveLayer:
       context.internal_nodes_canvas->clipPath(path_, true);
       context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+      if (context.layer_profiler) {
+        context.layer_profiler->RecordSaveLayer();
+      }
       break;
     case Clip::none:
       break;
@@ -95,6 +100,20 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   }
 }
 
+void PhysicalShapeLayer::Diff(DiffContext* context) const {
+  context->AddPaintRegion(
+      paint_bounds(),
+      fml::HashCombine(color_, shadow_color_, elevation_,
+                       DiffContext::HashPath(path_),
+                       static_cast<int>(clip_behavior_)));
+
+  DiffContext::AutoSubtreeRestore subtree(context);
+  if (clip_behavior_ != Clip::none) {
+    context->PushClipPath(path_, clip_behavior_ != Clip::hardEdge);
+  }
+  DiffChildren(context);
+}
+
 SkRect PhysicalShapeLayer::ComputeShadowBounds(const SkRect& bounds,
                                                float elevation,
                                                float pixel_ratio) {
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/flow/layer_profiler.h"
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 
 namespace flutter {
@@ -57,9 +59,19 @@ void PictureLayer::Paint(PaintContext& context) const {
   if (context.raster_cache &&
       context.raster_cache->Draw(*picture(), *context.leaf_nodes_canvas)) {
     TRACE_EVENT_INSTANT0("flutter", "raster cache hit");
+    if (context.layer_profiler) {
+      context.layer_profiler->RecordRasterCacheHit();
+    }
     return;
   }
   picture()->playback(context.leaf_nodes_canvas);
 }
 
+void PictureLayer::Diff(DiffContext* context) const {
+  FML_DCHECK(picture_.get());
+  context->AddPaintRegion(
+      paint_bounds(),
+      fml::HashCombine(picture()->uniqueID(), offset_.x(), offset_.y()));
+}
+
 }  // namespace flutter
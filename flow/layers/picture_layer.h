@@ -26,6 +26,10 @@ class PictureLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "PictureLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
  private:
   SkPoint offset_;
   // Even though pictures themselves are not GPU resources, they may reference
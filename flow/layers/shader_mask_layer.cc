@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/shader_mask_layer.h"
 
+#include "flutter/fml/hash_combine.h"
+
 namespace flutter {
 
 ShaderMaskLayer::ShaderMaskLayer(sk_sp<SkShader> shader,
@@ -37,4 +39,14 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+void ShaderMaskLayer::Diff(DiffContext* context) const {
+  DiffContext::Group group = context->BeginGroup();
+  DiffChildren(context);
+  context->EndGroup(
+      group, paint_bounds(),
+      fml::HashCombine(DiffContext::HashFlattenable(shader_.get()),
+                       DiffContext::HashRect(mask_rect_),
+                       static_cast<int>(blend_mode_)));
+}
+
 }  // namespace flutter
@@ -20,6 +20,10 @@ class ShaderMaskLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "ShaderMaskLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
  private:
   sk_sp<SkShader> shader_;
   SkRect mask_rect_;
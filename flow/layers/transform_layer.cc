@@ -78,4 +78,10 @@ void TransformLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void TransformLayer::Diff(DiffContext* context) const {
+  DiffContext::AutoSubtreeRestore subtree(context);
+  context->PushTransform(transform_);
+  DiffChildren(context);
+}
+
 }  // namespace flutter
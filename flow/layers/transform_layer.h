@@ -19,6 +19,10 @@ class TransformLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* GetTypeName() const override { return "TransformLayer"; }
+
+  void Diff(DiffContext* context) const override;
+
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
   void UpdateScene(std::shared_ptr<SceneUpdateContext> context) override;
 #endif
@@ -4,6 +4,9 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
 #include <vector>
 
 #include "flutter/common/constants.h"
@@ -12,9 +15,12 @@
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
 
 namespace flutter {
@@ -35,6 +41,27 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
   canvas.drawImage(image_, bounds.fLeft, bounds.fTop, paint);
 }
 
+void RasterCacheResult::draw_resampled(SkCanvas& canvas,
+                                       const SkPaint* paint,
+                                       const SkMatrix& raster_ctm) const {
+  TRACE_EVENT0("flutter", "RasterCacheResult::draw_resampled");
+  SkMatrix inverse;
+  if (!raster_ctm.invert(&inverse)) {
+    return;
+  }
+  SkAutoCanvasRestore auto_restore(&canvas, true);
+  // Map the pixels of the image back to the logical coordinates they were
+  // rasterized from, then to the device with the current transform.
+  SkIRect raster_bounds =
+      RasterCache::GetDeviceBounds(logical_rect_, raster_ctm);
+  SkMatrix image_to_device = canvas.getTotalMatrix();
+  image_to_device.preConcat(inverse);
+  image_to_device.preTranslate(raster_bounds.fLeft, raster_bounds.fTop);
+  canvas.setMatrix(image_to_device);
+  canvas.drawImage(image_.get(), 0, 0, SkSamplingOptions(SkFilterMode::kLinear),
+                   paint);
+}
+
 RasterCache::RasterCache(size_t access_threshold,
                          size_t picture_cache_limit_per_frame)
     : access_threshold_(access_threshold),
@@ -87,8 +114,31 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
   return picture->approximateOpCount() > 5;
 }
 
+// Estimates the byte size of the image that |Rasterize| would produce.
+static size_t EstimateImageBytes(const SkRect& logical_rect,
+                                 const SkMatrix& ctm) {
+  SkIRect cache_rect = RasterCache::GetDeviceBounds(logical_rect, ctm);
+  return SkImageInfo::MakeN32Premul(cache_rect.width(), cache_rect.height())
+      .computeMinByteSize();
+}
+
+static sk_sp<SkData> SerializeImageCheckingTextureBacked(SkImage* image,
+                                                         void* ctx) {
+  if (image->isTextureBacked()) {
+    *static_cast<bool*>(ctx) = true;
+  }
+  // Returning data keeps Skia from encoding the image.
+  return SkData::MakeEmpty();
+}
+
+static sk_sp<SkData> SerializeTypefaceAsEmpty(SkTypeface* typeface,
+                                              void* ctx) {
+  // Returning data keeps Skia from serializing the font data.
+  return SkData::MakeEmpty();
+}
+
 /// @note Procedure doesn't copy all closures.
-static std::unique_ptr<RasterCacheResult> Rasterize(
+static sk_sp<SkImage> RasterizeImage(
     GrDirectContext* context,
     const SkMatrix& ctm,
     SkColorSpace* dst_color_space,
@@ -120,8 +170,23 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
     DrawCheckerboard(canvas, logical_rect);
   }
 
-  return std::make_unique<RasterCacheResult>(surface->makeImageSnapshot(),
-                                             logical_rect);
+  return surface->makeImageSnapshot();
+}
+
+static std::unique_ptr<RasterCacheResult> Rasterize(
+    GrDirectContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    const SkRect& logical_rect,
+    const std::function<void(SkCanvas*)>& draw_function) {
+  sk_sp<SkImage> image = RasterizeImage(context, ctm, dst_color_space,
+                                        checkerboard, logical_rect,
+                                        draw_function);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(std::move(image), logical_rect);
 }
 
 std::unique_ptr<RasterCacheResult> RasterCache::RasterizePicture(
@@ -143,7 +208,19 @@ void RasterCache::Prepare(PrerollContext* context,
   entry.access_count++;
   entry.used_this_frame = true;
   if (!entry.image) {
+    if (reuse_enabled() && entry.access_count < access_threshold_) {
+      // Draw an image rasterized for another transform until the transform
+      // is stable.
+      if (Entry* reusable = FindReusableEntry(layer_cache_, cache_key)) {
+        reusable->used_this_frame = true;
+        return;
+      }
+    }
+    if (!ReserveBytes(EstimateImageBytes(layer->paint_bounds(), ctm))) {
+      return;
+    }
     entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+    SetRasterCTM(entry, ctm);
   }
 }
 
@@ -188,9 +265,6 @@ bool RasterCache::Prepare(GrDirectContext* context,
   if (access_threshold_ == 0) {
     return false;
   }
-  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
-    return false;
-  }
   if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
     // We only deal with pictures that are worthy of rasterization.
     return false;
@@ -209,69 +283,321 @@ bool RasterCache::Prepare(GrDirectContext* context,
 
   // Creates an entry, if not present prior.
   Entry& entry = picture_cache_[cache_key];
+  if (entry.image) {
+    // Keep the entry from being evicted while making room for other entries
+    // prepared in this frame, even if the picture ends up culled when
+    // painting.
+    entry.used_this_frame = true;
+    return true;
+  }
+
+  if (reuse_enabled()) {
+    // Keep an entry that can be drawn in place of this one until its image
+    // is ready.
+    if (Entry* reusable = FindReusableEntry(picture_cache_, cache_key)) {
+      reusable->used_this_frame = true;
+    }
+  }
+
+  if (entry.rasterizing) {
+    // The picture is drawn directly until the worker is done.
+    entry.used_this_frame = true;
+    return false;
+  }
+
+  const size_t image_bytes =
+      EstimateImageBytes(picture->cullRect(), transformation_matrix);
+
+  if (worker_task_runner_ &&
+      (is_complex || entry.access_count >= access_threshold_) &&
+      CanRasterizePictureOnWorker(picture)) {
+    entry.used_this_frame = true;
+    if (ReserveBytes(image_bytes)) {
+      entry.reserved_bytes = image_bytes;
+      RasterizePictureOnWorker(cache_key, entry, picture,
+                               transformation_matrix, dst_color_space);
+    }
+    return false;
+  }
+
   if (entry.access_count < access_threshold_) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
-  if (!entry.image) {
-    entry.image = RasterizePicture(picture, context, transformation_matrix,
-                                   dst_color_space, checkerboard_images_);
-    picture_cached_this_frame_++;
+  entry.used_this_frame = true;
+
+  if (picture_cached_this_frame_ >= picture_cache_limit_per_frame_) {
+    return false;
+  }
+  if (!ReserveBytes(image_bytes)) {
+    return false;
   }
+  entry.image = RasterizePicture(picture, context, transformation_matrix,
+                                 dst_color_space, checkerboard_images_);
+  SetRasterCTM(entry, transformation_matrix);
+  picture_cached_this_frame_++;
   return true;
 }
 
-bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
-  PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
-  auto it = picture_cache_.find(cache_key);
-  if (it == picture_cache_.end()) {
+// Texture backed images can only be read on the thread of their context, so
+// pictures drawing them (directly, through shaders or image filters, or in
+// nested pictures) must be rasterized on the raster thread.
+bool RasterCache::CanRasterizePictureOnWorker(SkPicture* picture) {
+  auto found = worker_rasterizable_pictures_.find(picture->uniqueID());
+  if (found != worker_rasterizable_pictures_.end()) {
+    return found->second;
+  }
+  TRACE_EVENT0("flutter", "RasterCache::CanRasterizePictureOnWorker");
+  bool has_texture_backed_images = false;
+  SkSerialProcs procs;
+  procs.fImageProc = SerializeImageCheckingTextureBacked;
+  procs.fImageCtx = &has_texture_backed_images;
+  procs.fTypefaceProc = SerializeTypefaceAsEmpty;
+  picture->serialize(&procs);
+  worker_rasterizable_pictures_[picture->uniqueID()] =
+      !has_texture_backed_images;
+  return !has_texture_backed_images;
+}
+
+void RasterCache::RasterizePictureOnWorker(
+    const PictureRasterCacheKey& cache_key,
+    Entry& entry,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space) {
+  entry.rasterizing = true;
+  entry.worker_task_id = ++worker_task_count_;
+  SetRasterCTM(entry, transformation_matrix);
+  worker_task_runner_->PostTask(
+      [results = worker_results_, cache_key, task_id = entry.worker_task_id,
+       picture = sk_ref_sp(picture), transformation_matrix,
+       dst_color_space = sk_ref_sp(dst_color_space),
+       checkerboard = checkerboard_images_]() {
+        TRACE_EVENT0("flutter", "RasterCache::RasterizePictureOnWorker");
+        // Raster surfaces only, the GPU contexts belong to other threads.
+        // The image is uploaded by |CollectWorkerResults|.
+        auto image = RasterizeImage(
+            nullptr, transformation_matrix, dst_color_space.get(),
+            checkerboard, picture->cullRect(),
+            [&picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+        std::scoped_lock lock(results->mutex);
+        results->results.push_back(
+            {cache_key, task_id, std::move(image), picture->cullRect()});
+      });
+}
+
+void RasterCache::SetWorkerTaskRunner(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner) {
+  worker_task_runner_ = std::move(task_runner);
+  if (worker_task_runner_ && !worker_results_) {
+    worker_results_ = std::make_shared<WorkerResults>();
+  }
+}
+
+void RasterCache::CollectWorkerResults(GrDirectContext* context) {
+  if (!worker_results_) {
+    return;
+  }
+  std::vector<WorkerResult> results;
+  {
+    std::scoped_lock lock(worker_results_->mutex);
+    results.swap(worker_results_->results);
+  }
+  for (auto& result : results) {
+    auto it = picture_cache_.find(result.key);
+    if (it == picture_cache_.end()) {
+      continue;
+    }
+    Entry& entry = it->second;
+    if (!entry.rasterizing || entry.worker_task_id != result.task_id) {
+      continue;
+    }
+    entry.rasterizing = false;
+    entry.reserved_bytes = 0;
+    if (result.image && context) {
+      // Upload the image once instead of with every draw into the GPU
+      // surface. The texture takes the place of the raster image in the byte
+      // budget, which |image_bytes| estimates the same way.
+      TRACE_EVENT0("flutter", "RasterCache::UploadWorkerResult");
+      result.image = result.image->makeTextureImage(context);
+    }
+    if (result.image) {
+      entry.image = std::make_unique<RasterCacheResult>(
+          std::move(result.image), result.logical_rect);
+    } else {
+      // Fall back to rasterizing the picture during preroll.
+      worker_rasterizable_pictures_[result.key.id()] = false;
+    }
+  }
+}
+
+void RasterCache::SetReuseScaleBounds(SkScalar min_scale, SkScalar max_scale) {
+  FML_DCHECK(min_scale > 0 && min_scale <= 1);
+  FML_DCHECK(max_scale >= 1);
+  reuse_min_scale_ = min_scale;
+  reuse_max_scale_ = max_scale;
+}
+
+void RasterCache::SetRasterCTM(Entry& entry, const SkMatrix& ctm) const {
+  entry.raster_ctm = ctm;
+  // Only images rasterized for a scale and a translation are reused at
+  // another scale. Other images are only reused at another fractional offset.
+  if (ctm.isScaleTranslate()) {
+    entry.min_reuse_scale = reuse_min_scale_;
+    entry.max_reuse_scale = reuse_max_scale_;
+  } else {
+    entry.min_reuse_scale = 1;
+    entry.max_reuse_scale = 1;
+  }
+}
+
+bool RasterCache::CanReuseEntry(const Entry& entry,
+                                const SkMatrix& matrix,
+                                SkScalar* distance) {
+  const SkMatrix& raster_ctm = entry.raster_ctm;
+  if (!raster_ctm.isScaleTranslate() || !matrix.isScaleTranslate() ||
+      raster_ctm.getScaleX() == 0 || raster_ctm.getScaleY() == 0) {
+    return false;
+  }
+  const SkScalar scale_x = matrix.getScaleX() / raster_ctm.getScaleX();
+  const SkScalar scale_y = matrix.getScaleY() / raster_ctm.getScaleY();
+  if (scale_x < entry.min_reuse_scale || scale_x > entry.max_reuse_scale ||
+      scale_y < entry.min_reuse_scale || scale_y > entry.max_reuse_scale) {
     return false;
   }
+  *distance = std::max(std::abs(scale_x - 1), std::abs(scale_y - 1));
+  return true;
+}
 
-  Entry& entry = it->second;
-  entry.access_count++;
-  entry.used_this_frame = true;
+static bool HasSameFractionalTranslation(const SkMatrix& a,
+                                         const SkMatrix& b) {
+  return SkScalarNearlyEqual(SkScalarFraction(a.getTranslateX()),
+                             SkScalarFraction(b.getTranslateX())) &&
+         SkScalarNearlyEqual(SkScalarFraction(a.getTranslateY()),
+                             SkScalarFraction(b.getTranslateY()));
+}
 
-  if (entry.image) {
-    entry.image->draw(canvas, nullptr);
-    return true;
+template <class Cache>
+bool RasterCache::DrawFromCache(Cache& cache,
+                                const typename Cache::key_type& key,
+                                SkCanvas& canvas,
+                                const SkPaint* paint) const {
+  auto it = cache.find(key);
+  if (it != cache.end()) {
+    Entry& entry = it->second;
+    entry.access_count++;
+    entry.used_this_frame = true;
+
+    if (entry.image) {
+      hit_count_++;
+      if (reuse_enabled() && !HasSameFractionalTranslation(
+                                 canvas.getTotalMatrix(), entry.raster_ctm)) {
+        // Rasterized at another fractional offset.
+        entry.image->draw_resampled(canvas, paint, entry.raster_ctm);
+      } else {
+        entry.image->draw(canvas, paint);
+      }
+      return true;
+    }
   }
 
+  if (reuse_enabled()) {
+    if (Entry* reusable = FindReusableEntry(cache, key)) {
+      reusable->used_this_frame = true;
+      resampled_hit_count_++;
+      reusable->image->draw_resampled(canvas, paint, reusable->raster_ctm);
+      return true;
+    }
+  }
+
+  if (it != cache.end()) {
+    miss_count_++;
+  }
   return false;
 }
 
+bool RasterCache::Draw(const SkPicture& picture, SkCanvas& canvas) const {
+  PictureRasterCacheKey cache_key(picture.uniqueID(), canvas.getTotalMatrix());
+  return DrawFromCache(picture_cache_, cache_key, canvas, nullptr);
+}
+
 bool RasterCache::Draw(const Layer* layer,
                        SkCanvas& canvas,
                        SkPaint* paint) const {
   LayerRasterCacheKey cache_key(layer->unique_id(), canvas.getTotalMatrix());
-  auto it = layer_cache_.find(cache_key);
-  if (it == layer_cache_.end()) {
-    return false;
-  }
+  return DrawFromCache(layer_cache_, cache_key, canvas, paint);
+}
 
-  Entry& entry = it->second;
-  entry.access_count++;
-  entry.used_this_frame = true;
+size_t RasterCache::EvictUnusedEntries(size_t target_bytes) {
+  std::vector<Entry*> candidates;
+  size_t bytes = CollectEvictionCandidates(picture_cache_, candidates) +
+                 CollectEvictionCandidates(layer_cache_, candidates);
+  if (bytes <= target_bytes) {
+    return bytes;
+  }
 
-  if (entry.image) {
-    entry.image->draw(canvas, paint);
-    return true;
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Entry* a, const Entry* b) {
+              if (a->last_used_frame != b->last_used_frame) {
+                return a->last_used_frame < b->last_used_frame;
+              }
+              return a->access_count < b->access_count;
+            });
+  for (Entry* entry : candidates) {
+    if (bytes <= target_bytes) {
+      break;
+    }
+    bytes -= entry->image_bytes();
+    entry->image.reset();
+    eviction_count_++;
   }
+  return bytes;
+}
 
-  return false;
+bool RasterCache::ReserveBytes(size_t bytes) {
+  if (bytes > max_bytes_) {
+    return false;
+  }
+  return EvictUnusedEntries(max_bytes_ - bytes) + bytes <= max_bytes_;
 }
 
 void RasterCache::SweepAfterFrame() {
-  SweepOneCacheAfterFrame(picture_cache_);
-  SweepOneCacheAfterFrame(layer_cache_);
+  EvictUnusedEntries(max_bytes_);
+  SweepOneCacheAfterFrame(picture_cache_, frame_count_);
+  SweepOneCacheAfterFrame(layer_cache_, frame_count_);
+  if (!worker_rasterizable_pictures_.empty()) {
+    std::unordered_set<uint32_t> cached_pictures;
+    for (const auto& item : picture_cache_) {
+      cached_pictures.insert(item.first.id());
+    }
+    for (auto it = worker_rasterizable_pictures_.begin();
+         it != worker_rasterizable_pictures_.end();) {
+      if (cached_pictures.count(it->first) == 0) {
+        it = worker_rasterizable_pictures_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  frame_count_++;
   picture_cached_this_frame_ = 0;
   TraceStatsToTimeline();
+  hit_count_ = 0;
+  miss_count_ = 0;
+  eviction_count_ = 0;
+  resampled_hit_count_ = 0;
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
   layer_cache_.clear();
+  worker_rasterizable_pictures_.clear();
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  EvictUnusedEntries(max_bytes_);
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
@@ -305,6 +631,10 @@ void RasterCache::TraceStatsToTimeline() const {
                     EstimateLayerCacheByteSize() / kMegaByteSizeInBytes,
                     "PictureCount", picture_cache_.size(), "PictureMBytes",
                     EstimatePictureCacheByteSize() / kMegaByteSizeInBytes);
+  FML_TRACE_COUNTER("flutter", "RasterCacheActivity",
+                    reinterpret_cast<int64_t>(this), "HitCount", hit_count_,
+                    "MissCount", miss_count_, "EvictionCount", eviction_count_,
+                    "ResampledHitCount", resampled_hit_count_);
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -6,11 +6,14 @@
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_runner.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -24,6 +27,13 @@ class RasterCacheResult {
 
   virtual void draw(SkCanvas& canvas, const SkPaint* paint) const;
 
+  // Draws the image for the current transform of |canvas| although it was
+  // rasterized for |raster_ctm|, resampling it with a filtered draw. Used to
+  // reuse the image at a nearby scale or at another fractional offset.
+  virtual void draw_resampled(SkCanvas& canvas,
+                              const SkPaint* paint,
+                              const SkMatrix& raster_ctm) const;
+
   virtual SkISize image_dimensions() const {
     return image_ ? image_->dimensions() : SkISize::Make(0, 0);
   };
@@ -47,6 +57,12 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // The default max number of bytes used by the images of the picture and
+  // layer raster caches combined. Entries that were not used in the last frame
+  // are kept around until this budget is exceeded, so that content that goes
+  // out of view briefly does not need to be rasterized again.
+  static constexpr size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
   explicit RasterCache(
       size_t access_threshold = 3,
       size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
@@ -132,6 +148,8 @@ class RasterCache {
   // 3. The picture is accessed too few times
   // 4. There are too many pictures to be cached in the current frame.
   //    (See also kDefaultPictureCacheLimitPerFrame.)
+  // 5. The picture is being rasterized by the worker task runner.
+  //    (See also SetWorkerTaskRunner.)
   bool Prepare(GrDirectContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -156,12 +174,67 @@ class RasterCache {
             SkCanvas& canvas,
             SkPaint* paint = nullptr) const;
 
+  // Evicts the least recently used entries that were not used in the current
+  // frame until the cache fits in its byte budget, and starts a new frame.
   void SweepAfterFrame();
 
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  /**
+   * @brief Set the max number of bytes used by the images of the picture and
+   * layer raster caches combined.
+   *
+   * Entries used in the current frame are never evicted to meet the budget.
+   * Instead, new entries are not rasterized when they would not fit in the
+   * budget together with the entries used in the current frame. Entries that
+   * are not used in the current frame are evicted in least recently used
+   * order, less frequently used entries first when they were last used in the
+   * same frame.
+   */
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  /**
+   * @brief Set the task runner used to rasterize pictures off the frame
+   * workload, or nullptr to rasterize all pictures during preroll.
+   *
+   * Pictures that are flagged as complex, or that reach the access threshold,
+   * are rasterized speculatively into raster surfaces on |task_runner|
+   * instead of during preroll, and are not subject to the per frame limit.
+   * Until the image is ready the picture is drawn directly. The image is
+   * uploaded on the raster thread and used starting with the first frame after
+   * it is ready, see |CollectWorkerResults|.
+   *
+   * Pictures drawing texture backed images are still rasterized during
+   * preroll since those images can only be read on the raster thread.
+   */
+  void SetWorkerTaskRunner(std::shared_ptr<fml::BasicTaskRunner> task_runner);
+
+  // Moves the images rasterized by the worker task runner since the last call
+  // into the cache. Called at the start of every frame. The images are
+  // uploaded to |context| first, if it is not null. Images that fail to
+  // upload are rasterized during preroll instead.
+  void CollectWorkerResults(GrDirectContext* context);
+
+  /**
+   * @brief Allow entries rasterized for another transform to be drawn when
+   * there is no entry for the current transform.
+   *
+   * An entry can be reused when both transforms only scale and translate and
+   * the current scale is within [min_scale, max_scale] times the scale the
+   * entry was rasterized at, on both axes. The bounds are captured by each
+   * entry when it is rasterized. Reused entries, and entries drawn at another
+   * fractional offset than they were rasterized at, are drawn with a filtered
+   * draw. An exact entry is still rasterized once the transform is stable for
+   * long enough to reach the access threshold.
+   *
+   * The default bounds of [1, 1] disable reuse.
+   */
+  void SetReuseScaleBounds(SkScalar min_scale, SkScalar max_scale);
+
   size_t GetCachedEntriesCount() const;
 
   size_t GetLayerCachedEntriesCount() const;
@@ -188,20 +261,76 @@ class RasterCache {
    */
   size_t EstimateLayerCacheByteSize() const;
 
+  // The number of |Draw| calls that found a cached image since the last
+  // |SweepAfterFrame|.
+  size_t GetHitCount() const { return hit_count_; }
+
+  // The number of |Draw| calls for prepared pictures and layers that did not
+  // find a cached image since the last |SweepAfterFrame|.
+  size_t GetMissCount() const { return miss_count_; }
+
+  // The number of cached images evicted to meet the byte budget since the last
+  // |SweepAfterFrame|.
+  size_t GetEvictionCount() const { return eviction_count_; }
+
+  // The number of |Draw| calls that reused an image rasterized for another
+  // transform since the last |SweepAfterFrame|, see |SetReuseScaleBounds|.
+  // Each of those would otherwise have drawn the picture or layer directly or
+  // have rasterized it again.
+  size_t GetResampledHitCount() const { return resampled_hit_count_; }
+
  private:
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    // The frame in which the entry was last used, see |frame_count_|.
+    size_t last_used_frame = 0;
+    // Set while the image is rasterized by the worker task runner.
+    bool rasterizing = false;
+    // Identifies the worker task rasterizing the image, so that results of
+    // tasks posted for entries that have since been removed are ignored.
+    size_t worker_task_id = 0;
+    // The bytes reserved for the image while it is being rasterized.
+    size_t reserved_bytes = 0;
+    // The transform the image was rasterized for.
+    SkMatrix raster_ctm;
+    // The range of scales, relative to |raster_ctm|, the image may be drawn
+    // at for another transform.
+    SkScalar min_reuse_scale = 1;
+    SkScalar max_reuse_scale = 1;
     std::unique_ptr<RasterCacheResult> image;
+
+    size_t image_bytes() const {
+      return image ? image->image_bytes() : reserved_bytes;
+    }
+  };
+
+  struct WorkerResult {
+    PictureRasterCacheKey key;
+    size_t task_id;
+    // A raster image, null if rasterization failed.
+    sk_sp<SkImage> image;
+    SkRect logical_rect;
+  };
+
+  // Images rasterized by the worker task runner. Shared with the posted tasks
+  // since they may complete after the cache is destroyed.
+  struct WorkerResults {
+    std::mutex mutex;
+    std::vector<WorkerResult> results;
   };
 
   template <class Cache>
-  static void SweepOneCacheAfterFrame(Cache& cache) {
+  static void SweepOneCacheAfterFrame(Cache& cache, size_t frame) {
     std::vector<typename Cache::iterator> dead;
 
     for (auto it = cache.begin(); it != cache.end(); ++it) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
+      if (entry.used_this_frame) {
+        entry.last_used_frame = frame;
+      } else if (!entry.image && !entry.rasterizing) {
+        // Entries without an image only track the access count, which is
+        // only meaningful for consecutive frames.
         dead.push_back(it);
       }
       entry.used_this_frame = false;
@@ -212,9 +341,109 @@ class RasterCache {
     }
   }
 
+  template <class Cache>
+  static size_t CollectEvictionCandidates(Cache& cache,
+                                          std::vector<Entry*>& candidates) {
+    size_t bytes = 0;
+    for (auto& item : cache) {
+      Entry& entry = item.second;
+      bytes += entry.image_bytes();
+      if (entry.image && !entry.used_this_frame) {
+        candidates.push_back(&entry);
+      }
+    }
+    return bytes;
+  }
+
+  // Finds the entry with an image for the same picture or layer as |key|
+  // that can be drawn for the transform of |key| with the least resampling.
+  template <class Cache>
+  static Entry* FindReusableEntry(Cache& cache,
+                                  const typename Cache::key_type& key) {
+    if (cache.empty()) {
+      return nullptr;
+    }
+    Entry* best_entry = nullptr;
+    SkScalar best_distance = SK_ScalarMax;
+    // The hash of a key only depends on its ID, so all the entries for the
+    // same picture or layer are in the same bucket.
+    const size_t bucket = cache.bucket(key);
+    for (auto it = cache.begin(bucket); it != cache.end(bucket); ++it) {
+      Entry& entry = it->second;
+      if (it->first.id() != key.id() || !entry.image) {
+        continue;
+      }
+      SkScalar distance;
+      if (CanReuseEntry(entry, key.matrix(), &distance) &&
+          distance < best_distance) {
+        best_entry = &entry;
+        best_distance = distance;
+      }
+    }
+    return best_entry;
+  }
+
+  // Returns true if the image of |entry| may be drawn for |matrix|.
+  // |distance| is set to how far the scale is from the scale the entry was
+  // rasterized at.
+  static bool CanReuseEntry(const Entry& entry,
+                            const SkMatrix& matrix,
+                            SkScalar* distance);
+
+  // Captures the transform an image is rasterized for, and the bounds of its
+  // reuse, in |entry|.
+  void SetRasterCTM(Entry& entry, const SkMatrix& ctm) const;
+
+  bool reuse_enabled() const {
+    return reuse_min_scale_ < 1 || reuse_max_scale_ > 1;
+  }
+
+  // Draws the entry for |key| or, if it has no image, an entry that can be
+  // reused for |key|. Returns false if neither exists.
+  template <class Cache>
+  bool DrawFromCache(Cache& cache,
+                     const typename Cache::key_type& key,
+                     SkCanvas& canvas,
+                     const SkPaint* paint) const;
+
+  // Evicts the images of entries not used in the current frame until the
+  // images of both caches use at most |target_bytes|. Returns the number of
+  // bytes used by the remaining images, which may exceed |target_bytes| if the
+  // images used in the current frame alone do.
+  size_t EvictUnusedEntries(size_t target_bytes);
+
+  // Evicts unused entries to make room for a new image of |bytes|. Returns
+  // false if the image does not fit in the budget.
+  bool ReserveBytes(size_t bytes);
+
+  // Whether the picture can be rasterized by the worker task runner. The
+  // verdict is remembered per picture since finding out walks the whole
+  // picture.
+  bool CanRasterizePictureOnWorker(SkPicture* picture);
+
+  void RasterizePictureOnWorker(const PictureRasterCacheKey& cache_key,
+                                Entry& entry,
+                                SkPicture* picture,
+                                const SkMatrix& transformation_matrix,
+                                SkColorSpace* dst_color_space);
+
   const size_t access_threshold_;
   const size_t picture_cache_limit_per_frame_;
   size_t picture_cached_this_frame_ = 0;
+  size_t max_bytes_ = kDefaultMaxBytes;
+  size_t frame_count_ = 0;
+  mutable size_t hit_count_ = 0;
+  mutable size_t miss_count_ = 0;
+  size_t eviction_count_ = 0;
+  mutable size_t resampled_hit_count_ = 0;
+  SkScalar reuse_min_scale_ = 1;
+  SkScalar reuse_max_scale_ = 1;
+  std::shared_ptr<fml::BasicTaskRunner> worker_task_runner_;
+  std::shared_ptr<WorkerResults> worker_results_;
+  size_t worker_task_count_ = 0;
+  // Keyed by the unique IDs of the pictures in |picture_cache_|, see
+  // |CanRasterizePictureOnWorker|.
+  std::unordered_map<uint32_t, bool> worker_rasterizable_pictures_;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
   bool checkerboard_images_;
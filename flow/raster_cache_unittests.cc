@@ -24,6 +24,12 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+// Runs the posted tasks right away, as if the workers finished instantly.
+class ImmediateTaskRunner : public fml::BasicTaskRunner {
+ public:
+  void PostTask(const fml::closure& task) override { task(); }
+};
+
 }  // namespace
 
 TEST(RasterCache, SimpleInitialization) {
@@ -103,7 +109,7 @@ TEST(RasterCache, PictureCacheLimitPerFrameIsRespectedWhenZero) {
   ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
 }
 
-TEST(RasterCache, SweepsRemoveUnusedFrames) {
+TEST(RasterCache, SweepsRemoveUnusedFramesOverBudget) {
   size_t threshold = 1;
   flutter::RasterCache cache(threshold);
 
@@ -127,11 +133,279 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
 
   cache.SweepAfterFrame();
+  // Evicts the entries that are not used in the current frame.
+  cache.SetMaxBytes(0);
   cache.SweepAfterFrame();  // Extra frame without a Get image access.
 
   ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
 }
 
+TEST(RasterCache, SweepsKeepUnusedFramesWithinBudget) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));  // 1
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));  // 2
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Extra frame without a Get image access.
+
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(cache.GetHitCount(), 1u);
+}
+
+TEST(RasterCache, LeastRecentlyUsedEntriesAreEvictedFirst) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  // Each picture takes 150 * 100 * 4 bytes, so two of them fit.
+  cache.SetMaxBytes(2 * 150 * 100 * 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+  auto picture3 = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto prepare_and_draw = [&](SkPicture* picture) {
+    bool prepared =
+        cache.Prepare(NULL, picture, matrix, srgb.get(), true, false);
+    cache.Draw(*picture, dummy_canvas);
+    return prepared;
+  };
+
+  ASSERT_FALSE(prepare_and_draw(picture1.get()));
+  ASSERT_FALSE(prepare_and_draw(picture2.get()));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(prepare_and_draw(picture1.get()));
+  ASSERT_TRUE(prepare_and_draw(picture2.get()));
+  cache.SweepAfterFrame();
+
+  // Only picture2 is used in this frame.
+  ASSERT_TRUE(prepare_and_draw(picture2.get()));
+  cache.SweepAfterFrame();
+
+  // Caching picture3 evicts picture1, which was used least recently.
+  ASSERT_FALSE(prepare_and_draw(picture3.get()));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(prepare_and_draw(picture3.get()));
+  ASSERT_EQ(cache.GetEvictionCount(), 1u);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 2u * 150 * 100 * 4);
+
+  ASSERT_TRUE(cache.Draw(*picture2, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+}
+
+TEST(RasterCache, EntriesUsedThisFrameAreNotEvicted) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  // Only one of the pictures fits.
+  cache.SetMaxBytes(150 * 100 * 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+  ASSERT_EQ(cache.GetHitCount(), 1u);
+  ASSERT_EQ(cache.GetMissCount(), 1u);
+  ASSERT_EQ(cache.GetEvictionCount(), 0u);
+}
+
+TEST(RasterCache, PicturesLargerThanTheBudgetAreNotCached) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetMaxBytes(1000);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 0u);
+}
+
+TEST(RasterCache, ComplexPicturesAreRasterizedOnWorkers) {
+  size_t threshold = 3;
+  flutter::RasterCache cache(threshold);
+  cache.SetWorkerTaskRunner(std::make_shared<ImmediateTaskRunner>());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // The picture is drawn directly in the frame that requests the image.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  // The image is used starting with the next frame, before the access
+  // threshold is reached.
+  cache.CollectWorkerResults(nullptr);
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, WorkersAreNotLimitedPerFrame) {
+  size_t threshold = 3;
+  size_t picture_cache_limit_per_frame = 0;
+  flutter::RasterCache cache(threshold, picture_cache_limit_per_frame);
+  cache.SetWorkerTaskRunner(std::make_shared<ImmediateTaskRunner>());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  cache.SweepAfterFrame();
+
+  cache.CollectWorkerResults(nullptr);
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, WorkerResultsOfClearedEntriesAreIgnored) {
+  size_t threshold = 3;
+  flutter::RasterCache cache(threshold);
+  cache.SetWorkerTaskRunner(std::make_shared<ImmediateTaskRunner>());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  cache.Clear();
+  cache.CollectWorkerResults(nullptr);
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(cache.GetPictureCachedEntriesCount(), 0u);
+}
+
+// Caches |picture| for |matrix| over two frames.
+static void CachePicture(flutter::RasterCache& cache,
+                         SkPicture* picture,
+                         const SkMatrix& matrix) {
+  SkCanvas canvas;
+  canvas.setMatrix(matrix);
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture, matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Prepare(NULL, picture, matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  cache.SweepAfterFrame();
+}
+
+TEST(RasterCache, EntriesAreReusedAtNearbyScales) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetReuseScaleBounds(0.8, 1.25);
+
+  auto picture = GetSamplePicture();
+  CachePicture(cache, picture.get(), SkMatrix::Scale(2, 2));
+
+  SkCanvas canvas;
+  canvas.setMatrix(SkMatrix::Scale(2.2, 2.2));
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  ASSERT_EQ(cache.GetResampledHitCount(), 1u);
+  ASSERT_EQ(cache.GetMissCount(), 0u);
+
+  canvas.setMatrix(SkMatrix::Scale(3, 3));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+  ASSERT_EQ(cache.GetResampledHitCount(), 1u);
+}
+
+TEST(RasterCache, EntriesAreNotReusedAtNearbyScalesByDefault) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  auto picture = GetSamplePicture();
+  CachePicture(cache, picture.get(), SkMatrix::Scale(2, 2));
+
+  SkCanvas canvas;
+  canvas.setMatrix(SkMatrix::Scale(2.2, 2.2));
+  ASSERT_FALSE(cache.Draw(*picture, canvas));
+  ASSERT_EQ(cache.GetResampledHitCount(), 0u);
+}
+
+TEST(RasterCache, ReusedEntriesAreKeptWhileDrawn) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetReuseScaleBounds(0.8, 1.25);
+
+  auto picture = GetSamplePicture();
+  CachePicture(cache, picture.get(), SkMatrix::Scale(2, 2));
+
+  SkMatrix matrix = SkMatrix::Scale(2.1, 2.1);
+  SkCanvas canvas;
+  canvas.setMatrix(matrix);
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  // Only entries not used in the current frame are evicted.
+  cache.SetMaxBytes(0);
+  ASSERT_TRUE(cache.Draw(*picture, canvas));
+  ASSERT_EQ(cache.GetResampledHitCount(), 1u);
+}
+
 // Construct a cache result whose device target rectangle rounds out to be one
 // pixel wider than the cached image.  Verify that it can be drawn without
 // triggering any assertions.
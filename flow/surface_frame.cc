@@ -9,9 +9,11 @@ namespace flutter {
 
 SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            bool supports_readback,
-                           const SubmitCallback& submit_callback)
+                           const SubmitCallback& submit_callback,
+                           FramebufferInfo framebuffer_info)
     : surface_(surface),
       supports_readback_(supports_readback),
+      framebuffer_info_(framebuffer_info),
       submit_callback_(submit_callback) {
   FML_DCHECK(submit_callback_);
 }
@@ -19,10 +21,12 @@ SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
 SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            bool supports_readback,
                            const SubmitCallback& submit_callback,
-                           std::unique_ptr<GLContextResult> context_result)
+                           std::unique_ptr<GLContextResult> context_result,
+                           FramebufferInfo framebuffer_info)
     : submitted_(false),
       surface_(surface),
       supports_readback_(supports_readback),
+      framebuffer_info_(framebuffer_info),
       submit_callback_(submit_callback),
       context_result_(std::move(context_result)) {
   FML_DCHECK(submit_callback_);
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_SURFACE_FRAME_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -21,14 +22,47 @@ class SurfaceFrame {
   using SubmitCallback =
       std::function<bool(const SurfaceFrame& surface_frame, SkCanvas* canvas)>;
 
+  // Information about the underlying framebuffer of the frame.
+  struct FramebufferInfo {
+    // Whether the rasterizer should compute the damage of the frame against
+    // the previously presented frame. The damage is reported back through
+    // |SubmitInfo|. The frame is only partially repainted if the
+    // |existing_damage| of the framebuffer is known as well.
+    bool supports_partial_repaint = false;
+
+    // The area of the framebuffer that does not contain the contents of the
+    // previously presented frame, in pixels. For example, a surface that
+    // cycles between two buffers reports the damage of the frame before the
+    // previous one here. An empty rect means the framebuffer contains the
+    // previous frame. If unset, the whole framebuffer is repainted.
+    std::optional<SkIRect> existing_damage;
+  };
+
+  // Information about the frame being submitted, filled in by the rasterizer
+  // before the frame is submitted.
+  struct SubmitInfo {
+    // The area of the frame that changed compared to the previously presented
+    // frame, in pixels. Surfaces may use this to present only the changed area
+    // (for example with a swap-with-damage extension). If unset, the whole
+    // frame changed.
+    std::optional<SkIRect> frame_damage;
+
+    // The area of the framebuffer that was repainted for this frame, in
+    // pixels. This is the frame damage joined with the existing damage of the
+    // framebuffer. If unset, the whole framebuffer was repainted.
+    std::optional<SkIRect> buffer_damage;
+  };
+
   SurfaceFrame(sk_sp<SkSurface> surface,
                bool supports_readback,
-               const SubmitCallback& submit_callback);
+               const SubmitCallback& submit_callback,
+               FramebufferInfo framebuffer_info = {});
 
   SurfaceFrame(sk_sp<SkSurface> surface,
                bool supports_readback,
                const SubmitCallback& submit_callback,
-               std::unique_ptr<GLContextResult> context_result);
+               std::unique_ptr<GLContextResult> context_result,
+               FramebufferInfo framebuffer_info = {});
 
   ~SurfaceFrame();
 
@@ -42,10 +76,19 @@ class SurfaceFrame {
 
   bool supports_readback() { return supports_readback_; }
 
+  const FramebufferInfo& framebuffer_info() const { return framebuffer_info_; }
+
+  void set_submit_info(const SubmitInfo& submit_info) {
+    submit_info_ = submit_info;
+  }
+  const SubmitInfo& submit_info() const { return submit_info_; }
+
  private:
   bool submitted_ = false;
   sk_sp<SkSurface> surface_;
   bool supports_readback_;
+  FramebufferInfo framebuffer_info_;
+  SubmitInfo submit_info_;
   SubmitCallback submit_callback_;
   std::unique_ptr<GLContextResult> context_result_;
 
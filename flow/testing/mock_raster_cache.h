@@ -25,6 +25,10 @@ class MockRasterCacheResult : public RasterCacheResult {
 
   void draw(SkCanvas& canvas, const SkPaint* paint = nullptr) const override{};
 
+  void draw_resampled(SkCanvas& canvas,
+                      const SkPaint* paint,
+                      const SkMatrix& raster_ctm) const override{};
+
   SkISize image_dimensions() const override { return device_rect_.size(); };
 
   int64_t image_bytes() const override {
@@ -6,11 +6,111 @@
 
 #include <algorithm>
 
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
 #include "flutter/fml/trace_event.h"
 
 namespace fml {
 
+namespace {
+
+struct WorkerContext {
+  const ConcurrentMessageLoop* loop;
+  size_t worker_index;
+};
+
+FML_THREAD_LOCAL ThreadLocalUniquePtr<WorkerContext> tls_worker_context;
+
+}  // namespace
+
+// A fixed capacity work-stealing deque (Chase and Lev, with the memory
+// orderings of Lê et al.). The owning worker pushes and pops tasks at the
+// bottom without locking while other workers steal tasks from the top.
+class ConcurrentMessageLoop::WorkerQueue {
+ public:
+  WorkerQueue() {
+    for (auto& slot : slots_) {
+      slot.store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~WorkerQueue() {
+    while (fml::closure* task = Pop()) {
+      delete task;
+    }
+  }
+
+  // Only called by the owning worker. Returns false if the queue is full.
+  bool Push(fml::closure* task) {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= kCapacity) {
+      return false;
+    }
+    slots_[bottom & kMask].store(task, std::memory_order_relaxed);
+    // Publishes the task to thieves that read |bottom_|.
+    bottom_.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Only called by the owning worker.
+  fml::closure* Pop() {
+    const int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      // Empty.
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    fml::closure* task = slots_[bottom & kMask].load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // Last task, race the thieves for it.
+      if (!top_.compare_exchange_strong(top, top + 1,
+                                        std::memory_order_seq_cst,
+                                        std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  // May be called by any thread. May spuriously return null if it loses a
+  // race with another thief or the owner.
+  fml::closure* Steal() {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    fml::closure* task = slots_[top & kMask].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return task;
+  }
+
+  bool IsEmpty() const {
+    return top_.load(std::memory_order_acquire) >=
+           bottom_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr int64_t kCapacity = 1024;
+  static constexpr int64_t kMask = kCapacity - 1;
+
+  std::atomic<int64_t> top_ = 0;
+  std::atomic<int64_t> bottom_ = 0;
+  std::atomic<fml::closure*> slots_[kCapacity];
+
+  FML_DISALLOW_COPY_AND_ASSIGN(WorkerQueue);
+};
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,11 +119,17 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.flutter.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      tls_worker_context.reset(new WorkerContext{this, i});
+      WorkerMain(i);
+      tls_worker_context.reset(nullptr);
     });
   }
 
@@ -52,6 +158,19 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
     return;
   }
 
+  // Tasks posted from a worker go to the queue of that worker first. This
+  // keeps the tasks that fan out from a task on the same worker unless other
+  // workers are idle and steal them.
+  const WorkerContext* context = tls_worker_context.get();
+  if (context && context->loop == this && !shutdown_) {
+    auto* worker_task = new fml::closure(task);
+    if (worker_queues_[context->worker_index]->Push(worker_task)) {
+      WakeUpSleepingWorker();
+      return;
+    }
+    delete worker_task;
+  }
+
   std::unique_lock lock(tasks_mutex_);
 
   // Don't just drop tasks on the floor in case of shutdown.
@@ -74,23 +193,82 @@ void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
   tasks_condition_.notify_one();
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
+void ConcurrentMessageLoop::WakeUpSleepingWorker() {
+  // Pairs with the fence in |WorkerMain| so that either the sleeping worker
+  // sees the new task or this sees the sleeping worker.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (sleeping_workers_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  {
+    // The worker may be between checking for tasks and waiting.
+    std::scoped_lock lock(tasks_mutex_);
+  }
+  tasks_condition_.notify_one();
+}
 
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
+fml::closure ConcurrentMessageLoop::TakeTask(size_t worker_index) {
+  if (fml::closure* task = worker_queues_[worker_index]->Pop()) {
+    fml::closure result = std::move(*task);
+    delete task;
+    return result;
+  }
 
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
+  {
+    std::scoped_lock lock(tasks_mutex_);
+    if (!tasks_.empty()) {
+      fml::closure task = std::move(tasks_.front());
       tasks_.pop();
+      return task;
+    }
+  }
+
+  for (size_t i = 1; i < worker_count_; ++i) {
+    auto& victim = worker_queues_[(worker_index + i) % worker_count_];
+    if (fml::closure* task = victim->Steal()) {
+      fml::closure result = std::move(*task);
+      delete task;
+      return result;
+    }
+  }
+
+  return nullptr;
+}
+
+bool ConcurrentMessageLoop::HasTasksLocked() const {
+  if (!tasks_.empty()) {
+    return true;
+  }
+  for (const auto& queue : worker_queues_) {
+    if (!queue->IsEmpty()) {
+      return true;
     }
+  }
+  return false;
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  size_t thread_tasks_generation = 0;
+  while (!shutdown_) {
+    // Avoid taking the lock for every task just to look for thread tasks.
+    if (thread_tasks_generation_ == thread_tasks_generation) {
+      if (fml::closure task = TakeTask(worker_index)) {
+        TRACE_EVENT0("flutter", "ConcurrentWorkerTask");
+        task();
+        continue;
+      }
+    }
+
+    std::unique_lock lock(tasks_mutex_);
+    ++sleeping_workers_;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    tasks_condition_.wait(lock, [&]() {
+      return HasTasksLocked() || shutdown_ || HasThreadTasksLocked();
+    });
+    --sleeping_workers_;
+    thread_tasks_generation = thread_tasks_generation_;
 
+    std::vector<fml::closure> thread_tasks;
     if (HasThreadTasksLocked()) {
       thread_tasks = GetThreadTasksLocked();
       FML_DCHECK(!HasThreadTasksLocked());
@@ -101,19 +279,10 @@ void ConcurrentMessageLoop::WorkerMain() {
     lock.unlock();
 
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
-    // Execute the primary task we woke up for.
-    if (task) {
-      task();
-    }
-
     // Execute any thread tasks.
     for (const auto& thread_task : thread_tasks) {
       thread_task();
     }
-
-    if (shutdown_now) {
-      break;
-    }
   }
 }
 
@@ -132,9 +301,44 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
   for (const auto& worker_thread_id : worker_thread_ids_) {
     thread_tasks_[worker_thread_id].emplace_back(task);
   }
+  ++thread_tasks_generation_;
   tasks_condition_.notify_all();
 }
 
+void ConcurrentMessageLoop::ParallelFor(
+    size_t count,
+    const std::function<void(size_t)>& task) {
+  if (count == 0) {
+    return;
+  }
+
+  struct State {
+    std::function<void(size_t)> task;
+    std::atomic<size_t> next_index = 0;
+    fml::CountDownLatch done;
+
+    State(const std::function<void(size_t)>& task, size_t count)
+        : task(task), done(count) {}
+
+    // Runs invocations until there are none left.
+    void Run(size_t count) {
+      for (size_t index = next_index++; index < count; index = next_index++) {
+        task(index);
+        done.CountDown();
+      }
+    }
+  };
+
+  auto state = std::make_shared<State>(task, count);
+  const size_t helper_count = std::min(count, worker_count_) - 1;
+  for (size_t i = 0; i < helper_count; ++i) {
+    PostTask([state, count]() { state->Run(count); });
+  }
+  // Helpers that are not scheduled in time find no invocations left to run.
+  state->Run(count);
+  state->done.Wait();
+}
+
 bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
   return thread_tasks_.count(std::this_thread::get_id()) > 0;
 }
@@ -170,4 +374,17 @@ void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
   task();
 }
 
+void ConcurrentTaskRunner::ParallelFor(
+    size_t count,
+    const std::function<void(size_t)>& task) {
+  if (auto loop = weak_loop_.lock()) {
+    loop->ParallelFor(count, task);
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    task(i);
+  }
+}
+
 }  // namespace fml
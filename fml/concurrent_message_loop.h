@@ -5,10 +5,14 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <map>
+#include <memory>
 #include <queue>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,6 +22,9 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+// Runs tasks on a pool of worker threads. Tasks posted from a worker are pushed
+// onto a queue owned by that worker, which runs them first. Workers that run
+// out of tasks steal tasks from the queues of the other workers.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -34,24 +41,45 @@ class ConcurrentMessageLoop
 
   void PostTaskToAllWorkers(fml::closure task);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Invokes |task| for every index in [0, count) on the workers
+  ///             and returns once all invocations are done. The calling thread
+  ///             runs invocations too, so this may be called from a worker.
+  ///
+  void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
  private:
   friend ConcurrentTaskRunner;
 
+  // The queue of tasks of a worker, see |WorkerMain|.
+  class WorkerQueue;
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
   std::mutex tasks_mutex_;
   std::condition_variable tasks_condition_;
+  // Tasks posted from threads that are not workers of this loop.
   std::queue<fml::closure> tasks_;
   std::vector<std::thread::id> worker_thread_ids_;
   std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  // Incremented whenever thread tasks are posted.
+  std::atomic<size_t> thread_tasks_generation_ = 0;
+  std::atomic<size_t> sleeping_workers_ = 0;
+  std::atomic<bool> shutdown_ = false;
 
   ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
 
   void PostTask(const fml::closure& task);
 
+  fml::closure TakeTask(size_t worker_index);
+
+  bool HasTasksLocked() const;
+
+  void WakeUpSleepingWorker();
+
   bool HasThreadTasksLocked() const;
 
   std::vector<fml::closure> GetThreadTasksLocked();
@@ -67,6 +95,10 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  // See |ConcurrentMessageLoop::ParallelFor|. Runs all invocations on the
+  // calling thread if the loop has died.
+  void ParallelFor(size_t count, const std::function<void(size_t)>& task);
+
  private:
   friend ConcurrentMessageLoop;
 
@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <atomic>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+
+namespace fml {
+namespace benchmarking {
+
+static const int kTaskCount = 10000;
+
+// Burns a little CPU so that the tasks are not entirely dominated by the
+// scheduling overhead.
+static void SmallTask(std::atomic<uint64_t>& sink) {
+  uint64_t value = 0;
+  for (int i = 0; i < 100; i++) {
+    value += i * i;
+  }
+  sink.fetch_add(value, std::memory_order_relaxed);
+}
+
+// Tasks are posted from a thread that is not a worker of the loop, so all of
+// them go through the shared queue.
+static void BM_ConcurrentMessageLoopThroughput(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<uint64_t> sink = 0;
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount);
+    for (int i = 0; i < kTaskCount; i++) {
+      task_runner->PostTask([&]() {
+        SmallTask(sink);
+        latch.CountDown();
+      });
+    }
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+// Tasks are posted from a worker of the loop, so they go to the queue of that
+// worker and the other workers have to steal them.
+static void BM_ConcurrentMessageLoopFanOut(benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<uint64_t> sink = 0;
+
+  while (state.KeepRunning()) {
+    CountDownLatch latch(kTaskCount + 1);
+    task_runner->PostTask([&]() {
+      for (int i = 0; i < kTaskCount; i++) {
+        task_runner->PostTask([&]() {
+          SmallTask(sink);
+          latch.CountDown();
+        });
+      }
+      latch.CountDown();
+    });
+    latch.Wait();
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+static void BM_ConcurrentMessageLoopParallelFor(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(state.range(0));
+  std::atomic<uint64_t> sink = 0;
+
+  while (state.KeepRunning()) {
+    loop->ParallelFor(kTaskCount, [&](size_t index) { SmallTask(sink); });
+  }
+
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopThroughput)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+BENCHMARK(BM_ConcurrentMessageLoopFanOut)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+BENCHMARK(BM_ConcurrentMessageLoopParallelFor)
+    ->ArgName("workers")
+    ->RangeMultiplier(2)
+    ->Range(1, 64)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
@@ -12,6 +12,20 @@
 
 namespace fml {
 
+// The priority of a task relative to the other runnable tasks of its queue.
+enum class TaskPriority {
+  // Tasks that produce the next frame, such as vsync callbacks. They run before
+  // the other runnable tasks.
+  kFrameCritical,
+  // The priority of tasks posted without an explicit priority.
+  kNormal,
+  // Tasks that only run during the idle periods of their queue, see
+  // |MessageLoopTaskQueues::SetIdleDeadline|.
+  kIdle,
+};
+
+constexpr size_t kTaskPriorityCount = 3;
+
 class DelayedTask {
  public:
   DelayedTask(size_t order,
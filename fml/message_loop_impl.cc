@@ -55,7 +55,8 @@ MessageLoopImpl::~MessageLoopImpl() {
 }
 
 void MessageLoopImpl::PostTask(const fml::closure& task,
-                               fml::TimePoint target_time) {
+                               fml::TimePoint target_time,
+                               TaskPriority priority) {
   FML_DCHECK(task != nullptr);
   FML_DCHECK(task != nullptr);
   if (terminated_) {
@@ -63,7 +64,7 @@ void MessageLoopImpl::PostTask(const fml::closure& task,
     // |task| synchronously within this function.
     return;
   }
-  task_queue_->RegisterTask(queue_id_, task, target_time);
+  task_queue_->RegisterTask(queue_id_, task, target_time, priority);
 }
 
 void MessageLoopImpl::AddTaskObserver(intptr_t key,
@@ -19,13 +19,92 @@ const size_t TaskQueueId::kUnmerged = ULONG_MAX;
 
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::instance_;
 
+namespace {
+
+// Normal priority tasks that have been runnable for this long run alongside
+// frame critical tasks.
+constexpr fml::TimeDelta kMaxNormalTaskDelay =
+    fml::TimeDelta::FromMilliseconds(100);
+
+// Idle priority tasks that have been runnable for this long run outside of
+// idle periods.
+constexpr fml::TimeDelta kMaxIdleTaskDelay = fml::TimeDelta::FromSeconds(1);
+
+size_t GetNumTasks(const TaskQueueEntry& entry) {
+  size_t num_tasks = 0;
+  for (const auto& tasks : entry.delayed_tasks) {
+    num_tasks += tasks.size();
+  }
+  return num_tasks;
+}
+
+// Returns when |task| can run, as seen from |now|.
+fml::TimePoint GetRunTime(const DelayedTask& task,
+                          TaskPriority priority,
+                          const TaskQueueEntry& entry,
+                          fml::TimePoint now) {
+  const fml::TimePoint target_time = task.GetTargetTime();
+  if (priority != TaskPriority::kIdle) {
+    return target_time;
+  }
+  if (now < entry.idle_deadline && target_time < entry.idle_deadline) {
+    return target_time;
+  }
+  return target_time + kMaxIdleTaskDelay;
+}
+
+// Tasks that can run are ordered by rank first, then by target time and order.
+int GetRank(const DelayedTask& task,
+            TaskPriority priority,
+            fml::TimePoint now) {
+  switch (priority) {
+    case TaskPriority::kFrameCritical:
+      return 0;
+    case TaskPriority::kNormal:
+      return now - task.GetTargetTime() >= kMaxNormalTaskDelay ? 0 : 1;
+    case TaskPriority::kIdle:
+      return 2;
+  }
+  return 1;
+}
+
+}  // namespace
+
 TaskQueueEntry::TaskQueueEntry()
     : owner_of(_kUnmerged), subsumed_by(_kUnmerged) {
   wakeable = NULL;
   task_observers = TaskObservers();
-  delayed_tasks = DelayedTaskQueue();
 }
 
+// Locks the mutex of a queue and of the queue it is merged with, if any. Must
+// be used while holding a shared lock on the queue meta mutex so that the
+// merge state does not change.
+class MessageLoopTaskQueues::MergedQueuesLock {
+ public:
+  MergedQueuesLock(const MessageLoopTaskQueues& queues, TaskQueueId queue_id) {
+    const auto& entry = queues.queue_entries_.at(queue_id);
+    TaskQueueId merged_with = entry->owner_of != _kUnmerged
+                                  ? entry->owner_of
+                                  : entry->subsumed_by;
+    if (merged_with == _kUnmerged) {
+      queue_lock_ = std::unique_lock(entry->mutex);
+      return;
+    }
+    queue_lock_ = std::unique_lock(entry->mutex, std::defer_lock);
+    merged_queue_lock_ = std::unique_lock(
+        queues.queue_entries_.at(merged_with)->mutex, std::defer_lock);
+    // Both queues of a merged pair may be locked concurrently, from either
+    // side. std::lock avoids the lock order inversion.
+    std::lock(queue_lock_, merged_queue_lock_);
+  }
+
+ private:
+  std::unique_lock<std::mutex> queue_lock_;
+  std::unique_lock<std::mutex> merged_queue_lock_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MergedQueuesLock);
+};
+
 fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
   std::scoped_lock creation(creation_mutex_);
   if (!instance_) {
@@ -35,7 +114,7 @@ fml::RefPtr<MessageLoopTaskQueues> MessageLoopTaskQueues::GetInstance() {
 }
 
 TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   TaskQueueId loop_id = TaskQueueId(task_queue_id_counter_);
   ++task_queue_id_counter_;
   queue_entries_[loop_id] = std::make_unique<TaskQueueEntry>();
@@ -43,12 +122,14 @@ TaskQueueId MessageLoopTaskQueues::CreateTaskQueue() {
 }
 
 MessageLoopTaskQueues::MessageLoopTaskQueues()
-    : task_queue_id_counter_(0), order_(0) {}
+    : queue_meta_mutex_(fml::SharedMutex::Create()),
+      task_queue_id_counter_(0),
+      order_(0) {}
 
 MessageLoopTaskQueues::~MessageLoopTaskQueues() = default;
 
 void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   TaskQueueId subsumed = queue_entry->owner_of;
@@ -59,7 +140,8 @@ void MessageLoopTaskQueues::Dispose(TaskQueueId queue_id) {
 }
 
 void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   FML_DCHECK(queue_entry->subsumed_by == _kUnmerged);
   TaskQueueId subsumed = queue_entry->owner_of;
@@ -71,43 +153,56 @@ void MessageLoopTaskQueues::DisposeTasks(TaskQueueId queue_id) {
 
 void MessageLoopTaskQueues::RegisterTask(TaskQueueId queue_id,
                                          const fml::closure& task,
-                                         fml::TimePoint target_time) {
-  std::lock_guard guard(queue_mutex_);
+                                         fml::TimePoint target_time,
+                                         TaskPriority priority) {
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   size_t order = order_++;
   const auto& queue_entry = queue_entries_.at(queue_id);
-  queue_entry->delayed_tasks.push({order, task, target_time});
+  queue_entry->delayed_tasks[static_cast<size_t>(priority)].push(
+      {order, task, target_time});
+  WakeUpOwnerUnlocked(queue_id);
+}
+
+void MessageLoopTaskQueues::WakeUpOwnerUnlocked(TaskQueueId queue_id) const {
   TaskQueueId loop_to_wake = queue_id;
+  const auto& queue_entry = queue_entries_.at(queue_id);
   if (queue_entry->subsumed_by != _kUnmerged) {
     loop_to_wake = queue_entry->subsumed_by;
   }
-  WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake));
+  WakeUpUnlocked(loop_to_wake, GetNextWakeTimeUnlocked(loop_to_wake,
+                                                       fml::TimePoint::Now()));
 }
 
 bool MessageLoopTaskQueues::HasPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   return HasPendingTasksUnlocked(queue_id);
 }
 
 fml::closure MessageLoopTaskQueues::GetNextTaskToRun(TaskQueueId queue_id,
                                                      fml::TimePoint from_time) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   if (!HasPendingTasksUnlocked(queue_id)) {
     return nullptr;
   }
-  TaskQueueId top_queue = _kUnmerged;
-  const auto& top = PeekNextTaskUnlocked(queue_id, top_queue);
+  const NextTask next = PeekNextTaskUnlocked(queue_id, from_time);
+  if (next.run_time > from_time) {
+    WakeUpUnlocked(queue_id, next.run_time);
+    return nullptr;
+  }
+
+  auto& tasks = queue_entries_.at(next.queue_id)
+                    ->delayed_tasks[static_cast<size_t>(next.priority)];
+  fml::closure invocation = tasks.top().GetTask();
+  tasks.pop();
 
   if (!HasPendingTasksUnlocked(queue_id)) {
     WakeUpUnlocked(queue_id, fml::TimePoint::Max());
   } else {
-    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id));
+    WakeUpUnlocked(queue_id, GetNextWakeTimeUnlocked(queue_id, from_time));
   }
-
-  if (top.GetTargetTime() > from_time) {
-    return nullptr;
-  }
-  fml::closure invocation = top.GetTask();
-  queue_entries_.at(top_queue)->delayed_tasks.pop();
   return invocation;
 }
 
@@ -119,19 +214,20 @@ void MessageLoopTaskQueues::WakeUpUnlocked(TaskQueueId queue_id,
 }
 
 size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   const auto& queue_entry = queue_entries_.at(queue_id);
   if (queue_entry->subsumed_by != _kUnmerged) {
     return 0;
   }
 
   size_t total_tasks = 0;
-  total_tasks += queue_entry->delayed_tasks.size();
+  total_tasks += GetNumTasks(*queue_entry);
 
   TaskQueueId subsumed = queue_entry->owner_of;
   if (subsumed != _kUnmerged) {
     const auto& subsumed_entry = queue_entries_.at(subsumed);
-    total_tasks += subsumed_entry->delayed_tasks.size();
+    total_tasks += GetNumTasks(*subsumed_entry);
   }
   return total_tasks;
 }
@@ -139,20 +235,23 @@ size_t MessageLoopTaskQueues::GetNumPendingTasks(TaskQueueId queue_id) const {
 void MessageLoopTaskQueues::AddTaskObserver(TaskQueueId queue_id,
                                             intptr_t key,
                                             const fml::closure& callback) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   FML_DCHECK(callback != nullptr) << "Observer callback must be non-null.";
   queue_entries_.at(queue_id)->task_observers[key] = callback;
 }
 
 void MessageLoopTaskQueues::RemoveTaskObserver(TaskQueueId queue_id,
                                                intptr_t key) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   queue_entries_.at(queue_id)->task_observers.erase(key);
 }
 
 std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
     TaskQueueId queue_id) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   std::vector<fml::closure> observers;
 
   if (queue_entries_.at(queue_id)->subsumed_by != _kUnmerged) {
@@ -175,17 +274,31 @@ std::vector<fml::closure> MessageLoopTaskQueues::GetObserversToNotify(
 
 void MessageLoopTaskQueues::SetWakeable(TaskQueueId queue_id,
                                         fml::Wakeable* wakeable) {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
   FML_CHECK(!queue_entries_.at(queue_id)->wakeable)
       << "Wakeable can only be set once.";
   queue_entries_.at(queue_id)->wakeable = wakeable;
 }
 
+void MessageLoopTaskQueues::SetIdleDeadline(TaskQueueId queue_id,
+                                            fml::TimePoint deadline) {
+  fml::SharedLock meta_lock(*queue_meta_mutex_);
+  MergedQueuesLock queues_lock(*this, queue_id);
+  queue_entries_.at(queue_id)->idle_deadline = deadline;
+  // Idle tasks that were waiting for an idle period may run now.
+  if (!queue_entries_.at(queue_id)
+           ->delayed_tasks[static_cast<size_t>(TaskPriority::kIdle)]
+           .empty()) {
+    WakeUpOwnerUnlocked(queue_id);
+  }
+}
+
 bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   if (owner == subsumed) {
     return true;
   }
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   auto& owner_entry = queue_entries_.at(owner);
   auto& subsumed_entry = queue_entries_.at(subsumed);
 
@@ -207,14 +320,15 @@ bool MessageLoopTaskQueues::Merge(TaskQueueId owner, TaskQueueId subsumed) {
   subsumed_entry->subsumed_by = owner;
 
   if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+    WakeUpUnlocked(owner,
+                   GetNextWakeTimeUnlocked(owner, fml::TimePoint::Now()));
   }
 
   return true;
 }
 
 bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
-  std::lock_guard guard(queue_mutex_);
+  fml::UniqueLock lock(*queue_meta_mutex_);
   const auto& owner_entry = queue_entries_.at(owner);
   const TaskQueueId subsumed = owner_entry->owner_of;
   if (subsumed == _kUnmerged) {
@@ -225,11 +339,13 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
   owner_entry->owner_of = _kUnmerged;
 
   if (HasPendingTasksUnlocked(owner)) {
-    WakeUpUnlocked(owner, GetNextWakeTimeUnlocked(owner));
+    WakeUpUnlocked(owner,
+                   GetNextWakeTimeUnlocked(owner, fml::TimePoint::Now()));
   }
 
   if (HasPendingTasksUnlocked(subsumed)) {
-    WakeUpUnlocked(subsumed, GetNextWakeTimeUnlocked(subsumed));
+    WakeUpUnlocked(subsumed,
+                   GetNextWakeTimeUnlocked(subsumed, fml::TimePoint::Now()));
   }
 
   return true;
@@ -237,7 +353,7 @@ bool MessageLoopTaskQueues::Unmerge(TaskQueueId owner) {
 
 bool MessageLoopTaskQueues::Owns(TaskQueueId owner,
                                  TaskQueueId subsumed) const {
-  std::lock_guard guard(queue_mutex_);
+  fml::SharedLock lock(*queue_meta_mutex_);
   return subsumed == queue_entries_.at(owner)->owner_of;
 }
 
@@ -251,7 +367,7 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     return false;
   }
 
-  if (!entry->delayed_tasks.empty()) {
+  if (GetNumTasks(*entry) > 0) {
     return true;
   }
 
@@ -260,47 +376,67 @@ bool MessageLoopTaskQueues::HasPendingTasksUnlocked(
     // this is not an owner and queue is empty.
     return false;
   } else {
-    return !queue_entries_.at(subsumed)->delayed_tasks.empty();
+    return GetNumTasks(*queue_entries_.at(subsumed)) > 0;
   }
 }
 
 fml::TimePoint MessageLoopTaskQueues::GetNextWakeTimeUnlocked(
-    TaskQueueId queue_id) const {
-  TaskQueueId tmp = _kUnmerged;
-  return PeekNextTaskUnlocked(queue_id, tmp).GetTargetTime();
+    TaskQueueId queue_id,
+    fml::TimePoint now) const {
+  return PeekNextTaskUnlocked(queue_id, now).run_time;
 }
 
-const DelayedTask& MessageLoopTaskQueues::PeekNextTaskUnlocked(
+MessageLoopTaskQueues::NextTask MessageLoopTaskQueues::PeekNextTaskUnlocked(
     TaskQueueId owner,
-    TaskQueueId& top_queue_id) const {
+    fml::TimePoint now) const {
   FML_DCHECK(HasPendingTasksUnlocked(owner));
-  const auto& entry = queue_entries_.at(owner);
-  const TaskQueueId subsumed = entry->owner_of;
-  if (subsumed == _kUnmerged) {
-    top_queue_id = owner;
-    return entry->delayed_tasks.top();
-  }
-
-  const auto& owner_tasks = entry->delayed_tasks;
-  const auto& subsumed_tasks = queue_entries_.at(subsumed)->delayed_tasks;
-
-  // we are owning another task queue
-  const bool subsumed_has_task = !subsumed_tasks.empty();
-  const bool owner_has_task = !owner_tasks.empty();
-  if (owner_has_task && subsumed_has_task) {
-    const auto owner_task = owner_tasks.top();
-    const auto subsumed_task = subsumed_tasks.top();
-    if (owner_task > subsumed_task) {
-      top_queue_id = subsumed;
-    } else {
-      top_queue_id = owner;
+  NextTask next;
+  // The best task that can run now, and the task that can run the soonest if
+  // none can.
+  const DelayedTask* next_task = nullptr;
+  int next_rank = 0;
+  bool next_can_run = false;
+
+  const TaskQueueId queue_ids[] = {owner, queue_entries_.at(owner)->owner_of};
+  for (TaskQueueId queue_id : queue_ids) {
+    if (queue_id == _kUnmerged) {
+      continue;
+    }
+    const auto& entry = queue_entries_.at(queue_id);
+    for (size_t i = 0; i < kTaskPriorityCount; i++) {
+      const auto& tasks = entry->delayed_tasks[i];
+      if (tasks.empty()) {
+        continue;
+      }
+      const auto priority = static_cast<TaskPriority>(i);
+      const DelayedTask& task = tasks.top();
+      const fml::TimePoint run_time = GetRunTime(task, priority, *entry, now);
+      const bool can_run = run_time <= now;
+      const int rank = GetRank(task, priority, now);
+
+      bool is_next;
+      if (!next_task) {
+        is_next = true;
+      } else if (can_run != next_can_run) {
+        is_next = can_run;
+      } else if (can_run) {
+        is_next = rank < next_rank ||
+                  (rank == next_rank && *next_task > task);
+      } else {
+        is_next = run_time < next.run_time;
+      }
+
+      if (is_next) {
+        next_task = &task;
+        next_rank = rank;
+        next_can_run = can_run;
+        next.queue_id = queue_id;
+        next.priority = priority;
+        next.run_time = run_time;
+      }
     }
-  } else if (owner_has_task) {
-    top_queue_id = owner;
-  } else {
-    top_queue_id = subsumed;
   }
-  return queue_entries_.at(top_queue_id)->delayed_tasks.top();
+  return next;
 }
 
 }  // namespace fml
@@ -5,7 +5,9 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 #define FLUTTER_FML_MESSAGE_LOOP_TASK_QUEUES_H_
 
+#include <array>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -39,7 +41,11 @@ class TaskQueueEntry {
   using TaskObservers = std::map<intptr_t, fml::closure>;
   Wakeable* wakeable;
   TaskObservers task_observers;
-  DelayedTaskQueue delayed_tasks;
+  // Indexed by |TaskPriority|.
+  std::array<DelayedTaskQueue, kTaskPriorityCount> delayed_tasks;
+  // The end of the current idle period of the queue. Idle priority tasks only
+  // run before it.
+  fml::TimePoint idle_deadline;
 
   // Note: Both of these can be _kUnmerged, which indicates that
   // this queue has not been merged or subsumed. OR exactly one
@@ -48,6 +54,11 @@ class TaskQueueEntry {
   TaskQueueId owner_of;
   TaskQueueId subsumed_by;
 
+  // Guards the tasks, observers and wakeable of this queue. The merge state
+  // (|owner_of| and |subsumed_by|) is guarded by the queue meta mutex of
+  // |MessageLoopTaskQueues| instead.
+  std::mutex mutex;
+
   TaskQueueEntry();
 
  private:
@@ -79,10 +90,17 @@ class MessageLoopTaskQueues
 
   void RegisterTask(TaskQueueId queue_id,
                     const fml::closure& task,
-                    fml::TimePoint target_time);
+                    fml::TimePoint target_time,
+                    TaskPriority priority = TaskPriority::kNormal);
 
   bool HasPendingTasks(TaskQueueId queue_id) const;
 
+  // Returns the task to run at |from_time|, if any. Of the tasks whose target
+  // time has been reached, frame critical tasks run first, then normal tasks,
+  // then idle tasks if the queue is in an idle period. To avoid starving them,
+  // normal tasks that have been waiting for more than 100 milliseconds run
+  // alongside frame critical tasks, and idle tasks that have been waiting for
+  // more than a second run outside of idle periods.
   fml::closure GetNextTaskToRun(TaskQueueId queue_id, fml::TimePoint from_time);
 
   size_t GetNumPendingTasks(TaskQueueId queue_id) const;
@@ -101,6 +119,10 @@ class MessageLoopTaskQueues
 
   void SetWakeable(TaskQueueId queue_id, fml::Wakeable* wakeable);
 
+  // Starts an idle period that ends at |deadline| on the given queue. Idle
+  // priority tasks registered on the queue may run until then.
+  void SetIdleDeadline(TaskQueueId queue_id, fml::TimePoint deadline);
+
   // Invariants for merge and un-merge
   //  1. RegisterTask will always submit to the queue_id that is passed
   //     to it. It is not aware of whether a queue is merged or not. Same with
@@ -111,6 +133,14 @@ class MessageLoopTaskQueues
   //
   //  Methods currently aware of the merged state of the queues:
   //  HasPendingTasks, GetNextTaskToRun, GetNumPendingTasks
+  //
+  // Locking:
+  //  Operations on the tasks and observers of a queue hold a shared lock on
+  //  the queue meta mutex plus the mutex of the queue itself (and of the
+  //  queue it is merged with, if any), so operations on unrelated queues do
+  //  not contend with each other. Creating, disposing, merging and unmerging
+  //  queues take the queue meta mutex exclusively, which keeps the merge
+  //  state stable for the duration of every other operation.
 
   // This method returns false if either the owner or subsumed has already been
   // merged with something else.
@@ -123,7 +153,15 @@ class MessageLoopTaskQueues
   bool Owns(TaskQueueId owner, TaskQueueId subsumed) const;
 
  private:
-  class MergedQueuesRunner;
+  class MergedQueuesLock;
+
+  // Identifies the task that should run next on a queue.
+  struct NextTask {
+    TaskQueueId queue_id = _kUnmerged;
+    TaskPriority priority = TaskPriority::kNormal;
+    // When the task can run.
+    fml::TimePoint run_time = fml::TimePoint::Max();
+  };
 
   MessageLoopTaskQueues();
 
@@ -133,15 +171,17 @@ class MessageLoopTaskQueues
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
 
-  const DelayedTask& PeekNextTaskUnlocked(TaskQueueId owner,
-                                          TaskQueueId& top_queue_id) const;
+  NextTask PeekNextTaskUnlocked(TaskQueueId owner, fml::TimePoint now) const;
+
+  fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id,
+                                         fml::TimePoint now) const;
 
-  fml::TimePoint GetNextWakeTimeUnlocked(TaskQueueId queue_id) const;
+  void WakeUpOwnerUnlocked(TaskQueueId queue_id) const;
 
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
+  std::unique_ptr<fml::SharedMutex> queue_meta_mutex_;
   std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
 
   size_t task_queue_id_counter_;
@@ -66,5 +66,63 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Threads post tasks to and run tasks from their own queue (or, with fewer
+// queues than threads, a queue shared with other threads). Operations on
+// distinct queues should not contend with each other.
+static void BM_RegisterAndGetTasksContended(  // NOLINT
+    benchmark::State& state) {
+  const int num_threads = state.range(0);
+  const int num_task_queues = state.range(1);
+  const int num_tasks_per_thread = 1000;
+  const fml::TimePoint past = fml::TimePoint::Now();
+
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  std::vector<TaskQueueId> queue_ids;
+  for (int i = 0; i < num_task_queues; i++) {
+    queue_ids.push_back(task_queue->CreateTaskQueue());
+  }
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    CountDownLatch threads_started(num_threads);
+
+    for (int i = 0; i < num_threads; i++) {
+      threads.emplace_back([queue_id = queue_ids[i % num_task_queues],
+                            &task_queue, past, &threads_started]() {
+        threads_started.CountDown();
+        threads_started.Wait();
+        for (int j = 0; j < num_tasks_per_thread; j++) {
+          task_queue->RegisterTask(
+              queue_id, [] {}, past);
+          if (task_queue->HasPendingTasks(queue_id)) {
+            task_queue->GetNextTaskToRun(queue_id, fml::TimePoint::Now());
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  for (auto queue_id : queue_ids) {
+    task_queue->Dispose(queue_id);
+  }
+
+  state.SetItemsProcessed(state.iterations() * num_threads *
+                          num_tasks_per_thread);
+}
+
+BENCHMARK(BM_RegisterAndGetTasksContended)
+    ->ArgNames({"threads", "queues"})
+    ->Args({1, 1})
+    ->Args({4, 1})
+    ->Args({4, 4})
+    ->Args({8, 1})
+    ->Args({8, 8})
+    ->Args({16, 16})
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
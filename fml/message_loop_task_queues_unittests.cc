@@ -283,5 +283,134 @@ TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   ASSERT_EQ(time1, wakes[2]);
 }
 
+TEST(MessageLoopTaskQueue, FrameCriticalTasksRunFirst) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  std::vector<int> order;
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, [&order]() { order.push_back(1); }, now);
+  task_queue->RegisterTask(
+      queue_id, [&order]() { order.push_back(2); }, now,
+      fml::TaskPriority::kFrameCritical);
+  task_queue->RegisterTask(
+      queue_id, [&order]() { order.push_back(3); }, now);
+
+  for (;;) {
+    fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+    if (!invocation) {
+      break;
+    }
+    invocation();
+  }
+  ASSERT_EQ(order, (std::vector<int>{2, 1, 3}));
+}
+
+TEST(MessageLoopTaskQueue, FrameCriticalTasksWaitForTheirTargetTime) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  int test_val = 0;
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 1; },
+      now + fml::TimeDelta::FromMilliseconds(10),
+      fml::TaskPriority::kFrameCritical);
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 2; }, now);
+
+  fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+  ASSERT_TRUE(invocation);
+  invocation();
+  ASSERT_EQ(test_val, 2);
+  ASSERT_FALSE(task_queue->GetNextTaskToRun(queue_id, now));
+}
+
+TEST(MessageLoopTaskQueue, NormalTasksAreNotStarvedByFrameCriticalTasks) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  int test_val = 0;
+
+  const auto now = fml::TimePoint::Now();
+  const auto long_ago = now - fml::TimeDelta::FromSeconds(1);
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 1; }, long_ago);
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 2; }, now,
+      fml::TaskPriority::kFrameCritical);
+
+  fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+  ASSERT_TRUE(invocation);
+  invocation();
+  ASSERT_EQ(test_val, 1);
+}
+
+TEST(MessageLoopTaskQueue, IdleTasksOnlyRunDuringIdlePeriods) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  int test_val = 0;
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 1; }, now,
+      fml::TaskPriority::kIdle);
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 2; }, now);
+
+  fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+  ASSERT_TRUE(invocation);
+  invocation();
+  ASSERT_EQ(test_val, 2);
+  ASSERT_FALSE(task_queue->GetNextTaskToRun(queue_id, now));
+  ASSERT_TRUE(task_queue->HasPendingTasks(queue_id));
+
+  task_queue->SetIdleDeadline(queue_id,
+                              now + fml::TimeDelta::FromMilliseconds(10));
+  invocation = task_queue->GetNextTaskToRun(queue_id, now);
+  ASSERT_TRUE(invocation);
+  invocation();
+  ASSERT_EQ(test_val, 1);
+}
+
+TEST(MessageLoopTaskQueue, IdleTasksAreNotStarved) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  int test_val = 0;
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, [&test_val]() { test_val = 1; },
+      now - fml::TimeDelta::FromSeconds(2), fml::TaskPriority::kIdle);
+
+  fml::closure invocation = task_queue->GetNextTaskToRun(queue_id, now);
+  ASSERT_TRUE(invocation);
+  invocation();
+  ASSERT_EQ(test_val, 1);
+}
+
+TEST(MessageLoopTaskQueue, IdlePeriodWakesUpQueueWithIdleTasks) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto queue_id = task_queue->CreateTaskQueue();
+  std::vector<fml::TimePoint> wakes;
+
+  task_queue->SetWakeable(queue_id,
+                          new TestWakeable([&wakes](fml::TimePoint wake_time) {
+                            wakes.push_back(wake_time);
+                          }));
+
+  const auto now = fml::TimePoint::Now();
+  task_queue->RegisterTask(
+      queue_id, []() {}, now, fml::TaskPriority::kIdle);
+  ASSERT_EQ(1UL, wakes.size());
+  // Not before the task may run outside of an idle period.
+  ASSERT_GT(wakes[0], now);
+
+  task_queue->SetIdleDeadline(queue_id,
+                              now + fml::TimeDelta::FromMilliseconds(10));
+  ASSERT_EQ(2UL, wakes.size());
+  ASSERT_EQ(now, wakes[1]);
+}
+
 }  // namespace testing
 }  // namespace fml
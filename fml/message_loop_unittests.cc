@@ -6,8 +6,10 @@
 
 #include "flutter/fml/message_loop.h"
 
+#include <atomic>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/concurrent_message_loop.h"
@@ -316,3 +318,91 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsTasksPostedFromWorkers) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  auto task_runner = loop->GetTaskRunner();
+  const size_t kCount = 2000;
+  // The posting task counts down too so that the loop outlives its posts.
+  fml::CountDownLatch latch(kCount + 1);
+  std::atomic<size_t> run_count = 0;
+  task_runner->PostTask([&]() {
+    // More tasks than fit in the queue of the worker.
+    for (size_t i = 0; i < kCount; ++i) {
+      task_runner->PostTask([&]() {
+        ++run_count;
+        latch.CountDown();
+      });
+    }
+    latch.CountDown();
+  });
+  latch.Wait();
+  ASSERT_EQ(run_count, kCount);
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsThreadTasksWhileBusy) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<bool> keep_busy = true;
+  fml::CountDownLatch busy_tasks_done(2);
+  // Keeps the workers busy with tasks that repost themselves.
+  std::function<void()> busy_task = [&]() {
+    if (keep_busy) {
+      task_runner->PostTask(busy_task);
+    } else {
+      busy_tasks_done.CountDown();
+    }
+  };
+  task_runner->PostTask(busy_task);
+  task_runner->PostTask(busy_task);
+
+  fml::CountDownLatch latch(loop->GetWorkerCount());
+  loop->PostTaskToAllWorkers([&]() { latch.CountDown(); });
+  latch.Wait();
+  keep_busy = false;
+  busy_tasks_done.Wait();
+
+  // Make sure no worker is still posting a task (and holding a reference to
+  // the loop) before the loop is collected on this thread.
+  fml::CountDownLatch idle_latch(loop->GetWorkerCount());
+  loop->PostTaskToAllWorkers([&]() { idle_latch.CountDown(); });
+  idle_latch.Wait();
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopParallelForRunsEveryIndexOnce) {
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  const size_t kCount = 1000;
+  std::vector<std::atomic<int>> counts(kCount);
+  loop->ParallelFor(kCount, [&](size_t index) { ++counts[index]; });
+  for (size_t i = 0; i < kCount; ++i) {
+    ASSERT_EQ(counts[i], 1);
+  }
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopParallelForCanBeNested) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  std::atomic<size_t> run_count = 0;
+  fml::AutoResetWaitableEvent done;
+  task_runner->PostTask([&]() {
+    task_runner->ParallelFor(8, [&](size_t) {
+      task_runner->ParallelFor(8, [&](size_t) { ++run_count; });
+    });
+    done.Signal();
+  });
+  done.Wait();
+  ASSERT_EQ(run_count, 64u);
+}
+
+TEST(MessageLoop, ConcurrentTaskRunnerParallelForRunsInlineWhenLoopIsDead) {
+  auto loop = fml::ConcurrentMessageLoop::Create(2);
+  auto task_runner = loop->GetTaskRunner();
+  loop.reset();
+  const auto thread_id = std::this_thread::get_id();
+  size_t run_count = 0;
+  task_runner->ParallelFor(4, [&](size_t) {
+    ASSERT_EQ(std::this_thread::get_id(), thread_id);
+    ++run_count;
+  });
+  ASSERT_EQ(run_count, 4u);
+}
@@ -35,6 +35,21 @@ void TaskRunner::PostDelayedTask(const fml::closure& task,
   loop_->PostTask(task, fml::TimePoint::Now() + delay);
 }
 
+void TaskRunner::PostTaskWithPriority(const fml::closure& task,
+                                      TaskPriority priority) {
+  PostTaskForTimeWithPriority(task, fml::TimePoint::Now(), priority);
+}
+
+void TaskRunner::PostTaskForTimeWithPriority(const fml::closure& task,
+                                             fml::TimePoint target_time,
+                                             TaskPriority priority) {
+  if (!loop_ || priority == TaskPriority::kNormal) {
+    PostTaskForTime(task, target_time);
+    return;
+  }
+  loop_->PostTask(task, target_time, priority);
+}
+
 TaskQueueId TaskRunner::GetTaskQueueId() {
   FML_DCHECK(loop_);
   return loop_->GetTaskQueueId();
@@ -6,6 +6,7 @@
 #define FLUTTER_FML_TASK_RUNNER_H_
 
 #include "flutter/fml/closure.h"
+#include "flutter/fml/delayed_task.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
@@ -33,6 +34,18 @@ class TaskRunner : public fml::RefCountedThreadSafe<TaskRunner>,
 
   virtual void PostDelayedTask(const fml::closure& task, fml::TimeDelta delay);
 
+  // Posts a task with the given priority, see |TaskPriority|. Task runners
+  // that are not backed by an |fml::MessageLoop|, such as the ones provided by
+  // embedders, ignore the priority.
+  void PostTaskWithPriority(const fml::closure& task, TaskPriority priority);
+
+  // Tasks of normal priority are posted through |PostTaskForTime|. Subclasses
+  // that override |PostTaskForTime| must override this as well to handle the
+  // other priorities.
+  virtual void PostTaskForTimeWithPriority(const fml::closure& task,
+                                           fml::TimePoint target_time,
+                                           TaskPriority priority);
+
   virtual bool RunsTasksOnCurrentThread();
 
   virtual TaskQueueId GetTaskQueueId();
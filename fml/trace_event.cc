@@ -6,6 +6,8 @@
 
 #include <algorithm>
 #include <atomic>
+#include <charconv>
+#include <cstdio>
 #include <utility>
 
 #include "flutter/fml/ascii_trie.h"
@@ -15,6 +17,30 @@
 namespace fml {
 namespace tracing {
 
+const char* TraceValue::Format(char (&buffer)[kFormatBufferSize]) const {
+  switch (type_) {
+    case Type::kString:
+      return string_;
+    case Type::kSigned:
+      *std::to_chars(buffer, buffer + kFormatBufferSize - 1, signed_).ptr =
+          '\0';
+      return buffer;
+    case Type::kUnsigned:
+      *std::to_chars(buffer, buffer + kFormatBufferSize - 1, unsigned_).ptr =
+          '\0';
+      return buffer;
+    case Type::kDouble: {
+      int length = snprintf(buffer, kFormatBufferSize, "%f", double_);
+      // Only very large magnitudes do not fit the fixed notation.
+      if (length < 0 || static_cast<size_t>(length) >= kFormatBufferSize) {
+        snprintf(buffer, kFormatBufferSize, "%g", double_);
+      }
+      return buffer;
+    }
+  }
+  return "";
+}
+
 #if FLUTTER_TIMELINE_ENABLED
 
 namespace {
@@ -48,25 +74,30 @@ void TraceTimelineEvent(TraceArg category_group,
                         int64_t timestamp_micros,
                         TraceIDArg identifier,
                         Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {
-  const auto argument_count = std::min(c_names.size(), values.size());
+                        size_t argument_count,
+                        const char* const* names,
+                        const TraceValue* values) {
+  // Numbers are only formatted for the events that are recorded.
+  if (!gAllowlist.Query(name)) {
+    return;
+  }
 
-  std::vector<const char*> c_values;
-  c_values.resize(argument_count, nullptr);
+  FML_DCHECK(argument_count <= kTraceMaxArguments);
+  argument_count = std::min(argument_count, kTraceMaxArguments);
 
+  char buffers[kTraceMaxArguments][TraceValue::kFormatBufferSize];
+  const char* c_values[kTraceMaxArguments];
   for (size_t i = 0; i < argument_count; i++) {
-    c_values[i] = values[i].c_str();
+    c_values[i] = values[i].Format(buffers[i]);
   }
 
-  FlutterTimelineEvent(
-      name,                                      // label
-      timestamp_micros,                          // timestamp0
-      identifier,                                // timestamp1_or_async_id
-      type,                                      // event type
-      argument_count,                            // argument_count
-      const_cast<const char**>(c_names.data()),  // argument_names
-      c_values.data()                            // argument_values
+  Dart_TimelineEvent(name,                             // label
+                     timestamp_micros,                 // timestamp0
+                     identifier,                       // timestamp1_or_async_id
+                     type,                             // event type
+                     argument_count,                   // argument_count
+                     const_cast<const char**>(names),  // argument_names
+                     c_values                          // argument_values
   );
 }
 
@@ -74,14 +105,16 @@ void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         TraceIDArg identifier,
                         Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {
+                        size_t argument_count,
+                        const char* const* names,
+                        const TraceValue* values) {
   TraceTimelineEvent(category_group,            // group
                      name,                      // name
                      Dart_TimelineGetMicros(),  // timestamp_micros
                      identifier,                // identifier
                      type,                      // type
-                     c_names,                   // names
+                     argument_count,            // argument_count
+                     names,                     // names
                      values                     // values
   );
 }
@@ -297,15 +330,17 @@ void TraceTimelineEvent(TraceArg category_group,
                         int64_t timestamp_micros,
                         TraceIDArg identifier,
                         Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
+                        size_t argument_count,
+                        const char* const* names,
+                        const TraceValue* values) {}
 
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         TraceIDArg identifier,
                         Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& c_names,
-                        const std::vector<std::string>& values) {}
+                        size_t argument_count,
+                        const char* const* names,
+                        const TraceValue* values) {}
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {}
 
@@ -145,65 +145,116 @@ using TraceIDArg = int64_t;
 
 void TraceSetAllowlist(const std::vector<std::string>& allowlist);
 
+// The maximum number of arguments of a trace event.
+constexpr size_t kTraceMaxArguments = 8;
+
+// The value of a trace event argument. Strings are referenced rather than
+// copied, and numbers are only formatted once the event is known to be
+// recorded.
+class TraceValue {
+ public:
+  // The size of the buffer numbers are formatted into.
+  static constexpr size_t kFormatBufferSize = 32;
+
+  TraceValue() : TraceValue("") {}
+
+  TraceValue(const char* string) : type_(Type::kString), string_(string) {}
+
+  TraceValue(const std::string& string) : TraceValue(string.c_str()) {}
+
+  TraceValue(TimePoint point)
+      : type_(Type::kSigned),
+        signed_(point.ToEpochDelta().ToNanoseconds()) {}
+
+  template <typename T,
+            typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+  TraceValue(T value) {
+    if constexpr (std::is_floating_point<T>::value) {
+      type_ = Type::kDouble;
+      double_ = value;
+    } else if constexpr (std::is_signed<T>::value) {
+      type_ = Type::kSigned;
+      signed_ = value;
+    } else {
+      type_ = Type::kUnsigned;
+      unsigned_ = value;
+    }
+  }
+
+  // Returns the value as a C string. Numbers are formatted into |buffer|, in
+  // the same format as std::to_string.
+  const char* Format(char (&buffer)[kFormatBufferSize]) const;
+
+ private:
+  enum class Type { kString, kSigned, kUnsigned, kDouble };
+
+  Type type_;
+  union {
+    const char* string_;
+    int64_t signed_;
+    uint64_t unsigned_;
+    double double_;
+  };
+};
+
+// The names and values of the arguments of a trace event, stored inline. |N|
+// is the number of name/value pairs.
+template <size_t N>
+class TraceArguments {
+ public:
+  static_assert(N <= kTraceMaxArguments, "Too many trace event arguments.");
+
+  template <typename... Args>
+  explicit TraceArguments(const Args&... args) {
+    static_assert(sizeof...(Args) == 2 * N,
+                  "Trace event arguments must be name/value pairs.");
+    Collect(0, args...);
+  }
+
+  size_t count() const { return N; }
+
+  const char* const* names() const { return names_; }
+
+  const TraceValue* values() const { return values_; }
+
+ private:
+  const char* names_[N > 0 ? N : 1] = {};
+  TraceValue values_[N > 0 ? N : 1];
+
+  void Collect(size_t index) {}
+
+  template <typename Key, typename Value, typename... Args>
+  void Collect(size_t index,
+               const Key& key,
+               const Value& value,
+               const Args&... args) {
+    names_[index] = key;
+    values_[index] = TraceValue(value);
+    Collect(index + 1, args...);
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TraceArguments);
+};
+
+template <typename... Args>
+TraceArguments(const Args&... args) -> TraceArguments<sizeof...(Args) / 2>;
+
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         int64_t timestamp_micros,
                         TraceIDArg id,
                         Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& names,
-                        const std::vector<std::string>& values);
+                        size_t argument_count,
+                        const char* const* names,
+                        const TraceValue* values);
 
 void TraceTimelineEvent(TraceArg category_group,
                         TraceArg name,
                         TraceIDArg id,
                         Dart_Timeline_Event_Type type,
-                        const std::vector<const char*>& names,
-                        const std::vector<std::string>& values);
-
-inline std::string TraceToString(const char* string) {
-  return std::string{string};
-}
-
-inline std::string TraceToString(std::string string) {
-  return string;
-}
-
-inline std::string TraceToString(TimePoint point) {
-  return std::to_string(point.ToEpochDelta().ToNanoseconds());
-}
-
-template <typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
-std::string TraceToString(T string) {
-  return std::to_string(string);
-}
-
-inline void SplitArgumentsCollect(std::vector<const char*>& keys,
-                                  std::vector<std::string>& values) {}
-
-template <typename Key, typename Value, typename... Args>
-void SplitArgumentsCollect(std::vector<const char*>& keys,
-                           std::vector<std::string>& values,
-                           Key key,
-                           Value value,
-                           Args... args) {
-  keys.emplace_back(key);
-  values.emplace_back(TraceToString(value));
-  SplitArgumentsCollect(keys, values, args...);
-}
-
-inline std::pair<std::vector<const char*>, std::vector<std::string>>
-SplitArguments() {
-  return {};
-}
-
-template <typename Key, typename Value, typename... Args>
-std::pair<std::vector<const char*>, std::vector<std::string>>
-SplitArguments(Key key, Value value, Args... args) {
-  std::vector<const char*> keys;
-  std::vector<std::string> values;
-  SplitArgumentsCollect(keys, values, key, value, args...);
-  return std::make_pair(std::move(keys), std::move(values));
-}
+                        size_t argument_count,
+                        const char* const* names,
+                        const TraceValue* values);
 
 size_t TraceNonce();
 
@@ -211,11 +262,11 @@ template <typename... Args>
 void TraceCounter(TraceArg category,
                   TraceArg name,
                   TraceIDArg identifier,
-                  Args... args) {
+                  const Args&... args) {
 #if FLUTTER_TIMELINE_ENABLED
-  auto split = SplitArguments(args...);
+  TraceArguments arguments(args...);
   TraceTimelineEvent(category, name, identifier, Dart_Timeline_Event_Counter,
-                     split.first, split.second);
+                     arguments.count(), arguments.names(), arguments.values());
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
 
@@ -228,11 +279,11 @@ void TraceCounterNopHACK(TraceArg category,
                          Args... args) {}
 
 template <typename... Args>
-void TraceEvent(TraceArg category, TraceArg name, Args... args) {
+void TraceEvent(TraceArg category, TraceArg name, const Args&... args) {
 #if FLUTTER_TIMELINE_ENABLED
-  auto split = SplitArguments(args...);
-  TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin, split.first,
-                     split.second);
+  TraceArguments arguments(args...);
+  TraceTimelineEvent(category, name, 0, Dart_Timeline_Event_Begin,
+                     arguments.count(), arguments.names(), arguments.values());
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
 
@@ -257,10 +308,10 @@ void TraceEventAsyncComplete(TraceArg category_group,
                              TraceArg name,
                              TimePoint begin,
                              TimePoint end,
-                             Args... args) {
+                             const Args&... args) {
 #if FLUTTER_TIMELINE_ENABLED
   auto identifier = TraceNonce();
-  const auto split = SplitArguments(args...);
+  TraceArguments arguments(args...);
 
   if (begin > end) {
     std::swap(begin, end);
@@ -274,8 +325,9 @@ void TraceEventAsyncComplete(TraceArg category_group,
                      begin_micros,                     // timestamp_micros
                      identifier,                       // identifier
                      Dart_Timeline_Event_Async_Begin,  // type
-                     split.first,                      // names
-                     split.second                      // values
+                     arguments.count(),                // argument_count
+                     arguments.names(),                // names
+                     arguments.values()                // values
   );
 
   TraceTimelineEvent(category_group,                 // group
@@ -283,8 +335,9 @@ void TraceEventAsyncComplete(TraceArg category_group,
                      end_micros,                     // timestamp_micros
                      identifier,                     // identifier
                      Dart_Timeline_Event_Async_End,  // type
-                     split.first,                    // names
-                     split.second                    // values
+                     arguments.count(),              // argument_count
+                     arguments.names(),              // names
+                     arguments.values()              // values
   );
 #endif  // FLUTTER_TIMELINE_ENABLED
 }
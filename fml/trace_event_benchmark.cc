@@ -0,0 +1,67 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_event.h"
+
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+
+namespace fml {
+namespace benchmarking {
+
+// The overhead of a trace event at the call site, with the timeline not
+// recording. This is what every instrumented frame pays.
+
+static void BM_TraceEventWithoutArguments(
+    benchmark::State& state) {  // NOLINT
+  while (state.KeepRunning()) {
+    TRACE_EVENT0("flutter", "BM_TraceEvent");
+  }
+}
+
+static void BM_TraceEventWithNumericArguments(
+    benchmark::State& state) {  // NOLINT
+  int64_t count = 0;
+  while (state.KeepRunning()) {
+    FML_TRACE_EVENT("flutter", "BM_TraceEvent", "Count", ++count, "Ratio",
+                    0.5);
+  }
+}
+
+static void BM_TraceEventWithStringArguments(
+    benchmark::State& state) {  // NOLINT
+  const std::string path = "assets/fonts/Roboto-Regular.ttf";
+  while (state.KeepRunning()) {
+    FML_TRACE_EVENT("flutter", "BM_TraceEvent", "Path", path, "Kind", "font");
+  }
+}
+
+static void BM_TraceCounter(benchmark::State& state) {  // NOLINT
+  int64_t count = 0;
+  while (state.KeepRunning()) {
+    FML_TRACE_COUNTER("flutter", "BM_TraceCounter", 0, "Count", ++count,
+                      "Bytes", count * 4);
+  }
+}
+
+// The cost of formatting the arguments of an event that is recorded.
+static void BM_TraceValueFormat(benchmark::State& state) {  // NOLINT
+  const fml::tracing::TraceValue values[] = {int64_t{1} << 40, 0.5, "font"};
+  char buffer[fml::tracing::TraceValue::kFormatBufferSize];
+  while (state.KeepRunning()) {
+    for (const auto& value : values) {
+      benchmark::DoNotOptimize(value.Format(buffer));
+    }
+  }
+}
+
+BENCHMARK(BM_TraceEventWithoutArguments);
+BENCHMARK(BM_TraceEventWithNumericArguments);
+BENCHMARK(BM_TraceEventWithStringArguments);
+BENCHMARK(BM_TraceCounter);
+BENCHMARK(BM_TraceValueFormat);
+
+}  // namespace benchmarking
+}  // namespace fml
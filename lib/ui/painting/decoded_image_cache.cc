@@ -0,0 +1,183 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <iterator>
+#include <string_view>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+// The number of bytes hashed at the start, the middle and the end of the
+// encoded data. Encoded images of the same size almost always differ in their
+// headers or in the first rows of their compressed contents.
+static constexpr size_t kHashedSampleBytes = 4096;
+
+static size_t HashBytes(const SkData& data, size_t offset, size_t size) {
+  return std::hash<std::string_view>{}(std::string_view(
+      static_cast<const char*>(data.data()) + offset, size));
+}
+
+bool DecodedImageCache::Key::operator==(const Key& other) const {
+  if (content_hash != other.content_hash ||
+      target_width != other.target_width ||
+      target_height != other.target_height ||
+      unref_queue != other.unref_queue) {
+    return false;
+  }
+  if (data == other.data) {
+    return true;
+  }
+  return data && other.data && data->equals(other.data.get());
+}
+
+size_t DecodedImageCache::Key::Hash::operator()(const Key& key) const {
+  return fml::HashCombine(key.content_hash, key.target_width,
+                          key.target_height, key.unref_queue);
+}
+
+DecodedImageCache* DecodedImageCache::GetCacheForProcess() {
+  static DecodedImageCache* cache = new DecodedImageCache();
+  return cache;
+}
+
+DecodedImageCache::Key DecodedImageCache::MakeKey(
+    sk_sp<SkData> data,
+    uint32_t target_width,
+    uint32_t target_height,
+    const SkiaUnrefQueue* unref_queue) {
+  Key key;
+  const size_t size = data ? data->size() : 0;
+  if (size == 0) {
+    key.content_hash = 0;
+  } else if (size <= 3 * kHashedSampleBytes) {
+    key.content_hash = fml::HashCombine(size, HashBytes(*data, 0, size));
+  } else {
+    key.content_hash = fml::HashCombine(
+        size, HashBytes(*data, 0, kHashedSampleBytes),
+        HashBytes(*data, (size - kHashedSampleBytes) / 2, kHashedSampleBytes),
+        HashBytes(*data, size - kHashedSampleBytes, kHashedSampleBytes));
+  }
+  key.data = std::move(data);
+  key.target_width = target_width;
+  key.target_height = target_height;
+  key.unref_queue = unref_queue;
+  return key;
+}
+
+DecodedImageCache::DecodedImageCache(size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+DecodedImageCache::~DecodedImageCache() {
+  Clear();
+}
+
+bool DecodedImageCache::IsEnabled() const {
+  std::scoped_lock lock(mutex_);
+  return max_bytes_ > 0;
+}
+
+sk_sp<SkImage> DecodedImageCache::Get(const Key& key) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->image;
+}
+
+void DecodedImageCache::Put(const Key& key,
+                            sk_sp<SkImage> image,
+                            fml::RefPtr<SkiaUnrefQueue> unref_queue) {
+  if (!image || !key.data) {
+    return;
+  }
+  FML_DCHECK(key.unref_queue == unref_queue.get());
+  FML_DCHECK(image->isTextureBacked() == (unref_queue.get() != nullptr));
+
+  const size_t bytes =
+      image->imageInfo().computeMinByteSize() + key.data->size();
+
+  std::scoped_lock lock(mutex_);
+  if (bytes > max_bytes_) {
+    return;
+  }
+
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    // Another decoder decoded the same image concurrently.
+    EraseLocked(found->second);
+  }
+
+  EvictLocked(max_bytes_ - bytes);
+  entries_.push_front({key, std::move(image), std::move(unref_queue), bytes});
+  index_[key] = entries_.begin();
+  bytes_ += bytes;
+}
+
+void DecodedImageCache::RemoveImages(const SkiaUnrefQueue* unref_queue) {
+  std::scoped_lock lock(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    auto next = std::next(it);
+    if (it->key.unref_queue == unref_queue) {
+      EraseLocked(it);
+    }
+    it = next;
+  }
+}
+
+void DecodedImageCache::SetMaxBytes(size_t max_bytes) {
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+  EvictLocked(max_bytes_);
+}
+
+size_t DecodedImageCache::max_bytes() const {
+  std::scoped_lock lock(mutex_);
+  return max_bytes_;
+}
+
+void DecodedImageCache::Clear() {
+  std::scoped_lock lock(mutex_);
+  while (!entries_.empty()) {
+    EraseLocked(entries_.begin());
+  }
+}
+
+DecodedImageCache::Stats DecodedImageCache::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  Stats stats;
+  stats.entry_count = entries_.size();
+  stats.bytes = bytes_;
+  stats.max_bytes = max_bytes_;
+  stats.hit_count = hit_count_;
+  stats.miss_count = miss_count_;
+  stats.eviction_count = eviction_count_;
+  return stats;
+}
+
+void DecodedImageCache::EraseLocked(std::list<Entry>::iterator entry) {
+  bytes_ -= entry->bytes;
+  if (entry->unref_queue) {
+    // Textures must be released on the thread of their resource context.
+    entry->unref_queue->Unref(entry->image.release());
+  }
+  index_.erase(entry->key);
+  entries_.erase(entry);
+}
+
+void DecodedImageCache::EvictLocked(size_t max_bytes) {
+  while (bytes_ > max_bytes && !entries_.empty()) {
+    EraseLocked(std::prev(entries_.end()));
+    eviction_count_++;
+  }
+}
+
+}  // namespace flutter
@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/flow/skia_gpu_object.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+
+namespace flutter {
+
+/// A cache of decoded (and resized) images, keyed by the contents of the
+/// encoded image and the target size it was decoded at.
+///
+/// The cache for the process is shared by the image decoders of all engines,
+/// so that decoding the same bytes to the same size in several engines, or
+/// several times in one engine, only decodes once. It is thread-safe. Once
+/// the images exceed the byte budget, the least recently used images are
+/// evicted.
+///
+/// Images uploaded to the GPU are cached as the uploaded textures, so no
+/// raster copy is kept alongside them. Since textures can only be used by the
+/// resource context they were uploaded with, they are keyed by the unref
+/// queue of that context, see |Key::unref_queue|. The owner of the queue must
+/// call |RemoveImages| before the context goes away.
+class DecodedImageCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
+  struct Key {
+    /// The encoded image. Keys only match if the encoded bytes are equal.
+    sk_sp<SkData> data;
+    /// A hash of the size and of a sample of the bytes of |data|.
+    size_t content_hash = 0;
+    uint32_t target_width = 0;
+    uint32_t target_height = 0;
+    /// The unref queue of the resource context the image is uploaded with,
+    /// or null for raster images.
+    const SkiaUnrefQueue* unref_queue = nullptr;
+
+    bool operator==(const Key& other) const;
+
+    struct Hash {
+      size_t operator()(const Key& key) const;
+    };
+  };
+
+  struct Stats {
+    size_t entry_count = 0;
+    size_t bytes = 0;
+    size_t max_bytes = 0;
+    size_t hit_count = 0;
+    size_t miss_count = 0;
+    size_t eviction_count = 0;
+  };
+
+  static DecodedImageCache* GetCacheForProcess();
+
+  /// Makes the key of the encoded |data|. Only a sample of the bytes is
+  /// hashed, so this takes constant time. Lookups compare the whole bytes
+  /// of keys with equal hashes.
+  static Key MakeKey(sk_sp<SkData> data,
+                     uint32_t target_width,
+                     uint32_t target_height,
+                     const SkiaUnrefQueue* unref_queue);
+
+  explicit DecodedImageCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~DecodedImageCache();
+
+  /// Whether the budget allows caching any image. Callers can skip making
+  /// keys when it does not.
+  bool IsEnabled() const;
+
+  /// Returns the cached image for |key| and marks it as most recently used,
+  /// or nullptr.
+  sk_sp<SkImage> Get(const Key& key);
+
+  /// Caches |image| for |key|. |unref_queue| is the queue of
+  /// |Key::unref_queue|, through which the image is released once evicted.
+  /// Images that do not fit in the budget along with their encoded data are
+  /// not cached.
+  void Put(const Key& key,
+           sk_sp<SkImage> image,
+           fml::RefPtr<SkiaUnrefQueue> unref_queue);
+
+  /// Removes the images released by |unref_queue|.
+  void RemoveImages(const SkiaUnrefQueue* unref_queue);
+
+  /// Sets the byte budget and evicts images until the cache fits in it. A
+  /// budget of 0 disables the cache.
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t max_bytes() const;
+
+  void Clear();
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    Key key;
+    sk_sp<SkImage> image;
+    fml::RefPtr<SkiaUnrefQueue> unref_queue;
+    // The bytes of the image and of the encoded data held by the key.
+    size_t bytes;
+  };
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<Key, std::list<Entry>::iterator, Key::Hash> index_;
+  size_t bytes_ = 0;
+  size_t max_bytes_;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  size_t eviction_count_ = 0;
+
+  void EraseLocked(std::list<Entry>::iterator entry);
+
+  void EvictLocked(size_t max_bytes);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DecodedImageCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_DECODED_IMAGE_CACHE_H_
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
+
+#include <string>
+
+#include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace flutter {
+namespace testing {
+
+// A 10x10 N32 image takes 400 bytes.
+static sk_sp<SkImage> MakeRasterImage(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+// The encoded data of the keys is 2 bytes long.
+static DecodedImageCache::Key MakeKey(const char* content,
+                                      uint32_t target_width = 10,
+                                      uint32_t target_height = 10) {
+  return DecodedImageCache::MakeKey(SkData::MakeWithCString(content),
+                                    target_width, target_height, nullptr);
+}
+
+static void PutRasterImage(DecodedImageCache& cache,
+                           const DecodedImageCache::Key& key,
+                           sk_sp<SkImage> image) {
+  cache.Put(key, std::move(image), nullptr);
+}
+
+TEST(DecodedImageCacheTest, KeysDependOnContentsAndTargetSize) {
+  EXPECT_TRUE(MakeKey("a") == MakeKey("a"));
+  EXPECT_FALSE(MakeKey("a") == MakeKey("b"));
+  EXPECT_FALSE(MakeKey("a", 10, 10) == MakeKey("a", 10, 20));
+  EXPECT_FALSE(MakeKey("a", 10, 10) == MakeKey("a", 20, 10));
+}
+
+TEST(DecodedImageCacheTest, KeysCompareAllBytes) {
+  // Large enough for only a sample of the bytes to be hashed.
+  std::string contents(100000, 'x');
+  auto key = DecodedImageCache::MakeKey(
+      SkData::MakeWithCopy(contents.data(), contents.size()), 10, 10, nullptr);
+  // A byte outside of the hashed samples.
+  contents[20000] = 'y';
+  auto other_key = DecodedImageCache::MakeKey(
+      SkData::MakeWithCopy(contents.data(), contents.size()), 10, 10, nullptr);
+
+  EXPECT_EQ(DecodedImageCache::Key::Hash{}(key),
+            DecodedImageCache::Key::Hash{}(other_key));
+  EXPECT_FALSE(key == other_key);
+
+  DecodedImageCache cache;
+  PutRasterImage(cache, key, MakeRasterImage(10, 10));
+  EXPECT_TRUE(cache.Get(key));
+  EXPECT_FALSE(cache.Get(other_key));
+}
+
+TEST(DecodedImageCacheTest, ZeroBudgetDisablesTheCache) {
+  DecodedImageCache cache(0);
+  EXPECT_FALSE(cache.IsEnabled());
+  PutRasterImage(cache, MakeKey("a"), MakeRasterImage(10, 10));
+  EXPECT_FALSE(cache.Get(MakeKey("a")));
+  EXPECT_EQ(cache.GetStats().entry_count, 0u);
+
+  cache.SetMaxBytes(1000);
+  EXPECT_TRUE(cache.IsEnabled());
+}
+
+TEST(DecodedImageCacheTest, ReturnsCachedImages) {
+  DecodedImageCache cache;
+  auto image = MakeRasterImage(10, 10);
+  ASSERT_FALSE(cache.Get(MakeKey("a")));
+  PutRasterImage(cache, MakeKey("a"), image);
+  ASSERT_EQ(cache.Get(MakeKey("a")).get(), image.get());
+  ASSERT_FALSE(cache.Get(MakeKey("a", 20, 20)));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.entry_count, 1u);
+  EXPECT_EQ(stats.bytes, 402u);
+  EXPECT_EQ(stats.hit_count, 1u);
+  EXPECT_EQ(stats.miss_count, 2u);
+  EXPECT_EQ(stats.eviction_count, 0u);
+}
+
+TEST(DecodedImageCacheTest, EvictsLeastRecentlyUsedImages) {
+  DecodedImageCache cache(1000);
+  PutRasterImage(cache, MakeKey("a"), MakeRasterImage(10, 10));
+  PutRasterImage(cache, MakeKey("b"), MakeRasterImage(10, 10));
+  // Makes "b" the least recently used image.
+  ASSERT_TRUE(cache.Get(MakeKey("a")));
+  PutRasterImage(cache, MakeKey("c"), MakeRasterImage(10, 10));
+
+  EXPECT_TRUE(cache.Get(MakeKey("a")));
+  EXPECT_FALSE(cache.Get(MakeKey("b")));
+  EXPECT_TRUE(cache.Get(MakeKey("c")));
+  EXPECT_EQ(cache.GetStats().bytes, 804u);
+  EXPECT_EQ(cache.GetStats().eviction_count, 1u);
+
+  cache.SetMaxBytes(402);
+  EXPECT_FALSE(cache.Get(MakeKey("a")));
+  EXPECT_TRUE(cache.Get(MakeKey("c")));
+  EXPECT_EQ(cache.GetStats().bytes, 402u);
+}
+
+TEST(DecodedImageCacheTest, DoesNotCacheImagesLargerThanBudget) {
+  DecodedImageCache cache(1000);
+  PutRasterImage(cache, MakeKey("a"), MakeRasterImage(10, 10));
+  PutRasterImage(cache, MakeKey("b"), MakeRasterImage(100, 100));
+  EXPECT_FALSE(cache.Get(MakeKey("b")));
+  EXPECT_TRUE(cache.Get(MakeKey("a")));
+}
+
+TEST(DecodedImageCacheTest, ReplacesImagesWithTheSameKey) {
+  DecodedImageCache cache;
+  PutRasterImage(cache, MakeKey("a"), MakeRasterImage(10, 10));
+  auto image = MakeRasterImage(10, 10);
+  PutRasterImage(cache, MakeKey("a"), image);
+  EXPECT_EQ(cache.Get(MakeKey("a")).get(), image.get());
+  EXPECT_EQ(cache.GetStats().entry_count, 1u);
+  EXPECT_EQ(cache.GetStats().bytes, 402u);
+}
+
+}  // namespace testing
+}  // namespace flutter
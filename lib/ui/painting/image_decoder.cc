@@ -5,9 +5,14 @@
 #include "flutter/lib/ui/painting/image_decoder.h"
 
 #include <algorithm>
+#include <cstring>
+#include <functional>
+#include <optional>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkStream.h"
 
 namespace flutter {
 
@@ -216,6 +221,104 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
   return result;
 }
 
+// On the IO thread.
+static SkiaGPUObject<SkImage> UploadDecompressedImage(
+    sk_sp<SkImage> decompressed,
+    const fml::WeakPtr<IOManager>& io_manager,
+    const fml::tracing::TraceFlow& flow) {
+  if (!io_manager) {
+    FML_LOG(ERROR) << "Could not acquire IO manager.";
+    return {};
+  }
+
+  // If the IO manager does not have a resource context, the caller might not
+  // have set one or a software backend could be in use. Either way, just
+  // return the image as-is.
+  if (!io_manager->GetResourceContext()) {
+    return {std::move(decompressed), io_manager->GetSkiaUnrefQueue()};
+  }
+
+  auto uploaded = UploadRasterImage(std::move(decompressed), io_manager, flow);
+
+  if (!uploaded.get()) {
+    FML_LOG(ERROR) << "Could not upload image to the GPU.";
+    return {};
+  }
+
+  return uploaded;
+}
+
+// Decompresses the image on a worker and uploads it on the IO thread. If
+// |cache_key| is set, the uploaded image is added to the decoded image cache.
+static void DecompressAndUpload(
+    ImageDescriptor* raw_descriptor,
+    uint32_t target_width,
+    uint32_t target_height,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& concurrent_task_runner,
+    fml::RefPtr<fml::TaskRunner> io_runner,
+    fml::WeakPtr<IOManager> io_manager,
+    std::optional<DecodedImageCache::Key> cache_key,
+    const std::function<void(SkiaGPUObject<SkImage>, fml::tracing::TraceFlow)>&
+        result,
+    fml::tracing::TraceFlow flow) {
+  concurrent_task_runner->PostTask(
+      fml::MakeCopyable([raw_descriptor,                      //
+                         io_manager = std::move(io_manager),  //
+                         io_runner = std::move(io_runner),    //
+                         result,                              //
+                         target_width = target_width,         //
+                         target_height = target_height,       //
+                         cache_key = std::move(cache_key),    //
+                         flow = std::move(flow)               //
+  ]() mutable {
+        // Step 1: Decompress the image.
+        // On Worker.
+
+        auto decompressed = raw_descriptor->is_compressed()
+                                ? ImageFromCompressedData(raw_descriptor,  //
+                                                          target_width,    //
+                                                          target_height,   //
+                                                          flow)
+                                : ImageFromDecompressedData(raw_descriptor,  //
+                                                            target_width,    //
+                                                            target_height,   //
+                                                            flow);
+
+        if (!decompressed) {
+          FML_LOG(ERROR) << "Could not decompress image.";
+          result({}, std::move(flow));
+          return;
+        }
+
+        // Step 2: Update the image to the GPU.
+        // On IO Thread.
+
+        io_runner->PostTask(fml::MakeCopyable(
+            [io_manager, decompressed, result,
+             cache_key = std::move(cache_key),
+             flow = std::move(flow)]() mutable {
+              auto uploaded = UploadDecompressedImage(std::move(decompressed),
+                                                      io_manager, flow);
+
+              // Textures are cached under the key of their resource context
+              // and raster images under the key without one. Images that are
+              // neither, such as the raster images used while the GPU is
+              // disabled, are not cached.
+              if (cache_key && uploaded.get() &&
+                  uploaded.get()->isTextureBacked() ==
+                      (cache_key->unref_queue != nullptr)) {
+                DecodedImageCache::GetCacheForProcess()->Put(
+                    *cache_key, uploaded.get(),
+                    cache_key->unref_queue ? io_manager->GetSkiaUnrefQueue()
+                                           : nullptr);
+              }
+
+              // Finally, all done.
+              result(std::move(uploaded), std::move(flow));
+            }));
+      }));
+}
+
 void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
                           uint32_t target_width,
                           uint32_t target_height,
@@ -263,72 +366,341 @@ void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
     return;
   }
 
-  concurrent_task_runner_->PostTask(
-      fml::MakeCopyable([raw_descriptor,                          //
-                         io_manager = io_manager_,                //
-                         io_runner = runners_.GetIOTaskRunner(),  //
-                         result,                                  //
-                         target_width = target_width,             //
-                         target_height = target_height,           //
-                         flow = std::move(flow)                   //
-  ]() mutable {
-        // Step 1: Decompress the image.
-        // On Worker.
-
-        auto decompressed = raw_descriptor->is_compressed()
-                                ? ImageFromCompressedData(raw_descriptor,  //
-                                                          target_width,    //
-                                                          target_height,   //
-                                                          flow)
-                                : ImageFromDecompressedData(raw_descriptor,  //
-                                                            target_width,    //
-                                                            target_height,   //
-                                                            flow);
+  auto cache = DecodedImageCache::GetCacheForProcess();
+  if (!raw_descriptor->is_compressed() || !cache->IsEnabled()) {
+    DecompressAndUpload(raw_descriptor, target_width, target_height,
+                        concurrent_task_runner_, runners_.GetIOTaskRunner(),
+                        io_manager_, std::nullopt, result, std::move(flow));
+    return;
+  }
 
-        if (!decompressed) {
-          FML_LOG(ERROR) << "Could not decompress image.";
+  // Step 0: Look for an image decoded earlier from the same data at the same
+  // target size. Uploaded images are cached per resource context, which is
+  // only accessible on the IO thread.
+  // On IO Thread.
+  runners_.GetIOTaskRunner()->PostTask(fml::MakeCopyable(
+      [raw_descriptor,                                    //
+       target_width,                                      //
+       target_height,                                     //
+       concurrent_task_runner = concurrent_task_runner_,  //
+       io_runner = runners_.GetIOTaskRunner(),            //
+       io_manager = io_manager_,                          //
+       result,                                            //
+       flow = std::move(flow)                             //
+  ]() mutable {
+        if (!io_manager) {
+          FML_LOG(ERROR) << "Could not acquire IO manager.";
           result({}, std::move(flow));
           return;
         }
 
-        // Step 2: Update the image to the GPU.
-        // On IO Thread.
+        auto unref_queue = io_manager->GetSkiaUnrefQueue();
+        auto key = DecodedImageCache::MakeKey(
+            raw_descriptor->data(), target_width, target_height,
+            io_manager->GetResourceContext() ? unref_queue.get() : nullptr);
+        if (auto image = DecodedImageCache::GetCacheForProcess()->Get(key)) {
+          flow.Step("DecodedImageCacheHit");
+          result({std::move(image), std::move(unref_queue)}, std::move(flow));
+          return;
+        }
 
-        io_runner->PostTask(fml::MakeCopyable([io_manager, decompressed, result,
-                                               flow =
-                                                   std::move(flow)]() mutable {
-          if (!io_manager) {
-            FML_LOG(ERROR) << "Could not acquire IO manager.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // If the IO manager does not have a resource context, the caller
-          // might not have set one or a software backend could be in use.
-          // Either way, just return the image as-is.
-          if (!io_manager->GetResourceContext()) {
-            result({std::move(decompressed), io_manager->GetSkiaUnrefQueue()},
-                   std::move(flow));
-            return;
-          }
-
-          auto uploaded =
-              UploadRasterImage(std::move(decompressed), io_manager, flow);
-
-          if (!uploaded.get()) {
-            FML_LOG(ERROR) << "Could not upload image to the GPU.";
-            result({}, std::move(flow));
-            return;
-          }
-
-          // Finally, all done.
-          result(std::move(uploaded), std::move(flow));
-        }));
+        DecompressAndUpload(raw_descriptor, target_width, target_height,
+                            concurrent_task_runner, std::move(io_runner),
+                            std::move(io_manager), std::move(key), result,
+                            std::move(flow));
       }));
 }
 
+std::shared_ptr<ProgressiveImageDecode> ImageDecoder::DecodeProgressively(
+    uint32_t target_width,
+    uint32_t target_height,
+    fml::TimeDelta partial_image_interval,
+    const ProgressiveImageResult& callback) {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  FML_DCHECK(callback);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  // Always service the callback on the UI thread.
+  auto result = [callback, ui_runner = runners_.GetUITaskRunner()](
+                    SkiaGPUObject<SkImage> image, bool is_complete) {
+    ui_runner->PostTask(fml::MakeCopyable(
+        [callback, image = std::move(image), is_complete]() mutable {
+          TRACE_EVENT0("flutter", "ProgressiveImageDecodeCallback");
+          callback(std::move(image), is_complete);
+        }));
+  };
+
+  return std::shared_ptr<ProgressiveImageDecode>(new ProgressiveImageDecode(
+      target_width, target_height, partial_image_interval,
+      concurrent_task_runner_, runners_.GetIOTaskRunner(), io_manager_,
+      std::move(result)));
+}
+
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
 
+class ProgressiveImageDecode::DataStream final : public SkStreamRewindable {
+ public:
+  explicit DataStream(ProgressiveImageDecode* decode) : decode_(decode) {}
+
+  // |SkStream|
+  size_t read(void* buffer, size_t size) override {
+    size_t read = decode_->ReadData(offset_, buffer, size);
+    offset_ += read;
+    return read;
+  }
+
+  // |SkStream|
+  bool isAtEnd() const override { return decode_->IsAtEnd(offset_); }
+
+  // |SkStream|
+  bool rewind() override {
+    offset_ = 0;
+    return true;
+  }
+
+ private:
+  // The decode owns the codec that owns this stream.
+  ProgressiveImageDecode* decode_;
+  size_t offset_ = 0;
+
+  // |SkStreamRewindable|
+  SkStreamRewindable* onDuplicate() const override {
+    return new DataStream(decode_);
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DataStream);
+};
+
+ProgressiveImageDecode::ProgressiveImageDecode(
+    uint32_t target_width,
+    uint32_t target_height,
+    fml::TimeDelta partial_image_interval,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+    fml::RefPtr<fml::TaskRunner> io_runner,
+    fml::WeakPtr<IOManager> io_manager,
+    std::function<void(SkiaGPUObject<SkImage>, bool)> result)
+    : target_width_(target_width),
+      target_height_(target_height),
+      partial_image_interval_(partial_image_interval),
+      concurrent_task_runner_(std::move(concurrent_task_runner)),
+      io_runner_(std::move(io_runner)),
+      io_manager_(std::move(io_manager)),
+      result_(std::move(result)) {}
+
+ProgressiveImageDecode::~ProgressiveImageDecode() = default;
+
+void ProgressiveImageDecode::AppendData(sk_sp<SkData> data) {
+  if (!data || data->size() == 0) {
+    return;
+  }
+
+  std::scoped_lock lock(data_mutex_);
+  FML_DCHECK(!finished_) << "Data appended to a finished image decode.";
+  if (finished_) {
+    return;
+  }
+  data_size_ += data->size();
+  chunks_.emplace_back(std::move(data));
+  ScheduleStepLocked();
+}
+
+void ProgressiveImageDecode::Finish() {
+  std::scoped_lock lock(data_mutex_);
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+  ScheduleStepLocked();
+}
+
+void ProgressiveImageDecode::ScheduleStepLocked() {
+  data_changed_ = true;
+  if (step_pending_) {
+    // The pending step either sees the new data or posts another step.
+    return;
+  }
+  step_pending_ = true;
+  concurrent_task_runner_->PostTask(
+      [decode = shared_from_this()]() { decode->Step(); });
+}
+
+void ProgressiveImageDecode::Step() {
+  TRACE_EVENT0("flutter", "ProgressiveImageDecodeStep");
+  bool finished = false;
+  {
+    std::scoped_lock lock(data_mutex_);
+    data_changed_ = false;
+    finished = finished_;
+  }
+
+  if (!done_) {
+    DecodeAvailableData(finished);
+  }
+
+  std::scoped_lock lock(data_mutex_);
+  if (done_ || !data_changed_) {
+    step_pending_ = false;
+    return;
+  }
+  concurrent_task_runner_->PostTask(
+      [decode = shared_from_this()]() { decode->Step(); });
+}
+
+void ProgressiveImageDecode::DecodeAvailableData(bool finished) {
+  if (!codec_) {
+    SkCodec::Result result = SkCodec::kSuccess;
+    codec_ = SkCodec::MakeFromStream(std::make_unique<DataStream>(this),
+                                     &result);
+    if (!codec_) {
+      if (result == SkCodec::kIncompleteInput && !finished) {
+        // Wait for the rest of the header.
+        return;
+      }
+      FML_LOG(ERROR) << "Could not create a codec for the image.";
+      Deliver(nullptr, true);
+      return;
+    }
+
+    // Incrementally decoded rows are not oriented, so only images that need
+    // no orientation are decoded incrementally.
+    if (codec_->getOrigin() == kTopLeft_SkEncodedOrigin &&
+        bitmap_.tryAllocPixels(
+            codec_->getInfo().makeColorType(kN32_SkColorType))) {
+      // Rows that are not decoded yet are transparent in partial images.
+      bitmap_.eraseColor(SK_ColorTRANSPARENT);
+      incremental_ =
+          codec_->startIncrementalDecode(bitmap_.info(), bitmap_.getPixels(),
+                                         bitmap_.rowBytes()) ==
+          SkCodec::kSuccess;
+    }
+    if (!incremental_) {
+      bitmap_.reset();
+    }
+    last_partial_time_ = fml::TimePoint::Now();
+  }
+
+  if (!incremental_) {
+    if (finished) {
+      DecodeCompleteData();
+    }
+    return;
+  }
+
+  int rows_decoded = 0;
+  const SkCodec::Result result = codec_->incrementalDecode(&rows_decoded);
+  if (result == SkCodec::kSuccess) {
+    bitmap_.setImmutable();
+    Deliver(SkImage::MakeFromBitmap(bitmap_), true);
+    return;
+  }
+
+  if (result != SkCodec::kIncompleteInput) {
+    FML_LOG(ERROR) << "Could not incrementally decode the image.";
+    Deliver(nullptr, true);
+    return;
+  }
+
+  if (finished) {
+    // The image is truncated. Deliver what could be decoded.
+    bitmap_.setImmutable();
+    Deliver(SkImage::MakeFromBitmap(bitmap_), true);
+    return;
+  }
+
+  const auto now = fml::TimePoint::Now();
+  if (rows_decoded > rows_delivered_ &&
+      now - last_partial_time_ >= partial_image_interval_) {
+    rows_delivered_ = rows_decoded;
+    last_partial_time_ = now;
+    // The codec keeps writing to the pixels of the bitmap.
+    Deliver(SkImage::MakeRasterCopy(bitmap_.pixmap()), false);
+  }
+}
+
+void ProgressiveImageDecode::DecodeCompleteData() {
+  TRACE_EVENT0("flutter", __FUNCTION__);
+  sk_sp<SkData> data;
+  {
+    std::scoped_lock lock(data_mutex_);
+    data = SkData::MakeUninitialized(data_size_);
+    auto* bytes = static_cast<uint8_t*>(data->writable_data());
+    for (const auto& chunk : chunks_) {
+      memcpy(bytes, chunk->data(), chunk->size());
+      bytes += chunk->size();
+    }
+  }
+
+  // Goes through a generator so that the image is oriented.
+  auto image = SkImage::MakeFromEncoded(std::move(data));
+  Deliver(image ? image->makeRasterImage() : nullptr, true);
+}
+
+void ProgressiveImageDecode::Deliver(sk_sp<SkImage> image, bool is_complete) {
+  if (is_complete) {
+    done_ = true;
+    // The codec reads from the chunks.
+    codec_.reset();
+    bitmap_.reset();
+    std::scoped_lock lock(data_mutex_);
+    chunks_.clear();
+  }
+
+  fml::tracing::TraceFlow flow(__FUNCTION__);
+
+  if (image && (target_width_ || target_height_) &&
+      (image->width() != static_cast<int>(target_width_) ||
+       image->height() != static_cast<int>(target_height_))) {
+    image = ResizeRasterImage(
+        std::move(image), SkISize::Make(target_width_, target_height_), flow);
+  }
+
+  if (!image) {
+    result_({}, is_complete);
+    return;
+  }
+
+  io_runner_->PostTask(fml::MakeCopyable(
+      [image = std::move(image), io_manager = io_manager_, result = result_,
+       is_complete, flow = std::move(flow)]() mutable {
+        // Flows cannot terminate without a base trace.
+        TRACE_EVENT0("flutter", "ProgressiveImageUpload");
+        auto uploaded =
+            UploadDecompressedImage(std::move(image), io_manager, flow);
+        flow.End();
+        result(std::move(uploaded), is_complete);
+      }));
+}
+
+size_t ProgressiveImageDecode::ReadData(size_t offset,
+                                        void* buffer,
+                                        size_t size) {
+  std::scoped_lock lock(data_mutex_);
+  size_t read = 0;
+  size_t chunk_offset = 0;
+  for (const auto& chunk : chunks_) {
+    if (read == size) {
+      break;
+    }
+    const size_t chunk_end = chunk_offset + chunk->size();
+    if (offset + read < chunk_end) {
+      const size_t start = offset + read - chunk_offset;
+      const size_t count = std::min(size - read, chunk->size() - start);
+      if (buffer) {
+        memcpy(static_cast<uint8_t*>(buffer) + read, chunk->bytes() + start,
+               count);
+      }
+      read += count;
+    }
+    chunk_offset = chunk_end;
+  }
+  return read;
+}
+
+bool ProgressiveImageDecode::IsAtEnd(size_t offset) {
+  std::scoped_lock lock(data_mutex_);
+  return finished_ && offset >= data_size_;
+}
+
 }  // namespace flutter
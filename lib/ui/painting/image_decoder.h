@@ -6,16 +6,22 @@
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODER_H_
 
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <vector>
 
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/skia_gpu_object.h"
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkImageInfo.h"
@@ -24,6 +30,8 @@
 
 namespace flutter {
 
+class ProgressiveImageDecode;
+
 // An object that coordinates image decompression and texture upload across
 // multiple threads/components in the shell. This object must be created,
 // accessed and collected on the UI thread (typically the engine or its runtime
@@ -50,6 +58,26 @@ class ImageDecoder {
               uint32_t target_height,
               const ImageResult& result);
 
+  // Invoked for every partial image and once more for the complete image, in
+  // which case |is_complete| is true. The image is null on error.
+  using ProgressiveImageResult =
+      std::function<void(SkiaGPUObject<SkImage> image, bool is_complete)>;
+
+  // Decodes an encoded image whose data arrives over time. The data is
+  // appended to the returned object as it becomes available. Encodings that
+  // can be decoded incrementally deliver partial images, but no more than one
+  // per |partial_image_interval|. Others only deliver the complete image. Just
+  // like |Decode|, the callback is always invoked on the UI thread.
+  //
+  // Only PNG and GIF images are decoded incrementally. Skia's JPEG codec
+  // cannot decode incrementally, so JPEG images, progressive ones included,
+  // only deliver the complete image. This is not exposed to Dart yet.
+  std::shared_ptr<ProgressiveImageDecode> DecodeProgressively(
+      uint32_t target_width,
+      uint32_t target_height,
+      fml::TimeDelta partial_image_interval,
+      const ProgressiveImageResult& result);
+
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
  private:
@@ -61,6 +89,78 @@ class ImageDecoder {
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
 };
 
+// The state of a decode started by |ImageDecoder::DecodeProgressively|. Data
+// may be appended from any thread. Decoding happens on the concurrent task
+// runner of the decoder, one step at a time.
+class ProgressiveImageDecode
+    : public std::enable_shared_from_this<ProgressiveImageDecode> {
+ public:
+  ~ProgressiveImageDecode();
+
+  // Appends the next chunk of the encoded image.
+  void AppendData(sk_sp<SkData> data);
+
+  // Signals that the encoded image is complete. The complete image is
+  // delivered once the remaining data is decoded.
+  void Finish();
+
+ private:
+  friend class ImageDecoder;
+
+  // Reads the data appended so far, see |ReadData|.
+  class DataStream;
+
+  const uint32_t target_width_;
+  const uint32_t target_height_;
+  const fml::TimeDelta partial_image_interval_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+  fml::RefPtr<fml::TaskRunner> io_runner_;
+  fml::WeakPtr<IOManager> io_manager_;
+  std::function<void(SkiaGPUObject<SkImage>, bool)> result_;
+
+  std::mutex data_mutex_;
+  std::vector<sk_sp<SkData>> chunks_;
+  size_t data_size_ = 0;
+  bool finished_ = false;
+  // Whether a decode step is posted or running.
+  bool step_pending_ = false;
+  // Whether data was appended (or finished) since the last step started.
+  bool data_changed_ = false;
+
+  // Only accessed by the decode steps.
+  std::unique_ptr<SkCodec> codec_;
+  SkBitmap bitmap_;
+  bool incremental_ = false;
+  bool done_ = false;
+  int rows_delivered_ = 0;
+  fml::TimePoint last_partial_time_;
+
+  ProgressiveImageDecode(
+      uint32_t target_width,
+      uint32_t target_height,
+      fml::TimeDelta partial_image_interval,
+      std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
+      fml::RefPtr<fml::TaskRunner> io_runner,
+      fml::WeakPtr<IOManager> io_manager,
+      std::function<void(SkiaGPUObject<SkImage>, bool)> result);
+
+  void ScheduleStepLocked();
+
+  void Step();
+
+  void DecodeAvailableData(bool finished);
+
+  void DecodeCompleteData();
+
+  void Deliver(sk_sp<SkImage> image, bool is_complete);
+
+  size_t ReadData(size_t offset, void* buffer, size_t size);
+
+  bool IsAtEnd(size_t offset);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ProgressiveImageDecode);
+};
+
 sk_sp<SkImage> ImageFromCompressedData(ImageDescriptor* descriptor,
                                        uint32_t target_width,
                                        uint32_t target_height,
@@ -7,6 +7,7 @@
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -45,6 +46,7 @@ class TestIOManager final : public IOManager {
   }
 
   ~TestIOManager() override {
+    DecodedImageCache::GetCacheForProcess()->RemoveImages(unref_queue_.get());
     fml::AutoResetWaitableEvent latch;
     fml::TaskRunner::RunNowOrPostTask(runner_,
                                       [&latch, queue = unref_queue_]() {
@@ -684,5 +686,175 @@ TEST_F(ImageDecoderFixtureTest,
   latch.Wait();
 }
 
+// Appends the data in small chunks and returns the sizes of the images
+// delivered, the size of the complete image last.
+static std::vector<SkISize> DecodeProgressivelyInChunks(
+    const TaskRunners& runners,
+    fml::ConcurrentMessageLoop& loop,
+    sk_sp<SkData> data,
+    uint32_t target_width,
+    uint32_t target_height) {
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+  std::vector<SkISize> sizes;
+
+  auto release_io_manager = [&]() {
+    io_manager.reset();
+    latch.Signal();
+  };
+  auto decode_image = [&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop.GetTaskRunner(), io_manager->GetWeakIOManager());
+
+    ImageDecoder::ProgressiveImageResult callback =
+        [&](SkiaGPUObject<SkImage> image, bool is_complete) {
+          ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+          ASSERT_TRUE(image.get());
+          sizes.push_back(image.get()->dimensions());
+          if (is_complete) {
+            image_decoder.reset();
+            runners.GetIOTaskRunner()->PostTask(release_io_manager);
+          }
+        };
+    auto decode = image_decoder->DecodeProgressively(
+        target_width, target_height, fml::TimeDelta::Zero(), callback);
+
+    const size_t kChunkSize = 1024;
+    for (size_t offset = 0; offset < data->size(); offset += kChunkSize) {
+      decode->AppendData(SkData::MakeSubset(
+          data.get(), offset, std::min(kChunkSize, data->size() - offset)));
+    }
+    decode->Finish();
+  };
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+    runners.GetUITaskRunner()->PostTask(decode_image);
+  });
+  latch.Wait();
+  return sizes;
+}
+
+TEST_F(ImageDecoderFixtureTest, CanDecodeProgressively) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(data);
+
+  auto sizes = DecodeProgressivelyInChunks(runners, *loop, data, 0, 0);
+  ASSERT_GE(sizes.size(), 1u);
+  for (const auto& size : sizes) {
+    ASSERT_EQ(size, SkISize::Make(300, 100));
+  }
+
+  sizes = DecodeProgressivelyInChunks(runners, *loop, data, 150, 50);
+  ASSERT_GE(sizes.size(), 1u);
+  for (const auto& size : sizes) {
+    ASSERT_EQ(size, SkISize::Make(150, 50));
+  }
+}
+
+TEST_F(ImageDecoderFixtureTest, ProgressiveDecodeDeliversPartialImages) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  ASSERT_TRUE(data);
+
+  // The image data of the fixture is split over several IDAT chunks. Each
+  // part ends after one of them, so each part decodes more rows. The next
+  // part is only appended once a partial image was delivered for the
+  // previous one.
+  const std::vector<size_t> part_ends = {8265, 16469, data->size()};
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<TestIOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+  std::shared_ptr<ProgressiveImageDecode> decode;
+  size_t parts_appended = 0;
+  size_t partial_images = 0;
+  bool completed = false;
+
+  auto append_next_part = [&]() {
+    const size_t start =
+        parts_appended == 0 ? 0 : part_ends[parts_appended - 1];
+    decode->AppendData(SkData::MakeSubset(data.get(), start,
+                                          part_ends[parts_appended] - start));
+    parts_appended++;
+    if (parts_appended == part_ends.size()) {
+      decode->Finish();
+    }
+  };
+  auto release_io_manager = [&]() {
+    io_manager.reset();
+    latch.Signal();
+  };
+  auto decode_image = [&]() {
+    image_decoder = std::make_unique<ImageDecoder>(
+        runners, loop->GetTaskRunner(), io_manager->GetWeakIOManager());
+
+    ImageDecoder::ProgressiveImageResult callback =
+        [&](SkiaGPUObject<SkImage> image, bool is_complete) {
+          ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+          ASSERT_TRUE(image.get());
+          ASSERT_EQ(image.get()->dimensions(), SkISize::Make(300, 100));
+          if (is_complete) {
+            completed = true;
+            decode.reset();
+            image_decoder.reset();
+            runners.GetIOTaskRunner()->PostTask(release_io_manager);
+            return;
+          }
+          partial_images++;
+          if (parts_appended < part_ends.size()) {
+            append_next_part();
+          }
+        };
+    decode = image_decoder->DecodeProgressively(0, 0, fml::TimeDelta::Zero(),
+                                                callback);
+    append_next_part();
+  };
+
+  runners.GetIOTaskRunner()->PostTask([&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+    runners.GetUITaskRunner()->PostTask(decode_image);
+  });
+  latch.Wait();
+
+  ASSERT_TRUE(completed);
+  ASSERT_EQ(parts_appended, part_ends.size());
+  ASSERT_GE(partial_images, 2u);
+}
+
+TEST_F(ImageDecoderFixtureTest, ProgressiveDecodeRespectsExifData) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  auto data = OpenFixtureAsSkData("Horizontal.jpg");
+  ASSERT_TRUE(data);
+
+  // Images that need to be oriented are only delivered once complete.
+  auto sizes = DecodeProgressivelyInChunks(runners, *loop, data, 0, 0);
+  ASSERT_EQ(sizes.size(), 1u);
+  ASSERT_EQ(sizes.front(), SkISize::Make(600, 200));
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -2255,6 +2255,24 @@ class ParagraphBuilder extends NativeFieldWrapperClass2 {
     return paragraph;
   }
   void _build(Paragraph outParagraph) native 'ParagraphBuilder_build';
+
+  /// Applies the given paragraph style and returns a future that completes
+  /// with a [Paragraph] containing the added text and associated styling,
+  /// laid out with the given constraints.
+  ///
+  /// The paragraph is laid out on a background thread, so that laying out
+  /// long text does not take time from the frame that is being built. The
+  /// paragraph only needs to be laid out again if the constraints change.
+  ///
+  /// After calling this function, the paragraph builder object is invalid and
+  /// cannot be used further.
+  Future<Paragraph> buildAndLayout(ParagraphConstraints constraints) {
+    final Paragraph paragraph = Paragraph._();
+    return _futurize((_Callback<bool> callback) {
+      return _buildAndLayout(paragraph, constraints.width, callback);
+    }).then((bool _) => paragraph);
+  }
+  String? _buildAndLayout(Paragraph outParagraph, double width, _Callback<bool> callback) native 'ParagraphBuilder_buildAndLayout';
 }
 
 /// Loads a font from a buffer and makes it available for rendering text.
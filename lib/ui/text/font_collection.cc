@@ -173,4 +173,14 @@ void FontCollection::LoadFontFromList(const uint8_t* font_data,
   collection_->ClearFontFamilyCache();
 }
 
+void FontCollection::SetLayoutTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> layout_task_runner) {
+  layout_task_runner_ = std::move(layout_task_runner);
+}
+
+std::shared_ptr<fml::ConcurrentTaskRunner>
+FontCollection::GetLayoutTaskRunner() const {
+  return layout_task_runner_;
+}
+
 }  // namespace flutter
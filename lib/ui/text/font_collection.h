@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "txt/font_collection.h"
@@ -39,8 +40,16 @@ class FontCollection {
                         int length,
                         std::string family_name);
 
+  // Sets the task runner that ParagraphBuilder.buildAndLayout lays out
+  // paragraphs on. Without one, paragraphs are laid out on the UI thread.
+  void SetLayoutTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> layout_task_runner);
+
+  std::shared_ptr<fml::ConcurrentTaskRunner> GetLayoutTaskRunner() const;
+
  private:
   std::shared_ptr<txt::FontCollection> collection_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> layout_task_runner_;
   sk_sp<txt::DynamicFontManager> dynamic_font_manager_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(FontCollection);
@@ -9,7 +9,9 @@
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
@@ -25,6 +27,8 @@
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/dart_library_natives.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/logging/dart_invoke.h"
 #include "third_party/tonic/typed_data/dart_byte_data.h"
 
 namespace flutter {
@@ -143,7 +147,8 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, ParagraphBuilder);
   V(ParagraphBuilder, pop)            \
   V(ParagraphBuilder, addText)        \
   V(ParagraphBuilder, addPlaceholder) \
-  V(ParagraphBuilder, build)
+  V(ParagraphBuilder, build)          \
+  V(ParagraphBuilder, buildAndLayout)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
@@ -312,6 +317,7 @@ ParagraphBuilder::ParagraphBuilder(
 #endif  // FLUTTER_ENABLE_SKSHAPER
 
   m_paragraphBuilder = factory(style, font_collection.GetFontCollection());
+  m_canLayoutConcurrently = factory == txt::ParagraphBuilder::CreateTxtBuilder;
 }
 
 ParagraphBuilder::~ParagraphBuilder() = default;
@@ -519,4 +525,70 @@ void ParagraphBuilder::build(Dart_Handle paragraph_handle) {
   Paragraph::Create(paragraph_handle, m_paragraphBuilder->Build());
 }
 
+Dart_Handle ParagraphBuilder::buildAndLayout(Dart_Handle paragraph_handle,
+                                             double width,
+                                             Dart_Handle callback) {
+  if (Dart_IsNull(callback) || !Dart_IsClosure(callback)) {
+    return tonic::ToDart("Callback was invalid");
+  }
+
+  auto* dart_state = UIDartState::Current();
+  std::shared_ptr<fml::ConcurrentTaskRunner> layout_task_runner =
+      dart_state->platform_configuration()
+          ->client()
+          ->GetFontCollection()
+          .GetLayoutTaskRunner();
+
+  // Building only moves the text and styles into the paragraph, it is the
+  // layout that takes time.
+  std::unique_ptr<txt::Paragraph> txt_paragraph = m_paragraphBuilder->Build();
+
+  if (!layout_task_runner || !m_canLayoutConcurrently) {
+    txt_paragraph->Layout(width);
+    Paragraph::Create(paragraph_handle, std::move(txt_paragraph));
+    tonic::DartInvoke(callback, {tonic::ToDart(true)});
+    return Dart_Null();
+  }
+
+  auto persistent_paragraph = std::make_unique<tonic::DartPersistentValue>(
+      dart_state, paragraph_handle);
+  auto persistent_callback =
+      std::make_unique<tonic::DartPersistentValue>(dart_state, callback);
+  auto ui_task_runner = dart_state->GetTaskRunners().GetUITaskRunner();
+
+  auto ui_task = fml::MakeCopyable(
+      [persistent_paragraph = std::move(persistent_paragraph),
+       persistent_callback = std::move(persistent_callback)](
+          std::unique_ptr<txt::Paragraph> txt_paragraph) mutable {
+        auto dart_state = persistent_callback->dart_state().lock();
+        if (!dart_state) {
+          // The isolate could have died in the meantime.
+          return;
+        }
+        tonic::DartState::Scope scope(dart_state);
+
+        Paragraph::Create(persistent_paragraph->Get(),
+                          std::move(txt_paragraph));
+        tonic::DartInvoke(persistent_callback->Get(), {tonic::ToDart(true)});
+
+        // The handles are associated with the Dart isolate and must be
+        // deleted on the UI thread.
+        persistent_paragraph.reset();
+        persistent_callback.reset();
+      });
+
+  layout_task_runner->PostTask(fml::MakeCopyable(
+      [txt_paragraph = std::move(txt_paragraph), width, ui_task_runner,
+       ui_task]() mutable {
+        TRACE_EVENT0("flutter", "ParagraphBuilder::buildAndLayout");
+        txt_paragraph->Layout(width);
+        ui_task_runner->PostTask(fml::MakeCopyable(
+            [ui_task, txt_paragraph = std::move(txt_paragraph)]() mutable {
+              ui_task(std::move(txt_paragraph));
+            }));
+      }));
+
+  return Dart_Null();
+}
+
 }  // namespace flutter
@@ -71,6 +71,15 @@ class ParagraphBuilder : public RefCountedDartWrappable<ParagraphBuilder> {
 
   void build(Dart_Handle paragraph_handle);
 
+  // Builds the paragraph and lays it out with the given width on the layout
+  // task runner of the font collection, so that laying out long text does not
+  // block the UI thread. The paragraph is associated with |paragraph_handle|
+  // before |callback| is invoked on the UI thread. Returns an error message,
+  // or null.
+  Dart_Handle buildAndLayout(Dart_Handle paragraph_handle,
+                             double width,
+                             Dart_Handle callback);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
@@ -84,6 +93,9 @@ class ParagraphBuilder : public RefCountedDartWrappable<ParagraphBuilder> {
                             const std::string& locale);
 
   std::unique_ptr<txt::ParagraphBuilder> m_paragraphBuilder;
+  // Whether the built paragraphs can be laid out off the UI thread. The
+  // SkParagraph caches are not thread-safe.
+  bool m_canLayoutConcurrently = false;
 };
 
 }  // namespace flutter
@@ -4,12 +4,17 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
+#include "flutter/shell/common/platform_message_batcher.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
+#include "flutter/third_party/txt/src/txt/paragraph_builder.h"
 
 #include <future>
 
@@ -112,9 +117,142 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// Measures how long the UI thread is busy laying out paragraphs, either on
+// the UI thread itself or by posting the layouts to the concurrent workers
+// like ParagraphBuilder.buildAndLayout does.
+static void BM_ParagraphLayout(benchmark::State& state, bool concurrent) {
+  ThreadHost thread_host("test", ThreadHost::Type::UI);
+  auto ui_task_runner = thread_host.ui_thread->GetTaskRunner();
+  auto concurrent_loop = fml::ConcurrentMessageLoop::Create();
+  auto worker_task_runner = concurrent_loop->GetTaskRunner();
+
+  FontCollection font_collection;
+  font_collection.RegisterTestFonts();
+
+  std::u16string text;
+  for (int i = 0; i < 20; i++) {
+    text += u"The quick brown fox jumps over the lazy dog. ";
+  }
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  const size_t paragraph_count = state.range(0);
+  constexpr double kWidth = 300;
+
+  while (state.KeepRunning()) {
+    std::vector<std::unique_ptr<txt::Paragraph>> paragraphs;
+    for (size_t i = 0; i < paragraph_count; i++) {
+      auto builder = txt::ParagraphBuilder::CreateTxtBuilder(
+          paragraph_style, font_collection.GetFontCollection());
+      builder->PushStyle(text_style);
+      builder->AddText(text);
+      paragraphs.push_back(builder->Build());
+    }
+
+    fml::CountDownLatch layouts_done(paragraph_count);
+    fml::AutoResetWaitableEvent ui_task_done;
+    fml::TimeDelta ui_time;
+    ui_task_runner->PostTask([&]() {
+      fml::TimePoint start = fml::TimePoint::Now();
+      for (auto& paragraph : paragraphs) {
+        txt::Paragraph* raw_paragraph = paragraph.get();
+        if (concurrent) {
+          worker_task_runner->PostTask([raw_paragraph, &layouts_done]() {
+            raw_paragraph->Layout(kWidth);
+            layouts_done.CountDown();
+          });
+        } else {
+          raw_paragraph->Layout(kWidth);
+          layouts_done.CountDown();
+        }
+      }
+      ui_time = fml::TimePoint::Now() - start;
+      ui_task_done.Signal();
+    });
+    ui_task_done.Wait();
+    layouts_done.Wait();
+    state.SetIterationTime(ui_time.ToSecondsF());
+  }
+}
+
+static void BM_ParagraphLayoutOnUIThread(benchmark::State& state) {
+  BM_ParagraphLayout(state, false);
+}
+
+static void BM_ParagraphLayoutOnConcurrentWorkers(benchmark::State& state) {
+  BM_ParagraphLayout(state, true);
+}
+
+// Measures how many platform messages per second can be sent to the UI
+// thread, either with a task per message or through a PlatformMessageBatcher.
+static void BM_PlatformMessageDispatch(benchmark::State& state, bool batched) {
+  ThreadHost thread_host("test", ThreadHost::Type::UI);
+  auto ui_task_runner = thread_host.ui_thread->GetTaskRunner();
+  const size_t message_count = state.range(0);
+
+  std::unique_ptr<fml::CountDownLatch> received;
+  auto handle_message = [&received](fml::RefPtr<PlatformMessage> message) {
+    received->CountDown();
+  };
+  auto batcher = std::make_shared<PlatformMessageBatcher>(
+      ui_task_runner, [&](PlatformMessageBatcher::Messages messages) {
+        for (auto& message : messages) {
+          handle_message(std::move(message));
+        }
+      });
+
+  std::vector<uint8_t> payload(64, 0);
+  while (state.KeepRunning()) {
+    received = std::make_unique<fml::CountDownLatch>(message_count);
+    for (size_t i = 0; i < message_count; i++) {
+      auto message = fml::MakeRefCounted<PlatformMessage>(
+          "test", payload, fml::RefPtr<PlatformMessageResponse>());
+      if (batched) {
+        batcher->Enqueue(std::move(message));
+      } else {
+        ui_task_runner->PostTask(
+            [&handle_message, message = std::move(message)]() mutable {
+              handle_message(std::move(message));
+            });
+      }
+    }
+    received->Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * message_count);
+}
+
+static void BM_PlatformMessageDispatchPerTask(benchmark::State& state) {
+  BM_PlatformMessageDispatch(state, false);
+}
+
+static void BM_PlatformMessageDispatchBatched(benchmark::State& state) {
+  BM_PlatformMessageDispatch(state, true);
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK(BM_PlatformMessageDispatchPerTask)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_PlatformMessageDispatchBatched)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000)
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ParagraphLayoutOnUIThread)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_ParagraphLayoutOnConcurrentWorkers)
+    ->RangeMultiplier(4)
+    ->Range(16, 256)
+    ->UseManualTime()
+    ->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
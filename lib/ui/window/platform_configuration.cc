@@ -16,6 +16,7 @@
 #include "third_party/tonic/dart_library_natives.h"
 #include "third_party/tonic/dart_microtask_queue.h"
 #include "third_party/tonic/logging/dart_invoke.h"
+#include "third_party/tonic/scopes/dart_api_scope.h"
 #include "third_party/tonic/typed_data/dart_byte_data.h"
 
 namespace flutter {
@@ -185,6 +186,32 @@ Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
   return tonic::DartByteData::Create(buffer.data(), buffer.size());
 }
 
+// Matches the threshold below which tonic::DartByteData::Create copies into
+// the Dart heap.
+constexpr size_t kExternalPayloadSizeThreshold = 1000;
+
+void FinalizeMapping(void* isolate_callback_data, void* peer) {
+  delete static_cast<fml::Mapping*>(peer);
+}
+
+// Small payloads are cheaper to copy than to track as external data. Larger
+// ones are handed to Dart without a copy, and the mapping is released once
+// the ByteData is collected.
+Dart_Handle ToByteData(std::unique_ptr<fml::Mapping> mapping) {
+  const size_t size = mapping->GetSize();
+  if (size < kExternalPayloadSizeThreshold) {
+    return tonic::DartByteData::Create(mapping->GetMapping(), size);
+  }
+  void* bytes = const_cast<uint8_t*>(mapping->GetMapping());
+  fml::Mapping* peer = mapping.release();
+  Dart_Handle handle = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, peer, size, FinalizeMapping);
+  if (Dart_IsError(handle)) {
+    delete peer;
+  }
+  return handle;
+}
+
 }  // namespace
 
 PlatformConfigurationClient::~PlatformConfigurationClient() {}
@@ -306,8 +333,39 @@ void PlatformConfiguration::DispatchPlatformMessage(
     return;
   }
   tonic::DartState::Scope scope(dart_state);
-  Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+  DispatchPlatformMessageInScope(std::move(message));
+}
+
+void PlatformConfiguration::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  std::shared_ptr<tonic::DartState> dart_state =
+      dispatch_platform_message_.dart_state().lock();
+  if (!dart_state) {
+    FML_DLOG(WARNING) << "Dropping " << messages.size()
+                      << " platform messages for lack of DartState.";
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+  for (size_t i = 0; i < messages.size(); i++) {
+    if (i > 0) {
+      // Microtasks scheduled by a message handler run before the next message
+      // is dispatched, as they would if each message had its own task.
+      UIDartState::Current()->FlushMicrotasksNow();
+    }
+    // Releases the handles of each message before dispatching the next one.
+    tonic::DartApiScope api_scope;
+    DispatchPlatformMessageInScope(std::move(messages[i]));
+  }
+}
+
+void PlatformConfiguration::DispatchPlatformMessageInScope(
+    fml::RefPtr<PlatformMessage> message) {
+  Dart_Handle data_handle = Dart_Null();
+  if (message->hasMapping()) {
+    data_handle = ToByteData(message->releaseMapping());
+  } else if (message->hasData()) {
+    data_handle = ToByteData(message->data());
+  }
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
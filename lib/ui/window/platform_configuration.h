@@ -308,6 +308,17 @@ class PlatformConfiguration final {
   ///
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the PlatformConfiguration that the client has sent
+  ///             it a batch of messages. The messages are dispatched in order
+  ///             from a single scope of the root isolate.
+  ///
+  /// @param[in]  messages  The messages sent from the embedder to the Dart
+  ///                       application.
+  ///
+  void DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the framework that the embedder encountered an
   ///             accessibility related action on the specified node. This call
@@ -430,6 +441,9 @@ class PlatformConfiguration final {
   int next_response_id_ = 1;
   std::unordered_map<int, fml::RefPtr<PlatformMessageResponse>>
       pending_responses_;
+
+  // Must be called from within the scope of the root isolate.
+  void DispatchPlatformMessageInScope(fml::RefPtr<PlatformMessage> message);
 };
 
 }  // namespace flutter
@@ -15,6 +15,14 @@ PlatformMessage::PlatformMessage(std::string channel,
       data_(std::move(data)),
       hasData_(true),
       response_(std::move(response)) {}
+PlatformMessage::PlatformMessage(std::string channel,
+                                 std::unique_ptr<fml::Mapping> mapping,
+                                 fml::RefPtr<PlatformMessageResponse> response)
+    : channel_(std::move(channel)),
+      data_(),
+      mapping_(std::move(mapping)),
+      hasData_(true),
+      response_(std::move(response)) {}
 PlatformMessage::PlatformMessage(std::string channel,
                                  fml::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
@@ -24,4 +32,16 @@ PlatformMessage::PlatformMessage(std::string channel,
 
 PlatformMessage::~PlatformMessage() = default;
 
+const uint8_t* PlatformMessage::payload() const {
+  return mapping_ ? mapping_->GetMapping() : data_.data();
+}
+
+size_t PlatformMessage::payload_size() const {
+  return mapping_ ? mapping_->GetSize() : data_.size();
+}
+
+std::unique_ptr<fml::Mapping> PlatformMessage::releaseMapping() {
+  return std::move(mapping_);
+}
+
 }  // namespace flutter
@@ -5,9 +5,11 @@
 #ifndef FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 #define FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/lib/ui/window/platform_message_response.h"
@@ -20,23 +22,45 @@ class PlatformMessage : public fml::RefCountedThreadSafe<PlatformMessage> {
 
  public:
   const std::string& channel() const { return channel_; }
+  // Empty for messages whose payload is held by a mapping. Use |payload()|
+  // to read the payload of any message.
   const std::vector<uint8_t>& data() const { return data_; }
   bool hasData() { return hasData_; }
 
+  const uint8_t* payload() const;
+  size_t payload_size() const;
+
+  bool hasMapping() const { return mapping_ != nullptr; }
+
+  // Hands the mapping over to the caller, so that its bytes can be given to
+  // Dart without a copy. The message has no payload afterwards.
+  std::unique_ptr<fml::Mapping> releaseMapping();
+
   const fml::RefPtr<PlatformMessageResponse>& response() const {
     return response_;
   }
 
+  // Only to be called before the message is handed to another thread.
+  void set_response(fml::RefPtr<PlatformMessageResponse> response) {
+    response_ = std::move(response);
+  }
+
  private:
   PlatformMessage(std::string channel,
                   std::vector<uint8_t> data,
                   fml::RefPtr<PlatformMessageResponse> response);
+  // The mapping may be handed to Dart as external typed data, so its memory
+  // must stay writable and valid until the mapping is destroyed.
+  PlatformMessage(std::string channel,
+                  std::unique_ptr<fml::Mapping> mapping,
+                  fml::RefPtr<PlatformMessageResponse> response);
   PlatformMessage(std::string channel,
                   fml::RefPtr<PlatformMessageResponse> response);
   ~PlatformMessage();
 
   std::string channel_;
   std::vector<uint8_t> data_;
+  std::unique_ptr<fml::Mapping> mapping_;
   bool hasData_;
   fml::RefPtr<PlatformMessageResponse> response_;
 };
@@ -4,10 +4,21 @@
 
 #include "flutter/lib/ui/window/platform_message_response.h"
 
+#include <utility>
+
 namespace flutter {
 
 PlatformMessageResponse::PlatformMessageResponse() = default;
 
 PlatformMessageResponse::~PlatformMessageResponse() = default;
 
+void PlatformMessageResponse::CompleteOnPlatformThread(
+    std::unique_ptr<fml::Mapping> data) {
+  if (data) {
+    Complete(std::move(data));
+  } else {
+    CompleteEmpty();
+  }
+}
+
 }  // namespace flutter
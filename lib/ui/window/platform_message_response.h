@@ -22,6 +22,13 @@ class PlatformMessageResponse
   virtual void Complete(std::unique_ptr<fml::Mapping> data) = 0;
   virtual void CompleteEmpty() = 0;
 
+  // Only callable on the platform thread. Delivers the response without
+  // posting a task to the platform thread first, so that the shell can
+  // deliver a batch of responses in a single task. |data| is null for empty
+  // responses. Responses that can only be delivered from a task of their own
+  // keep the default implementation, which calls |Complete|.
+  virtual void CompleteOnPlatformThread(std::unique_ptr<fml::Mapping> data);
+
   bool is_complete() const { return is_complete_; }
 
  protected:
@@ -845,6 +845,13 @@ class CkParagraphBuilder implements ui.ParagraphBuilder {
     return CkParagraph(builtParagraph, _style, _commands);
   }
 
+  @override
+  Future<CkParagraph> buildAndLayout(ui.ParagraphConstraints constraints) {
+    final CkParagraph paragraph = build();
+    paragraph.layout(constraints);
+    return Future<CkParagraph>.value(paragraph);
+  }
+
   /// Builds the CkParagraph with the builder and deletes the builder.
   SkParagraph _buildCkParagraph() {
     final SkParagraph result = _paragraphBuilder.build();
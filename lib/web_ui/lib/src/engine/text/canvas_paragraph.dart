@@ -649,4 +649,11 @@ class CanvasParagraphBuilder implements ui.ParagraphBuilder {
       drawOnCanvas: _drawOnCanvas,
     );
   }
+
+  @override
+  Future<CanvasParagraph> buildAndLayout(ui.ParagraphConstraints constraints) {
+    final CanvasParagraph paragraph = build();
+    paragraph.layout(constraints);
+    return Future<CanvasParagraph>.value(paragraph);
+  }
 }
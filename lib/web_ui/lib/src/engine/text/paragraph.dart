@@ -1365,6 +1365,13 @@ class DomParagraphBuilder implements ui.ParagraphBuilder {
     return _tryBuildPlainText() ?? _buildRichText();
   }
 
+  @override
+  Future<EngineParagraph> buildAndLayout(ui.ParagraphConstraints constraints) {
+    final EngineParagraph paragraph = build();
+    paragraph.layout(constraints);
+    return Future<EngineParagraph>.value(paragraph);
+  }
+
   /// Attempts to build a [Paragraph] assuming it is plain text.
   ///
   /// A paragraph is considered plain if it is built using the following
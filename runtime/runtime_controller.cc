@@ -250,6 +250,18 @@ bool RuntimeController::DispatchPlatformMessage(
   return false;
 }
 
+bool RuntimeController::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
+    TRACE_EVENT1("flutter", "RuntimeController::DispatchPlatformMessages",
+                 "count", std::to_string(messages.size()).c_str());
+    platform_configuration->DispatchPlatformMessages(std::move(messages));
+    return true;
+  }
+
+  return false;
+}
+
 bool RuntimeController::DispatchPointerDataPacket(
     const PointerDataPacket& packet) {
   if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
@@ -413,6 +413,18 @@ class RuntimeController : public PlatformConfigurationClient {
   ///
   virtual bool DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatch the specified platform messages, in order, to the
+  ///             running root isolate, entering the isolate only once.
+  ///
+  /// @param[in]  messages  The messages to dispatch to the isolate.
+  ///
+  /// @return     If the messages were dispatched to the running root isolate.
+  ///             This may fail is an isolate is not running.
+  ///
+  virtual bool DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Dispatch the specified pointer data message to the running
   ///             root isolate.
@@ -37,6 +37,17 @@ const std::string_view ServiceProtocol::kGetSkSLsExtensionName =
 const std::string_view
     ServiceProtocol::kEstimateRasterCacheMemoryExtensionName =
         "_flutter.estimateRasterCacheMemory";
+const std::string_view
+    ServiceProtocol::kGetDecodedImageCacheStatsExtensionName =
+        "_flutter.getDecodedImageCacheStats";
+const std::string_view
+    ServiceProtocol::kGetFrameTimingStatisticsExtensionName =
+        "_flutter.getFrameTimingStatistics";
+const std::string_view
+    ServiceProtocol::kSetLayerProfilingEnabledExtensionName =
+        "_flutter.setLayerProfilingEnabled";
+const std::string_view ServiceProtocol::kGetLayerProfileExtensionName =
+    "_flutter.getLayerProfile";
 
 static constexpr std::string_view kViewIdPrefx = "_flutterView/";
 static constexpr std::string_view kListViewsExtensionName =
@@ -56,6 +67,10 @@ ServiceProtocol::ServiceProtocol()
           kGetDisplayRefreshRateExtensionName,
           kGetSkSLsExtensionName,
           kEstimateRasterCacheMemoryExtensionName,
+          kGetDecodedImageCacheStatsExtensionName,
+          kGetFrameTimingStatisticsExtensionName,
+          kSetLayerProfilingEnabledExtensionName,
+          kGetLayerProfileExtensionName,
       }),
       handlers_mutex_(fml::SharedMutex::Create()) {}
 
@@ -29,6 +29,10 @@ class ServiceProtocol {
   static const std::string_view kGetDisplayRefreshRateExtensionName;
   static const std::string_view kGetSkSLsExtensionName;
   static const std::string_view kEstimateRasterCacheMemoryExtensionName;
+  static const std::string_view kGetDecodedImageCacheStatsExtensionName;
+  static const std::string_view kGetFrameTimingStatisticsExtensionName;
+  static const std::string_view kSetLayerProfilingEnabledExtensionName;
+  static const std::string_view kGetLayerProfileExtensionName;
 
   class Handler {
    public:
@@ -21,7 +21,8 @@ constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
 
 Animator::Animator(Delegate& delegate,
                    TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   PipelineMode pipeline_mode)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
@@ -30,7 +31,8 @@ Animator::Animator(Delegate& delegate,
       last_frame_target_time_(),
       dart_frame_deadline_(0),
 #if SHELL_ENABLE_METAL
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(2)),
+      layer_tree_pipeline_(
+          fml::MakeRefCounted<LayerTreePipeline>(2, pipeline_mode)),
 #else   // SHELL_ENABLE_METAL
       // TODO(dnfield): We should remove this logic and set the pipeline depth
       // back to 2 in this case. See
@@ -39,7 +41,8 @@ Animator::Animator(Delegate& delegate,
           task_runners.GetPlatformTaskRunner() ==
                   task_runners.GetRasterTaskRunner()
               ? 1
-              : 2)),
+              : 2,
+          pipeline_mode)),
 #endif  // SHELL_ENABLE_METAL
       pending_frame_semaphore_(1),
       frame_number_(1),
@@ -41,9 +41,17 @@ class Animator final {
     virtual void OnAnimatorDrawLastLayerTree() = 0;
   };
 
+  //----------------------------------------------------------------------------
+  /// @param[in]  pipeline_mode  How layer trees are handed to the raster
+  ///                            thread. With |PipelineMode::LatestWins|, a
+  ///                            layer tree that has not been rasterized yet is
+  ///                            replaced by a newer one instead of delaying
+  ///                            the next frame.
+  ///
   Animator(Delegate& delegate,
            TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           PipelineMode pipeline_mode = PipelineMode::Queue);
 
   ~Animator();
 
@@ -35,6 +35,10 @@ static constexpr char kLocalizationChannel[] = "flutter/localization";
 static constexpr char kSettingsChannel[] = "flutter/settings";
 static constexpr char kIsolateChannel[] = "flutter/isolate";
 
+// Collecting the stats of the text caches locks all their shards, so they are
+// only traced once every this many frames.
+static constexpr size_t kTextCacheStatsFrameInterval = 60;
+
 Engine::Engine(
     Delegate& delegate,
     const PointerDataDispatcherMaker& dispatcher_maker,
@@ -79,6 +83,7 @@ Engine::Engine(Delegate& delegate,
              io_manager,
              std::make_shared<FontCollection>(),
              nullptr) {
+  font_collection_->SetLayoutTaskRunner(vm.GetConcurrentWorkerTaskRunner());
   runtime_controller_ = std::make_unique<RuntimeController>(
       *this,                                 // runtime delegate
       &vm,                                   // VM
@@ -218,6 +223,11 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
 void Engine::BeginFrame(fml::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
   runtime_controller_->BeginFrame(frame_time);
+  // Text is laid out while the frame is built.
+  if (text_cache_stats_frame_count_++ % kTextCacheStatsFrameInterval == 0) {
+    txt::FontCollection::TraceShapingCacheStats();
+    font_collection_->GetFontCollection()->TraceParagraphCacheStats();
+  }
 }
 
 void Engine::ReportTimings(std::vector<int64_t> timings) {
@@ -313,9 +323,45 @@ void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
   FML_DLOG(WARNING) << "Dropping platform message on channel: " << channel;
 }
 
+void Engine::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  std::vector<fml::RefPtr<PlatformMessage>> dart_messages;
+  auto flush_dart_messages = [&]() {
+    if (dart_messages.empty()) {
+      return;
+    }
+    if (!runtime_controller_->IsRootIsolateRunning()) {
+      for (const auto& message : dart_messages) {
+        FML_DLOG(WARNING) << "Dropping platform message on channel: "
+                          << message->channel();
+      }
+    } else if (!runtime_controller_->DispatchPlatformMessages(
+                   std::move(dart_messages))) {
+      FML_DLOG(WARNING) << "Dropping a batch of platform messages.";
+    }
+    dart_messages.clear();
+  };
+
+  for (auto& message : messages) {
+    const std::string& channel = message->channel();
+    if (channel == kLifecycleChannel || channel == kLocalizationChannel ||
+        channel == kSettingsChannel ||
+        (channel == kNavigationChannel &&
+         !runtime_controller_->IsRootIsolateRunning())) {
+      // Messages the engine may handle itself must not overtake the ones
+      // that precede them.
+      flush_dart_messages();
+      DispatchPlatformMessage(std::move(message));
+    } else {
+      dart_messages.push_back(std::move(message));
+    }
+  }
+  flush_dart_messages();
+}
+
 bool Engine::HandleLifecyclePlatformMessage(PlatformMessage* message) {
-  const auto& data = message->data();
-  std::string state(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string state(reinterpret_cast<const char*>(message->payload()),
+                    message->payload_size());
   if (state == "AppLifecycleState.paused" ||
       state == "AppLifecycleState.detached") {
     activity_running_ = false;
@@ -339,10 +385,9 @@ bool Engine::HandleLifecyclePlatformMessage(PlatformMessage* message) {
 
 bool Engine::HandleNavigationPlatformMessage(
     fml::RefPtr<PlatformMessage> message) {
-  const auto& data = message->data();
-
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(message->payload()),
+                 message->payload_size());
   if (document.HasParseError() || !document.IsObject()) {
     return false;
   }
@@ -357,10 +402,9 @@ bool Engine::HandleNavigationPlatformMessage(
 }
 
 bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
-  const auto& data = message->data();
-
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(message->payload()),
+                 message->payload_size());
   if (document.HasParseError() || !document.IsObject()) {
     return false;
   }
@@ -399,8 +443,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
 }
 
 void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
-  const auto& data = message->data();
-  std::string jsonData(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string jsonData(reinterpret_cast<const char*>(message->payload()),
+                       message->payload_size());
   if (runtime_controller_->SetUserSettingsData(std::move(jsonData)) &&
       have_surface_) {
     ScheduleFrame();
@@ -707,6 +707,18 @@ class Engine final : public RuntimeDelegate,
   ///
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the embedder has sent it a batch of
+  ///             messages. The messages are handled in order as if they had
+  ///             been dispatched one by one, but consecutive messages for the
+  ///             Dart application enter the root isolate only once.
+  ///
+  /// @param[in]  messages  The messages sent from the embedder to the Dart
+  ///                       application.
+  ///
+  void DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that the embedder has sent it a pointer
   ///             data packet. A pointer data packet may contain multiple
@@ -900,6 +912,7 @@ class Engine final : public RuntimeDelegate,
   ImageDecoder image_decoder_;
   TaskRunners task_runners_;
   size_t hint_freed_bytes_since_last_idle_ = 0;
+  size_t text_cache_stats_frame_count_ = 0;
   fml::WeakPtrFactory<Engine> weak_factory_;
 
   // |RuntimeDelegate|
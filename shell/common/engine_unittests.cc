@@ -66,6 +66,8 @@ class MockRuntimeController : public RuntimeController {
       : RuntimeController(client, p_task_runners) {}
   MOCK_METHOD0(IsRootIsolateRunning, bool());
   MOCK_METHOD1(DispatchPlatformMessage, bool(fml::RefPtr<PlatformMessage>));
+  MOCK_METHOD1(DispatchPlatformMessages,
+               bool(std::vector<fml::RefPtr<PlatformMessage>>));
   MOCK_METHOD3(LoadDartDeferredLibraryError,
                void(intptr_t, const std::string, bool));
   MOCK_CONST_METHOD0(GetDartVM, DartVM*());
@@ -246,6 +248,38 @@ TEST_F(EngineTest, DispatchPlatformMessageInitialRouteIgnored) {
   });
 }
 
+TEST_F(EngineTest, DispatchPlatformMessagesEntersTheIsolateOnce) {
+  PostUITaskSync([this] {
+    MockRuntimeDelegate client;
+    auto mock_runtime_controller =
+        std::make_unique<MockRuntimeController>(client, task_runners_);
+    EXPECT_CALL(*mock_runtime_controller, IsRootIsolateRunning())
+        .WillRepeatedly(::testing::Return(true));
+    EXPECT_CALL(*mock_runtime_controller, DispatchPlatformMessage(::testing::_))
+        .Times(0);
+    EXPECT_CALL(*mock_runtime_controller,
+                DispatchPlatformMessages(::testing::SizeIs(2)))
+        .WillOnce(::testing::Return(true));
+    auto engine = std::make_unique<Engine>(
+        /*delegate=*/delegate_,
+        /*dispatcher_maker=*/dispatcher_maker_,
+        /*image_decoder_task_runner=*/image_decoder_task_runner_,
+        /*task_runners=*/task_runners_,
+        /*settings=*/settings_,
+        /*animator=*/std::move(animator_),
+        /*io_manager=*/io_manager_,
+        /*font_collection=*/std::make_shared<FontCollection>(),
+        /*runtime_controller=*/std::move(mock_runtime_controller));
+
+    fml::RefPtr<PlatformMessageResponse> response =
+        fml::MakeRefCounted<MockResponse>();
+    std::vector<fml::RefPtr<PlatformMessage>> messages;
+    messages.push_back(fml::MakeRefCounted<PlatformMessage>("foo", response));
+    messages.push_back(fml::MakeRefCounted<PlatformMessage>("bar", response));
+    engine->DispatchPlatformMessages(std::move(messages));
+  });
+}
+
 TEST_F(EngineTest, SpawnSharesFontLibrary) {
   PostUITaskSync([this] {
     MockRuntimeDelegate client;
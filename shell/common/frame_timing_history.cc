@@ -0,0 +1,206 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_history.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace flutter {
+
+namespace {
+
+// Intervals are bucketed in microseconds. Values below |kLinearLimit| get a
+// bucket each. Above it, every power of two is split into |kSubBucketCount|
+// buckets, up to 2^|kMaxExponent| microseconds (about a minute). Longer
+// intervals share a last, unbounded bucket.
+constexpr size_t kSubBucketBits = 5;
+constexpr size_t kSubBucketCount = 1 << kSubBucketBits;
+constexpr size_t kLinearLimit = 2 * kSubBucketCount;
+constexpr size_t kLinearExponent = kSubBucketBits + 1;
+constexpr size_t kMaxExponent = 26;
+constexpr size_t kBucketCount =
+    kLinearLimit + (kMaxExponent - kLinearExponent) * kSubBucketCount + 1;
+
+size_t GetBucketIndex(uint64_t micros) {
+  if (micros < kLinearLimit) {
+    return micros;
+  }
+  size_t exponent = kLinearExponent;
+  while (exponent < kMaxExponent && (micros >> (exponent + 1)) != 0) {
+    exponent++;
+  }
+  if (exponent == kMaxExponent) {
+    return kBucketCount - 1;
+  }
+  const size_t shift = exponent - kSubBucketBits;
+  return kLinearLimit + (exponent - kLinearExponent) * kSubBucketCount +
+         ((micros >> shift) - kSubBucketCount);
+}
+
+// Returns the largest value that falls into the bucket at |index|.
+uint64_t GetBucketUpperBound(size_t index) {
+  if (index < kLinearLimit) {
+    return index;
+  }
+  if (index == kBucketCount - 1) {
+    return std::numeric_limits<uint64_t>::max();
+  }
+  const size_t exponent =
+      (index - kLinearLimit) / kSubBucketCount + kLinearExponent;
+  const uint64_t sub_bucket = (index - kLinearLimit) % kSubBucketCount;
+  const size_t shift = exponent - kSubBucketBits;
+  return ((kSubBucketCount + sub_bucket + 1) << shift) - 1;
+}
+
+}  // namespace
+
+class FrameTimingHistory::Histogram {
+ public:
+  // Only called from the recording thread.
+  void Add(uint64_t micros) {
+    buckets_[GetBucketIndex(micros)].fetch_add(1, std::memory_order_relaxed);
+    if (micros > max_.load(std::memory_order_relaxed)) {
+      max_.store(micros, std::memory_order_relaxed);
+    }
+  }
+
+  Percentiles GetPercentiles() const {
+    std::array<uint64_t, kBucketCount> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+      counts[i] = buckets_[i].load(std::memory_order_relaxed);
+      total += counts[i];
+    }
+    const uint64_t max = max_.load(std::memory_order_relaxed);
+
+    Percentiles percentiles;
+    percentiles.p50 = GetPercentile(counts, total, max, 50);
+    percentiles.p90 = GetPercentile(counts, total, max, 90);
+    percentiles.p99 = GetPercentile(counts, total, max, 99);
+    percentiles.max = fml::TimeDelta::FromMicroseconds(max);
+    return percentiles;
+  }
+
+ private:
+  std::atomic<uint64_t> buckets_[kBucketCount] = {};
+  std::atomic<uint64_t> max_ = {0};
+
+  static fml::TimeDelta GetPercentile(
+      const std::array<uint64_t, kBucketCount>& counts,
+      uint64_t total,
+      uint64_t max,
+      uint64_t percent) {
+    if (total == 0) {
+      return fml::TimeDelta::Zero();
+    }
+    // The rank of the percentile, rounded up so that p99 of 10 frames is the
+    // slowest one.
+    const uint64_t rank = std::max<uint64_t>(1, (total * percent + 99) / 100);
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+      cumulative += counts[i];
+      if (cumulative >= rank) {
+        return fml::TimeDelta::FromMicroseconds(
+            std::min(GetBucketUpperBound(i), max));
+      }
+    }
+    return fml::TimeDelta::FromMicroseconds(max);
+  }
+};
+
+FrameTimingHistory::FrameTimingHistory()
+    : histograms_(new Histogram[kIntervalCount]) {}
+
+FrameTimingHistory::~FrameTimingHistory() = default;
+
+void FrameTimingHistory::Record(const FrameTiming& timing) {
+  const uint64_t number =
+      recorded_frame_count_.load(std::memory_order_relaxed);
+  Slot& slot = slots_[number % kCapacity];
+
+  slot.sequence.store(2 * number + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  for (auto phase : FrameTiming::kPhases) {
+    slot.timestamps[phase].store(
+        timing.Get(phase).ToEpochDelta().ToNanoseconds(),
+        std::memory_order_relaxed);
+  }
+  slot.sequence.store(2 * number + 2, std::memory_order_release);
+
+  for (size_t i = 0; i < kIntervalCount; i++) {
+    histograms_[i].Add(
+        GetInterval(timing, static_cast<Interval>(i)).ToMicroseconds());
+  }
+
+  recorded_frame_count_.store(number + 1, std::memory_order_release);
+}
+
+FrameTimingHistory::Statistics FrameTimingHistory::GetStatistics() const {
+  Statistics statistics;
+  statistics.frame_count =
+      recorded_frame_count_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < kIntervalCount; i++) {
+    statistics.intervals[i] = histograms_[i].GetPercentiles();
+  }
+  return statistics;
+}
+
+std::vector<FrameTiming> FrameTimingHistory::GetRecentFrames(
+    size_t max_count) const {
+  const uint64_t end = recorded_frame_count_.load(std::memory_order_acquire);
+  const uint64_t count =
+      std::min<uint64_t>({max_count, end, static_cast<uint64_t>(kCapacity)});
+
+  std::vector<FrameTiming> frames;
+  frames.reserve(count);
+  for (uint64_t number = end - count; number < end; number++) {
+    const Slot& slot = slots_[number % kCapacity];
+    const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != 2 * number + 2) {
+      // Overwritten by a newer frame since |end| was loaded.
+      continue;
+    }
+    FrameTiming timing;
+    for (auto phase : FrameTiming::kPhases) {
+      timing.Set(phase, fml::TimePoint::FromEpochDelta(
+                            fml::TimeDelta::FromNanoseconds(
+                                slot.timestamps[phase].load(
+                                    std::memory_order_relaxed))));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+    frames.push_back(timing);
+  }
+  return frames;
+}
+
+fml::TimeDelta FrameTimingHistory::GetInterval(const FrameTiming& timing,
+                                               Interval interval) {
+  FrameTiming::Phase start = FrameTiming::kVsyncStart;
+  FrameTiming::Phase end = FrameTiming::kRasterFinish;
+  switch (interval) {
+    case kVsyncOverhead:
+      start = FrameTiming::kVsyncStart;
+      end = FrameTiming::kBuildStart;
+      break;
+    case kBuild:
+      start = FrameTiming::kBuildStart;
+      end = FrameTiming::kBuildFinish;
+      break;
+    case kRaster:
+      start = FrameTiming::kRasterStart;
+      end = FrameTiming::kRasterFinish;
+      break;
+    case kTotal:
+    case kIntervalCount:
+      break;
+  }
+  const fml::TimeDelta delta = timing.Get(end) - timing.Get(start);
+  return std::max(delta, fml::TimeDelta::Zero());
+}
+
+}  // namespace flutter
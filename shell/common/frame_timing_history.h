@@ -0,0 +1,106 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTORY_H_
+#define FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTORY_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Keeps the timings of the frames rasterized by a shell, for in-process
+/// latency statistics that do not need a timeline to be recorded.
+///
+/// The timings of the most recent `kCapacity` frames are kept in a ring
+/// buffer. The phase intervals of every frame recorded so far are also
+/// aggregated into histograms with a relative error of about 3%, from which
+/// percentiles are computed.
+///
+/// Frames are recorded from a single thread, which is the raster thread in
+/// the shell. Neither recording nor querying takes a lock, so the history can
+/// be queried from any thread while frames are recorded. A query racing with
+/// a recording may or may not include that frame.
+///
+class FrameTimingHistory {
+ public:
+  /// The intervals between the phases of a frame that are aggregated.
+  enum Interval {
+    /// From the vsync signal to the start of the build.
+    kVsyncOverhead,
+    /// From the start to the end of the build on the UI thread.
+    kBuild,
+    /// From the start to the end of the rasterization.
+    kRaster,
+    /// From the vsync signal to the end of the rasterization.
+    kTotal,
+    kIntervalCount
+  };
+
+  /// The number of frames kept in the ring buffer.
+  static constexpr size_t kCapacity = 1024;
+
+  struct Percentiles {
+    fml::TimeDelta p50;
+    fml::TimeDelta p90;
+    fml::TimeDelta p99;
+    fml::TimeDelta max;
+  };
+
+  struct Statistics {
+    /// The number of frames recorded so far.
+    uint64_t frame_count = 0;
+    Percentiles intervals[kIntervalCount];
+  };
+
+  FrameTimingHistory();
+
+  ~FrameTimingHistory();
+
+  /// Records the timings of a rasterized frame. Must not be called
+  /// concurrently with itself.
+  void Record(const FrameTiming& timing);
+
+  /// Returns the percentiles of the intervals of all the frames recorded so
+  /// far.
+  Statistics GetStatistics() const;
+
+  /// Returns the timings of at most |max_count| of the most recently recorded
+  /// frames, oldest first.
+  std::vector<FrameTiming> GetRecentFrames(size_t max_count) const;
+
+  /// Returns |interval| of |timing|, or zero if its phases are out of order.
+  static fml::TimeDelta GetInterval(const FrameTiming& timing,
+                                    Interval interval);
+
+ private:
+  class Histogram;
+
+  // A frame of the ring buffer, guarded by a sequence lock. The sequence is
+  // odd while the frame is written, and `2 * n + 2` once frame number `n` has
+  // been written.
+  struct Slot {
+    std::atomic<uint64_t> sequence = {0};
+    std::atomic<int64_t> timestamps[FrameTiming::kCount] = {};
+  };
+
+  std::atomic<uint64_t> recorded_frame_count_ = {0};
+  std::array<Slot, kCapacity> slots_;
+  std::unique_ptr<Histogram[]> histograms_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingHistory);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_TIMING_HISTORY_H_
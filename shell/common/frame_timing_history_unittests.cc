@@ -0,0 +1,167 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timing_history.h"
+
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Returns a frame starting at |start_micros| whose vsync overhead, build and
+// raster take the given number of microseconds, back to back.
+FrameTiming MakeFrame(int64_t start_micros,
+                      int64_t vsync_overhead_micros,
+                      int64_t build_micros,
+                      int64_t raster_micros) {
+  const int64_t phases[FrameTiming::kCount] = {
+      start_micros,
+      start_micros + vsync_overhead_micros,
+      start_micros + vsync_overhead_micros + build_micros,
+      start_micros + vsync_overhead_micros + build_micros,
+      start_micros + vsync_overhead_micros + build_micros + raster_micros,
+  };
+  FrameTiming timing;
+  for (auto phase : FrameTiming::kPhases) {
+    timing.Set(phase, fml::TimePoint::FromEpochDelta(
+                          fml::TimeDelta::FromMicroseconds(phases[phase])));
+  }
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameTimingHistoryTest, IsEmptyInitially) {
+  FrameTimingHistory history;
+  const auto statistics = history.GetStatistics();
+  EXPECT_EQ(statistics.frame_count, 0u);
+  for (const auto& percentiles : statistics.intervals) {
+    EXPECT_EQ(percentiles.p50, fml::TimeDelta::Zero());
+    EXPECT_EQ(percentiles.max, fml::TimeDelta::Zero());
+  }
+  EXPECT_TRUE(history.GetRecentFrames(10).empty());
+}
+
+TEST(FrameTimingHistoryTest, ComputesIntervals) {
+  const FrameTiming timing = MakeFrame(1000, 100, 2000, 3000);
+  EXPECT_EQ(FrameTimingHistory::GetInterval(
+                timing, FrameTimingHistory::kVsyncOverhead),
+            fml::TimeDelta::FromMicroseconds(100));
+  EXPECT_EQ(FrameTimingHistory::GetInterval(timing, FrameTimingHistory::kBuild),
+            fml::TimeDelta::FromMicroseconds(2000));
+  EXPECT_EQ(
+      FrameTimingHistory::GetInterval(timing, FrameTimingHistory::kRaster),
+      fml::TimeDelta::FromMicroseconds(3000));
+  EXPECT_EQ(FrameTimingHistory::GetInterval(timing, FrameTimingHistory::kTotal),
+            fml::TimeDelta::FromMicroseconds(5100));
+
+  // Phases that were never set do not produce negative intervals.
+  FrameTiming unset;
+  unset.Set(FrameTiming::kVsyncStart, fml::TimePoint::Now());
+  EXPECT_EQ(FrameTimingHistory::GetInterval(unset, FrameTimingHistory::kTotal),
+            fml::TimeDelta::Zero());
+}
+
+TEST(FrameTimingHistoryTest, ComputesPercentilesWithinBucketPrecision) {
+  FrameTimingHistory history;
+  // Build times of 1ms to 100ms, in steps of 1ms.
+  for (int64_t i = 1; i <= 100; i++) {
+    history.Record(MakeFrame(i * 100000, 10, i * 1000, 500));
+  }
+
+  const auto statistics = history.GetStatistics();
+  EXPECT_EQ(statistics.frame_count, 100u);
+
+  const auto& build = statistics.intervals[FrameTimingHistory::kBuild];
+  // Percentiles are the upper bounds of their buckets, which are at most
+  // about 3% larger than the values in them.
+  EXPECT_GE(build.p50.ToMicroseconds(), 50000);
+  EXPECT_LE(build.p50.ToMicroseconds(), 51600);
+  EXPECT_GE(build.p90.ToMicroseconds(), 90000);
+  EXPECT_LE(build.p90.ToMicroseconds(), 92900);
+  EXPECT_GE(build.p99.ToMicroseconds(), 99000);
+  EXPECT_LE(build.p99.ToMicroseconds(), 100000);
+  EXPECT_EQ(build.max.ToMicroseconds(), 100000);
+
+  // Small intervals are exact.
+  const auto& vsync = statistics.intervals[FrameTimingHistory::kVsyncOverhead];
+  EXPECT_EQ(vsync.p50.ToMicroseconds(), 10);
+  EXPECT_EQ(vsync.p99.ToMicroseconds(), 10);
+
+  const auto& raster = statistics.intervals[FrameTimingHistory::kRaster];
+  EXPECT_EQ(raster.p50.ToMicroseconds(), 500);
+  EXPECT_EQ(raster.max.ToMicroseconds(), 500);
+}
+
+TEST(FrameTimingHistoryTest, ClampsVeryLongIntervals) {
+  FrameTimingHistory history;
+  const int64_t two_minutes = 120 * 1000 * 1000;
+  history.Record(MakeFrame(0, 0, two_minutes, 0));
+  const auto& build =
+      history.GetStatistics().intervals[FrameTimingHistory::kBuild];
+  EXPECT_EQ(build.p50.ToMicroseconds(), two_minutes);
+  EXPECT_EQ(build.max.ToMicroseconds(), two_minutes);
+}
+
+TEST(FrameTimingHistoryTest, KeepsTheMostRecentFrames) {
+  FrameTimingHistory history;
+  const size_t frame_count = FrameTimingHistory::kCapacity + 10;
+  for (size_t i = 0; i < frame_count; i++) {
+    history.Record(MakeFrame(i * 1000, 1, 2, 3));
+  }
+
+  auto frames = history.GetRecentFrames(3);
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[0].Get(FrameTiming::kVsyncStart).ToEpochDelta(),
+            fml::TimeDelta::FromMicroseconds((frame_count - 3) * 1000));
+  EXPECT_EQ(frames[2].Get(FrameTiming::kVsyncStart).ToEpochDelta(),
+            fml::TimeDelta::FromMicroseconds((frame_count - 1) * 1000));
+  EXPECT_EQ(frames[2].Get(FrameTiming::kRasterFinish).ToEpochDelta(),
+            fml::TimeDelta::FromMicroseconds((frame_count - 1) * 1000 + 6));
+
+  frames = history.GetRecentFrames(frame_count);
+  EXPECT_EQ(frames.size(), FrameTimingHistory::kCapacity);
+  EXPECT_EQ(history.GetStatistics().frame_count, frame_count);
+}
+
+TEST(FrameTimingHistoryTest, CanBeQueriedWhileFramesAreRecorded) {
+  FrameTimingHistory history;
+  const size_t frame_count = 20000;
+  std::thread recorder([&history]() {
+    for (size_t i = 0; i < frame_count; i++) {
+      history.Record(MakeFrame(i * 1000, 1, 2, 3));
+    }
+  });
+
+  uint64_t last_frame_count = 0;
+  while (last_frame_count < frame_count) {
+    const auto statistics = history.GetStatistics();
+    EXPECT_GE(statistics.frame_count, last_frame_count);
+    last_frame_count = statistics.frame_count;
+
+    // Frames that are overwritten while they are read are skipped, so the
+    // frames returned are always consistent and in order.
+    const auto frames = history.GetRecentFrames(FrameTimingHistory::kCapacity);
+    for (size_t i = 0; i < frames.size(); i++) {
+      const auto start = frames[i].Get(FrameTiming::kVsyncStart);
+      EXPECT_EQ(frames[i].Get(FrameTiming::kRasterFinish) - start,
+                fml::TimeDelta::FromMicroseconds(6));
+      if (i > 0) {
+        EXPECT_GT(start, frames[i - 1].Get(FrameTiming::kVsyncStart));
+      }
+    }
+  }
+  recorder.join();
+
+  const auto& raster =
+      history.GetStatistics().intervals[FrameTimingHistory::kRaster];
+  EXPECT_EQ(raster.p99.ToMicroseconds(), 3);
+}
+
+}  // namespace testing
+}  // namespace flutter
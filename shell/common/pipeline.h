@@ -5,6 +5,7 @@
 #ifndef FLUTTER_SHELL_COMMON_PIPELINE_H_
 #define FLUTTER_SHELL_COMMON_PIPELINE_H_
 
+#include <atomic>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -22,10 +23,21 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+enum class PipelineMode {
+  /// Resources are consumed in the order they are produced. Producers fail to
+  /// get a continuation while the pipeline holds |depth| resources.
+  Queue,
+  /// At most one resource waits to be consumed. A newly produced resource
+  /// replaces the waiting one, so the consumer always gets the latest
+  /// resource. Producers never fail to get a continuation. Lock-free.
+  LatestWins,
+};
+
 size_t GetNextPipelineTraceID();
 
 /// A thread-safe queue of resources for a single consumer and a single
-/// producer.
+/// producer, or a single slot holding the latest resource for a single consumer
+/// and multiple producers (see |PipelineMode|).
 template <class R>
 class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
  public:
@@ -90,14 +102,24 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth)
-      : depth_(depth), empty_(depth), available_(0), inflight_(0) {}
+  explicit Pipeline(uint32_t depth, PipelineMode mode = PipelineMode::Queue)
+      : depth_(depth),
+        mode_(mode),
+        empty_(depth),
+        available_(0),
+        inflight_(0),
+        latest_(nullptr) {}
 
-  ~Pipeline() = default;
+  ~Pipeline() { delete latest_.exchange(nullptr); }
 
   bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
 
+  PipelineMode mode() const { return mode_; }
+
   ProducerContinuation Produce() {
+    if (mode_ == PipelineMode::LatestWins) {
+      return ProduceLatest(&Pipeline::ProducerCommitLatest);
+    }
     if (!empty_.TryWait()) {
       return {};
     }
@@ -118,6 +140,9 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   // Prefer using |Produce|. ProducerContinuation returned by this method
   // doesn't guarantee that the frame will be rendered.
   ProducerContinuation ProduceIfEmpty() {
+    if (mode_ == PipelineMode::LatestWins) {
+      return ProduceLatest(&Pipeline::ProducerCommitLatestIfEmpty);
+    }
     if (!empty_.TryWait()) {
       return {};
     }
@@ -141,6 +166,10 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
       return PipelineConsumeResult::NoneAvailable;
     }
 
+    if (mode_ == PipelineMode::LatestWins) {
+      return ConsumeLatest(consumer);
+    }
+
     if (!available_.TryWait()) {
       return PipelineConsumeResult::NoneAvailable;
     }
@@ -172,12 +201,95 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
   }
 
  private:
+  struct LatestItem {
+    ResourcePtr resource;
+    size_t trace_id;
+  };
+
   const uint32_t depth_;
+  const PipelineMode mode_;
   fml::Semaphore empty_;
   fml::Semaphore available_;
   std::atomic<int> inflight_;
   std::mutex queue_mutex_;
   std::deque<std::pair<ResourcePtr, size_t>> queue_;
+  // The resource waiting to be consumed in |PipelineMode::LatestWins|.
+  std::atomic<LatestItem*> latest_;
+
+  ProducerContinuation ProduceLatest(bool (Pipeline::*commit)(ResourcePtr,
+                                                              size_t)) {
+    ++inflight_;
+    FML_TRACE_COUNTER("flutter", "Pipeline Depth",
+                      reinterpret_cast<int64_t>(this),      //
+                      "frames in flight", inflight_.load()  //
+    );
+
+    return ProducerContinuation{
+        std::bind(commit, this, std::placeholders::_1,
+                  std::placeholders::_2),  // continuation
+        GetNextPipelineTraceID()};         // trace id
+  }
+
+  bool ProducerCommitLatest(ResourcePtr resource, size_t trace_id) {
+    if (!resource) {
+      // The continuation was dropped.
+      --inflight_;
+      return false;
+    }
+    auto* item = new LatestItem{std::move(resource), trace_id};
+    LatestItem* replaced = latest_.exchange(item, std::memory_order_acq_rel);
+    if (replaced) {
+      DropLatest(replaced);
+    }
+    return true;
+  }
+
+  bool ProducerCommitLatestIfEmpty(ResourcePtr resource, size_t trace_id) {
+    if (!resource) {
+      --inflight_;
+      return false;
+    }
+    auto* item = new LatestItem{std::move(resource), trace_id};
+    LatestItem* expected = nullptr;
+    if (!latest_.compare_exchange_strong(expected, item,
+                                         std::memory_order_acq_rel)) {
+      // A newer resource is already waiting.
+      DropLatest(item);
+      return false;
+    }
+    return true;
+  }
+
+  void DropLatest(LatestItem* item) {
+    --inflight_;
+    // The resource will never be consumed. End the flow.
+    TRACE_EVENT_INSTANT0("flutter", "PipelineItemDropped");
+    TRACE_FLOW_END("flutter", "PipelineItem", item->trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", item->trace_id);
+    delete item;
+  }
+
+  PipelineConsumeResult ConsumeLatest(const Consumer& consumer) {
+    std::unique_ptr<LatestItem> item(
+        latest_.exchange(nullptr, std::memory_order_acq_rel));
+    if (!item) {
+      return PipelineConsumeResult::NoneAvailable;
+    }
+
+    {
+      TRACE_EVENT0("flutter", "PipelineConsume");
+      consumer(std::move(item->resource));
+    }
+
+    --inflight_;
+
+    TRACE_FLOW_END("flutter", "PipelineItem", item->trace_id);
+    TRACE_EVENT_ASYNC_END0("flutter", "PipelineItem", item->trace_id);
+
+    return latest_.load(std::memory_order_acquire) != nullptr
+               ? PipelineConsumeResult::MoreAvailable
+               : PipelineConsumeResult::Done;
+  }
 
   bool ProducerCommit(ResourcePtr resource, size_t trace_id) {
     {
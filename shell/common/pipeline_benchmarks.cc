@@ -0,0 +1,85 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pipeline.h"
+
+#include <atomic>
+#include <thread>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flutter {
+
+using TimePointPipeline = Pipeline<fml::TimePoint>;
+
+// Produces a frame every |kFrameInterval| while the consumer takes
+// |kRasterDuration| to consume each one, which simulates a raster thread that
+// cannot keep up with the UI thread. Reports how long the consumed frames
+// waited in the pipeline.
+static void BM_PipelineLatencyWithOverloadedConsumer(benchmark::State& state,
+                                                     PipelineMode mode) {
+  const int kFrameCount = 60;
+  const auto kFrameInterval = std::chrono::milliseconds(2);
+  const auto kRasterDuration = std::chrono::milliseconds(5);
+
+  int64_t consumed_frames = 0;
+  int64_t skipped_frames = 0;
+  fml::TimeDelta total_latency;
+
+  while (state.KeepRunning()) {
+    auto pipeline = fml::MakeRefCounted<TimePointPipeline>(2, mode);
+    std::atomic<bool> producing = true;
+
+    std::thread producer([&]() {
+      for (int i = 0; i < kFrameCount; i++) {
+        auto continuation = pipeline->Produce();
+        if (!continuation) {
+          // The animator would have to wait for the next vsync.
+          skipped_frames++;
+        } else {
+          // In |PipelineMode::LatestWins|, this may replace a frame that was
+          // not consumed yet.
+          (void)continuation.Complete(
+              std::make_unique<fml::TimePoint>(fml::TimePoint::Now()));
+        }
+        std::this_thread::sleep_for(kFrameInterval);
+      }
+      producing = false;
+    });
+
+    PipelineConsumeResult result = PipelineConsumeResult::NoneAvailable;
+    while (producing || result != PipelineConsumeResult::NoneAvailable) {
+      result = pipeline->Consume([&](std::unique_ptr<fml::TimePoint> produced) {
+        total_latency = total_latency + (fml::TimePoint::Now() - *produced);
+        consumed_frames++;
+        std::this_thread::sleep_for(kRasterDuration);
+      });
+      if (result == PipelineConsumeResult::NoneAvailable) {
+        std::this_thread::yield();
+      }
+    }
+
+    producer.join();
+  }
+
+  state.counters["ConsumedFrames"] = consumed_frames;
+  state.counters["SkippedFrames"] = skipped_frames;
+  state.counters["AverageLatencyMs"] =
+      consumed_frames > 0
+          ? total_latency.ToMillisecondsF() / consumed_frames
+          : 0;
+}
+
+BENCHMARK_CAPTURE(BM_PipelineLatencyWithOverloadedConsumer,
+                  Queue,
+                  PipelineMode::Queue)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_CAPTURE(BM_PipelineLatencyWithOverloadedConsumer,
+                  LatestWins,
+                  PipelineMode::LatestWins)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
@@ -6,9 +6,12 @@
 
 #include "flutter/shell/common/pipeline.h"
 
+#include <atomic>
 #include <functional>
 #include <future>
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -131,5 +134,129 @@ TEST(PipelineTest, ProduceIfEmptySuccessfulIfQueueIsEmpty) {
   ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
 }
 
+TEST(PipelineTest, LatestWinsReplacesUnconsumedResource) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::LatestWins);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->Produce();
+  ASSERT_TRUE(continuation_1);
+  ASSERT_TRUE(continuation_2);
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  bool result = continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result, true);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result, true);
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_2](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_2); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  PipelineConsumeResult consume_result_2 =
+      pipeline->Consume([](std::unique_ptr<int> v) { FAIL(); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::NoneAvailable);
+}
+
+TEST(PipelineTest, LatestWinsProduceIfEmptyDoesNotReplaceResource) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::LatestWins);
+
+  Continuation continuation_1 = pipeline->Produce();
+  Continuation continuation_2 = pipeline->ProduceIfEmpty();
+
+  const int test_val_1 = 1, test_val_2 = 2;
+  bool result = continuation_1.Complete(std::make_unique<int>(test_val_1));
+  ASSERT_EQ(result, true);
+  result = continuation_2.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result, false);
+
+  PipelineConsumeResult consume_result_1 = pipeline->Consume(
+      [&test_val_1](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_1); });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::Done);
+
+  Continuation continuation_3 = pipeline->ProduceIfEmpty();
+  result = continuation_3.Complete(std::make_unique<int>(test_val_2));
+  ASSERT_EQ(result, true);
+
+  PipelineConsumeResult consume_result_2 = pipeline->Consume(
+      [&test_val_2](std::unique_ptr<int> v) { ASSERT_EQ(*v, test_val_2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, LatestWinsReportsResourcesProducedDuringConsume) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::LatestWins);
+
+  Continuation continuation_1 = pipeline->Produce();
+  ASSERT_EQ(continuation_1.Complete(std::make_unique<int>(1)), true);
+
+  PipelineConsumeResult consume_result_1 =
+      pipeline->Consume([&pipeline](std::unique_ptr<int> v) {
+        ASSERT_EQ(*v, 1);
+        Continuation continuation_2 = pipeline->Produce();
+        ASSERT_EQ(continuation_2.Complete(std::make_unique<int>(2)), true);
+      });
+  ASSERT_EQ(consume_result_1, PipelineConsumeResult::MoreAvailable);
+
+  PipelineConsumeResult consume_result_2 = pipeline->Consume(
+      [](std::unique_ptr<int> v) { ASSERT_EQ(*v, 2); });
+  ASSERT_EQ(consume_result_2, PipelineConsumeResult::Done);
+}
+
+TEST(PipelineTest, LatestWinsConsumesLatestResourceOfConcurrentProducers) {
+  fml::RefPtr<IntPipeline> pipeline =
+      fml::MakeRefCounted<IntPipeline>(1, PipelineMode::LatestWins);
+
+  const int producer_count = 4;
+  const int resources_per_producer = 1000;
+  std::atomic<int> finished_producers = 0;
+  std::vector<std::thread> producers;
+  for (int i = 0; i < producer_count; i++) {
+    producers.emplace_back([&pipeline, &finished_producers]() {
+      for (int j = 1; j <= resources_per_producer; j++) {
+        Continuation continuation = pipeline->Produce();
+        ASSERT_EQ(continuation.Complete(std::make_unique<int>(j)), true);
+      }
+      ++finished_producers;
+    });
+  }
+
+  int last_value = 0;
+  while (finished_producers < producer_count) {
+    PipelineConsumeResult consume_result =
+        pipeline->Consume([&](std::unique_ptr<int> v) { last_value = *v; });
+    if (consume_result == PipelineConsumeResult::NoneAvailable) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  // The latest resource is the last resource of one of the producers, and it
+  // has either been consumed already or is still waiting.
+  (void)pipeline->Consume([&](std::unique_ptr<int> v) { last_value = *v; });
+  ASSERT_EQ(last_value, resources_per_producer);
+}
+
+TEST(PipelineTest, LatestWinsReleasesUnconsumedResources) {
+  std::shared_ptr<int> resource = std::make_shared<int>(1);
+  std::weak_ptr<int> weak_resource = resource;
+
+  {
+    auto pipeline = fml::MakeRefCounted<Pipeline<std::shared_ptr<int>>>(
+        1, PipelineMode::LatestWins);
+    auto continuation = pipeline->Produce();
+    ASSERT_EQ(continuation.Complete(std::make_unique<std::shared_ptr<int>>(
+                  std::move(resource))),
+              true);
+    ASSERT_FALSE(weak_resource.expired());
+  }
+
+  ASSERT_TRUE(weak_resource.expired());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,139 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/platform_message_batcher.h"
+
+#include <string>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+PlatformMessageBatcher::PlatformMessageBatcher(
+    fml::RefPtr<fml::TaskRunner> task_runner,
+    Handler handler)
+    : task_runner_(std::move(task_runner)), handler_(std::move(handler)) {}
+
+PlatformMessageBatcher::~PlatformMessageBatcher() = default;
+
+void PlatformMessageBatcher::Enqueue(fml::RefPtr<PlatformMessage> message) {
+  {
+    std::scoped_lock lock(mutex_);
+    pending_messages_.push_back(std::move(message));
+    if (pending_messages_.size() > 1) {
+      // A drain task is already pending and will pick this message up.
+      return;
+    }
+  }
+
+  task_runner_->PostTask([weak_batcher = weak_from_this()]() {
+    if (auto batcher = weak_batcher.lock()) {
+      batcher->Drain();
+    }
+  });
+}
+
+void PlatformMessageBatcher::Drain() {
+  Messages messages;
+  {
+    std::scoped_lock lock(mutex_);
+    messages.swap(pending_messages_);
+  }
+  TRACE_EVENT1("flutter", "PlatformMessageBatcher::Drain", "count",
+               std::to_string(messages.size()).c_str());
+  handler_(std::move(messages));
+}
+
+class PlatformMessageResponseBatcher::BatchedResponse
+    : public PlatformMessageResponse {
+ public:
+  BatchedResponse(std::weak_ptr<PlatformMessageResponseBatcher> batcher,
+                  fml::RefPtr<PlatformMessageResponse> response)
+      : batcher_(std::move(batcher)), response_(std::move(response)) {}
+
+  // |PlatformMessageResponse|
+  void Complete(std::unique_ptr<fml::Mapping> data) override {
+    FML_DCHECK(!is_complete_);
+    is_complete_ = true;
+    if (auto batcher = batcher_.lock()) {
+      batcher->Enqueue(std::move(response_), std::move(data));
+    } else {
+      response_->Complete(std::move(data));
+    }
+  }
+
+  // |PlatformMessageResponse|
+  void CompleteEmpty() override {
+    FML_DCHECK(!is_complete_);
+    is_complete_ = true;
+    if (auto batcher = batcher_.lock()) {
+      batcher->Enqueue(std::move(response_), nullptr);
+    } else {
+      response_->CompleteEmpty();
+    }
+  }
+
+ private:
+  const std::weak_ptr<PlatformMessageResponseBatcher> batcher_;
+  fml::RefPtr<PlatformMessageResponse> response_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(BatchedResponse);
+};
+
+PlatformMessageResponseBatcher::PlatformMessageResponseBatcher(
+    fml::RefPtr<fml::TaskRunner> platform_task_runner)
+    : platform_task_runner_(std::move(platform_task_runner)) {}
+
+PlatformMessageResponseBatcher::~PlatformMessageResponseBatcher() {
+  // No drain task can run anymore, so the responses are posted one by one.
+  for (auto& pending : pending_responses_) {
+    if (pending.data) {
+      pending.response->Complete(std::move(pending.data));
+    } else {
+      pending.response->CompleteEmpty();
+    }
+  }
+}
+
+fml::RefPtr<PlatformMessageResponse> PlatformMessageResponseBatcher::Wrap(
+    fml::RefPtr<PlatformMessageResponse> response) {
+  return fml::MakeRefCounted<BatchedResponse>(weak_from_this(),
+                                              std::move(response));
+}
+
+void PlatformMessageResponseBatcher::Enqueue(
+    fml::RefPtr<PlatformMessageResponse> response,
+    std::unique_ptr<fml::Mapping> data) {
+  {
+    std::scoped_lock lock(mutex_);
+    pending_responses_.push_back({std::move(response), std::move(data)});
+    if (pending_responses_.size() > 1) {
+      // A drain task is already pending and will pick this response up.
+      return;
+    }
+  }
+
+  platform_task_runner_->PostTask([weak_batcher = weak_from_this()]() {
+    if (auto batcher = weak_batcher.lock()) {
+      batcher->Drain();
+    }
+  });
+}
+
+void PlatformMessageResponseBatcher::Drain() {
+  std::vector<PendingResponse> responses;
+  {
+    std::scoped_lock lock(mutex_);
+    responses.swap(pending_responses_);
+  }
+  TRACE_EVENT1("flutter", "PlatformMessageResponseBatcher::Drain", "count",
+               std::to_string(responses.size()).c_str());
+  for (auto& pending : responses) {
+    pending.response->CompleteOnPlatformThread(std::move(pending.data));
+  }
+}
+
+}  // namespace flutter
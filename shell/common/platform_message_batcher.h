@@ -0,0 +1,101 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BATCHER_H_
+#define FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BATCHER_H_
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/lib/ui/window/platform_message.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Coalesces the platform messages sent from one thread to another.
+///
+/// The first message queued while the batcher is empty posts a task to the
+/// target task runner. That task hands all the messages queued by the time it
+/// runs to the handler at once, in the order they were queued, so a burst of
+/// messages costs a single task instead of one task per message.
+///
+/// Messages may be queued from any thread. The batcher must be owned by a
+/// `std::shared_ptr`. Messages still queued when it is collected are dropped.
+///
+class PlatformMessageBatcher
+    : public std::enable_shared_from_this<PlatformMessageBatcher> {
+ public:
+  using Messages = std::vector<fml::RefPtr<PlatformMessage>>;
+  using Handler = std::function<void(Messages messages)>;
+
+  PlatformMessageBatcher(fml::RefPtr<fml::TaskRunner> task_runner,
+                         Handler handler);
+
+  ~PlatformMessageBatcher();
+
+  void Enqueue(fml::RefPtr<PlatformMessage> message);
+
+ private:
+  const fml::RefPtr<fml::TaskRunner> task_runner_;
+  const Handler handler_;
+  std::mutex mutex_;
+  Messages pending_messages_;
+
+  void Drain();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageBatcher);
+};
+
+//------------------------------------------------------------------------------
+/// Coalesces the responses to the messages sent by the platform.
+///
+/// The responses returned by `Wrap` may be completed on any thread. The first
+/// response completed while the batcher is empty posts a task to the platform
+/// task runner. That task delivers all the responses completed by the time it
+/// runs through `PlatformMessageResponse::CompleteOnPlatformThread`, in the
+/// order they were completed.
+///
+/// The batcher must be owned by a `std::shared_ptr`. Responses completed after
+/// it is collected, or still queued when it is collected, are delivered
+/// through the `Complete` methods of the wrapped responses instead.
+///
+class PlatformMessageResponseBatcher
+    : public std::enable_shared_from_this<PlatformMessageResponseBatcher> {
+ public:
+  explicit PlatformMessageResponseBatcher(
+      fml::RefPtr<fml::TaskRunner> platform_task_runner);
+
+  ~PlatformMessageResponseBatcher();
+
+  fml::RefPtr<PlatformMessageResponse> Wrap(
+      fml::RefPtr<PlatformMessageResponse> response);
+
+ private:
+  class BatchedResponse;
+
+  struct PendingResponse {
+    fml::RefPtr<PlatformMessageResponse> response;
+    std::unique_ptr<fml::Mapping> data;
+  };
+
+  const fml::RefPtr<fml::TaskRunner> platform_task_runner_;
+  std::mutex mutex_;
+  std::vector<PendingResponse> pending_responses_;
+
+  void Enqueue(fml::RefPtr<PlatformMessageResponse> response,
+               std::unique_ptr<fml::Mapping> data);
+
+  void Drain();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformMessageResponseBatcher);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_PLATFORM_MESSAGE_BATCHER_H_
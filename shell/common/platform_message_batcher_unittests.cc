@@ -0,0 +1,150 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/shell/common/platform_message_batcher.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+static fml::RefPtr<PlatformMessage> MakeMessage(const std::string& channel) {
+  return fml::MakeRefCounted<PlatformMessage>(
+      channel, fml::RefPtr<PlatformMessageResponse>());
+}
+
+TEST(PlatformMessageBatcherTest, DrainsQueuedMessagesInOneTask) {
+  fml::Thread thread("test");
+  std::vector<std::vector<std::string>> batches;
+  fml::AutoResetWaitableEvent drained;
+  auto batcher = std::make_shared<PlatformMessageBatcher>(
+      thread.GetTaskRunner(), [&](PlatformMessageBatcher::Messages messages) {
+        std::vector<std::string> channels;
+        for (const auto& message : messages) {
+          channels.push_back(message->channel());
+        }
+        batches.push_back(std::move(channels));
+        drained.Signal();
+      });
+
+  // Keeps the thread busy while the messages are queued.
+  fml::AutoResetWaitableEvent release_thread;
+  thread.GetTaskRunner()->PostTask([&]() { release_thread.Wait(); });
+  batcher->Enqueue(MakeMessage("a"));
+  batcher->Enqueue(MakeMessage("b"));
+  batcher->Enqueue(MakeMessage("c"));
+  release_thread.Signal();
+  drained.Wait();
+
+  batcher->Enqueue(MakeMessage("d"));
+  drained.Wait();
+
+  ASSERT_EQ(batches.size(), 2u);
+  EXPECT_EQ(batches[0], (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(batches[1], (std::vector<std::string>{"d"}));
+}
+
+TEST(PlatformMessageBatcherTest, DropsMessagesOfCollectedBatchers) {
+  fml::Thread thread("test");
+  size_t drain_count = 0;
+  auto batcher = std::make_shared<PlatformMessageBatcher>(
+      thread.GetTaskRunner(),
+      [&](PlatformMessageBatcher::Messages messages) { drain_count++; });
+
+  fml::AutoResetWaitableEvent release_thread;
+  thread.GetTaskRunner()->PostTask([&]() { release_thread.Wait(); });
+  batcher->Enqueue(MakeMessage("a"));
+  batcher.reset();
+  release_thread.Signal();
+
+  fml::AutoResetWaitableEvent done;
+  thread.GetTaskRunner()->PostTask([&]() { done.Signal(); });
+  done.Wait();
+  EXPECT_EQ(drain_count, 0u);
+}
+
+namespace {
+class RecordingResponse : public PlatformMessageResponse {
+ public:
+  RecordingResponse(std::string name, std::vector<std::string>* delivered)
+      : name_(std::move(name)), delivered_(delivered) {}
+
+  // |PlatformMessageResponse|
+  void Complete(std::unique_ptr<fml::Mapping> data) override {
+    delivered_->push_back(name_ + " posted");
+  }
+
+  // |PlatformMessageResponse|
+  void CompleteEmpty() override { delivered_->push_back(name_ + " posted"); }
+
+  // |PlatformMessageResponse|
+  void CompleteOnPlatformThread(std::unique_ptr<fml::Mapping> data) override {
+    delivered_->push_back(name_ + (data ? " data" : " empty"));
+  }
+
+ private:
+  const std::string name_;
+  std::vector<std::string>* const delivered_;
+};
+}  // namespace
+
+TEST(PlatformMessageResponseBatcherTest, DeliversQueuedResponsesInOneTask) {
+  fml::Thread thread("test");
+  std::vector<std::string> delivered;
+  auto batcher =
+      std::make_shared<PlatformMessageResponseBatcher>(thread.GetTaskRunner());
+  auto a = batcher->Wrap(
+      fml::MakeRefCounted<RecordingResponse>("a", &delivered));
+  auto b = batcher->Wrap(
+      fml::MakeRefCounted<RecordingResponse>("b", &delivered));
+
+  fml::AutoResetWaitableEvent release_thread;
+  thread.GetTaskRunner()->PostTask([&]() { release_thread.Wait(); });
+  b->CompleteEmpty();
+  a->Complete(std::make_unique<fml::DataMapping>(std::vector<uint8_t>{1}));
+  // Runs after the drain task, which was posted when |b| completed.
+  fml::AutoResetWaitableEvent done;
+  thread.GetTaskRunner()->PostTask([&]() { done.Signal(); });
+  release_thread.Signal();
+  done.Wait();
+
+  EXPECT_EQ(delivered, (std::vector<std::string>{"b empty", "a data"}));
+  EXPECT_TRUE(a->is_complete());
+  EXPECT_TRUE(b->is_complete());
+}
+
+TEST(PlatformMessageResponseBatcherTest, PostsResponsesOfCollectedBatchers) {
+  fml::Thread thread("test");
+  std::vector<std::string> delivered;
+  auto batcher =
+      std::make_shared<PlatformMessageResponseBatcher>(thread.GetTaskRunner());
+  auto a = batcher->Wrap(
+      fml::MakeRefCounted<RecordingResponse>("a", &delivered));
+  auto b = batcher->Wrap(
+      fml::MakeRefCounted<RecordingResponse>("b", &delivered));
+
+  fml::AutoResetWaitableEvent release_thread;
+  thread.GetTaskRunner()->PostTask([&]() { release_thread.Wait(); });
+  a->CompleteEmpty();
+  batcher.reset();
+  b->CompleteEmpty();
+  release_thread.Signal();
+
+  fml::AutoResetWaitableEvent done;
+  thread.GetTaskRunner()->PostTask([&]() { done.Signal(); });
+  done.Wait();
+  EXPECT_EQ(delivered, (std::vector<std::string>{"a posted", "b posted"}));
+}
+
+}  // namespace testing
+}  // namespace flutter
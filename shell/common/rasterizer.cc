@@ -100,6 +100,7 @@ void Rasterizer::Teardown() {
   compositor_context_->OnGrContextDestroyed();
   surface_.reset();
   last_layer_tree_.reset();
+  prev_paint_regions_.reset();
 
   if (raster_thread_merger_.get() != nullptr &&
       raster_thread_merger_.get()->IsMerged()) {
@@ -450,6 +451,19 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   auto root_surface_canvas =
       embedder_root_canvas ? embedder_root_canvas : frame->SkiaCanvas();
 
+  // Partial repaint relies on the paint regions of the previous frame matching
+  // the contents of the root surface, which does not hold when an external
+  // view embedder splits the frame into several surfaces.
+  std::optional<FrameDamage> damage;
+  if (!external_view_embedder_ &&
+      frame->framebuffer_info().supports_partial_repaint) {
+    damage.emplace();
+    damage->existing_buffer_damage = frame->framebuffer_info().existing_damage;
+    if (prev_paint_regions_) {
+      damage->prev_paint_regions = &prev_paint_regions_.value();
+    }
+  }
+
   auto compositor_frame = compositor_context_->AcquireFrame(
       surface_->GetContext(),         // skia GrContext
       root_surface_canvas,            // root surface canvas
@@ -461,11 +475,23 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   );
 
   if (compositor_frame) {
-    RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
+    RasterStatus raster_status = compositor_frame->Raster(
+        layer_tree, false, damage ? &damage.value() : nullptr);
     if (raster_status == RasterStatus::kFailed ||
         raster_status == RasterStatus::kSkipAndRetry) {
+      prev_paint_regions_.reset();
       return raster_status;
     }
+    // The paint regions only describe the root surface once the frame has
+    // been presented, so they are kept until |Submit| succeeds.
+    std::optional<PaintRegionList> paint_regions;
+    if (damage && damage->frame_damage) {
+      SurfaceFrame::SubmitInfo submit_info;
+      submit_info.frame_damage = damage->frame_damage;
+      submit_info.buffer_damage = damage->buffer_damage;
+      frame->set_submit_info(submit_info);
+      paint_regions = std::move(damage->paint_regions);
+    }
     if (shared_engine_block_thread_merging_ && raster_thread_merger_ &&
         raster_thread_merger_->IsMerged()) {
       // TODO(73620): Remove when platform views are accounted for.
@@ -480,11 +506,14 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
     if (external_view_embedder_ &&
         (!raster_thread_merger_ || raster_thread_merger_->IsMerged())) {
       FML_DCHECK(!frame->IsSubmitted());
+      prev_paint_regions_.reset();
       external_view_embedder_->SubmitFrame(
           surface_->GetContext(), std::move(frame),
           delegate_.GetIsGpuDisabledSyncSwitch());
+    } else if (frame->Submit()) {
+      prev_paint_regions_ = std::move(paint_regions);
     } else {
-      frame->Submit();
+      prev_paint_regions_.reset();
     }
 
     FireNextFrameCallbackIfPresent();
@@ -449,6 +449,10 @@ class Rasterizer final : public SnapshotDelegate {
   std::unique_ptr<flutter::CompositorContext> compositor_context_;
   // This is the last successfully rasterized layer tree.
   std::unique_ptr<flutter::LayerTree> last_layer_tree_;
+  // The paint regions of the last frame submitted to the surface. Used to
+  // compute the damage of the next frame when the surface supports partial
+  // repaint.
+  std::optional<PaintRegionList> prev_paint_regions_;
   // Set when we need attempt to rasterize the layer tree again. This layer_tree
   // has not successfully rasterized. This can happen due to the change in the
   // thread configuration. This will be inserted to the front of the pipeline.
@@ -9,6 +9,7 @@
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/testing.h"
 #include "gmock/gmock.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 using testing::_;
 using testing::ByMove;
@@ -299,4 +300,63 @@ TEST(RasterizerTest, externalViewEmbedderDoesntEndFrameWhenNoSurfaceIsSet) {
   });
   latch.Wait();
 }
+
+TEST(RasterizerTest, failedSubmitDoesNotUpdatePreviousPaintRegions) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::Platform | ThreadHost::Type::RASTER |
+                             ThreadHost::Type::IO | ThreadHost::Type::UI);
+  TaskRunners task_runners("test", thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  MockDelegate delegate;
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<MockSurface>();
+
+  const SkISize frame_size = SkISize::Make(100, 100);
+  // The first frame fails to present, so the second frame cannot be diffed
+  // against it and is damaged as a whole.
+  std::vector<bool> submit_results = {false, true, true};
+  std::vector<std::optional<SkIRect>> frame_damages;
+  EXPECT_CALL(*surface, AcquireFrame(frame_size))
+      .Times(3)
+      .WillRepeatedly([&](const SkISize& size) {
+        SurfaceFrame::FramebufferInfo framebuffer_info;
+        framebuffer_info.supports_partial_repaint = true;
+        framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+        return std::make_unique<SurfaceFrame>(
+            SkSurface::MakeRasterN32Premul(size.width(), size.height()),
+            /*supports_readback=*/true,
+            /*submit_callback=*/
+            [&](const SurfaceFrame& frame, SkCanvas*) {
+              frame_damages.push_back(frame.submit_info().frame_damage);
+              return submit_results[frame_damages.size() - 1];
+            },
+            framebuffer_info);
+      });
+
+  rasterizer->Setup(std::move(surface));
+  fml::AutoResetWaitableEvent latch;
+  thread_host.raster_thread->GetTaskRunner()->PostTask([&] {
+    auto pipeline = fml::AdoptRef(new Pipeline<LayerTree>(/*depth=*/10));
+    auto no_discard = [](LayerTree&) { return false; };
+    for (size_t i = 0; i < submit_results.size(); i++) {
+      auto layer_tree = std::make_unique<LayerTree>(
+          frame_size, /*device_pixel_ratio=*/1.0f);
+      EXPECT_TRUE(pipeline->Produce().Complete(std::move(layer_tree)));
+      rasterizer->Draw(pipeline, no_discard);
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+
+  ASSERT_EQ(frame_damages.size(), 3u);
+  EXPECT_EQ(frame_damages[0], SkIRect::MakeSize(frame_size));
+  EXPECT_EQ(frame_damages[1], SkIRect::MakeSize(frame_size));
+  EXPECT_EQ(frame_damages[2], SkIRect::MakeEmpty());
+}
 }  // namespace flutter
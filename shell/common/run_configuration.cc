@@ -7,6 +7,7 @@
 #include <sstream>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/assets/packed_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/unique_fd.h"
@@ -24,10 +25,17 @@ RunConfiguration RunConfiguration::InferFromSettings(
         fml::Duplicate(settings.assets_dir), true));
   }
 
-  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
-      fml::OpenDirectory(settings.assets_path.c_str(), false,
-                         fml::FilePermission::kRead),
-      true));
+  if (fml::IsFile(settings.assets_path)) {
+    asset_manager->PushBack(std::make_unique<PackedAssetBundle>(
+        fml::OpenFile(settings.assets_path.c_str(), false,
+                      fml::FilePermission::kRead),
+        true));
+  } else {
+    asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
+        fml::OpenDirectory(settings.assets_path.c_str(), false,
+                           fml::FilePermission::kRead),
+        true));
+  }
 
   return {IsolateConfiguration::InferFromSettings(settings, asset_manager,
                                                   io_worker),
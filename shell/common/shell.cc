@@ -5,21 +5,26 @@
 #define RAPIDJSON_HAS_STDSTRING 1
 #include "flutter/shell/common/shell.h"
 
+#include <iterator>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/flow/layer_profiler.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/log_settings.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/message_loop_task_queues.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
@@ -31,6 +36,7 @@
 #include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/skia/include/utils/SkBase64.h"
 #include "third_party/tonic/common/log.h"
+#include "txt/font_collection.h"
 
 namespace flutter {
 
@@ -101,6 +107,22 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
   ]() {
         TRACE_EVENT0("flutter", "ShellSetupGPUSubsystem");
         std::unique_ptr<Rasterizer> rasterizer(on_create_rasterizer(*shell));
+        auto& raster_cache = rasterizer->compositor_context()->raster_cache();
+        const auto& settings = shell->GetSettings();
+        if (settings.raster_cache_max_bytes >= 0) {
+          raster_cache.SetMaxBytes(
+              settings.raster_cache_max_bytes == 0
+                  ? std::numeric_limits<size_t>::max()
+                  : static_cast<size_t>(settings.raster_cache_max_bytes));
+        }
+        if (settings.enable_async_raster_cache) {
+          raster_cache.SetWorkerTaskRunner(
+              shell->GetDartVM()->GetConcurrentWorkerTaskRunner());
+        }
+        if (settings.raster_cache_reuse_scale_tolerance > 0) {
+          const double tolerance = settings.raster_cache_reuse_scale_tolerance;
+          raster_cache.SetReuseScaleBounds(1 / (1 + tolerance), 1 + tolerance);
+        }
         snapshot_delegate_promise.set_value(rasterizer->GetSnapshotDelegate());
         rasterizer_promise.set_value(std::move(rasterizer));
       });
@@ -178,8 +200,11 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            shell->GetSettings().enable_latest_frame_pipeline
+                ? PipelineMode::LatestWins
+                : PipelineMode::Queue);
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -269,6 +294,19 @@ static void PerformInitializationTasks(Settings& settings) {
   });
 }
 
+// The decoded image cache and the shaping cache are shared by all the shells
+// of the process, so the settings of the last shell created apply.
+static void SetProcessCacheMaxBytes(const Settings& settings) {
+  if (settings.decoded_image_cache_max_bytes >= 0) {
+    DecodedImageCache::GetCacheForProcess()->SetMaxBytes(
+        static_cast<size_t>(settings.decoded_image_cache_max_bytes));
+  }
+  if (settings.shaping_cache_max_bytes >= 0) {
+    txt::FontCollection::SetShapingCacheMaxBytes(
+        static_cast<size_t>(settings.shaping_cache_max_bytes));
+  }
+}
+
 std::unique_ptr<Shell> Shell::Create(
     TaskRunners task_runners,
     Settings settings,
@@ -290,6 +328,7 @@ std::unique_ptr<Shell> Shell::Create(
     Shell::CreateCallback<Rasterizer> on_create_rasterizer) {
   PerformInitializationTasks(settings);
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+  SetProcessCacheMaxBytes(settings);
 
   TRACE_EVENT0("flutter", "Shell::Create");
 
@@ -319,6 +358,7 @@ std::unique_ptr<Shell> Shell::Create(
     const Shell::EngineCreateCallback& on_create_engine) {
   PerformInitializationTasks(settings);
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+  SetProcessCacheMaxBytes(settings);
 
   TRACE_EVENT0("flutter", "Shell::CreateWithSnapshots");
 
@@ -419,6 +459,25 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolEstimateRasterCacheMemory, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetDecodedImageCacheStatsExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetDecodedImageCacheStats, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetFrameTimingStatisticsExtensionName] = {
+          task_runners_.GetIOTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetFrameTimingStatistics, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kSetLayerProfilingEnabledExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolSetLayerProfilingEnabled, this,
+                    std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_[ServiceProtocol::kGetLayerProfileExtensionName] =
+      {task_runners_.GetRasterTaskRunner(),
+       std::bind(&Shell::OnServiceProtocolGetLayerProfile, this,
+                 std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -636,6 +695,29 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   weak_rasterizer_ = rasterizer_->GetWeakPtr();
   weak_platform_view_ = platform_view_->GetWeakPtr();
 
+  if (settings_.enable_platform_message_batching) {
+    messages_to_engine_ = std::make_shared<PlatformMessageBatcher>(
+        task_runners_.GetUITaskRunner(),
+        [engine = weak_engine_](PlatformMessageBatcher::Messages messages) {
+          if (engine) {
+            engine->DispatchPlatformMessages(std::move(messages));
+          }
+        });
+    messages_to_platform_ = std::make_shared<PlatformMessageBatcher>(
+        task_runners_.GetPlatformTaskRunner(),
+        [view =
+             weak_platform_view_](PlatformMessageBatcher::Messages messages) {
+          if (!view) {
+            return;
+          }
+          for (auto& message : messages) {
+            view->HandlePlatformMessage(std::move(message));
+          }
+        });
+    responses_to_platform_ = std::make_shared<PlatformMessageResponseBatcher>(
+        task_runners_.GetPlatformTaskRunner());
+  }
+
   // Setup the time-consuming default font manager right after engine created.
   fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(),
                                     [engine = weak_engine_] {
@@ -663,6 +745,10 @@ const Settings& Shell::GetSettings() const {
   return settings_;
 }
 
+const FrameTimingHistory& Shell::GetFrameTimingHistory() const {
+  return frame_timing_history_;
+}
+
 const TaskRunners& Shell::GetTaskRunners() const {
   return task_runners_;
 }
@@ -936,12 +1022,20 @@ void Shell::OnPlatformViewDispatchPlatformMessage(
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
-  task_runners_.GetUITaskRunner()->PostTask(
-      [engine = engine_->GetWeakPtr(), message = std::move(message)] {
-        if (engine) {
-          engine->DispatchPlatformMessage(std::move(message));
-        }
-      });
+  if (!messages_to_engine_) {
+    task_runners_.GetUITaskRunner()->PostTask(
+        [engine = engine_->GetWeakPtr(), message = std::move(message)] {
+          if (engine) {
+            engine->DispatchPlatformMessage(std::move(message));
+          }
+        });
+    return;
+  }
+
+  if (message->response()) {
+    message->set_response(responses_to_platform_->Wrap(message->response()));
+  }
+  messages_to_engine_->Enqueue(std::move(message));
 }
 
 // |PlatformView::Delegate|
@@ -1101,6 +1195,16 @@ void Shell::OnAnimatorNotifyIdle(int64_t deadline) {
     engine_->NotifyIdle(deadline);
     volatile_path_tracker_->OnFrame();
   }
+
+  // Let idle priority tasks of the UI thread run until the deadline. The
+  // deadline is based on the clock of the Dart timeline.
+  if (fml::MessageLoop::IsInitializedForCurrentThread()) {
+    const auto idle_deadline =
+        fml::TimePoint::Now() +
+        fml::TimeDelta::FromMicroseconds(deadline - Dart_TimelineGetMicros());
+    fml::MessageLoopTaskQueues::GetInstance()->SetIdleDeadline(
+        fml::MessageLoop::GetCurrentTaskQueueId(), idle_deadline);
+  }
 }
 
 // |Animator::Delegate|
@@ -1178,12 +1282,17 @@ void Shell::OnEngineHandlePlatformMessage(
     return;
   }
 
-  task_runners_.GetPlatformTaskRunner()->PostTask(
-      [view = platform_view_->GetWeakPtr(), message = std::move(message)]() {
-        if (view) {
-          view->HandlePlatformMessage(std::move(message));
-        }
-      });
+  if (!messages_to_platform_) {
+    task_runners_.GetPlatformTaskRunner()->PostTask(
+        [view = platform_view_->GetWeakPtr(), message = std::move(message)]() {
+          if (view) {
+            view->HandlePlatformMessage(std::move(message));
+          }
+        });
+    return;
+  }
+
+  messages_to_platform_->Enqueue(std::move(message));
 }
 
 void Shell::HandleEngineSkiaMessage(fml::RefPtr<PlatformMessage> message) {
@@ -1328,6 +1437,8 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  frame_timing_history_.Record(timing);
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1638,6 +1749,178 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
   response->AddMember<uint64_t>("pictureBytes",
                                 raster_cache.EstimatePictureCacheByteSize(),
                                 response->GetAllocator());
+  response->AddMember<uint64_t>("maxBytes", raster_cache.max_bytes(),
+                                response->GetAllocator());
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetDecodedImageCacheStats(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  const auto stats = DecodedImageCache::GetCacheForProcess()->GetStats();
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "DecodedImageCacheStats", allocator);
+  response->AddMember<uint64_t>("entryCount", stats.entry_count, allocator);
+  response->AddMember<uint64_t>("bytes", stats.bytes, allocator);
+  response->AddMember<uint64_t>("maxBytes", stats.max_bytes, allocator);
+  response->AddMember<uint64_t>("hitCount", stats.hit_count, allocator);
+  response->AddMember<uint64_t>("missCount", stats.miss_count, allocator);
+  response->AddMember<uint64_t>("evictionCount", stats.eviction_count,
+                                allocator);
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetFrameTimingStatistics(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetIOTaskRunner()->RunsTasksOnCurrentThread());
+  int64_t recent_frame_count = 0;
+  if (params.count("recentFrameCount") > 0) {
+    std::stringstream stream(params.at("recentFrameCount"));
+    if (!(stream >> recent_frame_count) || recent_frame_count < 0) {
+      ServiceProtocolParameterError(
+          response, "'recentFrameCount' must be a non-negative integer.");
+      return false;
+    }
+  }
+
+  const auto statistics = frame_timing_history_.GetStatistics();
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "FrameTimingStatistics", allocator);
+  response->AddMember<uint64_t>("frameCount", statistics.frame_count,
+                                allocator);
+
+  // Intervals are in microseconds, like the timings reported to Dart.
+  static constexpr const char* kIntervalNames[] = {
+      "vsyncOverhead",
+      "build",
+      "raster",
+      "total",
+  };
+  static_assert(
+      std::size(kIntervalNames) == FrameTimingHistory::kIntervalCount,
+      "Every interval must be named.");
+  for (size_t i = 0; i < FrameTimingHistory::kIntervalCount; i++) {
+    const auto& percentiles = statistics.intervals[i];
+    rapidjson::Value interval(rapidjson::kObjectType);
+    interval.AddMember<int64_t>("p50", percentiles.p50.ToMicroseconds(),
+                                allocator);
+    interval.AddMember<int64_t>("p90", percentiles.p90.ToMicroseconds(),
+                                allocator);
+    interval.AddMember<int64_t>("p99", percentiles.p99.ToMicroseconds(),
+                                allocator);
+    interval.AddMember<int64_t>("max", percentiles.max.ToMicroseconds(),
+                                allocator);
+    response->AddMember(rapidjson::StringRef(kIntervalNames[i]), interval,
+                        allocator);
+  }
+
+  if (recent_frame_count > 0) {
+    // Each frame is a list of its FrameTiming::kCount phase timestamps.
+    rapidjson::Value frames(rapidjson::kArrayType);
+    for (const auto& timing :
+         frame_timing_history_.GetRecentFrames(recent_frame_count)) {
+      rapidjson::Value phases(rapidjson::kArrayType);
+      for (auto phase : FrameTiming::kPhases) {
+        phases.PushBack<int64_t>(
+            timing.Get(phase).ToEpochDelta().ToMicroseconds(), allocator);
+      }
+      frames.PushBack(phases, allocator);
+    }
+    response->AddMember("recentFrames", frames, allocator);
+  }
+  return true;
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolSetLayerProfilingEnabled(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  if (params.count("enabled") == 0) {
+    ServiceProtocolParameterError(response, "'enabled' parameter is missing.");
+    return false;
+  }
+  const std::string& enabled = params.at("enabled");
+  if (enabled != "true" && enabled != "false") {
+    ServiceProtocolParameterError(response,
+                                  "'enabled' must be 'true' or 'false'.");
+    return false;
+  }
+
+  rasterizer_->compositor_context()->set_layer_profiling_enabled(enabled ==
+                                                                 "true");
+  response->SetObject();
+  response->AddMember("type", "Success", response->GetAllocator());
+  return true;
+}
+
+// Writes the entry of |profile| at |index| and the entries of its
+// descendants to |layer| as a JSON tree.
+static void LayerProfileEntryToJson(
+    const LayerProfiler& profile,
+    const std::vector<std::vector<size_t>>& children,
+    size_t index,
+    rapidjson::Value& layer,
+    rapidjson::Document::AllocatorType& allocator) {
+  const auto& entry = profile.entries()[index];
+  layer.SetObject();
+  layer.AddMember<uint64_t>("id", entry.layer_id, allocator);
+  layer.AddMember("type", rapidjson::StringRef(entry.type_name), allocator);
+  layer.AddMember("prerollMicros", entry.preroll_time.ToMicrosecondsF(),
+                  allocator);
+  layer.AddMember("paintMicros", entry.paint_time.ToMicrosecondsF(),
+                  allocator);
+  layer.AddMember<uint64_t>("saveLayerCount", entry.save_layer_count,
+                            allocator);
+  layer.AddMember<uint64_t>("rasterCacheHitCount",
+                            entry.raster_cache_hit_count, allocator);
+  rapidjson::Value children_json(rapidjson::kArrayType);
+  for (size_t child : children[index]) {
+    rapidjson::Value child_json;
+    LayerProfileEntryToJson(profile, children, child, child_json, allocator);
+    children_json.PushBack(child_json, allocator);
+  }
+  layer.AddMember("children", children_json, allocator);
+}
+
+// Service protocol handler
+bool Shell::OnServiceProtocolGetLayerProfile(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  const auto* compositor_context = rasterizer_->compositor_context();
+  auto& allocator = response->GetAllocator();
+  response->SetObject();
+  response->AddMember("type", "LayerProfile", allocator);
+  response->AddMember("enabled", compositor_context->layer_profiling_enabled(),
+                      allocator);
+
+  // Times are in microseconds and include the times of the children.
+  rapidjson::Value layers(rapidjson::kArrayType);
+  if (auto profile = compositor_context->last_layer_profile()) {
+    const auto& entries = profile->entries();
+    std::vector<std::vector<size_t>> children(entries.size());
+    std::vector<size_t> roots;
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (entries[i].parent == LayerProfiler::kNoParent) {
+        roots.push_back(i);
+      } else {
+        children[entries[i].parent].push_back(i);
+      }
+    }
+    for (size_t root : roots) {
+      rapidjson::Value layer;
+      LayerProfileEntryToJson(*profile, children, root, layer, allocator);
+      layers.PushBack(layer, allocator);
+    }
+  }
+  response->AddMember("layers", layers, allocator);
   return true;
 }
 
@@ -34,6 +34,8 @@
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/display_manager.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_timing_history.h"
+#include "flutter/shell/common/platform_message_batcher.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -253,6 +255,13 @@ class Shell final : public PlatformView::Delegate,
   ///
   const Settings& GetSettings() const;
 
+  //------------------------------------------------------------------------------
+  /// @return     The timings of the frames rasterized by this shell, and their
+  ///             percentiles. Unlike the rest of the shell, the history may
+  ///             be queried from any thread.
+  ///
+  const FrameTimingHistory& GetFrameTimingHistory() const;
+
   //------------------------------------------------------------------------------
   /// @brief      If callers wish to interact directly with any shell
   ///             subcomponents, they must (on the platform thread) obtain a
@@ -420,6 +429,13 @@ class Shell final : public PlatformView::Delegate,
   fml::WeakPtr<PlatformView>
       weak_platform_view_;  // to be shared across threads
 
+  // Coalesce the messages from the platform to the engine, from the engine to
+  // the platform, and the responses to the platform, into one task per burst.
+  // Only created when |Settings::enable_platform_message_batching| is set.
+  std::shared_ptr<PlatformMessageBatcher> messages_to_engine_;
+  std::shared_ptr<PlatformMessageBatcher> messages_to_platform_;
+  std::shared_ptr<PlatformMessageResponseBatcher> responses_to_platform_;
+
   std::unordered_map<std::string_view,  // method
                      std::pair<fml::RefPtr<fml::TaskRunner>,
                                ServiceProtocolHandler>  // task-runner/function
@@ -448,6 +464,10 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // The timings of all the rasterized frames, recorded whether or not they
+  // are reported to Dart.
+  FrameTimingHistory frame_timing_history_;
+
   /// Manages the displays. This class is thread safe, can be accessed from any
   /// of the threads.
   std::unique_ptr<DisplayManager> display_manager_;
@@ -653,6 +673,37 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // The decoded image cache is shared by all engines in the process.
+  bool OnServiceProtocolGetDecodedImageCacheStats(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // Reports the percentiles of the frame phase intervals, and the timings of
+  // the last `recentFrameCount` frames if that parameter is given.
+  bool OnServiceProtocolGetFrameTimingStatistics(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // Turns the per-layer profiling of the rasterized frames on or off
+  // depending on the `enabled` parameter.
+  bool OnServiceProtocolSetLayerProfilingEnabled(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
+  // Service protocol handler
+  //
+  // Reports the layer tree of the last frame rasterized while layer profiling
+  // was enabled, with the costs of each layer.
+  bool OnServiceProtocolGetLayerProfile(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Creates an asset bundle from the original settings asset path or
   // directory.
   std::unique_ptr<DirectoryAssetBundle> RestoreOriginalAssetResolver();
@@ -7,6 +7,7 @@
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 
 namespace flutter {
@@ -77,6 +78,9 @@ ShellIOManager::ShellIOManager(
 }
 
 ShellIOManager::~ShellIOManager() {
+  // The cached images are released through the unref queue, so they are
+  // released by the drain below.
+  DecodedImageCache::GetCacheForProcess()->RemoveImages(unref_queue_.get());
   // Last chance to drain the IO queue as the platform side reference to the
   // underlying OpenGL context may be going away.
   is_gpu_disabled_sync_switch_->Execute(
@@ -95,6 +99,8 @@ void ShellIOManager::NotifyResourceContextAvailable(
 
 void ShellIOManager::UpdateResourceContext(
     sk_sp<GrDirectContext> resource_context) {
+  // The cached textures belong to the previous context.
+  DecodedImageCache::GetCacheForProcess()->RemoveImages(unref_queue_.get());
   resource_context_ = std::move(resource_context);
   resource_context_weak_factory_ =
       resource_context_
@@ -253,6 +253,18 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kEstimateRasterCacheMemory:
             shell->OnServiceProtocolEstimateRasterCacheMemory(params, response);
             break;
+          case ServiceProtocolEnum::kGetDecodedImageCacheStats:
+            shell->OnServiceProtocolGetDecodedImageCacheStats(params, response);
+            break;
+          case ServiceProtocolEnum::kGetFrameTimingStatistics:
+            shell->OnServiceProtocolGetFrameTimingStatistics(params, response);
+            break;
+          case ServiceProtocolEnum::kSetLayerProfilingEnabled:
+            shell->OnServiceProtocolSetLayerProfilingEnabled(params, response);
+            break;
+          case ServiceProtocolEnum::kGetLayerProfile:
+            shell->OnServiceProtocolGetLayerProfile(params, response);
+            break;
           case ServiceProtocolEnum::kSetAssetBundlePath:
             shell->OnServiceProtocolSetAssetBundlePath(params, response);
             break;
@@ -95,6 +95,10 @@ class ShellTest : public FixtureTest {
   enum ServiceProtocolEnum {
     kGetSkSLs,
     kEstimateRasterCacheMemory,
+    kGetDecodedImageCacheStats,
+    kGetFrameTimingStatistics,
+    kSetLayerProfilingEnabled,
+    kGetLayerProfile,
     kSetAssetBundlePath,
     kRunInView,
   };
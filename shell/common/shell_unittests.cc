@@ -22,6 +22,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/painting/decoded_image_cache.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
@@ -2072,6 +2073,7 @@ static sk_sp<SkPicture> MakeSizedPicture(int width, int height) {
 
 TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   Settings settings = CreateSettingsForFixture();
+  settings.raster_cache_max_bytes = 1000000;
   std::unique_ptr<Shell> shell = CreateShell(settings);
 
   // 1. Construct a picture and a picture layer to be raster cached.
@@ -2140,13 +2142,177 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   document.Accept(writer);
   std::string expected_json =
       "{\"type\":\"EstimateRasterCacheMemory\",\"layerBytes\":40000,\"picture"
-      "Bytes\":400}";
+      "Bytes\":400,\"maxBytes\":1000000}";
   std::string actual_json = buffer.GetString();
   ASSERT_EQ(actual_json, expected_json);
 
   DestroyShell(std::move(shell));
 }
 
+TEST_F(ShellTest, OnServiceProtocolGetDecodedImageCacheStatsWorks) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  auto cache = DecodedImageCache::GetCacheForProcess();
+  const size_t original_max_bytes = cache->max_bytes();
+  cache->Clear();
+  cache->SetMaxBytes(1000000);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 10);
+  bitmap.setImmutable();
+  cache->Put(DecodedImageCache::MakeKey(SkData::MakeWithCString("image"), 10,
+                                        10, nullptr),
+             SkImage::MakeFromBitmap(bitmap), nullptr);
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetDecodedImageCacheStats,
+      shell->GetTaskRunners().GetIOTaskRunner(), empty_params, &document);
+  ASSERT_TRUE(document.IsObject());
+  EXPECT_EQ(std::string(document["type"].GetString()),
+            "DecodedImageCacheStats");
+  EXPECT_EQ(document["entryCount"].GetUint64(), 1u);
+  // The image and its encoded data.
+  EXPECT_EQ(document["bytes"].GetUint64(), 406u);
+  EXPECT_EQ(document["maxBytes"].GetUint64(), 1000000u);
+  // Other tests in the process may have decoded images.
+  EXPECT_TRUE(document.HasMember("hitCount"));
+  EXPECT_TRUE(document.HasMember("missCount"));
+  EXPECT_TRUE(document.HasMember("evictionCount"));
+
+  cache->Clear();
+  cache->SetMaxBytes(original_max_bytes);
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(ShellTest, OnServiceProtocolGetFrameTimingStatisticsWorks) {
+  auto settings = CreateSettingsForFixture();
+  fml::AutoResetWaitableEvent timing_latch;
+  FrameTiming timing;
+  settings.frame_rasterized_callback = [&timing,
+                                        &timing_latch](const FrameTiming& t) {
+    timing = t;
+    timing_latch.Signal();
+  };
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+  PumpOneFrame(shell.get());
+  timing_latch.Wait();
+  // The frame is recorded after the callback returns.
+  PostSync(shell->GetTaskRunners().GetRasterTaskRunner(), []() {});
+
+  EXPECT_EQ(shell->GetFrameTimingHistory().GetStatistics().frame_count, 1u);
+
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  params["recentFrameCount"] = "10";
+  rapidjson::Document document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetFrameTimingStatistics,
+      shell->GetTaskRunners().GetIOTaskRunner(), params, &document);
+  ASSERT_TRUE(document.IsObject());
+  EXPECT_EQ(std::string(document["type"].GetString()),
+            "FrameTimingStatistics");
+  EXPECT_EQ(document["frameCount"].GetUint64(), 1u);
+  for (const char* interval : {"vsyncOverhead", "build", "raster", "total"}) {
+    ASSERT_TRUE(document.HasMember(interval));
+    EXPECT_TRUE(document[interval].HasMember("p50"));
+    EXPECT_TRUE(document[interval].HasMember("p90"));
+    EXPECT_TRUE(document[interval].HasMember("p99"));
+    EXPECT_TRUE(document[interval].HasMember("max"));
+  }
+  const int64_t raster_micros =
+      FrameTimingHistory::GetInterval(timing, FrameTimingHistory::kRaster)
+          .ToMicroseconds();
+  EXPECT_EQ(document["raster"]["max"].GetInt64(), raster_micros);
+
+  const auto& frames = document["recentFrames"];
+  ASSERT_EQ(frames.Size(), 1u);
+  ASSERT_EQ(frames[0].Size(), static_cast<size_t>(FrameTiming::kCount));
+  for (auto phase : FrameTiming::kPhases) {
+    EXPECT_EQ(frames[0][phase].GetInt64(),
+              timing.Get(phase).ToEpochDelta().ToMicroseconds());
+  }
+
+  params["recentFrameCount"] = "-1";
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetFrameTimingStatistics,
+      shell->GetTaskRunners().GetIOTaskRunner(), params, &document);
+  ASSERT_TRUE(document.HasMember("code"));
+
+  DestroyShell(std::move(shell));
+}
+
+TEST_F(ShellTest, OnServiceProtocolGetLayerProfileWorks) {
+  auto settings = CreateSettingsForFixture();
+  fml::AutoResetWaitableEvent timing_latch;
+  settings.frame_rasterized_callback =
+      [&timing_latch](const FrameTiming& t) { timing_latch.Signal(); };
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+  PlatformViewNotifyCreated(shell.get());
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("emptyMain");
+  RunEngine(shell.get(), std::move(configuration));
+
+  const auto raster_task_runner = shell->GetTaskRunners().GetRasterTaskRunner();
+  ServiceProtocol::Handler::ServiceProtocolMap params;
+  rapidjson::Document document;
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetLayerProfile,
+                    raster_task_runner, params, &document);
+  EXPECT_EQ(std::string(document["type"].GetString()), "LayerProfile");
+  EXPECT_FALSE(document["enabled"].GetBool());
+  EXPECT_EQ(document["layers"].Size(), 0u);
+
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kSetLayerProfilingEnabled,
+                    raster_task_runner, params, &document);
+  ASSERT_TRUE(document.HasMember("code"));
+  params["enabled"] = "true";
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kSetLayerProfilingEnabled,
+                    raster_task_runner, params, &document);
+  EXPECT_EQ(std::string(document["type"].GetString()), "Success");
+
+  std::shared_ptr<PictureLayer> picture_layer;
+  LayerTreeBuilder builder = [&](std::shared_ptr<ContainerLayer> root) {
+    SkPictureRecorder recorder;
+    SkCanvas* recording_canvas =
+        recorder.beginRecording(SkRect::MakeXYWH(0, 0, 80, 80));
+    recording_canvas->drawRect(SkRect::MakeXYWH(0, 0, 80, 80),
+                               SkPaint(SkColor4f::FromColor(SK_ColorRED)));
+    auto sk_picture = recorder.finishRecordingAsPicture();
+    fml::RefPtr<SkiaUnrefQueue> queue = fml::MakeRefCounted<SkiaUnrefQueue>(
+        this->GetCurrentTaskRunner(), fml::TimeDelta::FromSeconds(0));
+    picture_layer = std::make_shared<PictureLayer>(
+        SkPoint::Make(10, 10),
+        flutter::SkiaGPUObject<SkPicture>({sk_picture, queue}), false, false);
+    root->Add(picture_layer);
+  };
+  PumpOneFrame(shell.get(), 100, 100, builder);
+  timing_latch.Wait();
+
+  params.clear();
+  OnServiceProtocol(shell.get(), ServiceProtocolEnum::kGetLayerProfile,
+                    raster_task_runner, params, &document);
+  EXPECT_TRUE(document["enabled"].GetBool());
+  const auto& layers = document["layers"];
+  ASSERT_EQ(layers.Size(), 1u);
+  EXPECT_EQ(std::string(layers[0]["type"].GetString()), "TransformLayer");
+  EXPECT_GE(layers[0]["paintMicros"].GetDouble(), 0.0);
+  const auto& children = layers[0]["children"];
+  ASSERT_EQ(children.Size(), 1u);
+  EXPECT_EQ(children[0]["id"].GetUint64(), picture_layer->unique_id());
+  EXPECT_EQ(std::string(children[0]["type"].GetString()), "PictureLayer");
+  EXPECT_EQ(children[0]["saveLayerCount"].GetUint64(), 0u);
+  EXPECT_EQ(children[0]["children"].Size(), 0u);
+
+  DestroyShell(std::move(shell));
+}
+
 TEST_F(ShellTest, DiscardLayerTreeOnResize) {
   auto settings = CreateSettingsForFixture();
 
@@ -415,6 +415,46 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
                                 &old_gen_heap_size);
     settings.old_gen_heap_size = std::stoi(old_gen_heap_size);
   }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    std::string raster_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxBytes),
+                                &raster_cache_max_bytes);
+    settings.raster_cache_max_bytes = std::stoll(raster_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DecodedImageCacheMaxBytes))) {
+    std::string decoded_image_cache_max_bytes;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::DecodedImageCacheMaxBytes),
+        &decoded_image_cache_max_bytes);
+    settings.decoded_image_cache_max_bytes =
+        std::stoll(decoded_image_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::ShapingCacheMaxBytes))) {
+    std::string shaping_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::ShapingCacheMaxBytes),
+                                &shaping_cache_max_bytes);
+    settings.shaping_cache_max_bytes = std::stoll(shaping_cache_max_bytes);
+  }
+
+  settings.enable_async_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAsyncRasterCache));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheReuseScaleTolerance))) {
+    std::string tolerance;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::RasterCacheReuseScaleTolerance), &tolerance);
+    settings.raster_cache_reuse_scale_tolerance = std::stod(tolerance);
+  }
+
+  settings.enable_latest_frame_pipeline =
+      command_line.HasOption(FlagForSwitch(Switch::EnableLatestFramePipeline));
+  settings.enable_platform_message_batching = command_line.HasOption(
+      FlagForSwitch(Switch::EnablePlatformMessageBatching));
   return settings;
 }
 
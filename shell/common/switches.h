@@ -108,7 +108,8 @@ DEF_SWITCH(SkiaDeterministicRendering,
            "is used to obtain 100% deterministic behavior in Skia rendering.")
 DEF_SWITCH(FlutterAssetsDir,
            "flutter-assets-dir",
-           "Path to the Flutter assets directory.")
+           "Path to the Flutter assets directory, or to a pack of the assets "
+           "created by the asset-packer tool.")
 DEF_SWITCH(Help, "help", "Display this help text.")
 DEF_SWITCH(LogTag, "log-tag", "Tag associated with log messages.")
 DEF_SWITCH(DisableServiceAuthCodes,
@@ -202,6 +203,44 @@ DEF_SWITCH(
 DEF_SWITCH(OldGenHeapSize,
            "old-gen-heap-size",
            "The size limit in megabytes for the Dart VM old gen heap space.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The size limit in bytes for the images held by the raster cache. "
+           "Images that were not used in the last frame are evicted in least "
+           "recently used order once the limit is reached. 0 means there is "
+           "no limit.")
+DEF_SWITCH(DecodedImageCacheMaxBytes,
+           "decoded-image-cache-max-bytes",
+           "The size limit in bytes for the decoded images shared by the "
+           "engines of the process. Least recently used images are evicted "
+           "once the limit is reached. 0 disables the cache.")
+DEF_SWITCH(ShapingCacheMaxBytes,
+           "shaping-cache-max-bytes",
+           "The size limit in bytes for the shaped words shared by the "
+           "engines of the process. Least recently used words are evicted "
+           "once the limit is reached. 0 disables the cache.")
+DEF_SWITCH(EnableAsyncRasterCache,
+           "enable-async-raster-cache",
+           "Rasterize the pictures of the raster cache on worker threads "
+           "instead of during the frame workload. Pictures are drawn directly "
+           "until their cached image is ready.")
+DEF_SWITCH(RasterCacheReuseScaleTolerance,
+           "raster-cache-reuse-scale-tolerance",
+           "How much the scale of a raster cache image may differ from the "
+           "scale it was rasterized at when it is reused for another "
+           "transform. For example, 0.25 allows images to be drawn between "
+           "0.8 and 1.25 times their rasterized size. 0, the default, "
+           "disables reuse.")
+DEF_SWITCH(EnableLatestFramePipeline,
+           "enable-latest-frame-pipeline",
+           "Replace frames that are waiting to be rasterized by newer frames "
+           "instead of queueing them. This bounds the latency of frames when "
+           "the raster thread is overloaded, at the cost of dropping frames.")
+DEF_SWITCH(EnablePlatformMessageBatching,
+           "enable-platform-message-batching",
+           "Deliver platform messages and the responses to them in one task "
+           "per burst instead of one task per message. Batched messages may "
+           "be handled ahead of pointer events sent after them.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
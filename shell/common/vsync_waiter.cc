@@ -118,19 +118,20 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
 
     TRACE_FLOW_BEGIN("flutter", kVsyncFlowName, flow_identifier);
 
-    task_runners_.GetUITaskRunner()->PostTaskForTime(
+    task_runners_.GetUITaskRunner()->PostTaskForTimeWithPriority(
         [callback, flow_identifier, frame_start_time, frame_target_time]() {
           FML_TRACE_EVENT("flutter", kVsyncTraceName, "StartTime",
                           frame_start_time, "TargetTime", frame_target_time);
           callback(frame_start_time, frame_target_time);
           TRACE_FLOW_END("flutter", kVsyncFlowName, flow_identifier);
         },
-        frame_start_time);
+        frame_start_time, fml::TaskPriority::kFrameCritical);
   }
 
   if (secondary_callback) {
-    task_runners_.GetUITaskRunner()->PostTaskForTime(
-        std::move(secondary_callback), frame_start_time);
+    task_runners_.GetUITaskRunner()->PostTaskForTimeWithPriority(
+        std::move(secondary_callback), frame_start_time,
+        fml::TaskPriority::kFrameCritical);
   }
 }
 
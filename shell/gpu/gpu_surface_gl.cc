@@ -259,15 +259,16 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
   SurfaceFrame::SubmitCallback submit_callback =
       [weak = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) {
-        return weak ? weak->PresentSurface(canvas) : false;
+        return weak ? weak->PresentSurface(surface_frame, canvas) : false;
       };
 
   return std::make_unique<SurfaceFrame>(
       surface, delegate_->SurfaceSupportsReadback(), submit_callback,
-      std::move(context_switch));
+      std::move(context_switch), delegate_->GLContextFramebufferInfo(fbo_id_));
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(const SurfaceFrame& frame,
+                                  SkCanvas* canvas) {
   if (delegate_ == nullptr || canvas == nullptr || context_ == nullptr) {
     return false;
   }
@@ -277,7 +278,11 @@ bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
     onscreen_surface_->getCanvas()->flush();
   }
 
-  if (!delegate_->GLContextPresent(fbo_id_)) {
+  GLPresentInfo present_info;
+  present_info.fbo_id = fbo_id_;
+  present_info.frame_damage = frame.submit_info().frame_damage;
+  present_info.buffer_damage = frame.submit_info().buffer_damage;
+  if (!delegate_->GLContextPresentWithInfo(present_info)) {
     return false;
   }
 
@@ -71,7 +71,7 @@ class GPUSurfaceGL : public Surface {
       const SkISize& untransformed_size,
       const SkMatrix& root_surface_transformation);
 
-  bool PresentSurface(SkCanvas* canvas);
+  bool PresentSurface(const SurfaceFrame& frame, SkCanvas* canvas);
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGL);
 };
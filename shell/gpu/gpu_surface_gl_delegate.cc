@@ -12,6 +12,16 @@ namespace flutter {
 
 GPUSurfaceGLDelegate::~GPUSurfaceGLDelegate() = default;
 
+bool GPUSurfaceGLDelegate::GLContextPresentWithInfo(
+    const GLPresentInfo& present_info) {
+  return GLContextPresent(present_info.fbo_id);
+}
+
+SurfaceFrame::FramebufferInfo GPUSurfaceGLDelegate::GLContextFramebufferInfo(
+    uint32_t fbo_id) const {
+  return {};
+}
+
 bool GPUSurfaceGLDelegate::GLContextFBOResetAfterPresent() const {
   return false;
 }
@@ -5,8 +5,11 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
+#include <optional>
+
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
+#include "flutter/flow/surface_frame.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
@@ -20,6 +23,24 @@ struct GLFrameInfo {
   uint32_t height;
 };
 
+// A structure to represent the information passed to the delegate when the
+// main GL surface is presented.
+struct GLPresentInfo {
+  uint32_t fbo_id;
+
+  // The area of the frame that changed compared to the previously presented
+  // frame. Delegates may use it to present only that area (for example with
+  // EGL_KHR_swap_buffers_with_damage). Unset if the whole frame changed.
+  //
+  // Like all damage rects, this uses a top-left origin and needs to be
+  // flipped for GL APIs that expect a bottom-left origin.
+  std::optional<SkIRect> frame_damage;
+
+  // The area of the framebuffer that was repainted. Unset if the whole
+  // framebuffer was repainted.
+  std::optional<SkIRect> buffer_damage;
+};
+
 class GPUSurfaceGLDelegate {
  public:
   ~GPUSurfaceGLDelegate();
@@ -35,6 +56,18 @@ class GPUSurfaceGLDelegate {
   // context and not any of the contexts dedicated for IO.
   virtual bool GLContextPresent(uint32_t fbo_id) = 0;
 
+  // Called to present the main GL surface along with the damage of the frame.
+  // The default implementation ignores the damage and forwards to
+  // |GLContextPresent|.
+  virtual bool GLContextPresentWithInfo(const GLPresentInfo& present_info);
+
+  // Information about the framebuffer with the given ID that the next frame
+  // will be rendered into. Delegates that know which parts of the framebuffer
+  // are stale (for example from EGL_EXT_buffer_age) report that here to
+  // enable partial repaint. The default disables partial repaint.
+  virtual SurfaceFrame::FramebufferInfo GLContextFramebufferInfo(
+      uint32_t fbo_id) const;
+
   // The ID of the main window bound framebuffer. Typically FBO0.
   virtual intptr_t GLContextFBO(GLFrameInfo frame_info) const = 0;
 
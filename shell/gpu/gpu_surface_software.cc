@@ -56,6 +56,15 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   SkCanvas* canvas = backing_store->getCanvas();
   canvas->resetMatrix();
 
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_partial_repaint = true;
+  if (backing_store->uniqueID() == last_presented_backing_store_id_) {
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+  }
+  // Until this frame is presented, the contents of the backing store are not
+  // known.
+  last_presented_backing_store_id_ = 0;
+
   SurfaceFrame::SubmitCallback on_submit =
       [self = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) -> bool {
@@ -66,10 +75,16 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    if (!self->delegate_->PresentBackingStore(surface_frame.SkiaSurface())) {
+      return false;
+    }
+    self->last_presented_backing_store_id_ =
+        surface_frame.SkiaSurface()->uniqueID();
+    return true;
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit,
+                                        framebuffer_info);
 }
 
 // |Surface|
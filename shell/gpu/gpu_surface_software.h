@@ -38,6 +38,11 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The unique ID of the backing store that was last presented successfully.
+  // Backing stores are raster surfaces owned by the delegate, so if the
+  // delegate hands out the same one again it still contains the previously
+  // presented frame and only the damaged area needs to be repainted.
+  uint32_t last_presented_backing_store_id_ = 0;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
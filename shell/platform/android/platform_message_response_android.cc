@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/android/platform_message_response_android.h"
 
+#include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/shell/platform/android/jni/platform_view_android_jni.h"
 
@@ -42,4 +43,12 @@ void PlatformMessageResponseAndroid::CompleteEmpty() {
                                                              nullptr);
       }));
 }
+
+// |flutter::PlatformMessageResponse|
+void PlatformMessageResponseAndroid::CompleteOnPlatformThread(
+    std::unique_ptr<fml::Mapping> data) {
+  FML_DCHECK(platform_task_runner_->RunsTasksOnCurrentThread());
+  jni_facade_->FlutterViewHandlePlatformMessageResponse(response_id_,
+                                                        std::move(data));
+}
 }  // namespace flutter
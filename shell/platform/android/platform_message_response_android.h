@@ -21,6 +21,9 @@ class PlatformMessageResponseAndroid : public flutter::PlatformMessageResponse {
   // |flutter::PlatformMessageResponse|
   void CompleteEmpty() override;
 
+  // |flutter::PlatformMessageResponse|
+  void CompleteOnPlatformThread(std::unique_ptr<fml::Mapping> data) override;
+
  private:
   PlatformMessageResponseAndroid(
       int response_id,
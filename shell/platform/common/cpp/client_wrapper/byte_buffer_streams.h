@@ -44,6 +44,16 @@ class ByteBufferStreamReader : public ByteStreamReader {
     location_ += length;
   }
 
+  // |ByteStreamReader|
+  const uint8_t* ReadBytesInPlace(size_t length) override {
+    if (location_ + length > size_) {
+      return nullptr;
+    }
+    const uint8_t* bytes = bytes_ + location_;
+    location_ += length;
+    return bytes;
+  }
+
   // |ByteStreamReader|
   void ReadAlignment(uint8_t alignment) override {
     uint8_t mod = location_ % alignment;
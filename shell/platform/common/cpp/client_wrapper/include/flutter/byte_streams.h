@@ -26,6 +26,14 @@ class ByteStreamReader {
   // the start of the stream, unless it is already aligned.
   virtual void ReadAlignment(uint8_t alignment) = 0;
 
+  // Returns a pointer to the next |length| bytes of the stream and advances
+  // past them, or returns nullptr without advancing if the stream doesn't
+  // provide direct access to its bytes. The pointer remains valid as long as
+  // the stream's underlying buffer does.
+  //
+  // Streams that don't override this are read with ReadBytes instead.
+  virtual const uint8_t* ReadBytesInPlace(size_t length) { return nullptr; }
+
   // Reads and returns the next 32-bit integer from the stream.
   int32_t ReadInt32() {
     int32_t value = 0;
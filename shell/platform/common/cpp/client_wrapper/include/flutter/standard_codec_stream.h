@@ -0,0 +1,122 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "byte_streams.h"
+
+namespace flutter {
+
+// Receives the values of a message in the standard codec encoding as they are
+// read by a StandardCodecStreamReader, without EncodableValues being built.
+//
+// Lists are reported as OnListBegin, their elements, and OnListEnd. Maps are
+// reported the same way, with their keys and values alternating. Strings and
+// typed lists are passed as views that are only valid for the duration of the
+// call.
+class StandardCodecStreamHandler {
+ public:
+  virtual ~StandardCodecStreamHandler() = default;
+
+  virtual void OnNull() {}
+  virtual void OnBool(bool value) {}
+  virtual void OnInt32(int32_t value) {}
+  virtual void OnInt64(int64_t value) {}
+  virtual void OnDouble(double value) {}
+  virtual void OnString(std::string_view value) {}
+  virtual void OnUInt8List(const uint8_t* values, size_t count) {}
+  virtual void OnInt32List(const int32_t* values, size_t count) {}
+  virtual void OnInt64List(const int64_t* values, size_t count) {}
+  virtual void OnFloat64List(const double* values, size_t count) {}
+  virtual void OnListBegin(size_t size) {}
+  virtual void OnListEnd() {}
+  virtual void OnMapBegin(size_t size) {}
+  virtual void OnMapEnd() {}
+};
+
+// Reads values in the standard codec encoding from a stream and reports them
+// to a StandardCodecStreamHandler.
+//
+// When the stream supports ByteStreamReader::ReadBytesInPlace, strings and
+// suitably aligned typed lists are passed to the handler as views into the
+// stream's buffer. Otherwise they are read into a scratch buffer that is
+// reused for all the values read by this reader.
+//
+// Only the types supported by StandardCodecSerializer itself can be read;
+// values of codec extension types cannot be streamed.
+class StandardCodecStreamReader {
+ public:
+  // Creates a reader for |stream|, which must outlive it.
+  explicit StandardCodecStreamReader(ByteStreamReader* stream);
+
+  ~StandardCodecStreamReader();
+
+  // Prevent copying.
+  StandardCodecStreamReader(StandardCodecStreamReader const&) = delete;
+  StandardCodecStreamReader& operator=(StandardCodecStreamReader const&) =
+      delete;
+
+  // Reads the next value from the stream, including any nested values, and
+  // reports it to |handler|.
+  //
+  // Returns false if the value is of an unknown type, in which case the
+  // stream is left at an unspecified position.
+  bool ReadValue(StandardCodecStreamHandler* handler);
+
+ private:
+  // Reads |count| elements of type T, which must start at a multiple of
+  // |alignment| relative to the start of the stream.
+  template <typename T>
+  const T* ReadElements(size_t count, uint8_t alignment);
+
+  ByteStreamReader* stream_;
+  // Holds the elements that could not be read in place. Uses 64-bit storage
+  // so that it is suitably aligned for every element type.
+  std::vector<uint64_t> scratch_;
+};
+
+// Writes values in the standard codec encoding to a stream, without
+// EncodableValues being built first.
+//
+// A list is written as WriteListBegin with its size, followed by exactly that
+// many values. A map is written as WriteMapBegin with its size, followed by
+// that many alternating keys and values.
+class StandardCodecStreamWriter {
+ public:
+  // Creates a writer for |stream|, which must outlive it.
+  explicit StandardCodecStreamWriter(ByteStreamWriter* stream);
+
+  ~StandardCodecStreamWriter();
+
+  // Prevent copying.
+  StandardCodecStreamWriter(StandardCodecStreamWriter const&) = delete;
+  StandardCodecStreamWriter& operator=(StandardCodecStreamWriter const&) =
+      delete;
+
+  void WriteNull();
+  void WriteBool(bool value);
+  void WriteInt32(int32_t value);
+  void WriteInt64(int64_t value);
+  void WriteDouble(double value);
+  void WriteString(std::string_view value);
+  void WriteUInt8List(const uint8_t* values, size_t count);
+  void WriteInt32List(const int32_t* values, size_t count);
+  void WriteInt64List(const int64_t* values, size_t count);
+  void WriteFloat64List(const double* values, size_t count);
+  void WriteListBegin(size_t size);
+  void WriteMapBegin(size_t size);
+
+ private:
+  ByteStreamWriter* stream_;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CPP_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_STREAM_H_
@@ -8,14 +8,17 @@
 // that any client that needs one of these files needs all three.
 
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "byte_buffer_streams.h"
 #include "include/flutter/standard_codec_serializer.h"
+#include "include/flutter/standard_codec_stream.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
 
@@ -75,6 +78,55 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// Reads the variable-length size from the current position in |stream|.
+size_t ReadEncodedSize(ByteStreamReader* stream) {
+  uint8_t byte = stream->ReadByte();
+  if (byte < 254) {
+    return byte;
+  } else if (byte == 254) {
+    uint16_t value;
+    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 2);
+    return value;
+  } else {
+    uint32_t value;
+    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 4);
+    return value;
+  }
+}
+
+// Writes the variable-length size encoding to |stream|.
+void WriteEncodedSize(size_t size, ByteStreamWriter* stream) {
+  if (size < 254) {
+    stream->WriteByte(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    stream->WriteByte(254);
+    uint16_t value = static_cast<uint16_t>(size);
+    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
+  } else {
+    stream->WriteByte(255);
+    uint32_t value = static_cast<uint32_t>(size);
+    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
+  }
+}
+
+// Writes |count| elements of a typed list, preceded by the size and the
+// padding to the alignment of the elements.
+template <typename T>
+void WriteEncodedElements(const T* elements,
+                          size_t count,
+                          ByteStreamWriter* stream) {
+  WriteEncodedSize(count, stream);
+  if (count == 0) {
+    return;
+  }
+  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
+  if (type_size > 1) {
+    stream->WriteAlignment(type_size);
+  }
+  stream->WriteBytes(reinterpret_cast<const uint8_t*>(elements),
+                     count * type_size);
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -181,7 +233,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -198,7 +250,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -208,7 +260,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
   }
   std::cerr << "Unknown type in StandardCodecSerializer::ReadValueOfType: "
@@ -217,33 +269,12 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
 }
 
 size_t StandardCodecSerializer::ReadSize(ByteStreamReader* stream) const {
-  uint8_t byte = stream->ReadByte();
-  if (byte < 254) {
-    return byte;
-  } else if (byte == 254) {
-    uint16_t value;
-    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 2);
-    return value;
-  } else {
-    uint32_t value;
-    stream->ReadBytes(reinterpret_cast<uint8_t*>(&value), 4);
-    return value;
-  }
+  return ReadEncodedSize(stream);
 }
 
 void StandardCodecSerializer::WriteSize(size_t size,
                                         ByteStreamWriter* stream) const {
-  if (size < 254) {
-    stream->WriteByte(static_cast<uint8_t>(size));
-  } else if (size <= 0xffff) {
-    stream->WriteByte(254);
-    uint16_t value = static_cast<uint16_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 2);
-  } else {
-    stream->WriteByte(255);
-    uint32_t value = static_cast<uint32_t>(size);
-    stream->WriteBytes(reinterpret_cast<uint8_t*>(&value), 4);
-  }
+  WriteEncodedSize(size, stream);
 }
 
 template <typename T>
@@ -258,23 +289,198 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
-void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
+void StandardCodecSerializer::WriteVector(const std::vector<T>& vector,
                                           ByteStreamWriter* stream) const {
-  size_t count = vector.size();
-  WriteSize(count, stream);
-  if (count == 0) {
-    return;
+  WriteEncodedElements(vector.data(), vector.size(), stream);
+}
+
+// ===== standard_codec_stream.h =====
+
+StandardCodecStreamReader::StandardCodecStreamReader(ByteStreamReader* stream)
+    : stream_(stream) {
+  assert(stream);
+}
+
+StandardCodecStreamReader::~StandardCodecStreamReader() = default;
+
+bool StandardCodecStreamReader::ReadValue(
+    StandardCodecStreamHandler* handler) {
+  uint8_t type = stream_->ReadByte();
+  switch (static_cast<EncodedType>(type)) {
+    case EncodedType::kNull:
+      handler->OnNull();
+      return true;
+    case EncodedType::kTrue:
+      handler->OnBool(true);
+      return true;
+    case EncodedType::kFalse:
+      handler->OnBool(false);
+      return true;
+    case EncodedType::kInt32:
+      handler->OnInt32(stream_->ReadInt32());
+      return true;
+    case EncodedType::kInt64:
+      handler->OnInt64(stream_->ReadInt64());
+      return true;
+    case EncodedType::kFloat64:
+      stream_->ReadAlignment(8);
+      handler->OnDouble(stream_->ReadDouble());
+      return true;
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t size = ReadEncodedSize(stream_);
+      handler->OnString(std::string_view(ReadElements<char>(size, 1), size));
+      return true;
+    }
+    case EncodedType::kUInt8List: {
+      size_t count = ReadEncodedSize(stream_);
+      handler->OnUInt8List(ReadElements<uint8_t>(count, 1), count);
+      return true;
+    }
+    case EncodedType::kInt32List: {
+      size_t count = ReadEncodedSize(stream_);
+      handler->OnInt32List(ReadElements<int32_t>(count, 4), count);
+      return true;
+    }
+    case EncodedType::kInt64List: {
+      size_t count = ReadEncodedSize(stream_);
+      handler->OnInt64List(ReadElements<int64_t>(count, 8), count);
+      return true;
+    }
+    case EncodedType::kFloat64List: {
+      size_t count = ReadEncodedSize(stream_);
+      handler->OnFloat64List(ReadElements<double>(count, 8), count);
+      return true;
+    }
+    case EncodedType::kList: {
+      size_t size = ReadEncodedSize(stream_);
+      handler->OnListBegin(size);
+      for (size_t i = 0; i < size; ++i) {
+        if (!ReadValue(handler)) {
+          return false;
+        }
+      }
+      handler->OnListEnd();
+      return true;
+    }
+    case EncodedType::kMap: {
+      size_t size = ReadEncodedSize(stream_);
+      handler->OnMapBegin(size);
+      for (size_t i = 0; i < size * 2; ++i) {
+        if (!ReadValue(handler)) {
+          return false;
+        }
+      }
+      handler->OnMapEnd();
+      return true;
+    }
   }
-  uint8_t type_size = static_cast<uint8_t>(sizeof(T));
-  if (type_size > 1) {
-    stream->WriteAlignment(type_size);
+  std::cerr << "Unknown type in StandardCodecStreamReader::ReadValue: "
+            << static_cast<int>(type) << std::endl;
+  return false;
+}
+
+template <typename T>
+const T* StandardCodecStreamReader::ReadElements(size_t count,
+                                                 uint8_t alignment) {
+  if (alignment > 1) {
+    stream_->ReadAlignment(alignment);
   }
-  stream->WriteBytes(reinterpret_cast<const uint8_t*>(vector.data()),
-                     count * type_size);
+  size_t length = count * sizeof(T);
+  const uint8_t* bytes = stream_->ReadBytesInPlace(length);
+  if (bytes && reinterpret_cast<uintptr_t>(bytes) % alignof(T) == 0) {
+    return reinterpret_cast<const T*>(bytes);
+  }
+
+  // The buffer may not be aligned for T even though the elements are aligned
+  // relative to the start of the stream.
+  scratch_.resize((length + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+  uint8_t* scratch = reinterpret_cast<uint8_t*>(scratch_.data());
+  if (bytes) {
+    std::memcpy(scratch, bytes, length);
+  } else if (length > 0) {
+    stream_->ReadBytes(scratch, length);
+  }
+  return reinterpret_cast<const T*>(scratch);
+}
+
+StandardCodecStreamWriter::StandardCodecStreamWriter(ByteStreamWriter* stream)
+    : stream_(stream) {
+  assert(stream);
+}
+
+StandardCodecStreamWriter::~StandardCodecStreamWriter() = default;
+
+void StandardCodecStreamWriter::WriteNull() {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kNull));
+}
+
+void StandardCodecStreamWriter::WriteBool(bool value) {
+  stream_->WriteByte(static_cast<uint8_t>(value ? EncodedType::kTrue
+                                                : EncodedType::kFalse));
+}
+
+void StandardCodecStreamWriter::WriteInt32(int32_t value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt32));
+  stream_->WriteInt32(value);
+}
+
+void StandardCodecStreamWriter::WriteInt64(int64_t value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt64));
+  stream_->WriteInt64(value);
+}
+
+void StandardCodecStreamWriter::WriteDouble(double value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kFloat64));
+  stream_->WriteAlignment(8);
+  stream_->WriteDouble(value);
+}
+
+void StandardCodecStreamWriter::WriteString(std::string_view value) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kString));
+  WriteEncodedSize(value.size(), stream_);
+  if (!value.empty()) {
+    stream_->WriteBytes(reinterpret_cast<const uint8_t*>(value.data()),
+                        value.size());
+  }
+}
+
+void StandardCodecStreamWriter::WriteUInt8List(const uint8_t* values,
+                                               size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kUInt8List));
+  WriteEncodedElements(values, count, stream_);
+}
+
+void StandardCodecStreamWriter::WriteInt32List(const int32_t* values,
+                                               size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt32List));
+  WriteEncodedElements(values, count, stream_);
+}
+
+void StandardCodecStreamWriter::WriteInt64List(const int64_t* values,
+                                               size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kInt64List));
+  WriteEncodedElements(values, count, stream_);
+}
+
+void StandardCodecStreamWriter::WriteFloat64List(const double* values,
+                                                 size_t count) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kFloat64List));
+  WriteEncodedElements(values, count, stream_);
+}
+
+void StandardCodecStreamWriter::WriteListBegin(size_t size) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kList));
+  WriteEncodedSize(size, stream_);
+}
+
+void StandardCodecStreamWriter::WriteMapBegin(size_t size) {
+  stream_->WriteByte(static_cast<uint8_t>(EncodedType::kMap));
+  WriteEncodedSize(size, stream_);
 }
 
 // ===== standard_message_codec.h =====
@@ -0,0 +1,140 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/byte_buffer_streams.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_codec_stream.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// Payloads like those of desktop plugins: a list of |state.range(0)| records,
+// each a map with a few scalar fields and a float64 list of samples.
+constexpr size_t kSamplesPerRecord = 64;
+
+EncodableValue MakeRecords(size_t count) {
+  EncodableList records;
+  for (size_t i = 0; i < count; ++i) {
+    records.push_back(EncodableValue(EncodableMap{
+        {EncodableValue("id"), EncodableValue(static_cast<int32_t>(i))},
+        {EncodableValue("name"),
+         EncodableValue("record " + std::to_string(i))},
+        {EncodableValue("enabled"), EncodableValue(i % 2 == 0)},
+        {EncodableValue("samples"),
+         EncodableValue(std::vector<double>(kSamplesPerRecord, 0.5))},
+    }));
+  }
+  return EncodableValue(std::move(records));
+}
+
+void WriteRecords(size_t count, StandardCodecStreamWriter* writer) {
+  const std::vector<double> samples(kSamplesPerRecord, 0.5);
+  writer->WriteListBegin(count);
+  for (size_t i = 0; i < count; ++i) {
+    // In the key order of EncodableMap, so that the encoding is identical.
+    writer->WriteMapBegin(4);
+    writer->WriteString("enabled");
+    writer->WriteBool(i % 2 == 0);
+    writer->WriteString("id");
+    writer->WriteInt32(static_cast<int32_t>(i));
+    writer->WriteString("name");
+    writer->WriteString("record " + std::to_string(i));
+    writer->WriteString("samples");
+    writer->WriteFloat64List(samples.data(), samples.size());
+  }
+}
+
+// Sums the samples, so that the values are actually consumed.
+class SumHandler : public StandardCodecStreamHandler {
+ public:
+  double sum = 0;
+
+  void OnFloat64List(const double* values, size_t count) override {
+    for (size_t i = 0; i < count; ++i) {
+      sum += values[i];
+    }
+  }
+};
+
+}  // namespace
+
+static void BM_StandardCodecDecodeEncodableValue(benchmark::State& state) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      MakeRecords(state.range(0)));
+  while (state.KeepRunning()) {
+    auto decoded = StandardMessageCodec::GetInstance().DecodeMessage(*encoded);
+    double sum = 0;
+    for (const auto& record : std::get<EncodableList>(*decoded)) {
+      const auto& map = std::get<EncodableMap>(record);
+      const auto& samples = std::get<std::vector<double>>(
+          map.find(EncodableValue("samples"))->second);
+      for (double sample : samples) {
+        sum += sample;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecDecodeStream(benchmark::State& state) {
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+      MakeRecords(state.range(0)));
+  while (state.KeepRunning()) {
+    ByteBufferStreamReader stream(encoded->data(), encoded->size());
+    StandardCodecStreamReader reader(&stream);
+    SumHandler handler;
+    reader.ReadValue(&handler);
+    benchmark::DoNotOptimize(handler.sum);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecEncodeEncodableValue(benchmark::State& state) {
+  size_t size = 0;
+  while (state.KeepRunning()) {
+    auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(
+        MakeRecords(state.range(0)));
+    size = encoded->size();
+    benchmark::DoNotOptimize(encoded->data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_StandardCodecEncodeStream(benchmark::State& state) {
+  size_t size = 0;
+  while (state.KeepRunning()) {
+    std::vector<uint8_t> encoded;
+    ByteBufferStreamWriter stream(&encoded);
+    StandardCodecStreamWriter writer(&stream);
+    WriteRecords(state.range(0), &writer);
+    size = encoded.size();
+    benchmark::DoNotOptimize(encoded.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_StandardCodecDecodeEncodableValue)
+    ->RangeMultiplier(8)
+    ->Range(8, 512)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardCodecDecodeStream)
+    ->RangeMultiplier(8)
+    ->Range(8, 512)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardCodecEncodeEncodableValue)
+    ->RangeMultiplier(8)
+    ->Range(8, 512)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StandardCodecEncodeStream)
+    ->RangeMultiplier(8)
+    ->Range(8, 512)
+    ->Unit(benchmark::kMicrosecond);
+
+}  // namespace flutter
@@ -0,0 +1,200 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_codec_stream.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "flutter/shell/platform/common/cpp/client_wrapper/byte_buffer_streams.h"
+#include "flutter/shell/platform/common/cpp/client_wrapper/include/flutter/standard_message_codec.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+// Records the values reported by a StandardCodecStreamReader as strings.
+class RecordingHandler : public StandardCodecStreamHandler {
+ public:
+  std::vector<std::string> events;
+
+  void OnNull() override { events.push_back("null"); }
+  void OnBool(bool value) override {
+    events.push_back(value ? "true" : "false");
+  }
+  void OnInt32(int32_t value) override {
+    events.push_back("int32 " + std::to_string(value));
+  }
+  void OnInt64(int64_t value) override {
+    events.push_back("int64 " + std::to_string(value));
+  }
+  void OnDouble(double value) override {
+    events.push_back("double " + std::to_string(value));
+  }
+  void OnString(std::string_view value) override {
+    events.push_back("string " + std::string(value));
+  }
+  void OnUInt8List(const uint8_t* values, size_t count) override {
+    events.push_back("uint8 list " + Join(values, count));
+  }
+  void OnInt32List(const int32_t* values, size_t count) override {
+    events.push_back("int32 list " + Join(values, count));
+  }
+  void OnInt64List(const int64_t* values, size_t count) override {
+    events.push_back("int64 list " + Join(values, count));
+  }
+  void OnFloat64List(const double* values, size_t count) override {
+    events.push_back("float64 list " + Join(values, count));
+  }
+  void OnListBegin(size_t size) override {
+    events.push_back("list " + std::to_string(size));
+  }
+  void OnListEnd() override { events.push_back("end list"); }
+  void OnMapBegin(size_t size) override {
+    events.push_back("map " + std::to_string(size));
+  }
+  void OnMapEnd() override { events.push_back("end map"); }
+
+ private:
+  template <typename T>
+  static std::string Join(const T* values, size_t count) {
+    std::string joined;
+    for (size_t i = 0; i < count; ++i) {
+      joined += (i ? "," : "") + std::to_string(values[i]);
+    }
+    return joined;
+  }
+};
+
+// A reader that does not support in-place reads.
+class CopyingStreamReader : public ByteStreamReader {
+ public:
+  CopyingStreamReader(const uint8_t* bytes, size_t size)
+      : reader_(bytes, size) {}
+
+  uint8_t ReadByte() override { return reader_.ReadByte(); }
+  void ReadBytes(uint8_t* buffer, size_t length) override {
+    reader_.ReadBytes(buffer, length);
+  }
+  void ReadAlignment(uint8_t alignment) override {
+    reader_.ReadAlignment(alignment);
+  }
+
+ private:
+  ByteBufferStreamReader reader_;
+};
+
+// Writes a map with every standard type using a StandardCodecStreamWriter.
+std::vector<uint8_t> WriteAllTypes() {
+  std::vector<uint8_t> encoded;
+  ByteBufferStreamWriter stream(&encoded);
+  StandardCodecStreamWriter writer(&stream);
+  const uint8_t bytes[] = {1, 2, 3};
+  const int32_t ints[] = {-1, 2};
+  const int64_t longs[] = {1ll << 40};
+  const double doubles[] = {0.5, 1.5};
+  // EncodableMap orders int keys before string keys.
+  writer.WriteMapBegin(2);
+  writer.WriteInt32(1);
+  writer.WriteBool(false);
+  writer.WriteString("values");
+  writer.WriteListBegin(10);
+  writer.WriteNull();
+  writer.WriteBool(true);
+  writer.WriteInt32(7);
+  writer.WriteInt64(1ll << 40);
+  writer.WriteDouble(0.25);
+  writer.WriteString("hello");
+  writer.WriteUInt8List(bytes, 3);
+  writer.WriteInt32List(ints, 2);
+  writer.WriteInt64List(longs, 1);
+  writer.WriteFloat64List(doubles, 2);
+  return encoded;
+}
+
+const std::vector<std::string> kAllTypesEvents = {
+    "map 2",
+    "int32 1",
+    "false",
+    "string values",
+    "list 10",
+    "null",
+    "true",
+    "int32 7",
+    "int64 1099511627776",
+    "double 0.250000",
+    "string hello",
+    "uint8 list 1,2,3",
+    "int32 list -1,2",
+    "int64 list 1099511627776",
+    "float64 list 0.500000,1.500000",
+    "end list",
+    "end map",
+};
+
+}  // namespace
+
+TEST(StandardCodecStream, WriterMatchesSerializerEncoding) {
+  EncodableValue value(EncodableMap{
+      {EncodableValue("values"),
+       EncodableValue(EncodableList{
+           EncodableValue(),
+           EncodableValue(true),
+           EncodableValue(7),
+           EncodableValue(int64_t{1ll << 40}),
+           EncodableValue(0.25),
+           EncodableValue("hello"),
+           EncodableValue(std::vector<uint8_t>{1, 2, 3}),
+           EncodableValue(std::vector<int32_t>{-1, 2}),
+           EncodableValue(std::vector<int64_t>{1ll << 40}),
+           EncodableValue(std::vector<double>{0.5, 1.5}),
+       })},
+      {EncodableValue(1), EncodableValue(false)},
+  });
+  auto expected = StandardMessageCodec::GetInstance().EncodeMessage(value);
+  EXPECT_EQ(WriteAllTypes(), *expected);
+}
+
+TEST(StandardCodecStream, ReadsValuesInPlace) {
+  std::vector<uint8_t> encoded = WriteAllTypes();
+  ByteBufferStreamReader stream(encoded.data(), encoded.size());
+  StandardCodecStreamReader reader(&stream);
+  RecordingHandler handler;
+  ASSERT_TRUE(reader.ReadValue(&handler));
+  EXPECT_EQ(handler.events, kAllTypesEvents);
+}
+
+TEST(StandardCodecStream, ReadsValuesFromMisalignedBuffers) {
+  std::vector<uint8_t> encoded = WriteAllTypes();
+  // Offsets the message by one byte, so the typed lists are no longer aligned
+  // in memory even though they are aligned relative to the message.
+  std::vector<uint8_t> storage(encoded.size() + 1);
+  std::memcpy(storage.data() + 1, encoded.data(), encoded.size());
+  ByteBufferStreamReader stream(storage.data() + 1, encoded.size());
+  StandardCodecStreamReader reader(&stream);
+  RecordingHandler handler;
+  ASSERT_TRUE(reader.ReadValue(&handler));
+  EXPECT_EQ(handler.events, kAllTypesEvents);
+}
+
+TEST(StandardCodecStream, ReadsValuesFromStreamsWithoutInPlaceReads) {
+  std::vector<uint8_t> encoded = WriteAllTypes();
+  CopyingStreamReader stream(encoded.data(), encoded.size());
+  StandardCodecStreamReader reader(&stream);
+  RecordingHandler handler;
+  ASSERT_TRUE(reader.ReadValue(&handler));
+  EXPECT_EQ(handler.events, kAllTypesEvents);
+}
+
+TEST(StandardCodecStream, RejectsUnknownTypes) {
+  std::vector<uint8_t> encoded = {12, 2, 3, 128};
+  ByteBufferStreamReader stream(encoded.data(), encoded.size());
+  StandardCodecStreamReader reader(&stream);
+  RecordingHandler handler;
+  EXPECT_FALSE(reader.ReadValue(&handler));
+}
+
+}  // namespace flutter
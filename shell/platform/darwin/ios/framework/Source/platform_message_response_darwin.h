@@ -24,6 +24,8 @@ class PlatformMessageResponseDarwin : public flutter::PlatformMessageResponse {
 
   void CompleteEmpty() override;
 
+  void CompleteOnPlatformThread(std::unique_ptr<fml::Mapping> data) override;
+
  private:
   explicit PlatformMessageResponseDarwin(PlatformMessageResponseCallback callback,
                                          fml::RefPtr<fml::TaskRunner> platform_task_runner);
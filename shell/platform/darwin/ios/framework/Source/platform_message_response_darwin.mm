@@ -4,6 +4,8 @@
 
 #import "flutter/shell/platform/darwin/ios/framework/Source/platform_message_response_darwin.h"
 
+#include "flutter/fml/logging.h"
+
 namespace flutter {
 
 PlatformMessageResponseDarwin::PlatformMessageResponseDarwin(
@@ -27,4 +29,9 @@ void PlatformMessageResponseDarwin::CompleteEmpty() {
       fml::MakeCopyable([self]() mutable { self->callback_.get()(nil); }));
 }
 
+void PlatformMessageResponseDarwin::CompleteOnPlatformThread(std::unique_ptr<fml::Mapping> data) {
+  FML_DCHECK(platform_task_runner_->RunsTasksOnCurrentThread());
+  callback_.get()(data ? GetNSDataFromMapping(std::move(data)) : nil);
+}
+
 }  // namespace flutter
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -41,9 +42,11 @@ extern const intptr_t kPlatformStrongDillSize;
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/shell/common/frame_timing_history.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/switches.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -175,6 +178,15 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // OS_LINUX || OS_WIN
 
+#ifdef SHELL_ENABLE_GL
+static FlutterRect ToFlutterRect(const SkIRect& rect) {
+  return FlutterRect{static_cast<double>(rect.left()),
+                     static_cast<double>(rect.top()),
+                     static_cast<double>(rect.right()),
+                     static_cast<double>(rect.bottom())};
+}
+#endif  // SHELL_ENABLE_GL
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferOpenGLPlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -194,15 +206,26 @@ InferOpenGLPlatformViewCreationCallback(
   auto gl_clear_current = [ptr = config->open_gl.clear_current,
                            user_data]() -> bool { return ptr(user_data); };
 
-  auto gl_present = [present = config->open_gl.present,
-                     present_with_info = config->open_gl.present_with_info,
-                     user_data](uint32_t fbo_id) -> bool {
+  auto gl_present =
+      [present = config->open_gl.present,
+       present_with_info = config->open_gl.present_with_info,
+       user_data](const flutter::GLPresentInfo& gl_present_info) -> bool {
     if (present) {
       return present(user_data);
     } else {
       FlutterPresentInfo present_info = {};
       present_info.struct_size = sizeof(FlutterPresentInfo);
-      present_info.fbo_id = fbo_id;
+      present_info.fbo_id = gl_present_info.fbo_id;
+      if (gl_present_info.frame_damage) {
+        present_info.has_frame_damage = true;
+        present_info.frame_damage =
+            ToFlutterRect(*gl_present_info.frame_damage);
+      }
+      if (gl_present_info.buffer_damage) {
+        present_info.has_buffer_damage = true;
+        present_info.buffer_damage =
+            ToFlutterRect(*gl_present_info.buffer_damage);
+      }
       return present_with_info(user_data, &present_info);
     }
   };
@@ -256,6 +279,23 @@ InferOpenGLPlatformViewCreationCallback(
     }
   }
 
+  std::function<std::optional<SkIRect>(uint32_t)>
+      gl_populate_existing_damage = nullptr;
+  if (SAFE_ACCESS(open_gl_config, populate_existing_damage, nullptr) !=
+      nullptr) {
+    gl_populate_existing_damage =
+        [ptr = config->open_gl.populate_existing_damage,
+         user_data](uint32_t fbo_id) -> std::optional<SkIRect> {
+      FlutterRect existing_damage = {};
+      if (!ptr(user_data, fbo_id, &existing_damage)) {
+        return std::nullopt;
+      }
+      return SkRect::MakeLTRB(existing_damage.left, existing_damage.top,
+                              existing_damage.right, existing_damage.bottom)
+          .roundOut();
+    };
+  }
+
   flutter::GPUSurfaceGLDelegate::GLProcResolver gl_proc_resolver = nullptr;
   if (SAFE_ACCESS(open_gl_config, gl_proc_resolver, nullptr) != nullptr) {
     gl_proc_resolver = [ptr = config->open_gl.gl_proc_resolver,
@@ -279,6 +319,7 @@ InferOpenGLPlatformViewCreationCallback(
       gl_make_resource_current_callback,   // gl_make_resource_current_callback
       gl_surface_transformation_callback,  // gl_surface_transformation_callback
       gl_proc_resolver,                    // gl_proc_resolver
+      gl_populate_existing_damage,         // gl_populate_existing_damage
   };
 
   return fml::MakeCopyable(
@@ -1492,9 +1533,21 @@ FlutterEngineResult FlutterEngineSendPointerEvent(
                                   "running Flutter application.");
 }
 
-FlutterEngineResult FlutterEngineSendPlatformMessage(
+// Sends a message on behalf of |FlutterEngineSendPlatformMessage| and
+// |FlutterEngineSendPlatformMessageWithReleaseCallback|. Without a release
+// callback the message data is copied. With one, the engine takes ownership
+// of the data and invokes the callback exactly once, even on failure.
+static FlutterEngineResult SendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
-    const FlutterPlatformMessage* flutter_message) {
+    const FlutterPlatformMessage* flutter_message,
+    VoidCallback release_callback,
+    void* release_user_data) {
+  fml::ScopedCleanupClosure release_data([&]() {
+    if (release_callback) {
+      release_callback(release_user_data);
+    }
+  });
+
   if (engine == nullptr) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
   }
@@ -1529,6 +1582,16 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
   if (message_size == 0) {
     message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel, response);
+  } else if (release_callback) {
+    // From here on the mapping owns the data and releases it.
+    release_data.Release();
+    auto mapping = std::make_unique<fml::NonOwnedMapping>(
+        message_data, message_size,
+        [release_callback, release_user_data](const uint8_t*, size_t) {
+          release_callback(release_user_data);
+        });
+    message = fml::MakeRefCounted<flutter::PlatformMessage>(
+        flutter_message->channel, std::move(mapping), response);
   } else {
     message = fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel,
@@ -1544,6 +1607,25 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
                                   "Flutter application.");
 }
 
+FlutterEngineResult FlutterEngineSendPlatformMessage(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* flutter_message) {
+  return SendPlatformMessage(engine, flutter_message, nullptr, nullptr);
+}
+
+FlutterEngineResult FlutterEngineSendPlatformMessageWithReleaseCallback(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* flutter_message,
+    VoidCallback release_callback,
+    void* release_user_data) {
+  if (release_callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid release callback argument.");
+  }
+  return SendPlatformMessage(engine, flutter_message, release_callback,
+                             release_user_data);
+}
+
 FlutterEngineResult FlutterPlatformMessageCreateResponseHandle(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterDataCallback data_callback,
@@ -2147,6 +2229,47 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
   }
 }
 
+namespace {
+static FlutterFrameTimingPercentiles ToEmbedderPercentiles(
+    const flutter::FrameTimingHistory::Percentiles& percentiles) {
+  return {
+      static_cast<uint64_t>(percentiles.p50.ToNanoseconds()),
+      static_cast<uint64_t>(percentiles.p90.ToNanoseconds()),
+      static_cast<uint64_t>(percentiles.p99.ToNanoseconds()),
+      static_cast<uint64_t>(percentiles.max.ToNanoseconds()),
+  };
+}
+}  // namespace
+
+FlutterEngineResult FlutterEngineGetFrameTimingStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterFrameTimingStatistics* statistics) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  if (statistics == nullptr ||
+      statistics->struct_size < sizeof(FlutterFrameTimingStatistics)) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "Invalid frame timing statistics specified.");
+  }
+
+  using History = flutter::FrameTimingHistory;
+  const auto history_statistics =
+      engine->GetShell().GetFrameTimingHistory().GetStatistics();
+  statistics->frame_count = history_statistics.frame_count;
+  statistics->vsync_overhead = ToEmbedderPercentiles(
+      history_statistics.intervals[History::kVsyncOverhead]);
+  statistics->build =
+      ToEmbedderPercentiles(history_statistics.intervals[History::kBuild]);
+  statistics->raster =
+      ToEmbedderPercentiles(history_statistics.intervals[History::kRaster]);
+  statistics->total =
+      ToEmbedderPercentiles(history_statistics.intervals[History::kTotal]);
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -2167,6 +2290,8 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(SendWindowMetricsEvent, FlutterEngineSendWindowMetricsEvent);
   SET_PROC(SendPointerEvent, FlutterEngineSendPointerEvent);
   SET_PROC(SendPlatformMessage, FlutterEngineSendPlatformMessage);
+  SET_PROC(SendPlatformMessageWithReleaseCallback,
+           FlutterEngineSendPlatformMessageWithReleaseCallback);
   SET_PROC(PlatformMessageCreateResponseHandle,
            FlutterPlatformMessageCreateResponseHandle);
   SET_PROC(PlatformMessageReleaseResponseHandle,
@@ -2196,6 +2321,7 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(GetFrameTimingStatistics, FlutterEngineGetFrameTimingStatistics);
 #undef SET_PROC
 
   return kSuccess;
@@ -371,6 +371,20 @@ typedef struct {
   size_t struct_size;
   /// Id of the fbo backing the surface that was presented.
   uint32_t fbo_id;
+  /// Whether `frame_damage` is set. Only set when the embedder specifies
+  /// `FlutterOpenGLRendererConfig.populate_existing_damage`. If false, the
+  /// whole surface changed.
+  bool has_frame_damage;
+  /// The area of the surface that changed compared to the previously
+  /// presented frame, in pixels with a top-left origin. Embedders may present
+  /// only this area, for example with EGL_KHR_swap_buffers_with_damage.
+  FlutterRect frame_damage;
+  /// Whether `buffer_damage` is set. If false, the whole fbo was repainted.
+  bool has_buffer_damage;
+  /// The area of the fbo that was repainted for this frame, in pixels with a
+  /// top-left origin. This is the frame damage joined with the existing
+  /// damage reported for the fbo.
+  FlutterRect buffer_damage;
 } FlutterPresentInfo;
 
 /// Callback for when a surface is presented.
@@ -378,6 +392,15 @@ typedef bool (*BoolPresentInfoCallback)(
     void* /* user data */,
     const FlutterPresentInfo* /* present info */);
 
+/// Callback for querying the area of an fbo that does not contain the
+/// previously presented frame. Returns false if that area is unknown.
+///
+/// See: \ref FlutterOpenGLRendererConfig.populate_existing_damage.
+typedef bool (*BoolExistingDamageCallback)(
+    void* /* user data */,
+    uint32_t /* fbo id */,
+    FlutterRect* /* existing damage out */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterOpenGLRendererConfig).
   size_t struct_size;
@@ -436,6 +459,17 @@ typedef struct {
   /// `FlutterPresentInfo` struct that the embedder can use to release any
   /// resources. The return value indicates success of the present call.
   BoolPresentInfoCallback present_with_info;
+  /// This is an optional callback that enables partial repaint. Before each
+  /// frame, the engine asks the embedder for the area of the fbo the frame
+  /// will be rendered into that does not contain the previously presented
+  /// frame, in pixels with a top-left origin. For example, an embedder that
+  /// cycles between two buffers reports the damage of the frame before the
+  /// previous one (see EGL_EXT_buffer_age), and an embedder that preserves
+  /// the buffer on swap reports an empty rect. The engine then only repaints
+  /// the changed area and reports it through `present_with_info`. Returning
+  /// false repaints the whole fbo. Partial repaint is not used with a custom
+  /// compositor (`FlutterProjectArgs.compositor`).
+  BoolExistingDamageCallback populate_existing_damage;
 } FlutterOpenGLRendererConfig;
 
 /// Alias for id<MTLDevice>.
@@ -1057,6 +1091,31 @@ typedef enum {
   kFlutterEngineDisplaysUpdateTypeCount,
 } FlutterEngineDisplaysUpdateType;
 
+/// The percentiles of the duration of one interval of the frames rasterized by
+/// an engine, in nanoseconds. Percentiles are accurate to about 3%.
+typedef struct {
+  uint64_t p50_nanos;
+  uint64_t p90_nanos;
+  uint64_t p99_nanos;
+  uint64_t max_nanos;
+} FlutterFrameTimingPercentiles;
+
+/// The statistics filled in by `FlutterEngineGetFrameTimingStatistics`.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterFrameTimingStatistics).
+  size_t struct_size;
+  /// The number of frames rasterized by the engine so far.
+  uint64_t frame_count;
+  /// From the vsync signal to the start of the frame build on the UI thread.
+  FlutterFrameTimingPercentiles vsync_overhead;
+  /// From the start to the end of the frame build on the UI thread.
+  FlutterFrameTimingPercentiles build;
+  /// From the start to the end of the rasterization on the raster thread.
+  FlutterFrameTimingPercentiles raster;
+  /// From the vsync signal to the end of the rasterization.
+  FlutterFrameTimingPercentiles total;
+} FlutterFrameTimingStatistics;
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -1554,6 +1613,34 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
 
+//------------------------------------------------------------------------------
+/// @brief      Sends a platform message to the Flutter application without
+///             copying its data. The engine takes ownership of the message
+///             data and hands it to the Dart application as is, so it must
+///             stay valid and writable until the release callback is
+///             invoked.
+///
+///             The release callback is invoked exactly once, on an
+///             unspecified thread, once the engine and the Dart application
+///             no longer reference the data. This includes the case where
+///             this call fails.
+///
+/// @param[in]  engine             A running engine instance.
+/// @param[in]  message            The message to send.
+/// @param[in]  release_callback   The callback invoked to release the
+///                                message data.
+/// @param[in]  release_user_data  The user data baton passed to the release
+///                                callback.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageWithReleaseCallback(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* message,
+    VoidCallback release_callback,
+    void* release_user_data);
+
 //------------------------------------------------------------------------------
 /// @brief     Creates a platform message response handle that allows the
 ///            embedder to set a native callback for a response to a message.
@@ -2029,6 +2116,26 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
     const FlutterEngineDisplay* displays,
     size_t display_count);
 
+//------------------------------------------------------------------------------
+/// @brief      Gets the percentiles of the frame timings of all the frames
+///             rasterized by a running engine instance so far. The timings
+///             are always recorded, in release mode too, and reading them
+///             does not need a timeline to be enabled.
+///
+///             This call does not block on any engine thread and may be made
+///             from any thread.
+///
+/// @param[in]  engine      A running engine instance.
+/// @param[out] statistics  The statistics to fill in. Its `struct_size` must
+///                         be set by the caller.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineGetFrameTimingStatistics(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingStatistics* statistics);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2065,6 +2172,12 @@ typedef FlutterEngineResult (*FlutterEngineSendPointerEventFnPtr)(
 typedef FlutterEngineResult (*FlutterEngineSendPlatformMessageFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
+typedef FlutterEngineResult (
+    *FlutterEngineSendPlatformMessageWithReleaseCallbackFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* message,
+    VoidCallback release_callback,
+    void* release_user_data);
 typedef FlutterEngineResult (
     *FlutterEnginePlatformMessageCreateResponseHandleFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
@@ -2140,6 +2253,9 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     FlutterEngineDisplaysUpdateType update_type,
     const FlutterEngineDisplay* displays,
     size_t display_count);
+typedef FlutterEngineResult (*FlutterEngineGetFrameTimingStatisticsFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterFrameTimingStatistics* statistics);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2183,6 +2299,9 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineSendPlatformMessageWithReleaseCallbackFnPtr
+      SendPlatformMessageWithReleaseCallback;
+  FlutterEngineGetFrameTimingStatisticsFnPtr GetFrameTimingStatistics;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/embedder/embedder_platform_message_response.h"
 
+#include "flutter/fml/logging.h"
 #include "flutter/fml/make_copyable.h"
 
 namespace flutter {
@@ -34,4 +35,15 @@ void EmbedderPlatformMessageResponse::CompleteEmpty() {
   Complete(std::make_unique<fml::NonOwnedMapping>(nullptr, 0u));
 }
 
+// |PlatformMessageResponse|
+void EmbedderPlatformMessageResponse::CompleteOnPlatformThread(
+    std::unique_ptr<fml::Mapping> data) {
+  FML_DCHECK(runner_->RunsTasksOnCurrentThread());
+  if (!data) {
+    callback_(nullptr, 0u);
+    return;
+  }
+  callback_(data->GetMapping(), data->GetSize());
+}
+
 }  // namespace flutter
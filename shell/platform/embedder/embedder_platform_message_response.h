@@ -45,6 +45,9 @@ class EmbedderPlatformMessageResponse : public PlatformMessageResponse {
   // |PlatformMessageResponse|
   void CompleteEmpty() override;
 
+  // |PlatformMessageResponse|
+  void CompleteOnPlatformThread(std::unique_ptr<fml::Mapping> data) override;
+
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderPlatformMessageResponse);
 };
 
@@ -46,7 +46,27 @@ bool EmbedderSurfaceGL::GLContextClearCurrent() {
 
 // |GPUSurfaceGLDelegate|
 bool EmbedderSurfaceGL::GLContextPresent(uint32_t fbo_id) {
-  return gl_dispatch_table_.gl_present_callback(fbo_id);
+  GLPresentInfo present_info;
+  present_info.fbo_id = fbo_id;
+  return GLContextPresentWithInfo(present_info);
+}
+
+// |GPUSurfaceGLDelegate|
+bool EmbedderSurfaceGL::GLContextPresentWithInfo(
+    const GLPresentInfo& present_info) {
+  return gl_dispatch_table_.gl_present_callback(present_info);
+}
+
+// |GPUSurfaceGLDelegate|
+SurfaceFrame::FramebufferInfo EmbedderSurfaceGL::GLContextFramebufferInfo(
+    uint32_t fbo_id) const {
+  SurfaceFrame::FramebufferInfo info;
+  auto callback = gl_dispatch_table_.gl_populate_existing_damage;
+  if (callback) {
+    info.supports_partial_repaint = true;
+    info.existing_damage = callback(fbo_id);
+  }
+  return info;
 }
 
 // |GPUSurfaceGLDelegate|
@@ -5,6 +5,8 @@
 #ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_GL_H_
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_GL_H_
 
+#include <optional>
+
 #include "flutter/fml/macros.h"
 #include "flutter/shell/gpu/gpu_surface_gl.h"
 #include "flutter/shell/platform/embedder/embedder_external_view_embedder.h"
@@ -18,12 +20,18 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   struct GLDispatchTable {
     std::function<bool(void)> gl_make_current_callback;           // required
     std::function<bool(void)> gl_clear_current_callback;          // required
-    std::function<bool(uint32_t)> gl_present_callback;            // required
+    std::function<bool(const GLPresentInfo&)>
+        gl_present_callback;                                      // required
     std::function<intptr_t(GLFrameInfo)> gl_fbo_callback;         // required
     std::function<bool(void)> gl_make_resource_current_callback;  // optional
     std::function<SkMatrix(void)>
         gl_surface_transformation_callback;              // optional
     std::function<void*(const char*)> gl_proc_resolver;  // optional
+    // Returns the area of the given FBO that does not contain the previously
+    // presented frame, or nullopt if it is unknown. Partial repaint is only
+    // enabled if this is set.
+    std::function<std::optional<SkIRect>(uint32_t)>
+        gl_populate_existing_damage;  // optional
   };
 
   EmbedderSurfaceGL(
@@ -58,6 +66,13 @@ class EmbedderSurfaceGL final : public EmbedderSurface,
   // |GPUSurfaceGLDelegate|
   bool GLContextPresent(uint32_t fbo_id) override;
 
+  // |GPUSurfaceGLDelegate|
+  bool GLContextPresentWithInfo(const GLPresentInfo& present_info) override;
+
+  // |GPUSurfaceGLDelegate|
+  SurfaceFrame::FramebufferInfo GLContextFramebufferInfo(
+      uint32_t fbo_id) const override;
+
   // |GPUSurfaceGLDelegate|
   intptr_t GLContextFBO(GLFrameInfo frame_info) const override;
 
@@ -89,6 +89,11 @@ class EmbedderTaskRunner final : public fml::TaskRunner {
   // |fml::TaskRunner|
   void PostDelayedTask(const fml::closure& task, fml::TimeDelta delay) override;
 
+  // |fml::TaskRunner|
+  void PostTaskForTimeWithPriority(const fml::closure& task,
+                                   fml::TimePoint target_time,
+                                   fml::TaskPriority priority) override;
+
   // |fml::TaskRunner|
   bool RunsTasksOnCurrentThread() override;
 
@@ -644,6 +644,17 @@ void push_frames_over_and_over() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void push_same_picture_over_and_over() {
+  final Picture picture = CreateColoredBox(Color.fromARGB(255, 128, 128, 128), Size(800.0, 600.0));
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    SceneBuilder builder = SceneBuilder();
+    builder.addPicture(Offset(0.0, 0.0), picture);
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    PlatformDispatcher.instance.scheduleFrame();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
 
 @pragma('vm:entry-point')
 void platform_view_mutators() {
@@ -45,7 +45,7 @@ EmbedderConfigBuilder::EmbedderConfigBuilder(
   opengl_renderer_config_.present_with_info =
       [](void* context, const FlutterPresentInfo* present_info) -> bool {
     return reinterpret_cast<EmbedderTestContextGL*>(context)->GLPresent(
-        present_info->fbo_id);
+        *present_info);
   };
   opengl_renderer_config_.fbo_with_frame_info_callback =
       [](void* context, const FlutterFrameInfo* frame_info) -> uint32_t {
@@ -148,7 +148,22 @@ void EmbedderConfigBuilder::SetOpenGLPresentCallBack() {
   FML_CHECK(renderer_config_.type == FlutterRendererType::kOpenGL);
   renderer_config_.open_gl.present = [](void* context) -> bool {
     // passing a placeholder fbo_id.
-    return reinterpret_cast<EmbedderTestContextGL*>(context)->GLPresent(0);
+    FlutterPresentInfo present_info = {};
+    present_info.struct_size = sizeof(FlutterPresentInfo);
+    return reinterpret_cast<EmbedderTestContextGL*>(context)->GLPresent(
+        present_info);
+  };
+#endif
+}
+
+void EmbedderConfigBuilder::SetOpenGLPopulateExistingDamageCallBack() {
+#ifdef SHELL_ENABLE_GL
+  // SetOpenGLRendererConfig must be called before this.
+  FML_CHECK(renderer_config_.type == FlutterRendererType::kOpenGL);
+  renderer_config_.open_gl.populate_existing_damage =
+      [](void* context, uint32_t fbo_id, FlutterRect* existing_damage) -> bool {
+    return reinterpret_cast<EmbedderTestContextGL*>(context)
+        ->GLPopulateExistingDamage(fbo_id, existing_damage);
   };
 #endif
 }
@@ -62,6 +62,12 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Used to set an `open_gl.populate_existing_damage` that forwards to the
+  // callback set with
+  // `EmbedderTestContextGL::SetGLPopulateExistingDamageCallback`, which
+  // enables partial repaint.
+  void SetOpenGLPopulateExistingDamageCallBack();
+
   void SetAssetsPath();
 
   void SetSnapshots();
@@ -39,7 +39,7 @@ bool EmbedderTestContextGL::GLClearCurrent() {
   return gl_surface_->ClearCurrent();
 }
 
-bool EmbedderTestContextGL::GLPresent(uint32_t fbo_id) {
+bool EmbedderTestContextGL::GLPresent(FlutterPresentInfo present_info) {
   FML_CHECK(gl_surface_) << "GL surface must be initialized.";
   gl_surface_present_count_++;
 
@@ -50,7 +50,7 @@ bool EmbedderTestContextGL::GLPresent(uint32_t fbo_id) {
   }
 
   if (callback) {
-    callback(fbo_id);
+    callback(present_info);
   }
 
   FireRootSurfacePresentCallbackIfPresent(
@@ -69,6 +69,24 @@ void EmbedderTestContextGL::SetGLPresentCallback(GLPresentCallback callback) {
   gl_present_callback_ = callback;
 }
 
+void EmbedderTestContextGL::SetGLPopulateExistingDamageCallback(
+    GLPopulateExistingDamageCallback callback) {
+  std::scoped_lock lock(gl_callback_mutex_);
+  gl_populate_existing_damage_callback_ = callback;
+}
+
+bool EmbedderTestContextGL::GLPopulateExistingDamage(
+    uint32_t fbo_id,
+    FlutterRect* existing_damage) {
+  GLPopulateExistingDamageCallback callback;
+  {
+    std::scoped_lock lock(gl_callback_mutex_);
+    callback = gl_populate_existing_damage_callback_;
+  }
+
+  return callback ? callback(fbo_id, existing_damage) : false;
+}
+
 uint32_t EmbedderTestContextGL::GLGetFramebuffer(FlutterFrameInfo frame_info) {
   FML_CHECK(gl_surface_) << "GL surface must be initialized.";
 
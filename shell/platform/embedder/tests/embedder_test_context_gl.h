@@ -14,7 +14,10 @@ namespace testing {
 class EmbedderTestContextGL : public EmbedderTestContext {
  public:
   using GLGetFBOCallback = std::function<void(FlutterFrameInfo frame_info)>;
-  using GLPresentCallback = std::function<void(uint32_t fbo_id)>;
+  using GLPresentCallback =
+      std::function<void(FlutterPresentInfo present_info)>;
+  using GLPopulateExistingDamageCallback =
+      std::function<bool(uint32_t fbo_id, FlutterRect* existing_damage)>;
 
   EmbedderTestContextGL(std::string assets_path = "");
 
@@ -53,6 +56,21 @@ class EmbedderTestContextGL : public EmbedderTestContext {
   ///
   void SetGLPresentCallback(GLPresentCallback callback);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets a callback that will be invoked (on the raster task
+  ///             runner) when the engine asks the embedder for the existing
+  ///             damage of an fbo. Only used if the renderer config was set up
+  ///             with `SetOpenGLPopulateExistingDamageCallBack`.
+  ///
+  /// @attention  The callback will be invoked on the raster task runner. The
+  ///             callback can be set on the tests host thread.
+  ///
+  /// @param[in]  callback  The callback to set. The previous callback will be
+  ///                       un-registered.
+  ///
+  void SetGLPopulateExistingDamageCallback(
+      GLPopulateExistingDamageCallback callback);
+
  protected:
   virtual void SetupCompositor() override;
 
@@ -65,6 +83,7 @@ class EmbedderTestContextGL : public EmbedderTestContext {
   std::mutex gl_callback_mutex_;
   GLGetFBOCallback gl_get_fbo_callback_;
   GLPresentCallback gl_present_callback_;
+  GLPopulateExistingDamageCallback gl_populate_existing_damage_callback_;
 
   void SetupSurface(SkISize surface_size) override;
 
@@ -72,7 +91,9 @@ class EmbedderTestContextGL : public EmbedderTestContext {
 
   bool GLClearCurrent();
 
-  bool GLPresent(uint32_t fbo_id);
+  bool GLPresent(FlutterPresentInfo present_info);
+
+  bool GLPopulateExistingDamage(uint32_t fbo_id, FlutterRect* existing_damage);
 
   uint32_t GLGetFramebuffer(FlutterFrameInfo frame_info);
 
@@ -387,6 +387,146 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that the engine takes ownership of the data of platform messages sent
+/// with a release callback, and releases it once the message is collected.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithReleaseCallback) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  // Large enough to be handed to Dart as external data.
+  const std::string message_data(4096, 'x');
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&message, &message_data](Dart_NativeArguments args) {
+            auto received_message = tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0));
+            ASSERT_EQ(received_message, message_data);
+            message.Signal();
+          })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  auto* owned_data = new std::string(message_data);
+  fml::AutoResetWaitableEvent released;
+  struct ReleaseBaton {
+    std::string* data;
+    fml::AutoResetWaitableEvent* released;
+  } baton = {owned_data, &released};
+
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message =
+      reinterpret_cast<const uint8_t*>(owned_data->data());
+  platform_message.message_size = owned_data->size();
+  platform_message.response_handle = nullptr;  // No response needed.
+
+  auto result = FlutterEngineSendPlatformMessageWithReleaseCallback(
+      engine.get(), &platform_message,
+      [](void* user_data) {
+        auto* baton = reinterpret_cast<ReleaseBaton*>(user_data);
+        delete baton->data;
+        baton->released->Signal();
+      },
+      &baton);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+
+  // Collecting the isolate collects the ByteData that wraps the message.
+  engine.reset();
+  released.Wait();
+}
+
+//------------------------------------------------------------------------------
+/// Tests that the release callback is invoked when a platform message sent
+/// with one is rejected.
+///
+TEST_F(EmbedderTest, RejectedPlatformMessagesInvokeReleaseCallback) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  uint8_t data[] = {1, 2, 3};
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = nullptr;  // Invalid.
+  platform_message.message = data;
+  platform_message.message_size = sizeof(data);
+
+  size_t release_count = 0;
+  auto result = FlutterEngineSendPlatformMessageWithReleaseCallback(
+      engine.get(), &platform_message,
+      [](void* user_data) { ++*reinterpret_cast<size_t*>(user_data); },
+      &release_count);
+  ASSERT_EQ(result, kInvalidArguments);
+  ASSERT_EQ(release_count, 1u);
+}
+
+//------------------------------------------------------------------------------
+/// Tests that the statistics of the rasterized frames can be queried.
+///
+TEST_F(EmbedderTest, CanGetFrameTimingStatistics) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("can_render_scene_without_custom_compositor");
+
+  auto rendered_scene = context.GetNextSceneImage();
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  FlutterFrameTimingStatistics statistics = {};
+  ASSERT_EQ(FlutterEngineGetFrameTimingStatistics(engine.get(), &statistics),
+            kInvalidArguments);
+  statistics.struct_size = sizeof(FlutterFrameTimingStatistics);
+
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  rendered_scene.wait();
+
+  // The frame is recorded by the raster task that presented it.
+  fml::AutoResetWaitableEvent latch;
+  ASSERT_EQ(FlutterEnginePostRenderThreadTask(
+                engine.get(),
+                [](void* user_data) {
+                  reinterpret_cast<fml::AutoResetWaitableEvent*>(user_data)
+                      ->Signal();
+                },
+                &latch),
+            kSuccess);
+  latch.Wait();
+
+  ASSERT_EQ(FlutterEngineGetFrameTimingStatistics(engine.get(), &statistics),
+            kSuccess);
+  ASSERT_GE(statistics.frame_count, 1u);
+  ASSERT_GT(statistics.raster.max_nanos, 0u);
+  ASSERT_GE(statistics.total.max_nanos, statistics.raster.max_nanos);
+  ASSERT_LE(statistics.raster.p50_nanos, statistics.raster.max_nanos);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
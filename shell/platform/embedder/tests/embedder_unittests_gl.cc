@@ -3118,8 +3118,9 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   const uint32_t window_fbo_id =
       static_cast<EmbedderTestContextGL&>(context).GetWindowFBOId();
   static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
-      [window_fbo_id = window_fbo_id, &frame_latch](uint32_t fbo_id) {
-        ASSERT_EQ(fbo_id, window_fbo_id);
+      [window_fbo_id = window_fbo_id,
+       &frame_latch](FlutterPresentInfo present_info) {
+        ASSERT_EQ(present_info.fbo_id, window_fbo_id);
 
         frame_latch.CountDown();
       });
@@ -3127,6 +3128,59 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   frame_latch.Wait();
 }
 
+TEST_F(EmbedderTest, PresentInfoContainsFrameDamageWithPartialRepaint) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  builder.SetOpenGLPopulateExistingDamageCallBack();
+  builder.SetDartEntrypoint("push_same_picture_over_and_over");
+
+  // The fbo always contains the previously presented frame.
+  static_cast<EmbedderTestContextGL&>(context)
+      .SetGLPopulateExistingDamageCallback(
+          [](uint32_t fbo_id, FlutterRect* existing_damage) {
+            *existing_damage = {0, 0, 0, 0};
+            return true;
+          });
+
+  std::vector<FlutterPresentInfo> presents;
+  fml::CountDownLatch frame_latch(3);
+  static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
+      [&](FlutterPresentInfo present_info) {
+        if (presents.size() < 3) {
+          presents.push_back(present_info);
+          frame_latch.CountDown();
+        }
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+
+  // The first frame has nothing to be compared against.
+  ASSERT_TRUE(presents[0].has_frame_damage);
+  ASSERT_EQ(presents[0].frame_damage.right, 800);
+  ASSERT_EQ(presents[0].frame_damage.bottom, 600);
+
+  // The following frames draw the same picture.
+  ASSERT_TRUE(presents[2].has_frame_damage);
+  ASSERT_EQ(presents[2].frame_damage.right - presents[2].frame_damage.left, 0);
+  ASSERT_TRUE(presents[2].has_buffer_damage);
+  ASSERT_EQ(presents[2].buffer_damage.right - presents[2].buffer_damage.left,
+            0);
+}
+
 TEST_F(EmbedderTest, SetSingleDisplayConfigurationWithDisplayId) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
 
@@ -36,6 +36,13 @@ class CompatTaskRunner : public fml::TaskRunner {
                            zx::duration(delay.ToNanoseconds()));
   }
 
+  void PostTaskForTimeWithPriority(const fml::closure& task,
+                                   fml::TimePoint target_time,
+                                   fml::TaskPriority priority) override {
+    // The async dispatcher has no notion of priorities.
+    PostTaskForTime(task, target_time);
+  }
+
   bool RunsTasksOnCurrentThread() override {
     return forwarding_target_ == async_get_default_dispatcher();
   }
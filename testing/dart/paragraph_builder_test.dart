@@ -22,6 +22,25 @@ void main() {
     expect(paragraph.height, isNonZero);
   });
 
+  test('buildAndLayout lays out the paragraph like build and layout', () async {
+    ParagraphBuilder createBuilder() {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle());
+      builder.addText('Hello, this text is long enough to wrap onto several lines.');
+      return builder;
+    }
+    const ParagraphConstraints constraints = ParagraphConstraints(width: 100.0);
+
+    final Paragraph expected = createBuilder().build();
+    expected.layout(constraints);
+    final Paragraph paragraph = await createBuilder().buildAndLayout(constraints);
+
+    expect(paragraph.width, expected.width);
+    expect(paragraph.height, expected.height);
+    expect(paragraph.longestLine, expected.longestLine);
+    expect(paragraph.computeLineMetrics().length,
+        expected.computeLineMetrics().length);
+  });
+
   test('PushStyle should not segfault after build()', () {
     final ParagraphBuilder paragraphBuilder =
         ParagraphBuilder(ParagraphStyle());
@@ -105,6 +105,8 @@ def RunCCTests(build_dir, filter):
     "--gtest_repeat=2",
   ]
 
+  RunEngineExecutable(build_dir, 'assets_unittests', filter, shuffle_flags)
+
   RunEngineExecutable(build_dir, 'client_wrapper_glfw_unittests', filter, shuffle_flags)
 
   RunEngineExecutable(build_dir, 'common_cpp_core_unittests', filter, shuffle_flags)
@@ -171,6 +173,8 @@ def RunCCTests(build_dir, filter):
 def RunEngineBenchmarks(build_dir, filter):
   print("Running Engine Benchmarks.")
 
+  RunEngineExecutable(build_dir, 'assets_benchmarks', filter)
+
   RunEngineExecutable(build_dir, 'shell_benchmarks', filter)
 
   RunEngineExecutable(build_dir, 'fml_benchmarks', filter)
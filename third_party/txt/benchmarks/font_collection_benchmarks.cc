@@ -0,0 +1,62 @@
+/*
+ * Copyright 2017 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "txt/font_collection.h"
+
+namespace txt {
+
+// Matches the fallback fonts for characters of a script in a new font
+// collection with the platform's fonts, as the first frames of an app showing
+// that script do. Only the first character asks the font managers, the others
+// are matched by the coverage of the fallback font found for it.
+static void ColdFallbackMatching(benchmark::State& state, uint32_t first) {
+  std::vector<uint32_t> code_points;
+  for (uint32_t ch = first; ch < first + state.range(0); ++ch) {
+    code_points.push_back(ch);
+  }
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    auto font_collection = std::make_shared<FontCollection>();
+    font_collection->SetupDefaultFontManager();
+    state.ResumeTiming();
+    font_collection->PrewarmFallbackFonts(code_points, "en-US");
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+static void BM_FontCollectionColdFallbackMatching(benchmark::State& state) {
+  // Emoji, starting at U+1F600 GRINNING FACE.
+  ColdFallbackMatching(state, 0x1F600);
+}
+BENCHMARK(BM_FontCollectionColdFallbackMatching)
+    ->RangeMultiplier(4)
+    ->Range(1, 64)
+    ->Complexity(benchmark::oN);
+
+static void BM_FontCollectionColdCJKFallbackMatching(benchmark::State& state) {
+  // CJK ideographs, starting at U+4E00.
+  ColdFallbackMatching(state, 0x4E00);
+}
+BENCHMARK(BM_FontCollectionColdCJKFallbackMatching)
+    ->RangeMultiplier(8)
+    ->Range(1, 4096)
+    ->Complexity(benchmark::oN);
+
+}  // namespace txt
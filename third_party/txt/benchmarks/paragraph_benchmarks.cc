@@ -17,6 +17,7 @@
 #include <minikin/Layout.h>
 
 #include <cstring>
+#include <thread>
 
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/logging.h"
@@ -245,6 +246,64 @@ BENCHMARK_REGISTER_F(ParagraphFixture, StylesBigO)
     ->Range(1 << 3, 1 << 12)
     ->Complexity(benchmark::oN);
 
+// Types and deletes a character at edit_index of a text of state.range(0)
+// characters, laying out the paragraph after each edit.
+static void IncrementalEdit(benchmark::State& state,
+                            std::shared_ptr<FontCollection> font_collection,
+                            size_t edit_index) {
+  // Text with a hard line break every 80 characters, like a document being
+  // edited in a text field.
+  std::u16string u16_text;
+  for (int i = 0; i < state.range(0); ++i) {
+    u16_text.push_back(i % 80 == 79 ? '\n' : (i % 5 == 0 ? ' ' : 'a'));
+  }
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+  bool inserted = false;
+  while (state.KeepRunning()) {
+    if (inserted) {
+      paragraph->ReplaceText(edit_index, edit_index + 1, u"");
+    } else {
+      paragraph->ReplaceText(edit_index, edit_index, u"b");
+    }
+    inserted = !inserted;
+    paragraph->Layout(300);
+  }
+  state.SetComplexityN(state.range(0));
+}
+
+BENCHMARK_DEFINE_F(ParagraphFixture, IncrementalEditBigO)
+(benchmark::State& state) {
+  // Edit the middle of the text.
+  IncrementalEdit(state, font_collection_, state.range(0) / 2);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, IncrementalEditBigO)
+    ->RangeMultiplier(4)
+    ->Range(10000, 100000)
+    ->Complexity(benchmark::oN);
+
+BENCHMARK_DEFINE_F(ParagraphFixture, IncrementalAppendBigO)
+(benchmark::State& state) {
+  // Edit the end of the text, like typing at the end of a document.
+  IncrementalEdit(state, font_collection_, state.range(0));
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, IncrementalAppendBigO)
+    ->RangeMultiplier(4)
+    ->Range(10000, 100000)
+    ->Complexity(benchmark::oN);
+
 BENCHMARK_F(ParagraphFixture, PaintSimple)(benchmark::State& state) {
   const char* text = "Hello world! This is a simple sentence to test drawing.";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
@@ -389,6 +448,49 @@ BENCHMARK_REGISTER_F(ParagraphFixture, MinikinDoLayout)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+// Lays out the same text as MinikinDoLayout on state.range(0) threads at once
+// to measure contention in minikin's caches.
+BENCHMARK_DEFINE_F(ParagraphFixture, MinikinDoLayoutParallel)
+(benchmark::State& state) {
+  const size_t kTextLength = 1 << 12;
+  const size_t thread_count = state.range(0);
+  std::vector<uint16_t> text;
+  for (uint16_t i = 0; i < kTextLength * thread_count; ++i) {
+    text.push_back(i % 5 == 0 ? ' ' : i);
+  }
+  minikin::FontStyle font;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  minikin::MinikinPaint paint;
+
+  font = minikin::FontStyle(4, false);
+  paint.size = text_style.font_size;
+  paint.letterSpacing = text_style.letter_spacing;
+  paint.wordSpacing = text_style.word_spacing;
+
+  auto collection = font_collection_->GetMinikinFontCollectionForFamilies(
+      text_style.font_families, "en-US");
+
+  while (state.KeepRunning()) {
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads.emplace_back([&, i]() {
+        minikin::Layout layout;
+        layout.doLayout(text.data() + i * kTextLength, 0, kTextLength,
+                        kTextLength, 0, font, paint, collection);
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * thread_count);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, MinikinDoLayoutParallel)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
 BENCHMARK_DEFINE_F(ParagraphFixture, AddStyleRun)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < 16000 * 2; ++i) {
@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "BreakIteratorPool.h"
+
+#include <mutex>
+#include <vector>
+
+namespace minikin {
+
+namespace {
+
+// Enough for the threads that lay out paragraphs at the same time. Iterators
+// released while the pool is full are deleted.
+const size_t kMaxPooledIterators = 8;
+
+struct Pool {
+  std::mutex mutex;
+  // Never used to iterate, only cloned.
+  std::unique_ptr<icu::BreakIterator> prototype;
+  std::vector<std::unique_ptr<icu::BreakIterator>> iterators;
+};
+
+Pool& getPool(BreakIteratorType type) {
+  static Pool* pools = new Pool[2];
+  return pools[type];
+}
+
+}  // namespace
+
+std::unique_ptr<icu::BreakIterator> acquireBreakIterator(
+    BreakIteratorType type) {
+  Pool& pool = getPool(type);
+  std::scoped_lock lock(pool.mutex);
+  if (!pool.iterators.empty()) {
+    std::unique_ptr<icu::BreakIterator> iterator =
+        std::move(pool.iterators.back());
+    pool.iterators.pop_back();
+    return iterator;
+  }
+  if (!pool.prototype) {
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::BreakIterator> prototype(
+        type == kBreakIteratorType_Line
+            ? icu::BreakIterator::createLineInstance(icu::Locale(), status)
+            : icu::BreakIterator::createWordInstance(icu::Locale(), status));
+    if (!U_SUCCESS(status))
+      return nullptr;
+    pool.prototype = std::move(prototype);
+  }
+  return std::unique_ptr<icu::BreakIterator>(pool.prototype->clone());
+}
+
+void releaseBreakIterator(BreakIteratorType type,
+                          std::unique_ptr<icu::BreakIterator> iterator) {
+  if (!iterator)
+    return;
+  Pool& pool = getPool(type);
+  std::scoped_lock lock(pool.mutex);
+  if (pool.iterators.size() < kMaxPooledIterators) {
+    pool.iterators.push_back(std::move(iterator));
+  }
+}
+
+}  // namespace minikin
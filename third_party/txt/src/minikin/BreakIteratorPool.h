@@ -0,0 +1,35 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MINIKIN_BREAK_ITERATOR_POOL_H
+#define MINIKIN_BREAK_ITERATOR_POOL_H
+
+#include <memory>
+
+#include "unicode/brkiter.h"
+
+namespace minikin {
+
+// libtxt extension: a process-wide pool of ICU break iterators for the
+// default locale. Creating a break iterator loads and compiles the break
+// rules, and even cloning one is expensive, so paragraphs borrow an iterator
+// while they break a text and return it afterwards. These are thread-safe.
+enum BreakIteratorType {
+  kBreakIteratorType_Line = 0,
+  kBreakIteratorType_Word = 1,
+};
+
+// Returns an iterator of the given type, or nullptr if ICU failed to create
+// one. The text of the iterator must be set before it is used.
+std::unique_ptr<icu::BreakIterator> acquireBreakIterator(
+    BreakIteratorType type);
+
+// Returns an iterator from acquireBreakIterator() to the pool. Its text is
+// never read again.
+void releaseBreakIterator(BreakIteratorType type,
+                          std::unique_ptr<icu::BreakIterator> iterator);
+
+}  // namespace minikin
+
+#endif  // MINIKIN_BREAK_ITERATOR_POOL_H
@@ -123,6 +123,7 @@ static std::vector<FontLanguage> parseLanguageList(const std::string& input) {
 // static
 uint32_t FontLanguageListCache::getId(const std::string& languages) {
   FontLanguageListCache* inst = FontLanguageListCache::getInstance();
+  std::scoped_lock _l(inst->mMutex);
   std::unordered_map<std::string, uint32_t>::const_iterator it =
       inst->mLanguageListLookupTable.find(languages);
   if (it != inst->mLanguageListLookupTable.end()) {
@@ -144,6 +145,7 @@ uint32_t FontLanguageListCache::getId(const std::string& languages) {
 // static
 const FontLanguages& FontLanguageListCache::getById(uint32_t id) {
   FontLanguageListCache* inst = FontLanguageListCache::getInstance();
+  std::scoped_lock _l(inst->mMutex);
   LOG_ALWAYS_FATAL_IF(id >= inst->mLanguageLists.size(),
                       "Lookup by unknown language list ID.");
   return inst->mLanguageLists[id];
@@ -151,17 +153,16 @@ const FontLanguages& FontLanguageListCache::getById(uint32_t id) {
 
 // static
 FontLanguageListCache* FontLanguageListCache::getInstance() {
-  assertMinikinLocked();
-  static FontLanguageListCache* instance = nullptr;
-  if (instance == nullptr) {
-    instance = new FontLanguageListCache();
+  static FontLanguageListCache* instance = []() {
+    FontLanguageListCache* instance = new FontLanguageListCache();
 
     // Insert an empty language list for mapping default language list to
     // kEmptyListId. The default language list has only one FontLanguage and it
     // is the unsupported language.
     instance->mLanguageLists.push_back(FontLanguages());
     instance->mLanguageListLookupTable.insert(std::make_pair("", kEmptyListId));
-  }
+    return instance;
+  }();
   return instance;
 }
 
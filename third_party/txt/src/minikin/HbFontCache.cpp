@@ -21,9 +21,12 @@
 #include <log/log.h>
 #include <utils/LruCache.h>
 
+#include <mutex>
+
 #include <hb-ot.h>
 #include <hb.h>
 
+#include <minikin/Layout.h>
 #include <minikin/MinikinFont.h>
 #include "MinikinInternal.h"
 
@@ -31,7 +34,8 @@ namespace minikin {
 
 class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
  public:
-  HbFontCache() : mCache(kMaxEntries) {
+  HbFontCache()
+      : mCache(android::LruCache<int32_t, hb_font_t*>::kUnlimitedCapacity) {
     mCache.setOnEntryRemovedListener(this);
   }
 
@@ -40,44 +44,87 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
     hb_font_destroy(value);
   }
 
-  hb_font_t* get(int32_t fontId) { return mCache.get(fontId); }
+  hb_font_t* get(int32_t fontId) {
+    hb_font_t* font = mCache.get(fontId);
+    if (font != nullptr) {
+      mHitCount++;
+    } else {
+      mMissCount++;
+    }
+    return font;
+  }
 
-  void put(int32_t fontId, hb_font_t* font) { mCache.put(fontId, font); }
+  void put(int32_t fontId, hb_font_t* font) {
+    mCache.put(fontId, font);
+    trim();
+  }
 
   void clear() { mCache.clear(); }
 
   void remove(int32_t fontId) { mCache.remove(fontId); }
 
+  void setMaxCount(size_t maxCount) {
+    mMaxCount = maxCount;
+    trim();
+  }
+
+  void getStats(LayoutCacheStats* stats) const {
+    stats->hbFontCount = mCache.size();
+    stats->hbFontMaxCount = mMaxCount;
+    stats->hbFontHitCount = mHitCount;
+    stats->hbFontMissCount = mMissCount;
+    stats->hbFontEvictionCount = mEvictionCount;
+  }
+
  private:
-  static const size_t kMaxEntries = 100;
+  static const size_t kDefaultMaxCount = 100;
+
+  void trim() {
+    while (mCache.size() > mMaxCount && mCache.removeOldest()) {
+      mEvictionCount++;
+    }
+  }
 
   android::LruCache<int32_t, hb_font_t*> mCache;
+  size_t mMaxCount = kDefaultMaxCount;
+  size_t mHitCount = 0;
+  size_t mMissCount = 0;
+  size_t mEvictionCount = 0;
 };
 
-HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+// Guards the cache and the null face font.
+static std::mutex gHbFontCacheMutex;
+
+static HbFontCache* getFontCacheLocked() {
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
+void purgeHbFontCache() {
+  std::scoped_lock _l(gHbFontCacheMutex);
   getFontCacheLocked()->clear();
 }
 
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+void purgeHbFont(const MinikinFont* minikinFont) {
   const int32_t fontId = minikinFont->GetUniqueId();
+  std::scoped_lock _l(gHbFontCacheMutex);
   getFontCacheLocked()->remove(fontId);
 }
 
+void setHbFontCacheMaxCount(size_t maxCount) {
+  std::scoped_lock _l(gHbFontCacheMutex);
+  getFontCacheLocked()->setMaxCount(maxCount);
+}
+
+void getHbFontCacheStats(LayoutCacheStats* stats) {
+  std::scoped_lock _l(gHbFontCacheMutex);
+  getFontCacheLocked()->getStats(stats);
+}
+
 // Returns a new reference to a hb_font_t object, caller is
 // responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
+  std::scoped_lock _l(gHbFontCacheMutex);
   // TODO: get rid of nullFaceFont
   static hb_font_t* nullFaceFont = nullptr;
   if (minikinFont == nullptr) {
@@ -110,8 +157,10 @@ hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
   hb_font_set_variations(font, variations.data(), variations.size());
   hb_font_destroy(parent_font);
   hb_face_destroy(face);
+  // Take the reference before caching the font, which may evict it.
+  hb_font_reference(font);
   fontCache->put(fontId, font);
-  return hb_font_reference(font);
+  return font;
 }
 
 }  // namespace minikin
@@ -17,14 +17,24 @@
 #ifndef MINIKIN_HBFONT_CACHE_H
 #define MINIKIN_HBFONT_CACHE_H
 
+#include <cstddef>
+
 struct hb_font_t;
 
 namespace minikin {
 class MinikinFont;
+struct LayoutCacheStats;
+
+// These are thread-safe. The returned fonts are shared by all threads and must
+// not be modified. Create a sub font to change the font functions or scale.
+void purgeHbFontCache();
+void purgeHbFont(const MinikinFont* minikinFont);
+hb_font_t* getHbFont(const MinikinFont* minikinFont);
 
-void purgeHbFontCacheLocked();
-void purgeHbFontLocked(const MinikinFont* minikinFont);
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont);
+// libtxt extension: the least recently used fonts are evicted once the cache
+// holds more than maxCount fonts.
+void setHbFontCacheMaxCount(size_t maxCount);
+void getHbFontCacheStats(LayoutCacheStats* stats);
 
 }  // namespace minikin
 #endif  // MINIKIN_HBFONT_CACHE_H
@@ -20,8 +20,11 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -33,6 +36,8 @@
 #include <hb-icu.h>
 #include <hb-ot.h>
 
+#include "flutter/fml/thread_local.h"
+
 #include <minikin/Emoji.h>
 #include <minikin/Layout.h>
 #include "FontLanguage.h"
@@ -99,6 +104,11 @@ class LayoutCacheKey {
     mChars = NULL;
   }
 
+  // The number of bytes retained by the key once its text is copied.
+  size_t getMemoryUsage() const {
+    return sizeof(LayoutCacheKey) + mNchars * sizeof(uint16_t);
+  }
+
   void doLayout(Layout* layout,
                 LayoutContext* ctx,
                 const std::shared_ptr<FontCollection>& collection) const {
@@ -129,60 +139,157 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// The layout cache is split into shards, each with its own lock, so that
+// threads laying out different words rarely contend. Words are laid out
+// without holding any lock; if two threads lay out the same word at the same
+// time, the first result to be inserted wins.
+//
+// Each shard evicts its least recently used words once the memory retained by
+// its words exceeds its share of the cache budget.
+class LayoutCache {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  LayoutCache() = default;
+
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      shard.cache.clear();
+    }
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  // Returns the cached layout for the key, laying out and caching the word if
+  // it is not in the cache yet. The returned layout is never modified and
+  // stays valid even if it is evicted.
+  std::shared_ptr<Layout> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = mShards[key.hash() % kShardCount];
+    {
+      std::scoped_lock lock(shard.mutex);
+      std::shared_ptr<Layout> layout = shard.cache.get(key);
+      if (layout) {
+        shard.hitCount++;
+        return layout;
+      }
+      shard.missCount++;
+    }
+
+    std::shared_ptr<Layout> layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+
+    key.copyText();
+    std::scoped_lock lock(shard.mutex);
+    if (shard.cache.put(key, layout)) {
+      shard.bytes += getMemoryUsage(key, *layout);
+      shard.trim(mMaxBytes / kShardCount);
+    } else {
+      key.freeText();
     }
     return layout;
   }
 
+  void setMaxBytes(size_t maxBytes) {
+    mMaxBytes = maxBytes;
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      shard.trim(maxBytes / kShardCount);
+    }
+  }
+
+  void getStats(LayoutCacheStats* stats) {
+    stats->layoutMaxBytes = mMaxBytes;
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      stats->layoutCount += shard.cache.size();
+      stats->layoutBytes += shard.bytes;
+      stats->layoutHitCount += shard.hitCount;
+      stats->layoutMissCount += shard.missCount;
+      stats->layoutEvictionCount += shard.evictionCount;
+    }
+  }
+
  private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
+  static size_t getMemoryUsage(const LayoutCacheKey& key,
+                               const Layout& layout) {
+    return key.getMemoryUsage() + layout.getMemoryUsage();
   }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+  class Shard
+      : private android::OnEntryRemoved<LayoutCacheKey,
+                                        std::shared_ptr<Layout>> {
+   public:
+    Shard()
+        : cache(android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>>::
+                    kUnlimitedCapacity) {
+      cache.setOnEntryRemovedListener(this);
+    }
+
+    // Evicts the least recently used words until the shard fits in maxBytes.
+    void trim(size_t maxBytes) {
+      while (bytes > maxBytes && cache.removeOldest()) {
+        evictionCount++;
+      }
+    }
+
+    std::mutex mutex;
+    android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> cache;
+    size_t bytes = 0;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    size_t evictionCount = 0;
+
+   private:
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key,
+                    std::shared_ptr<Layout>& value) override {
+      bytes -= getMemoryUsage(key, *value);
+      key.freeText();
+    }
+  };
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+  // About 10,000 words of average length.
+  static const size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+  static const size_t kShardCount = 16;
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  std::atomic<size_t> mMaxBytes{kDefaultMaxBytes};
+  Shard mShards[kShardCount];
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
+  // Returns the HarfBuzz buffer of the calling thread. Buffers are reused
+  // across layouts but cannot be shared between threads.
+  hb_buffer_t* getHbBuffer() {
+    FML_THREAD_LOCAL fml::ThreadLocalUniquePtr<HbBuffer> tls_buffer;
+    if (!tls_buffer.get()) {
+      tls_buffer.reset(new HbBuffer(unicodeFunctions));
+    }
+    return tls_buffer.get()->buffer;
+  }
+
   static LayoutEngine& getInstance() {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+ private:
+  struct HbBuffer {
+    explicit HbBuffer(hb_unicode_funcs_t* unicodeFunctions)
+        : buffer(hb_buffer_create()) {
+      hb_buffer_set_unicode_funcs(buffer, unicodeFunctions);
+    }
+    ~HbBuffer() { hb_buffer_destroy(buffer); }
+
+    hb_buffer_t* buffer;
+  };
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
@@ -254,34 +361,33 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  // Both function tables are immutable once created and can be shared by all
+  // threads.
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +422,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared with other threads, so the size and font
+    // functions of this layout are set on a private sub font.
+    hb_font_t* cachedFont = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(cachedFont);
+    hb_font_destroy(cachedFont);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +435,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +695,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +717,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,9 +823,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -748,7 +851,7 @@ static void addFeatures(const std::string& str,
   const char* end = start + str.size();
 
   while (start < end) {
-    static hb_feature_t feature;
+    hb_feature_t feature;
     const char* p = strchr(start, ',');
     if (!p)
       p = end;
@@ -919,7 +1022,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1193,10 +1296,30 @@ void Layout::getBounds(MinikinRect* bounds) const {
 }
 
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
+}
+
+void Layout::setCacheMaxBytes(size_t maxBytes) {
+  LayoutEngine::getInstance().layoutCache.setMaxBytes(maxBytes);
+}
+
+void Layout::setHbFontCacheMaxCount(size_t maxCount) {
+  minikin::setHbFontCacheMaxCount(maxCount);
+}
+
+LayoutCacheStats Layout::getCacheStats() {
+  LayoutCacheStats stats;
+  LayoutEngine::getInstance().layoutCache.getStats(&stats);
+  getHbFontCacheStats(&stats);
+  return stats;
+}
+
+size_t Layout::getMemoryUsage() const {
+  return sizeof(Layout) + mGlyphs.capacity() * sizeof(LayoutGlyph) +
+         mAdvances.capacity() * sizeof(float) +
+         mFaces.capacity() * sizeof(FakedFont);
 }
 
 }  // namespace minikin
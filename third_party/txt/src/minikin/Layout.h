@@ -57,6 +57,25 @@ enum {
   kBidi_Mask = 0x7
 };
 
+// libtxt extension: the size and activity of the shaping caches, which are
+// shared by all threads. Counts are cumulative since the process started.
+struct LayoutCacheStats {
+  // The cache of shaped words.
+  size_t layoutCount = 0;
+  size_t layoutBytes = 0;
+  size_t layoutMaxBytes = 0;
+  size_t layoutHitCount = 0;
+  size_t layoutMissCount = 0;
+  size_t layoutEvictionCount = 0;
+
+  // The cache of HarfBuzz fonts.
+  size_t hbFontCount = 0;
+  size_t hbFontMaxCount = 0;
+  size_t hbFontHitCount = 0;
+  size_t hbFontMissCount = 0;
+  size_t hbFontEvictionCount = 0;
+};
+
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
 // may not mutate it at the same time.
@@ -117,9 +136,23 @@ class Layout {
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // libtxt extension: sets the budget of the shaped word cache, evicting the
+  // least recently used words until the cache fits in it.
+  static void setCacheMaxBytes(size_t maxBytes);
+
+  // libtxt extension: sets how many HarfBuzz fonts are kept.
+  static void setHbFontCacheMaxCount(size_t maxCount);
+
+  // libtxt extension
+  static LayoutCacheStats getCacheStats();
+
  private:
+  friend class LayoutCache;
   friend class LayoutCacheKey;
 
+  // The number of bytes retained by this layout, used for the cache budget.
+  size_t getMemoryUsage() const;
+
   // Find a face in the mFaces vector, or create a new entry
   int findFace(const FakedFont& face, LayoutContext* ctx);
 
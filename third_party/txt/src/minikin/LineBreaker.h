@@ -98,8 +98,8 @@ class LineBreaker {
   // the cost of constructing and comparing the ICU Locale object.
   // Note: caller is responsible for managing lifetime of hyphenator
   //
-  // libtxt extension: always use the default locale so that a cached instance
-  // of the ICU break iterator can be reused.
+  // libtxt extension: always use the default locale so that pooled ICU break
+  // iterators can be reused.
   void setLocale();
 
   void resize(size_t size) {
@@ -21,6 +21,7 @@
 #include <minikin/Emoji.h>
 #include <minikin/Hyphenator.h>
 #include <minikin/WordBreaker.h>
+#include "BreakIteratorPool.h"
 #include "MinikinInternal.h"
 
 #include <unicode/uchar.h>
@@ -31,24 +32,9 @@ namespace minikin {
 const uint32_t CHAR_SOFT_HYPHEN = 0x00AD;
 const uint32_t CHAR_ZWJ = 0x200D;
 
-// libtxt extension: avoid the cost of initializing new ICU break iterators
-// by constructing a global iterator using the default locale and then
-// creating a clone for each WordBreaker instance.
-static std::once_flag gLibtxtBreakIteratorInitFlag;
-static icu::BreakIterator* gLibtxtDefaultBreakIterator = nullptr;
-
 void WordBreaker::setLocale() {
-  UErrorCode status = U_ZERO_ERROR;
-  std::call_once(gLibtxtBreakIteratorInitFlag, [&status] {
-    gLibtxtDefaultBreakIterator =
-        icu::BreakIterator::createLineInstance(icu::Locale(), status);
-  });
-  mBreakIterator.reset(gLibtxtDefaultBreakIterator->clone());
-  // TODO: handle failure status
-  if (mText != nullptr) {
-    mBreakIterator->setText(&mUText, status);
-  }
-  mIteratorWasReset = true;
+  // libtxt extension: the break iterator for the default locale is borrowed
+  // from the pool while a text is set, so there is nothing to create here.
 }
 
 void WordBreaker::setText(const uint16_t* data, size_t size) {
@@ -62,8 +48,15 @@ void WordBreaker::setText(const uint16_t* data, size_t size) {
   UErrorCode status = U_ZERO_ERROR;
   utext_openUChars(&mUText, reinterpret_cast<const UChar*>(data), size,
                    &status);
-  mBreakIterator->setText(&mUText, status);
-  mBreakIterator->first();
+  if (!mBreakIterator) {
+    mBreakIterator = acquireBreakIterator(kBreakIteratorType_Line);
+  }
+  // Without a break iterator the only break opportunity is at the end of the
+  // text, see next().
+  if (mBreakIterator) {
+    mBreakIterator->setText(&mUText, status);
+    mBreakIterator->first();
+  }
 }
 
 ssize_t WordBreaker::current() const {
@@ -232,6 +225,13 @@ ssize_t WordBreaker::findNextBreakInEmailOrUrl() {
 ssize_t WordBreaker::next() {
   mLast = mCurrent;
 
+  if (!mBreakIterator) {
+    // ICU failed to create the break iterator.
+    mCurrent = (size_t)mCurrent < mTextSize ? (ssize_t)mTextSize
+                                            : icu::BreakIterator::DONE;
+    return mCurrent;
+  }
+
   detectEmailOrUrl();
   if (mInEmailOrUrl) {
     mCurrent = findNextBreakInEmailOrUrl();
@@ -288,6 +288,7 @@ void WordBreaker::finish() {
   mText = nullptr;
   // Note: calling utext_close multiply is safe
   utext_close(&mUText);
+  releaseBreakIterator(kBreakIteratorType_Line, std::move(mBreakIterator));
 }
 
 }  // namespace minikin
@@ -33,8 +33,8 @@ class WordBreaker {
  public:
   ~WordBreaker() { finish(); }
 
-  // libtxt extension: always use the default locale so that a cached instance
-  // of the ICU break iterator can be reused.
+  // libtxt extension: always use the default locale so that pooled ICU break
+  // iterators can be reused.
   void setLocale();
 
   void setText(const uint16_t* data, size_t size);
@@ -54,6 +54,7 @@ class WordBreaker {
 
   int breakBadness() const;
 
+  // Returns the break iterator to the pool until the next setText().
   void finish();
 
  private:
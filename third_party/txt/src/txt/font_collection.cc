@@ -23,13 +23,16 @@
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "font_skia.h"
 #include "minikin/Layout.h"
+#include "txt/paragraph_cache.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
+#include "unicode/uchar.h"
 
 namespace txt {
 
@@ -37,6 +40,19 @@ namespace {
 
 const std::shared_ptr<minikin::FontFamily> g_null_family;
 
+// Appends the ranges of consecutive values in coverage to ranges.
+void AppendCoverageRanges(const minikin::SparseBitSet& coverage,
+                          std::vector<std::pair<uint32_t, uint32_t>>* ranges) {
+  uint32_t start = coverage.nextSetBit(0);
+  while (start != minikin::SparseBitSet::kNotFound) {
+    uint32_t end = start + 1;
+    while (end < coverage.length() && coverage.get(end))
+      end++;
+    ranges->emplace_back(start, end);
+    start = coverage.nextSetBit(end);
+  }
+}
+
 }  // anonymous namespace
 
 FontCollection::FamilyKey::FamilyKey(const std::vector<std::string>& families,
@@ -81,7 +97,10 @@ class TxtFallbackFontProvider
   std::weak_ptr<FontCollection> font_collection_;
 };
 
-FontCollection::FontCollection() : enable_font_fallback_(true) {}
+FontCollection::FontCollection()
+    : fallback_mutex_(fml::SharedMutex::Create()),
+      enable_font_fallback_(true),
+      paragraph_cache_(std::make_unique<ParagraphCache>()) {}
 
 FontCollection::~FontCollection() {
   minikin::Layout::purgeCaches();
@@ -98,10 +117,12 @@ size_t FontCollection::GetFontManagersCount() const {
 }
 
 void FontCollection::SetupDefaultFontManager() {
+  std::scoped_lock lock(font_managers_mutex_);
   default_font_manager_ = GetDefaultFontManager();
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(font_managers_mutex_);
   default_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -110,6 +131,7 @@ void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(font_managers_mutex_);
   asset_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -118,6 +140,7 @@ void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(font_managers_mutex_);
   dynamic_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -126,6 +149,7 @@ void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
 }
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(font_managers_mutex_);
   test_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
@@ -135,6 +159,7 @@ void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
 
 // Return the available font managers in the order they should be queried.
 std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
+  std::scoped_lock lock(font_managers_mutex_);
   std::vector<sk_sp<SkFontMgr>> order;
   if (dynamic_font_manager_)
     order.push_back(dynamic_font_manager_);
@@ -151,6 +176,7 @@ void FontCollection::DisableFontFallback() {
   enable_font_fallback_ = false;
 
 #if FLUTTER_ENABLE_SKSHAPER
+  std::scoped_lock lock(font_managers_mutex_);
   if (skt_collection_) {
     skt_collection_->disableFontFallback();
   }
@@ -163,11 +189,19 @@ FontCollection::GetMinikinFontCollectionForFamilies(
     const std::string& locale) {
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
-  auto cached = font_collections_cache_.find(family_key);
-  if (cached != font_collections_cache_.end()) {
-    return cached->second;
+  {
+    FamilyCacheShard& shard = GetFamilyCacheShard(family_key);
+    std::scoped_lock lock(shard.mutex);
+    auto cached = shard.font_collections.find(family_key);
+    if (cached != shard.font_collections.end()) {
+      return cached->second;
+    }
   }
 
+  // Finding the families in the font managers is slow, so the collection is
+  // built without holding a lock. Threads that miss the cache at the same
+  // time all build it, and the collection that is cached first is used.
+  const uint64_t generation = family_cache_generation_.load();
   std::vector<std::shared_ptr<minikin::FontFamily>> minikin_families;
 
   // Search for all user provided font families.
@@ -193,15 +227,17 @@ FontCollection::GetMinikinFontCollectionForFamilies(
   }
   // Default font family also not found. We fail to get a FontCollection.
   if (minikin_families.empty()) {
-    font_collections_cache_[family_key] = nullptr;
-    return nullptr;
+    return CacheFontCollection(family_key, generation, nullptr);
   }
   if (enable_font_fallback_) {
-    for (const std::string& fallback_family :
-         fallback_fonts_for_locale_[locale]) {
-      auto it = fallback_fonts_.find(fallback_family);
-      if (it != fallback_fonts_.end()) {
-        minikin_families.push_back(it->second);
+    fml::SharedLock lock(*fallback_mutex_);
+    auto locale_families = fallback_fonts_for_locale_.find(locale);
+    if (locale_families != fallback_fonts_for_locale_.end()) {
+      for (const std::string& fallback_family : locale_families->second) {
+        auto it = fallback_fonts_.find(fallback_family);
+        if (it != fallback_fonts_.end()) {
+          minikin_families.push_back(it->second);
+        }
       }
     }
   }
@@ -209,8 +245,7 @@ FontCollection::GetMinikinFontCollectionForFamilies(
   auto font_collection =
       minikin::FontCollection::Create(std::move(minikin_families));
   if (!font_collection) {
-    font_collections_cache_[family_key] = nullptr;
-    return nullptr;
+    return CacheFontCollection(family_key, generation, nullptr);
   }
   if (enable_font_fallback_) {
     font_collection->set_fallback_font_provider(
@@ -218,9 +253,39 @@ FontCollection::GetMinikinFontCollectionForFamilies(
   }
 
   // Cache the font collection for future queries.
-  font_collections_cache_[family_key] = font_collection;
+  return CacheFontCollection(family_key, generation,
+                             std::move(font_collection));
+}
+
+FontCollection::FamilyCacheShard& FontCollection::GetFamilyCacheShard(
+    const FamilyKey& key) {
+  return family_cache_shards_[FamilyKey::Hasher()(key) %
+                              kFamilyCacheShardCount];
+}
+
+std::shared_ptr<minikin::FontCollection> FontCollection::CacheFontCollection(
+    const FamilyKey& key,
+    uint64_t generation,
+    std::shared_ptr<minikin::FontCollection> font_collection) {
+  FamilyCacheShard& shard = GetFamilyCacheShard(key);
+  std::scoped_lock lock(shard.mutex);
+  // The fallback fonts or the font managers changed while the collection was
+  // built. The collection can still be used, but must not be cached.
+  if (family_cache_generation_.load() != generation) {
+    return font_collection;
+  }
+  auto inserted = shard.font_collections.emplace(key, font_collection);
+  return inserted.first->second;
+}
 
-  return font_collection;
+void FontCollection::ClearFontCollectionsCache() {
+  // Incremented before the shards are cleared, so that collections being
+  // built now are not cached once their shard has been cleared.
+  family_cache_generation_++;
+  for (FamilyCacheShard& shard : family_cache_shards_) {
+    std::scoped_lock lock(shard.mutex);
+    shard.font_collections.clear();
+  }
 }
 
 std::shared_ptr<minikin::FontFamily> FontCollection::FindFontFamilyInManagers(
@@ -316,16 +381,108 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
-  auto lookup = fallback_match_cache_.find(ch);
-  if (lookup != fallback_match_cache_.end()) {
-    return *lookup->second;
+  //
+  // A fallback font usually covers a whole script (or all emoji), so asking
+  // the font managers, which may scan every font on the system, is only
+  // needed for the first character of each script. Other characters are
+  // matched by the cmap coverage of the fallback fonts found before.
+  {
+    fml::SharedLock lock(*fallback_mutex_);
+    if (auto cached = FindFallbackMatch(ch, locale)) {
+      return *cached;
+    }
+    if (auto covering = FindCoveringFallbackFamily(ch, locale)) {
+      return *covering;
+    }
+  }
+
+  fml::UniqueLock lock(*fallback_mutex_);
+  // Another thread may have matched ch since the shared lock was released.
+  if (auto cached = FindFallbackMatch(ch, locale)) {
+    return *cached;
+  }
+  if (auto covering = FindCoveringFallbackFamily(ch, locale)) {
+    return *covering;
   }
   const std::shared_ptr<minikin::FontFamily>* match =
       &DoMatchFallbackFont(ch, locale);
-  fallback_match_cache_.insert(std::make_pair(ch, match));
+  fallback_match_cache_[locale][ch] = match;
   return *match;
 }
 
+const std::shared_ptr<minikin::FontFamily>* FontCollection::FindFallbackMatch(
+    uint32_t ch,
+    const std::string& locale) const {
+  auto locale_matches = fallback_match_cache_.find(locale);
+  if (locale_matches == fallback_match_cache_.end())
+    return nullptr;
+  auto match = locale_matches->second.find(ch);
+  if (match == locale_matches->second.end())
+    return nullptr;
+  return match->second;
+}
+
+const std::shared_ptr<minikin::FontFamily>*
+FontCollection::FindCoveringFallbackFamily(uint32_t ch,
+                                           const std::string& locale) const {
+  // Symbols that are emoji but not drawn as emoji by default, such as the
+  // copyright sign or the heart, are covered by many text fonts. The font
+  // managers may still prefer a color emoji font for them, so they are always
+  // matched by the font managers.
+  if (u_hasBinaryProperty(ch, UCHAR_EMOJI) &&
+      !u_hasBinaryProperty(ch, UCHAR_EMOJI_PRESENTATION))
+    return nullptr;
+  auto locale_coverage = fallback_coverage_.find(locale);
+  if (locale_coverage == fallback_coverage_.end() ||
+      !locale_coverage->second.coverage.get(ch))
+    return nullptr;
+  for (const std::shared_ptr<minikin::FontFamily>* family :
+       locale_coverage->second.families) {
+    if ((*family)->getCoverage().get(ch))
+      return family;
+  }
+  return nullptr;
+}
+
+void FontCollection::AddFallbackCoverage(
+    const std::string& locale,
+    const std::shared_ptr<minikin::FontFamily>& family) {
+  FallbackCoverage& locale_coverage = fallback_coverage_[locale];
+  if (std::find(locale_coverage.families.begin(),
+                locale_coverage.families.end(),
+                &family) != locale_coverage.families.end())
+    return;
+  TRACE_EVENT0("flutter", "FontCollection::AddFallbackCoverage");
+  locale_coverage.families.push_back(&family);
+
+  // Rebuild the union of the coverage of the locale's families. This only
+  // happens when a new fallback font is found.
+  std::vector<std::pair<uint32_t, uint32_t>> ranges;
+  AppendCoverageRanges(locale_coverage.coverage, &ranges);
+  AppendCoverageRanges(family->getCoverage(), &ranges);
+  std::sort(ranges.begin(), ranges.end());
+  std::vector<uint32_t> merged;
+  for (const auto& [start, end] : ranges) {
+    if (!merged.empty() && start <= merged.back()) {
+      merged.back() = std::max(merged.back(), end);
+    } else {
+      merged.push_back(start);
+      merged.push_back(end);
+    }
+  }
+  locale_coverage.coverage =
+      minikin::SparseBitSet(merged.data(), merged.size() / 2);
+}
+
+void FontCollection::PrewarmFallbackFonts(
+    const std::vector<uint32_t>& code_points,
+    const std::string& locale) {
+  TRACE_EVENT0("flutter", "FontCollection::PrewarmFallbackFonts");
+  for (uint32_t ch : code_points) {
+    MatchFallbackFont(ch, locale);
+  }
+}
+
 const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     uint32_t ch,
     std::string locale) {
@@ -342,12 +499,17 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     typeface->getFamilyName(&sk_family_name);
     std::string family_name(sk_family_name.c_str());
 
-    if (std::find(fallback_fonts_for_locale_[locale].begin(),
-                  fallback_fonts_for_locale_[locale].end(),
-                  family_name) == fallback_fonts_for_locale_[locale].end())
-      fallback_fonts_for_locale_[locale].push_back(family_name);
-
-    return GetFallbackFontFamily(manager, family_name);
+    const std::shared_ptr<minikin::FontFamily>& family =
+        GetFallbackFontFamily(manager, family_name);
+    std::vector<std::string>& locale_families =
+        fallback_fonts_for_locale_[locale];
+    if (std::find(locale_families.begin(), locale_families.end(),
+                  family_name) == locale_families.end())
+      locale_families.push_back(family_name);
+    if (family)
+      AddFallbackCoverage(locale, family);
+
+    return family;
   }
   return g_null_family;
 }
@@ -371,25 +533,64 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 
   // Clear the cache to force creation of new font collections that will
   // include this fallback font.
-  font_collections_cache_.clear();
+  ClearFontCollectionsCache();
 
   return insert_it.first->second;
 }
 
 void FontCollection::ClearFontFamilyCache() {
-  font_collections_cache_.clear();
+  ClearFontCollectionsCache();
+  // Paragraphs may be laid out with different fonts now.
+  paragraph_cache_->Clear();
 
 #if FLUTTER_ENABLE_SKSHAPER
+  std::scoped_lock lock(font_managers_mutex_);
   if (skt_collection_) {
     skt_collection_->clearCaches();
   }
 #endif
 }
 
+void FontCollection::SetShapingCacheMaxBytes(size_t max_bytes) {
+  minikin::Layout::setCacheMaxBytes(max_bytes);
+}
+
+void FontCollection::TraceShapingCacheStats() {
+#if FLUTTER_TIMELINE_ENABLED
+  minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  FML_TRACE_COUNTER("flutter", "ShapingCache", 0, "WordCount",
+                    stats.layoutCount, "WordKBytes", stats.layoutBytes / 1024,
+                    "HbFontCount", stats.hbFontCount);
+  FML_TRACE_COUNTER("flutter", "ShapingCacheActivity", 0, "WordHitCount",
+                    stats.layoutHitCount, "WordMissCount",
+                    stats.layoutMissCount, "WordEvictionCount",
+                    stats.layoutEvictionCount, "HbFontHitCount",
+                    stats.hbFontHitCount, "HbFontMissCount",
+                    stats.hbFontMissCount, "HbFontEvictionCount",
+                    stats.hbFontEvictionCount);
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
+ParagraphCache* FontCollection::GetParagraphCache() const {
+  return paragraph_cache_.get();
+}
+
+void FontCollection::TraceParagraphCacheStats() const {
+#if FLUTTER_TIMELINE_ENABLED
+  ParagraphCache::Stats stats = paragraph_cache_->GetStats();
+  FML_TRACE_COUNTER("flutter", "ParagraphCache", 0, "EntryCount",
+                    stats.entry_count, "KBytes", stats.bytes / 1024);
+  FML_TRACE_COUNTER("flutter", "ParagraphCacheActivity", 0, "HitCount",
+                    stats.hit_count, "MissCount", stats.miss_count,
+                    "EvictionCount", stats.eviction_count);
+#endif  // FLUTTER_TIMELINE_ENABLED
+}
+
 #if FLUTTER_ENABLE_SKSHAPER
 
 sk_sp<skia::textlayout::FontCollection>
 FontCollection::CreateSktFontCollection() {
+  std::scoped_lock lock(font_managers_mutex_);
   if (!skt_collection_) {
     skt_collection_ = sk_make_sp<skia::textlayout::FontCollection>();
 
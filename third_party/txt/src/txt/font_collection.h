@@ -17,14 +17,20 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <array>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/shared_mutex.h"
 #include "minikin/FontCollection.h"
 #include "minikin/FontFamily.h"
+#include "minikin/SparseBitSet.h"
 #include "third_party/googletest/googletest/include/gtest/gtest_prod.h"  // nogncheck
 #include "third_party/skia/include/core/SkFontMgr.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
@@ -37,6 +43,8 @@
 
 namespace txt {
 
+class ParagraphCache;
+
 class FontCollection : public std::enable_shared_from_this<FontCollection> {
  public:
   FontCollection();
@@ -51,16 +59,28 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   void SetDynamicFontManager(sk_sp<SkFontMgr> font_manager);
   void SetTestFontManager(sk_sp<SkFontMgr> font_manager);
 
+  // Returns the minikin font collection of the families, which is cached.
+  // This is thread-safe.
   std::shared_ptr<minikin::FontCollection> GetMinikinFontCollectionForFamilies(
       const std::vector<std::string>& font_families,
       const std::string& locale);
 
   // Provides a FontFamily that contains glyphs for ch. This caches previously
   // matched fonts. Also see FontCollection::DoMatchFallbackFont.
+  //
+  // This is called by minikin while laying out paragraphs, which may happen on
+  // several threads at once, and is thread-safe. Lookups of characters that
+  // were matched before only take a shared lock.
   const std::shared_ptr<minikin::FontFamily>& MatchFallbackFont(
       uint32_t ch,
       std::string locale);
 
+  // Finds the fallback fonts for code_points ahead of time, so that laying out
+  // the first text that needs them does not wait for the font managers. This
+  // is thread-safe and can be called on a background thread at startup.
+  void PrewarmFallbackFonts(const std::vector<uint32_t>& code_points,
+                            const std::string& locale);
+
   // Do not provide alternative fonts that can match characters which are
   // missing from the requested font family.
   void DisableFontFallback();
@@ -68,6 +88,19 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Sets the memory budget of the cache of shaped words, which is shared by
+  // all font collections in the process.
+  static void SetShapingCacheMaxBytes(size_t max_bytes);
+
+  // Records the size and hit rate of the shaping caches on the timeline.
+  static void TraceShapingCacheStats();
+
+  // The cache of paragraph layouts made with this collection's fonts.
+  ParagraphCache* GetParagraphCache() const;
+
+  // Records the size and hit rate of the paragraph cache on the timeline.
+  void TraceParagraphCacheStats() const;
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -90,35 +123,92 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
     };
   };
 
+  // Guards the font managers and skt_collection_. The managers can be
+  // replaced on the UI thread while paragraphs are laid out on worker threads.
+  mutable std::mutex font_managers_mutex_;
   sk_sp<SkFontMgr> default_font_manager_;
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
   sk_sp<SkFontMgr> test_font_manager_;
-  std::unordered_map<FamilyKey,
-                     std::shared_ptr<minikin::FontCollection>,
-                     FamilyKey::Hasher>
-      font_collections_cache_;
-  // Cache that stores the results of MatchFallbackFont to ensure lag-free emoji
-  // font fallback matching.
-  std::unordered_map<uint32_t, const std::shared_ptr<minikin::FontFamily>*>
-      fallback_match_cache_;
+
+  // The font collections cache is split into shards with their own locks, so
+  // that paragraphs laid out on different threads (or by different engines
+  // sharing this collection) rarely wait for each other.
+  static constexpr size_t kFamilyCacheShardCount = 8;
+  struct FamilyCacheShard {
+    std::mutex mutex;
+    std::unordered_map<FamilyKey,
+                       std::shared_ptr<minikin::FontCollection>,
+                       FamilyKey::Hasher>
+        font_collections;
+  };
+  std::array<FamilyCacheShard, kFamilyCacheShardCount> family_cache_shards_;
+  // Incremented whenever the font collections cache is cleared, so that
+  // collections built before a clear are not cached after it.
+  std::atomic<uint64_t> family_cache_generation_{0};
+
+  // Guards the fallback font caches below. Most lookups only read them.
+  std::unique_ptr<fml::SharedMutex> fallback_mutex_;
+  // Cache that stores the results of MatchFallbackFont, by locale and then by
+  // character, to ensure lag-free emoji font fallback matching.
+  using FallbackMatches =
+      std::unordered_map<uint32_t, const std::shared_ptr<minikin::FontFamily>*>;
+  std::unordered_map<std::string, FallbackMatches> fallback_match_cache_;
   std::unordered_map<std::string, std::shared_ptr<minikin::FontFamily>>
       fallback_fonts_;
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
+  // The fallback font families found for a locale, in the order they were
+  // found, and the union of the cmap coverage of all of them.
+  struct FallbackCoverage {
+    std::vector<const std::shared_ptr<minikin::FontFamily>*> families;
+    minikin::SparseBitSet coverage;
+  };
+  std::unordered_map<std::string, FallbackCoverage> fallback_coverage_;
   bool enable_font_fallback_;
+  std::unique_ptr<ParagraphCache> paragraph_cache_;
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
   sk_sp<skia::textlayout::FontCollection> skt_collection_;
 #endif
 
+  FamilyCacheShard& GetFamilyCacheShard(const FamilyKey& key);
+
+  // Caches a font collection built for key, unless the cache was cleared
+  // since generation. Returns the collection cached for key.
+  std::shared_ptr<minikin::FontCollection> CacheFontCollection(
+      const FamilyKey& key,
+      uint64_t generation,
+      std::shared_ptr<minikin::FontCollection> font_collection);
+
+  void ClearFontCollectionsCache();
+
   // Performs the actual work of MatchFallbackFont. The result is cached in
-  // fallback_match_cache_.
+  // fallback_match_cache_. Must be called with fallback_mutex_ held
+  // exclusively.
   const std::shared_ptr<minikin::FontFamily>& DoMatchFallbackFont(
       uint32_t ch,
       std::string locale);
 
+  // Returns the font family that ch was matched to for the locale, or nullptr
+  // if it was not matched yet. Must be called with fallback_mutex_ held.
+  const std::shared_ptr<minikin::FontFamily>* FindFallbackMatch(
+      uint32_t ch,
+      const std::string& locale) const;
+
+  // Returns the first fallback font family found for the locale whose cmap
+  // covers ch, or nullptr. Must be called with fallback_mutex_ held.
+  const std::shared_ptr<minikin::FontFamily>* FindCoveringFallbackFamily(
+      uint32_t ch,
+      const std::string& locale) const;
+
+  // Adds the coverage of a fallback font family found for the locale to
+  // fallback_coverage_, unless it was added before. Must be called with
+  // fallback_mutex_ held exclusively.
+  void AddFallbackCoverage(const std::string& locale,
+                           const std::shared_ptr<minikin::FontFamily>& family);
+
   std::vector<sk_sp<SkFontMgr>> GetFontManagerOrder() const;
 
   std::shared_ptr<minikin::FontFamily> FindFontFamilyInManagers(
@@ -133,6 +223,7 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   FRIEND_TEST(FontCollectionTest, CheckSkTypefacesSorting);
   static void SortSkTypefaces(std::vector<sk_sp<SkTypeface>>& sk_typefaces);
 
+  // Must be called with fallback_mutex_ held exclusively.
   const std::shared_ptr<minikin::FontFamily>& GetFallbackFontFamily(
       const sk_sp<SkFontMgr>& manager,
       const std::string& family_name);
@@ -102,4 +102,9 @@ void PaintRecord::SetOffset(SkPoint pt) {
   offset_ = pt;
 }
 
+PaintRecord PaintRecord::CopyForLine(size_t line) const {
+  return PaintRecord(style_, offset_, text_, metrics_, line, x_start_, x_end_,
+                     is_ghost_, placeholder_run_);
+}
+
 }  // namespace txt
@@ -70,6 +70,10 @@ class PaintRecord {
 
   void SetOffset(SkPoint pt);
 
+  // Returns a record that paints the same text blob on another line. The
+  // blob is shared, not copied.
+  PaintRecord CopyForLine(size_t line) const;
+
   SkTextBlob* text() const { return text_.get(); }
 
   const SkFontMetrics& metrics() const { return metrics_; }
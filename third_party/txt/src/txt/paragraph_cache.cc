@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "paragraph_cache.h"
+
+#include <iterator>
+#include <utility>
+
+namespace txt {
+
+ParagraphCache::ParagraphCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+ParagraphCache::~ParagraphCache() = default;
+
+ParagraphCache::Layout ParagraphCache::Get(
+    size_t hash,
+    const std::function<bool(const ParagraphTxt::CachedLayout&)>& matches) {
+  std::scoped_lock lock(mutex_);
+  auto found = index_.find(hash);
+  if (found == index_.end() || !matches(*found->second->layout)) {
+    miss_count_++;
+    return nullptr;
+  }
+  hit_count_++;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->layout;
+}
+
+void ParagraphCache::Put(size_t hash, Layout layout, size_t bytes) {
+  if (!layout)
+    return;
+
+  std::scoped_lock lock(mutex_);
+  if (bytes > max_bytes_)
+    return;
+
+  auto found = index_.find(hash);
+  if (found != index_.end()) {
+    // Either another paragraph was laid out concurrently, or the hash
+    // collided with that of a different paragraph.
+    EraseLocked(found->second);
+  }
+
+  EvictLocked(max_bytes_ - bytes);
+  entries_.push_front(Entry{hash, std::move(layout), bytes});
+  index_[hash] = entries_.begin();
+  bytes_ += bytes;
+}
+
+void ParagraphCache::SetMaxBytes(size_t max_bytes) {
+  std::scoped_lock lock(mutex_);
+  max_bytes_ = max_bytes;
+  EvictLocked(max_bytes_);
+}
+
+void ParagraphCache::Clear() {
+  std::scoped_lock lock(mutex_);
+  entries_.clear();
+  index_.clear();
+  bytes_ = 0;
+}
+
+ParagraphCache::Stats ParagraphCache::GetStats() const {
+  std::scoped_lock lock(mutex_);
+  Stats stats;
+  stats.entry_count = entries_.size();
+  stats.bytes = bytes_;
+  stats.max_bytes = max_bytes_;
+  stats.hit_count = hit_count_;
+  stats.miss_count = miss_count_;
+  stats.eviction_count = eviction_count_;
+  return stats;
+}
+
+void ParagraphCache::EraseLocked(std::list<Entry>::iterator entry) {
+  bytes_ -= entry->bytes;
+  index_.erase(entry->hash);
+  entries_.erase(entry);
+}
+
+void ParagraphCache::EvictLocked(size_t max_bytes) {
+  while (bytes_ > max_bytes && !entries_.empty()) {
+    EraseLocked(std::prev(entries_.end()));
+    eviction_count_++;
+  }
+}
+
+}  // namespace txt
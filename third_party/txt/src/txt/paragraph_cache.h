@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef LIB_TXT_SRC_PARAGRAPH_CACHE_H_
+#define LIB_TXT_SRC_PARAGRAPH_CACHE_H_
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "paragraph_txt.h"
+
+namespace txt {
+
+// A cache of the layouts of short paragraphs, which lets paragraphs with the
+// same text, styles and width (such as the labels of the items of a list)
+// share the line metrics and text blobs of one layout.
+//
+// Each FontCollection owns a cache, because the layouts depend on its fonts.
+// It is thread-safe. Once the layouts exceed the byte budget, the least
+// recently used layouts are evicted.
+class ParagraphCache {
+ public:
+  static constexpr size_t kDefaultMaxBytes = 2 * 1024 * 1024;
+
+  // Longer paragraphs are rarely laid out more than once, and are not cached.
+  static constexpr size_t kMaxTextLength = 500;
+
+  struct Stats {
+    size_t entry_count = 0;
+    size_t bytes = 0;
+    size_t max_bytes = 0;
+    size_t hit_count = 0;
+    size_t miss_count = 0;
+    size_t eviction_count = 0;
+  };
+
+  using Layout = std::shared_ptr<const ParagraphTxt::CachedLayout>;
+
+  explicit ParagraphCache(size_t max_bytes = kDefaultMaxBytes);
+
+  ~ParagraphCache();
+
+  // Returns the layout cached for the hash if matches returns true for it, and
+  // marks it as most recently used. Otherwise returns nullptr.
+  Layout Get(size_t hash,
+             const std::function<bool(const ParagraphTxt::CachedLayout&)>&
+                 matches);
+
+  // Caches a layout that takes about bytes of memory, replacing any layout
+  // with the same hash. Layouts larger than the budget are not cached.
+  void Put(size_t hash, Layout layout, size_t bytes);
+
+  // Sets the byte budget and evicts layouts until the cache fits in it.
+  void SetMaxBytes(size_t max_bytes);
+
+  void Clear();
+
+  Stats GetStats() const;
+
+ private:
+  struct Entry {
+    size_t hash;
+    Layout layout;
+    size_t bytes;
+  };
+
+  mutable std::mutex mutex_;
+  // Most recently used first.
+  std::list<Entry> entries_;
+  std::unordered_map<size_t, std::list<Entry>::iterator> index_;
+  size_t bytes_ = 0;
+  size_t max_bytes_;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  size_t eviction_count_ = 0;
+
+  void EraseLocked(std::list<Entry>::iterator entry);
+
+  void EvictLocked(size_t max_bytes);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ParagraphCache);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_PARAGRAPH_CACHE_H_
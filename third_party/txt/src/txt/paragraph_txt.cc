@@ -24,18 +24,22 @@
 #include <limits>
 #include <map>
 #include <numeric>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 #include "font_collection.h"
 #include "font_skia.h"
+#include "minikin/BreakIteratorPool.h"
 #include "minikin/FontLanguageListCache.h"
 #include "minikin/GraphemeBreak.h"
 #include "minikin/HbFontCache.h"
 #include "minikin/LayoutUtils.h"
 #include "minikin/LineBreaker.h"
 #include "minikin/MinikinFont.h"
+#include "paragraph_cache.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkFont.h"
 #include "third_party/skia/include/core/SkFontMetrics.h"
@@ -222,12 +226,148 @@ ParagraphTxt::CodeUnitRun::CodeUnitRun(std::vector<GlyphPosition>&& p,
       direction(dir),
       placeholder_run(placeholder) {}
 
+void ParagraphTxt::GlyphPosition::MoveCodeUnits(size_t old_start,
+                                                size_t new_start) {
+  code_units.start = code_units.start - old_start + new_start;
+  code_units.end = code_units.end - old_start + new_start;
+}
+
 void ParagraphTxt::CodeUnitRun::Shift(double delta) {
   x_pos.Shift(delta);
   for (GlyphPosition& position : positions)
     position.Shift(delta);
 }
 
+void ParagraphTxt::CodeUnitRun::MoveCodeUnits(size_t old_start,
+                                              size_t new_start) {
+  code_units.start = code_units.start - old_start + new_start;
+  code_units.end = code_units.end - old_start + new_start;
+  for (GlyphPosition& position : positions)
+    position.MoveCodeUnits(old_start, new_start);
+}
+
+bool ParagraphTxt::LineLayout::HasRuns(const std::vector<BidiRun>& line_runs,
+                                       size_t line_start) const {
+  if (line_runs.size() != runs.size())
+    return false;
+  for (size_t i = 0; i < runs.size(); ++i) {
+    const BidiRun& a = runs[i];
+    const BidiRun& b = line_runs[i];
+    if (a.start() - start_index != b.start() - line_start ||
+        a.end() - start_index != b.end() - line_start ||
+        a.direction() != b.direction() || &a.style() != &b.style() ||
+        a.is_ghost() != b.is_ghost() ||
+        a.placeholder_run() != b.placeholder_run()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Whether two styles of the runs of cached paragraphs are interchangeable.
+// Unlike TextStyle::equals, this compares every field, since the cached paint
+// records keep the styles they were laid out with.
+static bool CacheKeyStylesEqual(const TextStyle& a, const TextStyle& b) {
+  return a.color == b.color && a.decoration == b.decoration &&
+         a.decoration_color == b.decoration_color &&
+         a.decoration_style == b.decoration_style &&
+         a.decoration_thickness_multiplier ==
+             b.decoration_thickness_multiplier &&
+         a.font_weight == b.font_weight && a.font_style == b.font_style &&
+         a.text_baseline == b.text_baseline &&
+         a.font_families == b.font_families && a.font_size == b.font_size &&
+         a.letter_spacing == b.letter_spacing &&
+         a.word_spacing == b.word_spacing && a.height == b.height &&
+         a.has_height_override == b.has_height_override &&
+         a.locale == b.locale && a.has_background == b.has_background &&
+         a.background == b.background &&
+         a.has_foreground == b.has_foreground &&
+         a.foreground == b.foreground && a.text_shadows == b.text_shadows &&
+         a.font_features.GetFontFeatures() == b.font_features.GetFontFeatures();
+}
+
+// Hashes the fields compared by CacheKeyStylesEqual, except for the paints and
+// the shadows, which are only counted.
+static void HashCacheKeyStyle(size_t& hash, const TextStyle& style) {
+  fml::HashCombineSeed(
+      hash, style.color, style.decoration, style.decoration_color,
+      style.decoration_style, style.decoration_thickness_multiplier,
+      style.font_weight, style.font_style, style.text_baseline,
+      style.font_size, style.letter_spacing, style.word_spacing, style.height,
+      style.has_height_override, style.locale, style.has_background,
+      style.has_foreground, style.text_shadows.size(),
+      style.font_families.size());
+  for (const std::string& family : style.font_families) {
+    fml::HashCombineSeed(hash, family);
+  }
+  for (const auto& [tag, value] : style.font_features.GetFontFeatures()) {
+    fml::HashCombineSeed(hash, tag, value);
+  }
+}
+
+struct ParagraphTxt::CachedLayout {
+  // The inputs of the layout, which are compared on lookup because different
+  // inputs can have the same hash. The style pointers below point into runs.
+  std::vector<uint16_t> text;
+  StyledRuns runs;
+  ParagraphStyle paragraph_style;
+  double width = 0;
+
+  std::vector<LineMetrics> line_metrics;
+  size_t final_line_count = 0;
+  std::vector<double> line_widths;
+  std::vector<PaintRecord> records;
+  std::vector<GlyphLine> glyph_lines;
+  std::vector<CodeUnitRun> code_unit_runs;
+  bool did_exceed_max_lines = false;
+  StrutMetrics strut;
+  double max_right = FLT_MIN;
+  double min_left = FLT_MAX;
+  double longest_line = -1;
+  double max_intrinsic_width = 0;
+  double min_intrinsic_width = 0;
+  double alphabetic_baseline = FLT_MAX;
+  double ideographic_baseline = FLT_MAX;
+
+  bool Matches(const ParagraphTxt& paragraph) const {
+    if (width != paragraph.width_ || text != paragraph.text_ ||
+        runs.size() != paragraph.runs_.size() ||
+        !paragraph_style.equals(paragraph.paragraph_style_)) {
+      return false;
+    }
+    for (size_t i = 0; i < runs.size(); ++i) {
+      StyledRuns::Run run = runs.GetRun(i);
+      StyledRuns::Run other = paragraph.runs_.GetRun(i);
+      if (run.start != other.start || run.end != other.end ||
+          !CacheKeyStylesEqual(run.style, other.style)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // An estimate that assumes the text blobs hold a glyph per code unit.
+  size_t GetMemoryUsage() const {
+    size_t bytes = sizeof(CachedLayout) +
+                   text.size() * (sizeof(uint16_t) + sizeof(SkGlyphID) +
+                                  sizeof(SkPoint)) +
+                   records.size() * sizeof(PaintRecord);
+    for (const LineMetrics& line : line_metrics) {
+      bytes += sizeof(LineMetrics) +
+               line.run_metrics.size() * (sizeof(size_t) + sizeof(RunMetrics));
+    }
+    for (const GlyphLine& line : glyph_lines) {
+      bytes +=
+          sizeof(GlyphLine) + line.positions.size() * sizeof(GlyphPosition);
+    }
+    for (const CodeUnitRun& run : code_unit_runs) {
+      bytes +=
+          sizeof(CodeUnitRun) + run.positions.size() * sizeof(GlyphPosition);
+    }
+    return bytes;
+  }
+};
+
 ParagraphTxt::ParagraphTxt() {
   breaker_.setLocale();
 }
@@ -245,146 +385,378 @@ void ParagraphTxt::SetText(std::vector<uint16_t> text, StyledRuns runs) {
 void ParagraphTxt::SetInlinePlaceholders(
     std::vector<PlaceholderRun> inline_placeholders,
     std::unordered_set<size_t> obj_replacement_char_indexes) {
-  needs_layout_ = true;
+  SetDirty(true);
   inline_placeholders_ = std::move(inline_placeholders);
   obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
 }
 
+bool ParagraphTxt::ReplaceText(size_t start,
+                               size_t end,
+                               const std::u16string& text) {
+  if (start > end || end > text_.size() || runs_.size() == 0)
+    return false;
+  // Placeholders are matched to their runs by index, so edits must not remove
+  // them or add text to their runs.
+  for (size_t index : obj_replacement_char_indexes_) {
+    if (index + 1 >= start && index <= end)
+      return false;
+  }
+
+  const size_t removed = end - start;
+  text_.erase(text_.begin() + start, text_.begin() + end);
+  text_.insert(text_.begin() + start, text.begin(), text.end());
+  runs_.ReplaceRange(start, end, text.size());
+
+  std::unordered_set<size_t> obj_replacement_char_indexes;
+  for (size_t index : obj_replacement_char_indexes_) {
+    obj_replacement_char_indexes.insert(
+        index < start ? index : index - removed + text.size());
+  }
+  obj_replacement_char_indexes_ = std::move(obj_replacement_char_indexes);
+
+  needs_layout_ = true;
+  if (blocks_.empty())
+    return true;
+
+  // Merge the blocks that contain the edit into one dirty block, which is
+  // split at its hard line breaks by the next ComputeLineBreaks().
+  auto block_containing = [this](size_t index) {
+    return std::find_if(
+        blocks_.begin(), blocks_.end(),
+        [index](const LayoutBlock& block) { return block.end >= index; });
+  };
+  auto first = block_containing(start);
+  auto last = block_containing(end);
+  FML_DCHECK(first != blocks_.end() && last != blocks_.end());
+  LayoutBlock merged(first->start, last->end - removed + text.size());
+  for (auto it = last + 1; it != blocks_.end(); ++it) {
+    it->start = it->start - removed + text.size();
+    it->end = it->end - removed + text.size();
+  }
+  *first = merged;
+  blocks_.erase(first + 1, last + 1);
+  return true;
+}
+
+bool ParagraphTxt::CanLayoutIncrementally() const {
+  // The last line of paragraphs with a line limit or an ellipsis is laid out
+  // differently, and which line is last can change with any edit.
+  return paragraph_style_.unlimited_lines() && !paragraph_style_.ellipsized();
+}
+
+bool ParagraphTxt::CanUseParagraphCache() const {
+  return font_collection_ && runs_.size() != 0 &&
+         text_.size() <= ParagraphCache::kMaxTextLength &&
+         inline_placeholders_.empty() && obj_replacement_char_indexes_.empty();
+}
+
+size_t ParagraphTxt::HashLayoutInputs() const {
+  std::u16string_view text(reinterpret_cast<const char16_t*>(text_.data()),
+                           text_.size());
+  size_t hash = fml::HashCombine(text, width_, runs_.size(),
+                                 paragraph_style_.max_lines,
+                                 paragraph_style_.text_align);
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    StyledRuns::Run run = runs_.GetRun(i);
+    fml::HashCombineSeed(hash, run.start, run.end);
+    HashCacheKeyStyle(hash, run.style);
+  }
+  return hash;
+}
+
+std::shared_ptr<ParagraphTxt::CachedLayout> ParagraphTxt::SaveLayout() const {
+  auto cached = std::make_shared<CachedLayout>();
+  cached->text = text_;
+  cached->runs = runs_.Copy();
+  cached->paragraph_style = paragraph_style_;
+  cached->width = width_;
+
+  cached->line_metrics = line_metrics_;
+  for (LineMetrics& line : cached->line_metrics) {
+    for (auto& [index, run_metrics] : line.run_metrics) {
+      run_metrics.text_style =
+          cached->runs.MapStyle(runs_, run_metrics.text_style);
+    }
+  }
+  cached->final_line_count = final_line_count_;
+  cached->line_widths = line_widths_;
+  for (const PaintRecord& record : records_) {
+    cached->records.push_back(record.CopyForLine(record.line()));
+  }
+  for (const GlyphLine& glyph_line : glyph_lines_) {
+    cached->glyph_lines.push_back(glyph_line);
+  }
+  cached->code_unit_runs = code_unit_runs_;
+  for (CodeUnitRun& code_unit_run : cached->code_unit_runs) {
+    code_unit_run.style = cached->runs.MapStyle(runs_, code_unit_run.style);
+  }
+  cached->did_exceed_max_lines = did_exceed_max_lines_;
+  cached->strut = strut_;
+  cached->max_right = max_right_;
+  cached->min_left = min_left_;
+  cached->longest_line = longest_line_;
+  cached->max_intrinsic_width = max_intrinsic_width_;
+  cached->min_intrinsic_width = min_intrinsic_width_;
+  cached->alphabetic_baseline = alphabetic_baseline_;
+  cached->ideographic_baseline = ideographic_baseline_;
+  return cached;
+}
+
+void ParagraphTxt::RestoreLayout(const CachedLayout& cached) {
+  line_metrics_ = cached.line_metrics;
+  for (LineMetrics& line : line_metrics_) {
+    for (auto& [index, run_metrics] : line.run_metrics) {
+      run_metrics.text_style =
+          runs_.MapStyle(cached.runs, run_metrics.text_style);
+    }
+  }
+  final_line_count_ = cached.final_line_count;
+  line_widths_ = cached.line_widths;
+  // The text blobs are immutable, so the records share them.
+  for (const PaintRecord& record : cached.records) {
+    records_.push_back(record.CopyForLine(record.line()));
+  }
+  for (const GlyphLine& glyph_line : cached.glyph_lines) {
+    glyph_lines_.push_back(glyph_line);
+  }
+  code_unit_runs_ = cached.code_unit_runs;
+  for (CodeUnitRun& code_unit_run : code_unit_runs_) {
+    code_unit_run.style = runs_.MapStyle(cached.runs, code_unit_run.style);
+  }
+  did_exceed_max_lines_ = cached.did_exceed_max_lines;
+  strut_ = cached.strut;
+  max_right_ = cached.max_right;
+  min_left_ = cached.min_left;
+  longest_line_ = cached.longest_line;
+  max_intrinsic_width_ = cached.max_intrinsic_width;
+  min_intrinsic_width_ = cached.min_intrinsic_width;
+  alphabetic_baseline_ = cached.alphabetic_baseline;
+  ideographic_baseline_ = cached.ideographic_baseline;
+
+  // The lines of a shared layout are not kept for ReplaceText().
+  blocks_.clear();
+  line_layouts_.clear();
+}
+
 bool ParagraphTxt::ComputeLineBreaks() {
-  line_metrics_.clear();
-  line_widths_.clear();
+  std::vector<LineMetrics> line_metrics;
+  std::vector<double> line_widths;
+  std::vector<std::shared_ptr<LineLayout>> line_layouts;
   max_intrinsic_width_ = 0;
 
-  std::vector<size_t> newline_positions;
-  // Discover and add all hard breaks.
-  for (size_t i = 0; i < text_.size(); ++i) {
-    ULineBreak ulb = static_cast<ULineBreak>(
-        u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
-    if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
-      newline_positions.push_back(i);
+  if (blocks_.empty()) {
+    blocks_.emplace_back(0, text_.size());
+  }
+
+  // Discover and add all hard breaks in the dirty blocks.
+  std::vector<LayoutBlock> blocks;
+  blocks.reserve(blocks_.size());
+  for (const LayoutBlock& block : blocks_) {
+    if (!block.dirty) {
+      blocks.push_back(block);
+      continue;
+    }
+    size_t block_start = block.start;
+    for (size_t i = block.start; i < block.end; ++i) {
+      ULineBreak ulb = static_cast<ULineBreak>(
+          u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
+      if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK) {
+        blocks.emplace_back(block_start, i);
+        block_start = i + 1;
+      }
+    }
+    // Break at the end of the block.
+    blocks.emplace_back(block_start, block.end);
   }
-  // Break at the end of the paragraph.
-  newline_positions.push_back(text_.size());
 
   // Calculate and add any breaks due to a line being too long.
   size_t run_index = 0;
   size_t inline_placeholder_index = 0;
-  for (size_t newline_index = 0; newline_index < newline_positions.size();
-       ++newline_index) {
-    size_t block_start =
-        (newline_index > 0) ? newline_positions[newline_index - 1] + 1 : 0;
-    size_t block_end = newline_positions[newline_index];
+  for (LayoutBlock& block : blocks) {
+    size_t block_start = block.start;
+    size_t block_end = block.end;
     size_t block_size = block_end - block_start;
-
-    if (block_size == 0) {
-      line_metrics_.emplace_back(block_start, block_end, block_end,
-                                 block_end + 1, true);
-      line_widths_.push_back(0);
+    size_t first_line = line_metrics.size();
+
+    if (!block.dirty) {
+      // Reuse the lines of the block, moved to where the block starts now.
+      for (size_t i = 0; i < block.line_count; ++i) {
+        const LineMetrics& old_line = line_metrics_[block.first_line + i];
+        size_t line_end = old_line.end_index - block.layout_start + block_start;
+        size_t line_end_including_newline =
+            (old_line.hard_break && line_end < text_.size()) ? line_end + 1
+                                                             : line_end;
+        line_metrics.emplace_back(
+            old_line.start_index - block.layout_start + block_start, line_end,
+            old_line.end_excluding_whitespace - block.layout_start +
+                block_start,
+            line_end_including_newline, old_line.hard_break);
+        line_widths.push_back(line_widths_[block.first_line + i]);
+        line_layouts.push_back(line_layouts_[block.first_line + i]);
+      }
+      inline_placeholder_index += block.placeholder_count;
+      max_intrinsic_width_ =
+          std::max(max_intrinsic_width_, block.max_intrinsic_width);
+      if (block.bidi_runs) {
+        for (BidiRun& bidi_run : *block.bidi_runs) {
+          bidi_run.MoveCodeUnits(block.layout_start, block_start);
+        }
+      }
+      block.layout_start = block_start;
+      block.first_line = first_line;
       continue;
     }
 
-    // Setup breaker. We wait to set the line width in order to account for the
-    // widths of the inline placeholders, which are calcualted in the loop over
-    // the runs.
-    breaker_.setLineWidths(0.0f, 0, width_);
-    breaker_.setJustified(paragraph_style_.text_align == TextAlign::justify);
-    breaker_.setStrategy(paragraph_style_.break_strategy);
-    breaker_.resize(block_size);
-    memcpy(breaker_.buffer(), text_.data() + block_start,
-           block_size * sizeof(text_[0]));
-    breaker_.setText();
-
-    // Add the runs that include this line to the LineBreaker.
+    size_t block_first_placeholder = inline_placeholder_index;
     double block_total_width = 0;
-    while (run_index < runs_.size()) {
-      StyledRuns::Run run = runs_.GetRun(run_index);
-      if (run.start >= block_end)
-        break;
-      if (run.end < block_start) {
-        run_index++;
-        continue;
-      }
 
-      minikin::FontStyle font;
-      minikin::MinikinPaint paint;
-      GetFontAndMinikinPaint(run.style, &font, &paint);
-      std::shared_ptr<minikin::FontCollection> collection =
-          GetMinikinFontCollectionForStyle(run.style);
-      if (collection == nullptr) {
-        FML_LOG(INFO) << "Could not find font collection for families \""
-                      << (run.style.font_families.empty()
-                              ? ""
-                              : run.style.font_families[0])
-                      << "\".";
-        return false;
+    if (block_size == 0) {
+      line_metrics.emplace_back(block_start, block_end, block_end,
+                                block_end + 1, true);
+      line_widths.push_back(0);
+    } else {
+      // Setup breaker. We wait to set the line width in order to account for
+      // the widths of the inline placeholders, which are calcualted in the
+      // loop over the runs.
+      breaker_.setLineWidths(0.0f, 0, width_);
+      breaker_.setJustified(paragraph_style_.text_align == TextAlign::justify);
+      breaker_.setStrategy(paragraph_style_.break_strategy);
+      breaker_.resize(block_size);
+      memcpy(breaker_.buffer(), text_.data() + block_start,
+             block_size * sizeof(text_[0]));
+      breaker_.setText();
+
+      // Add the runs that include this line to the LineBreaker.
+      while (run_index < runs_.size()) {
+        StyledRuns::Run run = runs_.GetRun(run_index);
+        if (run.start >= block_end)
+          break;
+        if (run.end < block_start) {
+          run_index++;
+          continue;
+        }
+
+        minikin::FontStyle font;
+        minikin::MinikinPaint paint;
+        GetFontAndMinikinPaint(run.style, &font, &paint);
+        std::shared_ptr<minikin::FontCollection> collection =
+            GetMinikinFontCollectionForStyle(run.style);
+        if (collection == nullptr) {
+          FML_LOG(INFO) << "Could not find font collection for families \""
+                        << (run.style.font_families.empty()
+                                ? ""
+                                : run.style.font_families[0])
+                        << "\".";
+          breaker_.finish();
+          blocks_.clear();
+          line_metrics_.clear();
+          line_widths_.clear();
+          line_layouts_.clear();
+          return false;
+        }
+        size_t run_start = std::max(run.start, block_start) - block_start;
+        size_t run_end = std::min(run.end, block_end) - block_start;
+        bool isRtl = (paragraph_style_.text_direction == TextDirection::rtl);
+
+        // Check if the run is an object replacement character-only run. We
+        // should leave space for inline placeholder and break around it if
+        // appropriate.
+        if (run.end - run.start == 1 &&
+            obj_replacement_char_indexes_.count(run.start) != 0 &&
+            text_[run.start] == objReplacementChar &&
+            inline_placeholder_index < inline_placeholders_.size()) {
+          // Is a inline placeholder run.
+          PlaceholderRun placeholder_run =
+              inline_placeholders_[inline_placeholder_index];
+          block_total_width += placeholder_run.width;
+
+          // Inject custom width into minikin breaker. (Uses LibTxt-minikin
+          // patch).
+          breaker_.setCustomCharWidth(run_start, placeholder_run.width);
+
+          // Called with nullptr as paint in order to use the custom widths
+          // passed above.
+          breaker_.addStyleRun(nullptr, collection, font, run_start, run_end,
+                               isRtl);
+          inline_placeholder_index++;
+        } else {
+          // Is a regular text run.
+          double run_width = breaker_.addStyleRun(&paint, collection, font,
+                                                  run_start, run_end, isRtl);
+          block_total_width += run_width;
+        }
+
+        if (run.end > block_end)
+          break;
+        run_index++;
       }
-      size_t run_start = std::max(run.start, block_start) - block_start;
-      size_t run_end = std::min(run.end, block_end) - block_start;
-      bool isRtl = (paragraph_style_.text_direction == TextDirection::rtl);
-
-      // Check if the run is an object replacement character-only run. We should
-      // leave space for inline placeholder and break around it if appropriate.
-      if (run.end - run.start == 1 &&
-          obj_replacement_char_indexes_.count(run.start) != 0 &&
-          text_[run.start] == objReplacementChar &&
-          inline_placeholder_index < inline_placeholders_.size()) {
-        // Is a inline placeholder run.
-        PlaceholderRun placeholder_run =
-            inline_placeholders_[inline_placeholder_index];
-        block_total_width += placeholder_run.width;
-
-        // Inject custom width into minikin breaker. (Uses LibTxt-minikin
-        // patch).
-        breaker_.setCustomCharWidth(run_start, placeholder_run.width);
-
-        // Called with nullptr as paint in order to use the custom widths passed
-        // above.
-        breaker_.addStyleRun(nullptr, collection, font, run_start, run_end,
-                             isRtl);
-        inline_placeholder_index++;
-      } else {
-        // Is a regular text run.
-        double run_width = breaker_.addStyleRun(&paint, collection, font,
-                                                run_start, run_end, isRtl);
-        block_total_width += run_width;
+      max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+
+      size_t breaks_count = breaker_.computeBreaks();
+      const int* breaks = breaker_.getBreaks();
+      for (size_t i = 0; i < breaks_count; ++i) {
+        size_t break_start = (i > 0) ? breaks[i - 1] : 0;
+        size_t line_start = break_start + block_start;
+        size_t line_end = breaks[i] + block_start;
+        bool hard_break = i == breaks_count - 1;
+        size_t line_end_including_newline =
+            (hard_break && line_end < text_.size()) ? line_end + 1 : line_end;
+        size_t line_end_excluding_whitespace = line_end;
+        while (
+            line_end_excluding_whitespace > line_start &&
+            minikin::isLineEndSpace(text_[line_end_excluding_whitespace - 1])) {
+          line_end_excluding_whitespace--;
+        }
+        line_metrics.emplace_back(line_start, line_end,
+                                  line_end_excluding_whitespace,
+                                  line_end_including_newline, hard_break);
+        line_widths.push_back(breaker_.getWidths()[i]);
       }
 
-      if (run.end > block_end)
-        break;
-      run_index++;
-    }
-    max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
-
-    size_t breaks_count = breaker_.computeBreaks();
-    const int* breaks = breaker_.getBreaks();
-    for (size_t i = 0; i < breaks_count; ++i) {
-      size_t break_start = (i > 0) ? breaks[i - 1] : 0;
-      size_t line_start = break_start + block_start;
-      size_t line_end = breaks[i] + block_start;
-      bool hard_break = i == breaks_count - 1;
-      size_t line_end_including_newline =
-          (hard_break && line_end < text_.size()) ? line_end + 1 : line_end;
-      size_t line_end_excluding_whitespace = line_end;
-      while (
-          line_end_excluding_whitespace > line_start &&
-          minikin::isLineEndSpace(text_[line_end_excluding_whitespace - 1])) {
-        line_end_excluding_whitespace--;
-      }
-      line_metrics_.emplace_back(line_start, line_end,
-                                 line_end_excluding_whitespace,
-                                 line_end_including_newline, hard_break);
-      line_widths_.push_back(breaker_.getWidths()[i]);
+      breaker_.finish();
     }
 
-    breaker_.finish();
+    line_layouts.resize(line_metrics.size());
+    block.dirty = false;
+    block.layout_start = block_start;
+    block.first_line = first_line;
+    block.line_count = line_metrics.size() - first_line;
+    block.placeholder_count =
+        inline_placeholder_index - block_first_placeholder;
+    block.max_intrinsic_width = block_total_width;
   }
 
+  blocks_ = std::move(blocks);
+  line_metrics_ = std::move(line_metrics);
+  line_widths_ = std::move(line_widths);
+  line_layouts_ = std::move(line_layouts);
   return true;
 }
 
-bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
-  if (text_.empty())
+bool ParagraphTxt::ComputeBidiRuns() {
+  // Hard line breaks end bidi paragraphs, so the runs of a block do not depend
+  // on the text of the other blocks.
+  for (LayoutBlock& block : blocks_) {
+    size_t end = std::min(block.end + 1, text_.size());
+    bool end_text = end == text_.size();
+    if (block.bidi_runs && block.bidi_runs_end_text == end_text)
+      continue;
+    std::vector<BidiRun> bidi_runs;
+    if (!ComputeBidiRuns(block.start, end, &bidi_runs))
+      return false;
+    block.bidi_runs = std::move(bidi_runs);
+    block.bidi_runs_end_text = end_text;
+  }
+  return true;
+}
+
+bool ParagraphTxt::ComputeBidiRuns(size_t start,
+                                   size_t end,
+                                   std::vector<BidiRun>* result) {
+  if (start >= end)
     return true;
+  const uint16_t* text = text_.data() + start;
+  const int32_t text_size = static_cast<int32_t>(end - start);
 
   auto ubidi_closer = [](UBiDi* b) { ubidi_close(b); };
   std::unique_ptr<UBiDi, decltype(ubidi_closer)> bidi(ubidi_open(),
@@ -396,8 +768,8 @@ bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
                              ? UBIDI_RTL
                              : UBIDI_LTR;
   UErrorCode status = U_ZERO_ERROR;
-  ubidi_setPara(bidi.get(), reinterpret_cast<const UChar*>(text_.data()),
-                text_.size(), paraLevel, nullptr, &status);
+  ubidi_setPara(bidi.get(), reinterpret_cast<const UChar*>(text), text_size,
+                paraLevel, nullptr, &status);
   if (!U_SUCCESS(status))
     return false;
 
@@ -419,15 +791,15 @@ bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
   // level.
   bool has_trailing_whitespace = false;
   int32_t bidi_run_start, bidi_run_length;
-  if (bidi_run_count > 1) {
+  if (end == text_.size() && bidi_run_count > 1) {
     ubidi_getVisualRun(bidi.get(), bidi_run_count - 1, &bidi_run_start,
                        &bidi_run_length);
     if (!U_SUCCESS(status))
       return false;
     if (bidi_run_length == 1) {
       UChar32 last_char;
-      U16_GET(text_.data(), 0, bidi_run_start + bidi_run_length - 1,
-              static_cast<int>(text_.size()), last_char);
+      U16_GET(text, 0, bidi_run_start + bidi_run_length - 1, text_size,
+              last_char);
       if (u_hasBinaryProperty(last_char, UCHAR_WHITE_SPACE)) {
         // Check if the trailing whitespace occurs before the previous run or
         // not. If so, this trailing whitespace was a leading whitespace.
@@ -444,10 +816,24 @@ bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
     }
   }
 
-  // Build a map of styled runs indexed by start position.
+  // Build a map of the styled runs in the range indexed by start position.
+  // The styled runs are sorted, so skip to the first one that ends after the
+  // start of the range.
+  size_t first_run = 0;
+  size_t last_run = runs_.size();
+  while (first_run < last_run) {
+    size_t middle = first_run + (last_run - first_run) / 2;
+    if (runs_.GetRun(middle).end <= start) {
+      first_run = middle + 1;
+    } else {
+      last_run = middle;
+    }
+  }
   std::map<size_t, StyledRuns::Run> styled_run_map;
-  for (size_t i = 0; i < runs_.size(); ++i) {
+  for (size_t i = first_run; i < runs_.size(); ++i) {
     StyledRuns::Run run = runs_.GetRun(i);
+    if (run.start >= end)
+      break;
     styled_run_map.emplace(std::make_pair(run.start, run));
   }
 
@@ -460,8 +846,7 @@ bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
 
     // Exclude the leading bidi control character if present.
     UChar32 first_char;
-    U16_GET(text_.data(), 0, bidi_run_start, static_cast<int>(text_.size()),
-            first_char);
+    U16_GET(text, 0, bidi_run_start, text_size, first_char);
     if (u_hasBinaryProperty(first_char, UCHAR_BIDI_CONTROL)) {
       bidi_run_start++;
       bidi_run_length--;
@@ -471,8 +856,8 @@ bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
 
     // Exclude the trailing bidi control character if present.
     UChar32 last_char;
-    U16_GET(text_.data(), 0, bidi_run_start + bidi_run_length - 1,
-            static_cast<int>(text_.size()), last_char);
+    U16_GET(text, 0, bidi_run_start + bidi_run_length - 1, text_size,
+            last_char);
     if (u_hasBinaryProperty(last_char, UCHAR_BIDI_CONTROL)) {
       bidi_run_length--;
     }
@@ -484,6 +869,7 @@ bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
       bidi_run_length++;
     }
 
+    bidi_run_start += start;
     size_t bidi_run_end = bidi_run_start + bidi_run_length;
     TextDirection text_direction =
         direction == UBIDI_RTL ? TextDirection::rtl : TextDirection::ltr;
@@ -643,8 +1029,8 @@ void ParagraphTxt::ComputePlaceholder(PlaceholderRun* placeholder_run,
 // Implementation outline:
 //
 // -For each line:
-//   -Compute Bidi runs, convert into line_runs (keeps in-line-range runs, adds
-//   special runs)
+//   -Compute Bidi runs of the edited blocks, convert the runs of the line's
+//   block into line_runs (keeps in-line-range runs, adds special runs)
 //   -For each line_run (runs in the line):
 //     -Calculate ellipsis
 //     -Obtain font
@@ -663,6 +1049,12 @@ void ParagraphTxt::Layout(double width) {
     return;
   }
 
+  // Lines can only be reused if they are broken at the same width, and if
+  // ellipsizing or a line limit cannot make an edit affect earlier lines.
+  if (rounded_width != width_ || !CanLayoutIncrementally()) {
+    blocks_.clear();
+  }
+
   width_ = rounded_width;
 
   needs_layout_ = false;
@@ -675,11 +1067,28 @@ void ParagraphTxt::Layout(double width) {
   min_left_ = FLT_MAX;
   final_line_count_ = 0;
 
+  // Paragraphs with the same text, styles and width, such as the labels of
+  // the items of a list, share the layout of the first of them. Incremental
+  // layouts are not shared, as an edited paragraph rarely matches another.
+  ParagraphCache* cache = nullptr;
+  size_t cache_hash = 0;
+  if (blocks_.empty() && CanUseParagraphCache()) {
+    cache = font_collection_->GetParagraphCache();
+    cache_hash = HashLayoutInputs();
+    ParagraphCache::Layout cached =
+        cache->Get(cache_hash, [this](const CachedLayout& layout) {
+          return layout.Matches(*this);
+        });
+    if (cached) {
+      RestoreLayout(*cached);
+      return;
+    }
+  }
+
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
+  if (!ComputeBidiRuns())
     return;
 
   SkFont font;
@@ -702,22 +1111,13 @@ void ParagraphTxt::Layout(double width) {
   did_exceed_max_lines_ = (line_metrics_.size() > paragraph_style_.max_lines);
 
   size_t placeholder_run_index = 0;
+  size_t block_index = 0;
   for (size_t line_number = 0; line_number < line_limit; ++line_number) {
     LineMetrics& line_metrics = line_metrics_[line_number];
-
-    // Break the line into words if justification should be applied.
-    std::vector<Range<size_t>> words;
-    double word_gap_width = 0;
-    size_t word_index = 0;
-    bool justify_line =
-        (paragraph_style_.text_align == TextAlign::justify &&
-         line_number != line_limit - 1 && !line_metrics.hard_break);
-    FindWords(text_, line_metrics.start_index, line_metrics.end_index, &words);
-    if (justify_line) {
-      if (words.size() > 1) {
-        word_gap_width =
-            (width_ - line_widths_[line_number]) / (words.size() - 1);
-      }
+    while (block_index + 1 < blocks_.size() &&
+           line_number >= blocks_[block_index].first_line +
+                              blocks_[block_index].line_count) {
+      block_index++;
     }
 
     // Exclude trailing whitespace from justified lines so the last visible
@@ -729,9 +1129,9 @@ void ParagraphTxt::Layout(double width) {
             ? line_metrics.end_excluding_whitespace
             : line_metrics.end_index;
 
-    // Find the runs comprising this line.
+    // Find the runs comprising this line among the runs of its block.
     std::vector<BidiRun> line_runs;
-    for (const BidiRun& bidi_run : bidi_runs) {
+    for (const BidiRun& bidi_run : *blocks_[block_index].bidi_runs) {
       // A "ghost" run is a run that does not impact the layout, breaking,
       // alignment, width, etc but is still "visible" through getRectsForRange.
       // For example, trailing whitespace on centered text can be scrolled
@@ -780,330 +1180,59 @@ void ParagraphTxt::Layout(double width) {
         line_runs.push_back(*ghost_run);
       }
     }
-    bool line_runs_all_rtl =
-        line_runs.size() &&
-        std::accumulate(
-            line_runs.begin(), line_runs.end(), true,
-            [](const bool a, const BidiRun& b) { return a && b.is_rtl(); });
-    if (line_runs_all_rtl) {
-      std::reverse(words.begin(), words.end());
-    }
 
-    std::vector<GlyphPosition> line_glyph_positions;
-    std::vector<CodeUnitRun> line_code_unit_runs;
-    std::vector<CodeUnitRun> line_inline_placeholder_code_unit_runs;
-
-    double run_x_offset = 0;
-    double justify_x_offset = 0;
-    std::vector<PaintRecord> paint_records;
-
-    for (auto line_run_it = line_runs.begin(); line_run_it != line_runs.end();
-         ++line_run_it) {
-      const BidiRun& run = *line_run_it;
-      minikin::FontStyle minikin_font;
-      minikin::MinikinPaint minikin_paint;
-      GetFontAndMinikinPaint(run.style(), &minikin_font, &minikin_paint);
-      font.setSize(run.style().font_size);
-
-      std::shared_ptr<minikin::FontCollection> minikin_font_collection =
-          GetMinikinFontCollectionForStyle(run.style());
-      if (!minikin_font_collection) {
+    // Reuse the layout of the line if it was not edited since the previous
+    // layout.
+    if (!line_layouts_[line_number] ||
+        !line_layouts_[line_number]->HasRuns(line_runs,
+                                             line_metrics.start_index)) {
+      auto line_layout = std::make_shared<LineLayout>();
+      if (!LayoutLine(line_number, line_runs, line_limit, font, layout,
+                      builder, line_layout.get())) {
         return;
       }
-
-      // Lay out this run.
-      uint16_t* text_ptr = text_.data();
-      size_t text_start = run.start();
-      size_t text_count = run.end() - run.start();
-      size_t text_size = text_.size();
-
-      // Apply ellipsizing if the run was not completely laid out and this
-      // is the last line (or lines are unlimited).
-      const std::u16string& ellipsis = paragraph_style_.ellipsis;
-      std::vector<uint16_t> ellipsized_text;
-      if (ellipsis.length() && !isinf(width_) && !line_metrics.hard_break &&
-          line_run_it == line_runs.end() - 1 &&
-          (line_number == line_limit - 1 ||
-           paragraph_style_.unlimited_lines())) {
-        float ellipsis_width = layout.measureText(
-            reinterpret_cast<const uint16_t*>(ellipsis.data()), 0,
-            ellipsis.length(), ellipsis.length(), run.is_rtl(), minikin_font,
-            minikin_paint, minikin_font_collection, nullptr);
-
-        std::vector<float> text_advances(text_count);
-        float text_width =
-            layout.measureText(text_ptr, text_start, text_count, text_.size(),
-                               run.is_rtl(), minikin_font, minikin_paint,
-                               minikin_font_collection, text_advances.data());
-
-        // Truncate characters from the text until the ellipsis fits.
-        size_t truncate_count = 0;
-        while (truncate_count < text_count &&
-               run_x_offset + text_width + ellipsis_width > width_) {
-          text_width -= text_advances[text_count - truncate_count - 1];
-          truncate_count++;
-        }
-
-        ellipsized_text.reserve(text_count - truncate_count +
-                                ellipsis.length());
-        ellipsized_text.insert(ellipsized_text.begin(),
-                               text_.begin() + run.start(),
-                               text_.begin() + run.end() - truncate_count);
-        ellipsized_text.insert(ellipsized_text.end(), ellipsis.begin(),
-                               ellipsis.end());
-        text_ptr = ellipsized_text.data();
-        text_start = 0;
-        text_count = ellipsized_text.size();
-        text_size = text_count;
-
-        // If there is no line limit, then skip all lines after the ellipsized
-        // line.
-        if (paragraph_style_.unlimited_lines()) {
-          line_limit = line_number + 1;
-          did_exceed_max_lines_ = true;
-        }
-      }
-
-      layout.doLayout(text_ptr, text_start, text_count, text_size, run.is_rtl(),
-                      minikin_font, minikin_paint, minikin_font_collection);
-
-      if (layout.nGlyphs() == 0)
-        continue;
-
-      // When laying out RTL ghost runs, shift the run_x_offset here by the
-      // advance so that the ghost run is positioned to the left of the first
-      // real run of text in the line. However, since we do not want it to
-      // impact the layout of real text, this advance is subsequently added
-      // back into the run_x_offset after the ghost run positions have been
-      // calcuated and before the next real run of text is laid out, ensuring
-      // later runs are laid out in the same position as if there were no ghost
-      // run.
-      if (run.is_ghost() && run.is_rtl())
-        run_x_offset -= layout.getAdvance();
-
-      std::vector<float> layout_advances(text_count);
-      layout.getAdvances(layout_advances.data());
-
-      // Break the layout into blobs that share the same SkPaint parameters.
-      std::vector<Range<size_t>> glyph_blobs = GetLayoutTypefaceRuns(layout);
-
-      double word_start_position = std::numeric_limits<double>::quiet_NaN();
-
-      // Build a Skia text blob from each group of glyphs.
-      for (const Range<size_t>& glyph_blob : glyph_blobs) {
-        std::vector<GlyphPosition> glyph_positions;
-
-        GetGlyphTypeface(layout, glyph_blob.start).apply(font);
-        const SkTextBlobBuilder::RunBuffer& blob_buffer =
-            builder.allocRunPos(font, glyph_blob.end - glyph_blob.start);
-
-        double justify_x_offset_delta = 0;
-        for (size_t glyph_index = glyph_blob.start;
-             glyph_index < glyph_blob.end;) {
-          size_t cluster_start_glyph_index = glyph_index;
-          uint32_t cluster = layout.getGlyphCluster(cluster_start_glyph_index);
-          double glyph_x_offset;
-          // Add all the glyphs in this cluster to the text blob.
-          do {
-            size_t blob_index = glyph_index - glyph_blob.start;
-            blob_buffer.glyphs[blob_index] = layout.getGlyphId(glyph_index);
-
-            size_t pos_index = blob_index * 2;
-            blob_buffer.pos[pos_index] =
-                layout.getX(glyph_index) + justify_x_offset_delta;
-            blob_buffer.pos[pos_index + 1] = layout.getY(glyph_index);
-
-            if (glyph_index == cluster_start_glyph_index)
-              glyph_x_offset = blob_buffer.pos[pos_index];
-
-            glyph_index++;
-          } while (glyph_index < glyph_blob.end &&
-                   layout.getGlyphCluster(glyph_index) == cluster);
-
-          Range<int32_t> glyph_code_units(cluster, 0);
-          std::vector<size_t> grapheme_code_unit_counts;
-          if (run.is_rtl()) {
-            if (cluster_start_glyph_index > 0) {
-              glyph_code_units.end =
-                  layout.getGlyphCluster(cluster_start_glyph_index - 1);
-            } else {
-              glyph_code_units.end = text_count;
-            }
-            grapheme_code_unit_counts.push_back(glyph_code_units.width());
-          } else {
-            if (glyph_index < layout.nGlyphs()) {
-              glyph_code_units.end = layout.getGlyphCluster(glyph_index);
-            } else {
-              glyph_code_units.end = text_count;
-            }
-
-            // The glyph may be a ligature.  Determine how many graphemes are
-            // joined into this glyph and how many input code units map to
-            // each grapheme.
-            size_t code_unit_count = 1;
-            for (int32_t offset = glyph_code_units.start + 1;
-                 offset < glyph_code_units.end; ++offset) {
-              if (minikin::GraphemeBreak::isGraphemeBreak(
-                      layout_advances.data(), text_ptr, text_start, text_count,
-                      text_start + offset)) {
-                grapheme_code_unit_counts.push_back(code_unit_count);
-                code_unit_count = 1;
-              } else {
-                code_unit_count++;
-              }
-            }
-            grapheme_code_unit_counts.push_back(code_unit_count);
-          }
-          float glyph_advance;
-          if (run.is_placeholder_run()) {
-            // The placeholder run's layout should yield one glyph representing
-            // the object replacement character.  Replace its width with the
-            // placeholder's width.
-            FML_DCHECK(layout.nGlyphs() == 1);
-            glyph_advance = run.placeholder_run()->width;
-          } else {
-            glyph_advance = layout.getCharAdvance(glyph_code_units.start);
-          }
-          float grapheme_advance =
-              glyph_advance / grapheme_code_unit_counts.size();
-
-          glyph_positions.emplace_back(run_x_offset + glyph_x_offset,
-                                       grapheme_advance,
-                                       run.start() + glyph_code_units.start,
-                                       grapheme_code_unit_counts[0]);
-
-          // Compute positions for the additional graphemes in the ligature.
-          for (size_t i = 1; i < grapheme_code_unit_counts.size(); ++i) {
-            glyph_positions.emplace_back(
-                glyph_positions.back().x_pos.end, grapheme_advance,
-                glyph_positions.back().code_units.start +
-                    grapheme_code_unit_counts[i - 1],
-                grapheme_code_unit_counts[i]);
-          }
-
-          bool at_word_start = false;
-          bool at_word_end = false;
-          if (word_index < words.size()) {
-            at_word_start =
-                words[word_index].start == run.start() + glyph_code_units.start;
-            at_word_end =
-                words[word_index].end == run.start() + glyph_code_units.end;
-            if (line_runs_all_rtl) {
-              std::swap(at_word_start, at_word_end);
-            }
-          }
-
-          if (at_word_start) {
-            word_start_position = run_x_offset + glyph_x_offset;
-          }
-
-          if (at_word_end) {
-            if (justify_line) {
-              justify_x_offset_delta += word_gap_width;
-            }
-            word_index++;
-
-            if (!isnan(word_start_position)) {
-              double word_width =
-                  glyph_positions.back().x_pos.end - word_start_position;
-              max_word_width = std::max(word_width, max_word_width);
-              word_start_position = std::numeric_limits<double>::quiet_NaN();
-            }
-          }
-        }  // for each in glyph_blob
-
-        if (glyph_positions.empty())
-          continue;
-
-        // Store the font metrics and TextStyle in the LineMetrics for this line
-        // to provide metrics upon user request. We index this RunMetrics
-        // instance at `run.end() - 1` to allow map::lower_bound to access the
-        // correct RunMetrics at any text index.
-        size_t run_key = run.end() - 1;
-        line_metrics.run_metrics.emplace(run_key, &run.style());
-        SkFontMetrics* metrics =
-            &line_metrics.run_metrics.at(run_key).font_metrics;
-        font.getMetrics(metrics);
-
-        Range<double> record_x_pos(
-            glyph_positions.front().x_pos.start - run_x_offset,
-            glyph_positions.back().x_pos.end - run_x_offset);
-        paint_records.emplace_back(
-            run.style(), SkPoint::Make(run_x_offset + justify_x_offset, 0),
-            builder.make(), *metrics, line_number, record_x_pos.start,
-            record_x_pos.end, run.is_ghost(), run.placeholder_run());
-        justify_x_offset += justify_x_offset_delta;
-
-        line_glyph_positions.insert(line_glyph_positions.end(),
-                                    glyph_positions.begin(),
-                                    glyph_positions.end());
-
-        // Add a record of glyph positions sorted by code unit index.
-        std::vector<GlyphPosition> code_unit_positions(glyph_positions);
-        std::sort(code_unit_positions.begin(), code_unit_positions.end(),
-                  [](const GlyphPosition& a, const GlyphPosition& b) {
-                    return a.code_units.start < b.code_units.start;
-                  });
-
-        double blob_x_pos_start = glyph_positions.front().x_pos.start;
-        double blob_x_pos_end = glyph_positions.back().x_pos.end;
-        line_code_unit_runs.emplace_back(
-            std::move(code_unit_positions),
-            Range<size_t>(run.start(), run.end()),
-            Range<double>(blob_x_pos_start, blob_x_pos_end), line_number,
-            *metrics, run.style(), run.direction(), run.placeholder_run());
-
-        if (run.is_placeholder_run()) {
-          line_inline_placeholder_code_unit_runs.push_back(
-              line_code_unit_runs.back());
-        }
-
-        if (!run.is_ghost()) {
-          min_left_ = std::min(min_left_, blob_x_pos_start);
-          max_right_ = std::max(max_right_, blob_x_pos_end);
-        }
-      }  // for each in glyph_blobs
-
-      if (run.is_placeholder_run()) {
-        run_x_offset += run.placeholder_run()->width;
-      } else {
-        // Do not increase x offset for LTR trailing ghost runs as it should not
-        // impact the layout of visible glyphs. RTL tailing ghost runs have the
-        // advance subtracted, so we do add the advance here to reset the
-        // run_x_offset. We do keep the record though so GetRectsForRange() can
-        // find metrics for trailing spaces.
-        if (!run.is_ghost() || run.is_rtl()) {
-          run_x_offset += layout.getAdvance();
-        }
-      }
-    }  // for each in line_runs
-
-    // Adjust the glyph positions based on the alignment of the line.
-    double line_x_offset = GetLineXOffset(run_x_offset, justify_line);
-    if (line_x_offset) {
-      for (CodeUnitRun& code_unit_run : line_code_unit_runs) {
-        code_unit_run.Shift(line_x_offset);
-      }
-      for (CodeUnitRun& code_unit_run :
-           line_inline_placeholder_code_unit_runs) {
-        code_unit_run.Shift(line_x_offset);
-      }
-      for (GlyphPosition& position : line_glyph_positions) {
-        position.Shift(line_x_offset);
-      }
+      line_layouts_[line_number] = std::move(line_layout);
+    }
+    const LineLayout& line_layout = *line_layouts_[line_number];
+
+    // Move the code units of the layout to where the line starts now.
+    const size_t layout_start = line_layout.start_index;
+    const size_t line_start = line_metrics.start_index;
+    std::vector<GlyphPosition> line_glyph_positions(
+        line_layout.glyph_positions);
+    for (GlyphPosition& position : line_glyph_positions) {
+      position.MoveCodeUnits(layout_start, line_start);
     }
+    for (const CodeUnitRun& code_unit_run : line_layout.code_unit_runs) {
+      code_unit_runs_.push_back(code_unit_run);
+      code_unit_runs_.back().MoveCodeUnits(layout_start, line_start);
+      code_unit_runs_.back().line_number = line_number;
+    }
+    for (const CodeUnitRun& code_unit_run :
+         line_layout.inline_placeholder_code_unit_runs) {
+      inline_placeholder_code_unit_runs_.push_back(code_unit_run);
+      inline_placeholder_code_unit_runs_.back().MoveCodeUnits(layout_start,
+                                                              line_start);
+      inline_placeholder_code_unit_runs_.back().line_number = line_number;
+    }
+    for (const auto& [run_key, run_metrics] : line_layout.run_metrics) {
+      line_metrics.run_metrics.emplace(run_key - layout_start + line_start,
+                                       run_metrics);
+    }
+    std::vector<PaintRecord> paint_records;
+    for (const PaintRecord& paint_record : line_layout.paint_records) {
+      paint_records.push_back(paint_record.CopyForLine(line_number));
+    }
+    double line_x_offset = line_layout.x_offset;
+    max_word_width = std::max(max_word_width, line_layout.max_word_width);
+    min_left_ = std::min(min_left_, line_layout.min_left);
+    max_right_ = std::max(max_right_, line_layout.max_right);
 
     size_t next_line_start = (line_number < line_metrics_.size() - 1)
                                  ? line_metrics_[line_number + 1].start_index
                                  : text_.size();
     glyph_lines_.emplace_back(std::move(line_glyph_positions),
                               next_line_start - line_metrics.start_index);
-    code_unit_runs_.insert(code_unit_runs_.end(), line_code_unit_runs.begin(),
-                           line_code_unit_runs.end());
-    inline_placeholder_code_unit_runs_.insert(
-        inline_placeholder_code_unit_runs_.end(),
-        line_inline_placeholder_code_unit_runs.begin(),
-        line_inline_placeholder_code_unit_runs.end());
 
     // Calculate the amount to advance in the y direction. This is done by
     // computing the maximum ascent and descent with respect to the strut.
@@ -1175,6 +1304,359 @@ void ParagraphTxt::Layout(double width) {
             });
 
   longest_line_ = max_right_ - min_left_;
+
+  if (cache) {
+    std::shared_ptr<CachedLayout> cached = SaveLayout();
+    const size_t bytes = cached->GetMemoryUsage();
+    cache->Put(cache_hash, std::move(cached), bytes);
+  }
+}
+
+bool ParagraphTxt::LayoutLine(size_t line_number,
+                              const std::vector<BidiRun>& line_runs,
+                              size_t& line_limit,
+                              SkFont& font,
+                              minikin::Layout& layout,
+                              SkTextBlobBuilder& builder,
+                              LineLayout* line_layout) {
+  const LineMetrics& line_metrics = line_metrics_[line_number];
+  line_layout->start_index = line_metrics.start_index;
+  line_layout->runs = line_runs;
+
+  // Break the line into words if justification should be applied.
+  std::vector<Range<size_t>> words;
+  double word_gap_width = 0;
+  size_t word_index = 0;
+  bool justify_line =
+      (paragraph_style_.text_align == TextAlign::justify &&
+       line_number != line_limit - 1 && !line_metrics.hard_break);
+  FindWords(text_, line_metrics.start_index, line_metrics.end_index, &words);
+  if (justify_line) {
+    if (words.size() > 1) {
+      word_gap_width =
+          (width_ - line_widths_[line_number]) / (words.size() - 1);
+    }
+  }
+
+  bool line_runs_all_rtl =
+      line_runs.size() &&
+      std::accumulate(
+          line_runs.begin(), line_runs.end(), true,
+          [](const bool a, const BidiRun& b) { return a && b.is_rtl(); });
+  if (line_runs_all_rtl) {
+    std::reverse(words.begin(), words.end());
+  }
+
+  std::vector<GlyphPosition>& line_glyph_positions =
+      line_layout->glyph_positions;
+  std::vector<CodeUnitRun>& line_code_unit_runs = line_layout->code_unit_runs;
+  std::vector<CodeUnitRun>& line_inline_placeholder_code_unit_runs =
+      line_layout->inline_placeholder_code_unit_runs;
+
+  double run_x_offset = 0;
+  double justify_x_offset = 0;
+  std::vector<PaintRecord>& paint_records = line_layout->paint_records;
+
+  for (auto line_run_it = line_runs.begin(); line_run_it != line_runs.end();
+       ++line_run_it) {
+    const BidiRun& run = *line_run_it;
+    minikin::FontStyle minikin_font;
+    minikin::MinikinPaint minikin_paint;
+    GetFontAndMinikinPaint(run.style(), &minikin_font, &minikin_paint);
+    font.setSize(run.style().font_size);
+
+    std::shared_ptr<minikin::FontCollection> minikin_font_collection =
+        GetMinikinFontCollectionForStyle(run.style());
+    if (!minikin_font_collection) {
+      return false;
+    }
+
+    // Lay out this run.
+    uint16_t* text_ptr = text_.data();
+    size_t text_start = run.start();
+    size_t text_count = run.end() - run.start();
+    size_t text_size = text_.size();
+
+    // Apply ellipsizing if the run was not completely laid out and this
+    // is the last line (or lines are unlimited).
+    const std::u16string& ellipsis = paragraph_style_.ellipsis;
+    std::vector<uint16_t> ellipsized_text;
+    if (ellipsis.length() && !isinf(width_) && !line_metrics.hard_break &&
+        line_run_it == line_runs.end() - 1 &&
+        (line_number == line_limit - 1 ||
+         paragraph_style_.unlimited_lines())) {
+      float ellipsis_width = layout.measureText(
+          reinterpret_cast<const uint16_t*>(ellipsis.data()), 0,
+          ellipsis.length(), ellipsis.length(), run.is_rtl(), minikin_font,
+          minikin_paint, minikin_font_collection, nullptr);
+
+      std::vector<float> text_advances(text_count);
+      float text_width =
+          layout.measureText(text_ptr, text_start, text_count, text_.size(),
+                             run.is_rtl(), minikin_font, minikin_paint,
+                             minikin_font_collection, text_advances.data());
+
+      // Truncate characters from the text until the ellipsis fits.
+      size_t truncate_count = 0;
+      while (truncate_count < text_count &&
+             run_x_offset + text_width + ellipsis_width > width_) {
+        text_width -= text_advances[text_count - truncate_count - 1];
+        truncate_count++;
+      }
+
+      ellipsized_text.reserve(text_count - truncate_count +
+                              ellipsis.length());
+      ellipsized_text.insert(ellipsized_text.begin(),
+                             text_.begin() + run.start(),
+                             text_.begin() + run.end() - truncate_count);
+      ellipsized_text.insert(ellipsized_text.end(), ellipsis.begin(),
+                             ellipsis.end());
+      text_ptr = ellipsized_text.data();
+      text_start = 0;
+      text_count = ellipsized_text.size();
+      text_size = text_count;
+
+      // If there is no line limit, then skip all lines after the ellipsized
+      // line.
+      if (paragraph_style_.unlimited_lines()) {
+        line_limit = line_number + 1;
+        did_exceed_max_lines_ = true;
+      }
+    }
+
+    layout.doLayout(text_ptr, text_start, text_count, text_size, run.is_rtl(),
+                    minikin_font, minikin_paint, minikin_font_collection);
+
+    if (layout.nGlyphs() == 0)
+      continue;
+
+    // When laying out RTL ghost runs, shift the run_x_offset here by the
+    // advance so that the ghost run is positioned to the left of the first
+    // real run of text in the line. However, since we do not want it to
+    // impact the layout of real text, this advance is subsequently added
+    // back into the run_x_offset after the ghost run positions have been
+    // calcuated and before the next real run of text is laid out, ensuring
+    // later runs are laid out in the same position as if there were no ghost
+    // run.
+    if (run.is_ghost() && run.is_rtl())
+      run_x_offset -= layout.getAdvance();
+
+    std::vector<float> layout_advances(text_count);
+    layout.getAdvances(layout_advances.data());
+
+    // Break the layout into blobs that share the same SkPaint parameters.
+    std::vector<Range<size_t>> glyph_blobs = GetLayoutTypefaceRuns(layout);
+
+    double word_start_position = std::numeric_limits<double>::quiet_NaN();
+
+    // Build a Skia text blob from each group of glyphs.
+    for (const Range<size_t>& glyph_blob : glyph_blobs) {
+      std::vector<GlyphPosition> glyph_positions;
+
+      GetGlyphTypeface(layout, glyph_blob.start).apply(font);
+      const SkTextBlobBuilder::RunBuffer& blob_buffer =
+          builder.allocRunPos(font, glyph_blob.end - glyph_blob.start);
+
+      double justify_x_offset_delta = 0;
+      for (size_t glyph_index = glyph_blob.start;
+           glyph_index < glyph_blob.end;) {
+        size_t cluster_start_glyph_index = glyph_index;
+        uint32_t cluster = layout.getGlyphCluster(cluster_start_glyph_index);
+        double glyph_x_offset;
+        // Add all the glyphs in this cluster to the text blob.
+        do {
+          size_t blob_index = glyph_index - glyph_blob.start;
+          blob_buffer.glyphs[blob_index] = layout.getGlyphId(glyph_index);
+
+          size_t pos_index = blob_index * 2;
+          blob_buffer.pos[pos_index] =
+              layout.getX(glyph_index) + justify_x_offset_delta;
+          blob_buffer.pos[pos_index + 1] = layout.getY(glyph_index);
+
+          if (glyph_index == cluster_start_glyph_index)
+            glyph_x_offset = blob_buffer.pos[pos_index];
+
+          glyph_index++;
+        } while (glyph_index < glyph_blob.end &&
+                 layout.getGlyphCluster(glyph_index) == cluster);
+
+        Range<int32_t> glyph_code_units(cluster, 0);
+        std::vector<size_t> grapheme_code_unit_counts;
+        if (run.is_rtl()) {
+          if (cluster_start_glyph_index > 0) {
+            glyph_code_units.end =
+                layout.getGlyphCluster(cluster_start_glyph_index - 1);
+          } else {
+            glyph_code_units.end = text_count;
+          }
+          grapheme_code_unit_counts.push_back(glyph_code_units.width());
+        } else {
+          if (glyph_index < layout.nGlyphs()) {
+            glyph_code_units.end = layout.getGlyphCluster(glyph_index);
+          } else {
+            glyph_code_units.end = text_count;
+          }
+
+          // The glyph may be a ligature.  Determine how many graphemes are
+          // joined into this glyph and how many input code units map to
+          // each grapheme.
+          size_t code_unit_count = 1;
+          for (int32_t offset = glyph_code_units.start + 1;
+               offset < glyph_code_units.end; ++offset) {
+            if (minikin::GraphemeBreak::isGraphemeBreak(
+                    layout_advances.data(), text_ptr, text_start, text_count,
+                    text_start + offset)) {
+              grapheme_code_unit_counts.push_back(code_unit_count);
+              code_unit_count = 1;
+            } else {
+              code_unit_count++;
+            }
+          }
+          grapheme_code_unit_counts.push_back(code_unit_count);
+        }
+        float glyph_advance;
+        if (run.is_placeholder_run()) {
+          // The placeholder run's layout should yield one glyph representing
+          // the object replacement character.  Replace its width with the
+          // placeholder's width.
+          FML_DCHECK(layout.nGlyphs() == 1);
+          glyph_advance = run.placeholder_run()->width;
+        } else {
+          glyph_advance = layout.getCharAdvance(glyph_code_units.start);
+        }
+        float grapheme_advance =
+            glyph_advance / grapheme_code_unit_counts.size();
+
+        glyph_positions.emplace_back(run_x_offset + glyph_x_offset,
+                                     grapheme_advance,
+                                     run.start() + glyph_code_units.start,
+                                     grapheme_code_unit_counts[0]);
+
+        // Compute positions for the additional graphemes in the ligature.
+        for (size_t i = 1; i < grapheme_code_unit_counts.size(); ++i) {
+          glyph_positions.emplace_back(
+              glyph_positions.back().x_pos.end, grapheme_advance,
+              glyph_positions.back().code_units.start +
+                  grapheme_code_unit_counts[i - 1],
+              grapheme_code_unit_counts[i]);
+        }
+
+        bool at_word_start = false;
+        bool at_word_end = false;
+        if (word_index < words.size()) {
+          at_word_start =
+              words[word_index].start == run.start() + glyph_code_units.start;
+          at_word_end =
+              words[word_index].end == run.start() + glyph_code_units.end;
+          if (line_runs_all_rtl) {
+            std::swap(at_word_start, at_word_end);
+          }
+        }
+
+        if (at_word_start) {
+          word_start_position = run_x_offset + glyph_x_offset;
+        }
+
+        if (at_word_end) {
+          if (justify_line) {
+            justify_x_offset_delta += word_gap_width;
+          }
+          word_index++;
+
+          if (!isnan(word_start_position)) {
+            double word_width =
+                glyph_positions.back().x_pos.end - word_start_position;
+            line_layout->max_word_width =
+                std::max(word_width, line_layout->max_word_width);
+            word_start_position = std::numeric_limits<double>::quiet_NaN();
+          }
+        }
+      }  // for each in glyph_blob
+
+      if (glyph_positions.empty())
+        continue;
+
+      // Store the font metrics and TextStyle in the LineMetrics for this line
+      // to provide metrics upon user request. We index this RunMetrics
+      // instance at `run.end() - 1` to allow map::lower_bound to access the
+      // correct RunMetrics at any text index.
+      size_t run_key = run.end() - 1;
+      line_layout->run_metrics.emplace(run_key, &run.style());
+      SkFontMetrics* metrics =
+          &line_layout->run_metrics.at(run_key).font_metrics;
+      font.getMetrics(metrics);
+
+      Range<double> record_x_pos(
+          glyph_positions.front().x_pos.start - run_x_offset,
+          glyph_positions.back().x_pos.end - run_x_offset);
+      paint_records.emplace_back(
+          run.style(), SkPoint::Make(run_x_offset + justify_x_offset, 0),
+          builder.make(), *metrics, line_number, record_x_pos.start,
+          record_x_pos.end, run.is_ghost(), run.placeholder_run());
+      justify_x_offset += justify_x_offset_delta;
+
+      line_glyph_positions.insert(line_glyph_positions.end(),
+                                  glyph_positions.begin(),
+                                  glyph_positions.end());
+
+      // Add a record of glyph positions sorted by code unit index.
+      std::vector<GlyphPosition> code_unit_positions(glyph_positions);
+      std::sort(code_unit_positions.begin(), code_unit_positions.end(),
+                [](const GlyphPosition& a, const GlyphPosition& b) {
+                  return a.code_units.start < b.code_units.start;
+                });
+
+      double blob_x_pos_start = glyph_positions.front().x_pos.start;
+      double blob_x_pos_end = glyph_positions.back().x_pos.end;
+      line_code_unit_runs.emplace_back(
+          std::move(code_unit_positions),
+          Range<size_t>(run.start(), run.end()),
+          Range<double>(blob_x_pos_start, blob_x_pos_end), line_number,
+          *metrics, run.style(), run.direction(), run.placeholder_run());
+
+      if (run.is_placeholder_run()) {
+        line_inline_placeholder_code_unit_runs.push_back(
+            line_code_unit_runs.back());
+      }
+
+      if (!run.is_ghost()) {
+        line_layout->min_left =
+            std::min(line_layout->min_left, blob_x_pos_start);
+        line_layout->max_right =
+            std::max(line_layout->max_right, blob_x_pos_end);
+      }
+    }  // for each in glyph_blobs
+
+    if (run.is_placeholder_run()) {
+      run_x_offset += run.placeholder_run()->width;
+    } else {
+      // Do not increase x offset for LTR trailing ghost runs as it should not
+      // impact the layout of visible glyphs. RTL tailing ghost runs have the
+      // advance subtracted, so we do add the advance here to reset the
+      // run_x_offset. We do keep the record though so GetRectsForRange() can
+      // find metrics for trailing spaces.
+      if (!run.is_ghost() || run.is_rtl()) {
+        run_x_offset += layout.getAdvance();
+      }
+    }
+  }  // for each in line_runs
+
+  // Adjust the glyph positions based on the alignment of the line.
+  double line_x_offset = GetLineXOffset(run_x_offset, justify_line);
+  if (line_x_offset) {
+    for (CodeUnitRun& code_unit_run : line_code_unit_runs) {
+      code_unit_run.Shift(line_x_offset);
+    }
+    for (CodeUnitRun& code_unit_run :
+         line_inline_placeholder_code_unit_runs) {
+      code_unit_run.Shift(line_x_offset);
+    }
+    for (GlyphPosition& position : line_glyph_positions) {
+      position.Shift(line_x_offset);
+    }
+  }
+  line_layout->x_offset = line_x_offset;
+  return true;
 }
 
 void ParagraphTxt::UpdateLineMetrics(const SkFontMetrics& metrics,
@@ -1339,7 +1821,7 @@ double ParagraphTxt::GetLongestLine() {
 }
 
 void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
-  needs_layout_ = true;
+  SetDirty(true);
   paragraph_style_ = style;
 }
 
@@ -1956,18 +2438,19 @@ Paragraph::Range<size_t> ParagraphTxt::GetWordBoundary(size_t offset) {
   if (text_.size() == 0)
     return Range<size_t>(0, 0);
 
-  if (!word_breaker_) {
-    UErrorCode status = U_ZERO_ERROR;
-    word_breaker_.reset(
-        icu::BreakIterator::createWordInstance(icu::Locale(), status));
-    if (!U_SUCCESS(status))
-      return Range<size_t>(0, 0);
-  }
+  std::unique_ptr<icu::BreakIterator> word_breaker =
+      minikin::acquireBreakIterator(minikin::kBreakIteratorType_Word);
+  if (!word_breaker)
+    return Range<size_t>(0, 0);
 
-  word_breaker_->setText(icu::UnicodeString(false, text_.data(), text_.size()));
+  // The break iterator keeps a reference to the string while it is used.
+  icu::UnicodeString text(false, text_.data(), text_.size());
+  word_breaker->setText(text);
 
-  int32_t prev_boundary = word_breaker_->preceding(offset + 1);
-  int32_t next_boundary = word_breaker_->next();
+  int32_t prev_boundary = word_breaker->preceding(offset + 1);
+  int32_t next_boundary = word_breaker->next();
+  minikin::releaseBreakIterator(minikin::kBreakIteratorType_Word,
+                                std::move(word_breaker));
   if (prev_boundary == icu::BreakIterator::DONE)
     prev_boundary = offset;
   if (next_boundary == icu::BreakIterator::DONE)
@@ -1987,6 +2470,10 @@ bool ParagraphTxt::DidExceedMaxLines() {
 
 void ParagraphTxt::SetDirty(bool dirty) {
   needs_layout_ = dirty;
+  if (dirty) {
+    // Nothing from the previous layout can be reused.
+    blocks_.clear();
+  }
 }
 
 std::vector<LineMetrics>& ParagraphTxt::GetLineMetrics() {
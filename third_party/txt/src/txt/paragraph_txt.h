@@ -17,7 +17,11 @@
 #ifndef LIB_TXT_SRC_PARAGRAPH_TXT_H_
 #define LIB_TXT_SRC_PARAGRAPH_TXT_H_
 
+#include <map>
+#include <memory>
+#include <optional>
 #include <set>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -25,6 +29,7 @@
 #include "flutter/fml/macros.h"
 #include "font_collection.h"
 #include "line_metrics.h"
+#include "minikin/Layout.h"
 #include "minikin/LineBreaker.h"
 #include "paint_record.h"
 #include "paragraph.h"
@@ -126,6 +131,28 @@ class ParagraphTxt : public Paragraph {
   // Layout from being calculated by setting to false.
   void SetDirty(bool dirty = true);
 
+  // Replaces the code units in [start, end) with text, which takes the style of
+  // the code unit before start (or of the first code unit if start is 0).
+  //
+  // The next Layout() with the same width only breaks and shapes the blocks of
+  // text between hard line breaks that the edit touches, and reuses the lines
+  // of all other blocks. Paragraphs with a maximum number of lines or an
+  // ellipsis are always laid out in full.
+  //
+  // Returns false without changing the paragraph if the range is out of
+  // bounds, if the paragraph has no styled text, or if the range removes or
+  // borders an inline placeholder.
+  //
+  // This is the entry point for text editors that own a ParagraphTxt built by
+  // ParagraphBuilderTxt and edit its text in place. It is not part of the
+  // Paragraph interface, so it is not reachable from dart:ui, whose paragraphs
+  // are immutable and are rebuilt by the framework for every edit.
+  bool ReplaceText(size_t start, size_t end, const std::u16string& text);
+
+  // The result of Layout() for a text, its styles and a width, which
+  // paragraphs share through the ParagraphCache of their font collection.
+  struct CachedLayout;
+
  private:
   friend class ParagraphBuilderTxt;
   FRIEND_TEST(ParagraphTest, SimpleParagraph);
@@ -164,6 +191,8 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
+  FRIEND_TEST(ParagraphTest, ReplaceTextReusesUneditedLines);
+  FRIEND_TEST(ParagraphTest, IdenticalParagraphsShareLayout);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -184,7 +213,6 @@ class ParagraphTxt : public Paragraph {
   std::shared_ptr<FontCollection> font_collection_;
 
   minikin::LineBreaker breaker_;
-  mutable std::unique_ptr<icu::BreakIterator> word_breaker_;
 
   std::vector<LineMetrics> line_metrics_;
   size_t final_line_count_;
@@ -249,6 +277,13 @@ class ParagraphTxt : public Paragraph {
     bool is_ghost() const { return is_ghost_; }
     bool is_placeholder_run() const { return placeholder_run_ != nullptr; }
 
+    // Moves the run of a block that started at old_start and now starts at
+    // new_start.
+    void MoveCodeUnits(size_t old_start, size_t new_start) {
+      start_ = start_ - old_start + new_start;
+      end_ = end_ - old_start + new_start;
+    }
+
    private:
     size_t start_, end_;
     TextDirection direction_;
@@ -267,6 +302,10 @@ class ParagraphTxt : public Paragraph {
                   size_t code_unit_width);
 
     void Shift(double delta);
+
+    // Moves the code units of a line that started at old_start and now starts
+    // at new_start.
+    void MoveCodeUnits(size_t old_start, size_t new_start);
   };
 
   struct GlyphLine {
@@ -298,6 +337,62 @@ class ParagraphTxt : public Paragraph {
                 const PlaceholderRun* placeholder);
 
     void Shift(double delta);
+
+    void MoveCodeUnits(size_t old_start, size_t new_start);
+  };
+
+  // The results of laying out a line that do not depend on the lines above it.
+  // Layout() keeps them so that the lines of blocks that were not edited by
+  // ReplaceText() are not shaped again.
+  struct LineLayout {
+    // The index of the first code unit of the line when it was laid out. All
+    // code unit indexes below are relative to the text at that time.
+    size_t start_index = 0;
+    // The runs the line was laid out from. The layout is reused only if the
+    // line still has the same runs.
+    std::vector<BidiRun> runs;
+    // Records offset horizontally within the line, before alignment.
+    std::vector<PaintRecord> paint_records;
+    std::vector<GlyphPosition> glyph_positions;
+    std::vector<CodeUnitRun> code_unit_runs;
+    std::vector<CodeUnitRun> inline_placeholder_code_unit_runs;
+    std::map<size_t, RunMetrics> run_metrics;
+    double x_offset = 0;
+    double min_left = FLT_MAX;
+    double max_right = FLT_MIN;
+    double max_word_width = 0;
+
+    // Returns whether runs, moved to a line starting at line_start, are the
+    // runs this line was laid out from.
+    bool HasRuns(const std::vector<BidiRun>& runs, size_t line_start) const;
+  };
+
+  // A range of text that is broken into lines independently of the rest of
+  // the paragraph because it ends with a hard line break (or the end of the
+  // text).
+  struct LayoutBlock {
+    size_t start;
+    // The index of the hard line break that ends the block, or the text size.
+    size_t end;
+    // Whether the text of the block changed since the block was broken into
+    // lines. The fields below are only valid for blocks that are not dirty.
+    bool dirty = true;
+    // The index of the first code unit of the block when it was broken.
+    size_t layout_start = 0;
+    // The lines of the block in line_metrics_, line_widths_ and
+    // line_layouts_.
+    size_t first_line = 0;
+    size_t line_count = 0;
+    size_t placeholder_count = 0;
+    double max_intrinsic_width = 0;
+    // The bidi runs of the block and of the hard line break that ends it, in
+    // visual order, or nullopt if they have to be computed again.
+    std::optional<std::vector<BidiRun>> bidi_runs;
+    // Whether bidi_runs were computed for the end of the text, where a
+    // trailing whitespace is attached to the run before it.
+    bool bidi_runs_end_text = false;
+
+    LayoutBlock(size_t s, size_t e) : start(s), end(e) {}
   };
 
   // Holds the laid out x positions of each glyph.
@@ -309,6 +404,12 @@ class ParagraphTxt : public Paragraph {
   // Holds the positions of the inline placeholders.
   std::vector<CodeUnitRun> inline_placeholder_code_unit_runs_;
 
+  // The blocks of the text between hard line breaks, and the layout of each
+  // line (parallel to line_metrics_) that can be reused by the next Layout().
+  // Empty when the next Layout() has to break and shape all of the text.
+  std::vector<LayoutBlock> blocks_;
+  std::vector<std::shared_ptr<LineLayout>> line_layouts_;
+
   // The max width of the paragraph as provided in the most recent Layout()
   // call.
   double width_ = -1.0f;
@@ -342,11 +443,48 @@ class ParagraphTxt : public Paragraph {
       std::vector<PlaceholderRun> inline_placeholders,
       std::unordered_set<size_t> obj_replacement_char_indexes);
 
-  // Break the text into lines.
+  // Break the text into lines. Only the dirty blocks of blocks_ are broken
+  // again, the lines of the other blocks are reused.
   bool ComputeLineBreaks();
 
-  // Break the text into runs based on LTR/RTL text direction.
-  bool ComputeBidiRuns(std::vector<BidiRun>* result);
+  // Whether Layout() can reuse the lines of unedited blocks. Otherwise, all of
+  // the text is laid out again.
+  bool CanLayoutIncrementally() const;
+
+  // Whether the layout can be shared with other paragraphs through the
+  // ParagraphCache. Paragraphs with placeholders and long paragraphs are
+  // always laid out themselves.
+  bool CanUseParagraphCache() const;
+
+  // Hashes the text, styles and width that the layout depends on.
+  size_t HashLayoutInputs() const;
+
+  // Copies the result of the last Layout() to be shared with other paragraphs.
+  std::shared_ptr<CachedLayout> SaveLayout() const;
+
+  // Replaces the result of Layout() with a layout shared by another paragraph
+  // that has the same text, styles and width.
+  void RestoreLayout(const CachedLayout& cached);
+
+  // Break the text of the blocks of blocks_ into runs based on LTR/RTL text
+  // direction. The runs of the blocks that were not edited are reused.
+  bool ComputeBidiRuns();
+
+  // Break the text in [start, end) into runs based on LTR/RTL text direction.
+  // The range must end at a hard line break or at the end of the text.
+  bool ComputeBidiRuns(size_t start,
+                       size_t end,
+                       std::vector<BidiRun>* result);
+
+  // Shapes the runs of a line and positions them within the line. Returns
+  // false if a font collection could not be found.
+  bool LayoutLine(size_t line_number,
+                  const std::vector<BidiRun>& line_runs,
+                  size_t& line_limit,
+                  SkFont& font,
+                  minikin::Layout& layout,
+                  SkTextBlobBuilder& builder,
+                  LineLayout* line_layout);
 
   // Calculates and populates strut based on paragraph_style_ strut info.
   void ComputeStrut(StrutMetrics* strut, SkFont& font);
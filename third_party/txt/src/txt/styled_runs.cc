@@ -41,6 +41,24 @@ void StyledRuns::swap(StyledRuns& other) {
   runs_.swap(other.runs_);
 }
 
+StyledRuns StyledRuns::Copy() const {
+  StyledRuns copy;
+  copy.styles_ = styles_;
+  copy.runs_ = runs_;
+  return copy;
+}
+
+const TextStyle* StyledRuns::MapStyle(const StyledRuns& other,
+                                      const TextStyle* style) const {
+  FML_DCHECK(runs_.size() == other.runs_.size());
+  for (size_t i = 0; i < other.runs_.size(); ++i) {
+    if (&other.styles_[other.runs_[i].style_index] == style)
+      return &styles_[runs_[i].style_index];
+  }
+  FML_DCHECK(false);
+  return nullptr;
+}
+
 size_t StyledRuns::AddStyle(const TextStyle& style) {
   const size_t style_index = styles_.size();
   styles_.push_back(style);
@@ -73,4 +91,29 @@ StyledRuns::Run StyledRuns::GetRun(size_t index) const {
   return Run{styles_[run.style_index], run.start, run.end};
 }
 
+void StyledRuns::ReplaceRange(size_t start, size_t end, size_t length) {
+  FML_DCHECK(start <= end);
+  // Run boundaries before the edit stay in place, and boundaries after it
+  // move with the text. Boundaries at or inside the replaced range end up
+  // after the new code units, so the run before the edit grows.
+  auto move_boundary = [start, end, length](size_t index) -> size_t {
+    if (index < start || index == 0)
+      return index;
+    if (index <= end)
+      return start + length;
+    return index - (end - start) + length;
+  };
+
+  std::vector<IndexedRun> runs;
+  runs.reserve(runs_.size());
+  for (const IndexedRun& run : runs_) {
+    size_t run_start = move_boundary(run.start);
+    size_t run_end = move_boundary(run.end);
+    if (run_start < run_end) {
+      runs.emplace_back(run.style_index, run_start, run_end);
+    }
+  }
+  runs_.swap(runs);
+}
+
 }  // namespace txt
@@ -48,6 +48,15 @@ class StyledRuns {
 
   void swap(StyledRuns& other);
 
+  // Returns a copy of the styles and runs. Copies are explicit because
+  // pointers to the styles of a paragraph's runs must not outlive them.
+  StyledRuns Copy() const;
+
+  // Returns the style of the run of these runs that corresponds to the run of
+  // other with the given style. Other must equal these runs.
+  const TextStyle* MapStyle(const StyledRuns& other,
+                            const TextStyle* style) const;
+
   size_t AddStyle(const TextStyle& style);
 
   const TextStyle& GetStyle(size_t style_index) const;
@@ -60,6 +69,12 @@ class StyledRuns {
 
   Run GetRun(size_t index) const;
 
+  // Updates the runs after the code units in [start, end) of the text were
+  // replaced with length code units. The new code units are added to the run
+  // of the code unit before start, or to the first run if start is 0. Runs
+  // that no longer contain any code units are removed.
+  void ReplaceRange(size_t start, size_t end, size_t length);
+
  private:
   FRIEND_TEST(ParagraphTest, SimpleParagraph);
   FRIEND_TEST(ParagraphTest, SimpleParagraphSmall);
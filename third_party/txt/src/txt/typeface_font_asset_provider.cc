@@ -28,17 +28,20 @@ TypefaceFontAssetProvider::~TypefaceFontAssetProvider() = default;
 
 // |FontAssetProvider|
 size_t TypefaceFontAssetProvider::GetFamilyCount() const {
+  std::scoped_lock lock(mutex_);
   return family_names_.size();
 }
 
 // |FontAssetProvider|
 std::string TypefaceFontAssetProvider::GetFamilyName(int index) const {
+  std::scoped_lock lock(mutex_);
   return family_names_[index];
 }
 
 // |FontAssetProvider|
 SkFontStyleSet* TypefaceFontAssetProvider::MatchFamily(
     const std::string& family_name) {
+  std::scoped_lock lock(mutex_);
   auto found = registered_families_.find(CanonicalFamilyName(family_name));
   if (found == registered_families_.end()) {
     return nullptr;
@@ -67,6 +70,7 @@ void TypefaceFontAssetProvider::RegisterTypeface(
   }
 
   std::string canonical_name = CanonicalFamilyName(family_name_alias);
+  std::scoped_lock lock(mutex_);
   auto family_it = registered_families_.find(canonical_name);
   if (family_it == registered_families_.end()) {
     family_names_.push_back(family_name_alias);
@@ -85,16 +89,19 @@ void TypefaceFontStyleSet::registerTypeface(sk_sp<SkTypeface> typeface) {
   if (typeface == nullptr) {
     return;
   }
+  std::scoped_lock lock(mutex_);
   typefaces_.emplace_back(std::move(typeface));
 }
 
 int TypefaceFontStyleSet::count() {
+  std::scoped_lock lock(mutex_);
   return typefaces_.size();
 }
 
 void TypefaceFontStyleSet::getStyle(int index,
                                     SkFontStyle* style,
                                     SkString* name) {
+  std::scoped_lock lock(mutex_);
   FML_DCHECK(static_cast<size_t>(index) < typefaces_.size());
   if (style) {
     *style = typefaces_[index]->fontStyle();
@@ -105,6 +112,7 @@ void TypefaceFontStyleSet::getStyle(int index,
 }
 
 SkTypeface* TypefaceFontStyleSet::createTypeface(int i) {
+  std::scoped_lock lock(mutex_);
   size_t index = i;
   if (index >= typefaces_.size()) {
     return nullptr;
@@ -14,9 +14,14 @@
  * limitations under the License.
  */
 
+#include <thread>
+
 #include "flutter/fml/logging.h"
 #include "gtest/gtest.h"
+#include "minikin/Layout.h"
+#include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/utils/SkCustomTypeface.h"
+#include "txt/asset_font_manager.h"
 #include "txt/font_collection.h"
 #include "txt_test_utils.h"
 
@@ -138,6 +143,126 @@ TEST(FontCollectionTest, CheckSkTypefacesSorting) {
             SkFontStyle::kExpanded_Width);
 }
 
+TEST(FontCollectionTest, ShapingCacheReusesWordsAcrossTexts) {
+  auto font_collection = GetTestFontCollection();
+  auto minikin_collection =
+      font_collection->GetMinikinFontCollectionForFamilies({"Roboto"}, "");
+  ASSERT_NE(minikin_collection, nullptr);
+  minikin::Layout::purgeCaches();
+
+  auto layout_text = [&](const std::u16string& text) {
+    minikin::Layout layout;
+    layout.doLayout(reinterpret_cast<const uint16_t*>(text.data()), 0,
+                    text.size(), text.size(), false, minikin::FontStyle(),
+                    minikin::MinikinPaint(), minikin_collection);
+  };
+
+  layout_text(u"hello world");
+  minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  EXPECT_EQ(stats.layoutHitCount, 0u);
+  EXPECT_GT(stats.layoutMissCount, 0u);
+  EXPECT_GT(stats.layoutBytes, 0u);
+  EXPECT_LE(stats.layoutBytes, stats.layoutMaxBytes);
+
+  // The words are shaped once, even though they are in different text.
+  layout_text(u"world hello");
+  minikin::LayoutCacheStats reused_stats = minikin::Layout::getCacheStats();
+  EXPECT_EQ(reused_stats.layoutMissCount, stats.layoutMissCount);
+  EXPECT_EQ(reused_stats.layoutHitCount, stats.layoutMissCount);
+  EXPECT_EQ(reused_stats.layoutCount, stats.layoutCount);
+
+  // Shrinking the budget evicts the words.
+  FontCollection::SetShapingCacheMaxBytes(0);
+  minikin::LayoutCacheStats evicted_stats = minikin::Layout::getCacheStats();
+  EXPECT_EQ(evicted_stats.layoutCount, 0u);
+  EXPECT_EQ(evicted_stats.layoutBytes, 0u);
+  EXPECT_EQ(evicted_stats.layoutEvictionCount, stats.layoutCount);
+
+  FontCollection::SetShapingCacheMaxBytes(stats.layoutMaxBytes);
+}
+
+namespace {
+// A font manager that matches every character to Roboto, like a platform
+// font manager with a single fallback font, and counts the queries.
+class CountingFallbackFontManager : public DynamicFontManager {
+ public:
+  CountingFallbackFontManager() {
+    font_provider().RegisterTypeface(SkTypeface::MakeFromFile(
+        (GetFontDir() + "/Roboto-Regular.ttf").c_str()));
+  }
+
+  int query_count() const { return query_count_; }
+
+ private:
+  mutable int query_count_ = 0;
+
+  // |SkFontMgr|
+  SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                          const SkFontStyle& style,
+                                          const char* bcp47[],
+                                          int bcp47Count,
+                                          SkUnichar character) const override {
+    query_count_++;
+    return matchFamilyStyle("Roboto", style);
+  }
+};
+}  // namespace
+
+TEST(FontCollectionTest, FallbackFontsAreMatchedByCoverage) {
+  auto font_manager = sk_make_sp<CountingFallbackFontManager>();
+  auto font_collection = std::make_shared<FontCollection>();
+  font_collection->SetDynamicFontManager(font_manager);
+
+  auto roboto = font_collection->MatchFallbackFont('a', "en");
+  ASSERT_NE(roboto, nullptr);
+  EXPECT_EQ(font_manager->query_count(), 1);
+
+  // Other characters covered by the fallback font found for the locale are
+  // matched to it without asking the font manager.
+  EXPECT_EQ(font_collection->MatchFallbackFont('b', "en"), roboto);
+  EXPECT_EQ(font_collection->MatchFallbackFont('Z', "en"), roboto);
+  EXPECT_EQ(font_manager->query_count(), 1);
+
+  // Characters that the font does not cover, symbols that may be drawn with
+  // an emoji font, and other locales still ask the font manager.
+  font_collection->MatchFallbackFont(0x1F600, "en");
+  EXPECT_EQ(font_manager->query_count(), 2);
+  font_collection->MatchFallbackFont(0x00A9, "en");
+  EXPECT_EQ(font_manager->query_count(), 3);
+  font_collection->MatchFallbackFont('b', "ja");
+  EXPECT_EQ(font_manager->query_count(), 4);
+}
+
+TEST(FontCollectionTest, ConcurrentLookupsShareFontCollections) {
+  auto font_collection = GetTestFontCollection();
+  constexpr size_t kThreadCount = 4;
+  std::vector<std::shared_ptr<minikin::FontCollection>> results(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; ++i) {
+    threads.emplace_back([&font_collection, &results, i] {
+      results[i] = font_collection->GetMinikinFontCollectionForFamilies(
+          {"Roboto"}, "en");
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  // Threads that built the collection at the same time get the one that was
+  // cached first.
+  auto cached =
+      font_collection->GetMinikinFontCollectionForFamilies({"Roboto"}, "en");
+  ASSERT_NE(cached, nullptr);
+  for (const auto& result : results) {
+    EXPECT_EQ(result, cached);
+  }
+
+  font_collection->ClearFontFamilyCache();
+  EXPECT_NE(
+      font_collection->GetMinikinFontCollectionForFamilies({"Roboto"}, "en"),
+      cached);
+}
+
 #if 0
 
 TEST(FontCollection, HasDefaultRegistrations) {
@@ -24,6 +24,7 @@
 #include "third_party/skia/include/core/SkPath.h"
 #include "txt/font_style.h"
 #include "txt/font_weight.h"
+#include "txt/paragraph_cache.h"
 #include "txt/paragraph_builder_txt.h"
 #include "txt/paragraph_txt.h"
 #include "txt/placeholder_run.h"
@@ -6560,4 +6561,208 @@ TEST_F(ParagraphTest, TextHeightBehaviorRectsParagraph) {
   ASSERT_TRUE(Snapshot());
 }
 
+TEST_F(ParagraphTest, ReplaceTextReusesUneditedLines) {
+  const char* text =
+      "This is the first block of text. It wraps onto several lines.\n"
+      "This is the second block of text. It is edited below.\n"
+      "This is the third block of text. It also wraps onto several lines.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  const std::u16string inserted = u"Some more words. ";
+  const size_t edit_index = u16_text.find(u"It is edited");
+  std::u16string edited_text = u16_text;
+  edited_text.insert(edit_index, inserted);
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  auto build = [&](const std::u16string& paragraph_text) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(paragraph_text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph = build(u16_text);
+  paragraph->Layout(300);
+  ASSERT_GT(paragraph->line_metrics_.size(), 3ull);
+  auto first_line_layout = paragraph->line_layouts_.front();
+  auto last_line_layout = paragraph->line_layouts_.back();
+
+  ASSERT_TRUE(paragraph->ReplaceText(edit_index, edit_index, inserted));
+
+  // Only the bidi runs of the edited block have to be computed again.
+  ASSERT_EQ(paragraph->blocks_.size(), 3ull);
+  EXPECT_TRUE(paragraph->blocks_[0].bidi_runs);
+  EXPECT_FALSE(paragraph->blocks_[1].bidi_runs);
+  EXPECT_TRUE(paragraph->blocks_[2].bidi_runs);
+
+  paragraph->Layout(300);
+
+  // The lines of the first and last blocks were not laid out again.
+  EXPECT_EQ(paragraph->line_layouts_.front(), first_line_layout);
+  EXPECT_EQ(paragraph->line_layouts_.back(), last_line_layout);
+
+  // The bidi runs of the last block moved with its text.
+  const auto& last_block = paragraph->blocks_.back();
+  ASSERT_TRUE(last_block.bidi_runs);
+  ASSERT_FALSE(last_block.bidi_runs->empty());
+  EXPECT_EQ(last_block.bidi_runs->front().start(), last_block.start);
+  EXPECT_EQ(last_block.bidi_runs->back().end(), edited_text.size());
+
+  // The result is the same as laying out the edited text from scratch.
+  auto expected = build(edited_text);
+  expected->Layout(300);
+  ASSERT_EQ(paragraph->text_.size(), edited_text.size());
+  for (size_t i = 0; i < edited_text.size(); i++) {
+    ASSERT_EQ(paragraph->text_[i], edited_text[i]);
+  }
+  ASSERT_EQ(paragraph->line_metrics_.size(), expected->line_metrics_.size());
+  for (size_t i = 0; i < expected->line_metrics_.size(); ++i) {
+    const LineMetrics& actual_line = paragraph->line_metrics_[i];
+    const LineMetrics& expected_line = expected->line_metrics_[i];
+    EXPECT_EQ(actual_line.start_index, expected_line.start_index);
+    EXPECT_EQ(actual_line.end_index, expected_line.end_index);
+    EXPECT_EQ(actual_line.hard_break, expected_line.hard_break);
+    EXPECT_DOUBLE_EQ(actual_line.baseline, expected_line.baseline);
+    EXPECT_DOUBLE_EQ(actual_line.width, expected_line.width);
+  }
+  ASSERT_EQ(paragraph->records_.size(), expected->records_.size());
+  for (size_t i = 0; i < expected->records_.size(); ++i) {
+    EXPECT_EQ(paragraph->records_[i].line(), expected->records_[i].line());
+    EXPECT_EQ(paragraph->records_[i].offset(), expected->records_[i].offset());
+  }
+  ASSERT_EQ(paragraph->glyph_lines_.size(), expected->glyph_lines_.size());
+  for (size_t i = 0; i < expected->glyph_lines_.size(); ++i) {
+    const auto& actual_positions = paragraph->glyph_lines_[i].positions;
+    const auto& expected_positions = expected->glyph_lines_[i].positions;
+    ASSERT_EQ(actual_positions.size(), expected_positions.size());
+    for (size_t j = 0; j < expected_positions.size(); ++j) {
+      EXPECT_EQ(actual_positions[j].code_units.start,
+                expected_positions[j].code_units.start);
+      EXPECT_DOUBLE_EQ(actual_positions[j].x_pos.start,
+                       expected_positions[j].x_pos.start);
+    }
+  }
+  auto actual_boxes = paragraph->GetRectsForRange(
+      0, edited_text.size(), Paragraph::RectHeightStyle::kMax,
+      Paragraph::RectWidthStyle::kTight);
+  auto expected_boxes = expected->GetRectsForRange(
+      0, edited_text.size(), Paragraph::RectHeightStyle::kMax,
+      Paragraph::RectWidthStyle::kTight);
+  ASSERT_EQ(actual_boxes.size(), expected_boxes.size());
+  for (size_t i = 0; i < expected_boxes.size(); ++i) {
+    EXPECT_EQ(actual_boxes[i].rect, expected_boxes[i].rect);
+  }
+
+  // Invalid ranges are rejected.
+  EXPECT_FALSE(paragraph->ReplaceText(10, 5, u""));
+  EXPECT_FALSE(
+      paragraph->ReplaceText(edited_text.size() + 1, edited_text.size() + 1,
+                             u""));
+}
+
+TEST_F(ParagraphTest, IdenticalParagraphsShareLayout) {
+  auto font_collection = GetTestFontCollection();
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  auto build = [&](const std::u16string& text, SkColor color) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    text_style.color = color;
+    builder.PushStyle(text_style);
+    builder.AddText(text);
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto paragraph = build(u"A label of a list item", SK_ColorBLACK);
+  paragraph->Layout(100);
+  auto same_paragraph = build(u"A label of a list item", SK_ColorBLACK);
+  same_paragraph->Layout(100);
+  auto red_paragraph = build(u"A label of a list item", SK_ColorRED);
+  red_paragraph->Layout(100);
+
+  // The second paragraph reuses the text blobs of the first.
+  ASSERT_GT(paragraph->GetLineCount(), 1ull);
+  ASSERT_EQ(same_paragraph->records_.size(), paragraph->records_.size());
+  for (size_t i = 0; i < paragraph->records_.size(); ++i) {
+    EXPECT_EQ(same_paragraph->records_[i].text(),
+              paragraph->records_[i].text());
+    EXPECT_EQ(same_paragraph->records_[i].offset(),
+              paragraph->records_[i].offset());
+  }
+  ASSERT_EQ(same_paragraph->line_metrics_.size(),
+            paragraph->line_metrics_.size());
+  EXPECT_DOUBLE_EQ(same_paragraph->GetHeight(), paragraph->GetHeight());
+  EXPECT_DOUBLE_EQ(same_paragraph->GetLongestLine(),
+                   paragraph->GetLongestLine());
+  for (const auto& code_unit_run : same_paragraph->code_unit_runs_) {
+    EXPECT_EQ(code_unit_run.style, &same_paragraph->runs_.GetRun(0).style);
+  }
+
+  // A paragraph with a different style is laid out itself.
+  ASSERT_FALSE(red_paragraph->records_.empty());
+  EXPECT_NE(red_paragraph->records_[0].text(), paragraph->records_[0].text());
+  EXPECT_EQ(red_paragraph->records_[0].style().color, SK_ColorRED);
+
+  auto stats = font_collection->GetParagraphCache()->GetStats();
+  EXPECT_EQ(stats.hit_count, 1u);
+  EXPECT_EQ(stats.miss_count, 2u);
+  EXPECT_EQ(stats.entry_count, 2u);
+
+  // Loading fonts invalidates the layouts.
+  font_collection->ClearFontFamilyCache();
+  EXPECT_EQ(font_collection->GetParagraphCache()->GetStats().entry_count, 0u);
+}
+
+TEST_F(ParagraphTest, ParagraphCacheKeyCoversFontFeaturesAndFamilies) {
+  auto font_collection = GetTestFontCollection();
+  txt::ParagraphStyle paragraph_style;
+
+  auto layout = [&](const txt::TextStyle& text_style) {
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+    builder.PushStyle(text_style);
+    builder.AddText(u"0123456789");
+    builder.Pop();
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(GetTestCanvasWidth());
+  };
+  auto miss_count = [&font_collection]() {
+    return font_collection->GetParagraphCache()->GetStats().miss_count;
+  };
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  layout(text_style);
+  layout(text_style);
+  EXPECT_EQ(miss_count(), 1u);
+
+  txt::TextStyle tabular_style = text_style;
+  tabular_style.font_features.SetFeature("tnum", 1);
+  layout(tabular_style);
+  EXPECT_EQ(miss_count(), 2u);
+
+  // Only the first families are compared by TextStyle::equals.
+  txt::TextStyle fallback_style = text_style;
+  fallback_style.font_families.push_back("Homemade Apple");
+  layout(fallback_style);
+  EXPECT_EQ(miss_count(), 3u);
+
+  txt::TextStyle no_families_style = text_style;
+  no_families_style.font_families.clear();
+  layout(no_families_style);
+  EXPECT_EQ(miss_count(), 4u);
+
+  EXPECT_EQ(font_collection->GetParagraphCache()->GetStats().hit_count, 1u);
+}
+
 }  // namespace txt
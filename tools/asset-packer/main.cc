@@ -0,0 +1,69 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <iostream>
+#include <string>
+
+#include "flutter/assets/asset_packer.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/paths.h"
+
+void Usage() {
+  std::cout << "Usage:" << std::endl;
+  std::cout << "asset-packer <output.pack> <assets directory>" << std::endl;
+  std::cout << std::endl;
+  std::cout << "Packs every file under the assets directory into a single "
+               "file that the engine can serve the assets from when it is "
+               "passed as the --flutter-assets-dir."
+            << std::endl;
+  std::cout << "The output file will be overwritten if it exists already and "
+               "the packing succeeds."
+            << std::endl;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    Usage();
+    return -1;
+  }
+  std::string output_file_path(argv[1]);
+  std::string assets_directory_path(argv[2]);
+
+  auto assets_directory = fml::OpenDirectory(
+      assets_directory_path.c_str(), false, fml::FilePermission::kRead);
+  if (!assets_directory.is_valid()) {
+    std::cerr << "Could not open the assets directory "
+              << assets_directory_path << "." << std::endl;
+    return -1;
+  }
+
+  flutter::AssetPacker packer;
+  if (!packer.AddDirectory(assets_directory)) {
+    std::cerr << "Could not read all the assets; aborting." << std::endl;
+    return -1;
+  }
+  auto pack = packer.Pack();
+  if (!pack) {
+    std::cerr << "Could not pack the assets; aborting." << std::endl;
+    return -1;
+  }
+
+  std::string output_directory_path =
+      fml::paths::GetDirectoryName(output_file_path);
+  if (output_directory_path.empty()) {
+    output_directory_path = ".";
+  }
+  auto output_directory = fml::OpenDirectory(
+      output_directory_path.c_str(), false, fml::FilePermission::kReadWrite);
+  const std::string output_file_name =
+      output_file_path.substr(output_file_path.find_last_of("/\\") + 1);
+  if (!fml::WriteAtomically(output_directory, output_file_name.c_str(),
+                            *pack)) {
+    std::cerr << "Could not write " << output_file_path << "." << std::endl;
+    return -1;
+  }
+  std::cout << "Wrote " << pack->GetSize() << " bytes to " << output_file_path
+            << "." << std::endl;
+  return 0;
+}